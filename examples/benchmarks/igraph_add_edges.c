@@ -0,0 +1,51 @@
+
+#include <igraph.h>
+#include "bench.h"
+
+/* Adds the same number of edges to a large graph, in batches of
+   different sizes. With incremental index maintenance the total time
+   should be roughly proportional to the number of batches times the
+   size of the graph, and not to the number of edges added. */
+
+#define N 100000
+#define M 1000000
+#define TOTAL 20000
+
+void add_in_batches(igraph_t *graph, long int batch_size) {
+    igraph_vector_t batch;
+    long int i, j;
+
+    igraph_vector_init(&batch, 2 * batch_size);
+    for (i = 0; i < TOTAL; i += batch_size) {
+        for (j = 0; j < 2 * batch_size; j++) {
+            VECTOR(batch)[j] = RNG_INTEGER(0, N - 1);
+        }
+        igraph_add_edges(graph, &batch, 0);
+    }
+    igraph_vector_destroy(&batch);
+}
+
+int main() {
+    igraph_t base, graph;
+    long int batch_sizes[] = { 10, 100, 1000, 10000 };
+    char name[100];
+    int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&base, IGRAPH_ERDOS_RENYI_GNM, N, M,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+
+    for (i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+        igraph_copy(&graph, &base);
+        snprintf(name, sizeof(name),
+                 "%d Adding %d edges to a %d edge graph, batch size %5ld ",
+                 i + 1, TOTAL, M, batch_sizes[i]);
+        BENCH(name, add_in_batches(&graph, batch_sizes[i]));
+        igraph_destroy(&graph);
+    }
+
+    igraph_destroy(&base);
+
+    return 0;
+}
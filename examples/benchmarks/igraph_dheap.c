@@ -0,0 +1,137 @@
+
+#include <igraph.h>
+#include "igraph_types_internal.h"
+#include "bench.h"
+
+/* Compares the indexed 4-ary heap with the two-way binary heap, on
+   heap sort and on Dijkstra's algorithm with real weights, where the
+   heap operations dominate. The two-way heap is a maximum heap, so it
+   gets the negated keys. */
+
+#define N 1000000
+#define M 8000000
+
+igraph_real_t sort_2wheap(const igraph_vector_t *keys) {
+    igraph_2wheap_t h;
+    long int i, n = igraph_vector_size(keys);
+    igraph_real_t sum = 0;
+    igraph_2wheap_init(&h, n);
+    for (i = 0; i < n; i++) {
+        igraph_2wheap_push_with_index(&h, i, -VECTOR(*keys)[i]);
+    }
+    while (!igraph_2wheap_empty(&h)) {
+        sum += igraph_2wheap_delete_max(&h);
+    }
+    igraph_2wheap_destroy(&h);
+    return sum;
+}
+
+igraph_real_t sort_dheap(const igraph_vector_t *keys) {
+    igraph_dheap_t h;
+    long int i, n = igraph_vector_size(keys);
+    igraph_real_t sum = 0;
+    igraph_dheap_init(&h, n);
+    for (i = 0; i < n; i++) {
+        igraph_dheap_push_with_index(&h, i, VECTOR(*keys)[i]);
+    }
+    while (!igraph_dheap_empty(&h)) {
+        sum += igraph_dheap_delete_min(&h, 0);
+    }
+    igraph_dheap_destroy(&h);
+    return sum;
+}
+
+igraph_real_t dijkstra_2wheap(const igraph_t *g, const igraph_inclist_t *il,
+                              const igraph_vector_t *w) {
+    igraph_2wheap_t h;
+    igraph_real_t sum = 0;
+    igraph_2wheap_init(&h, igraph_vcount(g));
+    igraph_2wheap_push_with_index(&h, 0, 0);
+    while (!igraph_2wheap_empty(&h)) {
+        long int v = igraph_2wheap_max_index(&h), i;
+        igraph_real_t d = -igraph_2wheap_deactivate_max(&h);
+        igraph_vector_int_t *inc = igraph_inclist_get(il, v);
+        sum += d;
+        for (i = 0; i < igraph_vector_int_size(inc); i++) {
+            long int e = VECTOR(*inc)[i], u = IGRAPH_TO(g, e);
+            igraph_real_t alt = d + VECTOR(*w)[e];
+            if (!igraph_2wheap_has_elem(&h, u)) {
+                igraph_2wheap_push_with_index(&h, u, -alt);
+            } else if (igraph_2wheap_has_active(&h, u) &&
+                       alt < -igraph_2wheap_get(&h, u)) {
+                igraph_2wheap_modify(&h, u, -alt);
+            }
+        }
+    }
+    igraph_2wheap_destroy(&h);
+    return sum;
+}
+
+igraph_real_t dijkstra_dheap(const igraph_t *g, const igraph_inclist_t *il,
+                             const igraph_vector_t *w) {
+    igraph_dheap_t h;
+    igraph_real_t sum = 0;
+    igraph_dheap_init(&h, igraph_vcount(g));
+    igraph_dheap_push_with_index(&h, 0, 0);
+    while (!igraph_dheap_empty(&h)) {
+        long int v, i;
+        igraph_real_t d = igraph_dheap_deactivate_min(&h, &v);
+        igraph_vector_int_t *inc = igraph_inclist_get(il, v);
+        sum += d;
+        for (i = 0; i < igraph_vector_int_size(inc); i++) {
+            long int e = VECTOR(*inc)[i], u = IGRAPH_TO(g, e);
+            igraph_real_t alt = d + VECTOR(*w)[e];
+            if (!igraph_dheap_has_elem(&h, u)) {
+                igraph_dheap_push_with_index(&h, u, alt);
+            } else if (igraph_dheap_has_active(&h, u) &&
+                       alt < igraph_dheap_get(&h, u)) {
+                igraph_dheap_modify(&h, u, alt);
+            }
+        }
+    }
+    igraph_dheap_destroy(&h);
+    return sum;
+}
+
+int main() {
+    igraph_t g;
+    igraph_inclist_t il;
+    igraph_vector_t keys, w;
+    igraph_real_t s1 = 0, s2 = 0;
+    long int i;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_vector_init(&keys, N);
+    for (i = 0; i < N; i++) {
+        VECTOR(keys)[i] = RNG_UNIF01();
+    }
+    BENCH("1 Heap sort of 1,000,000 keys, two-way heap", s1 = sort_2wheap(&keys));
+    BENCH("2 Heap sort of 1,000,000 keys, 4-ary heap  ", s2 = sort_dheap(&keys));
+    if (s1 != -s2) {
+        printf("Results differ\n");
+    }
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, N, M,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&w, M);
+    for (i = 0; i < M; i++) {
+        VECTOR(w)[i] = RNG_UNIF01();
+    }
+    igraph_inclist_init(&g, &il, IGRAPH_OUT);
+
+    BENCH("3 Dijkstra, 1,000,000 vertices, 8,000,000 edges, two-way heap",
+          s1 = dijkstra_2wheap(&g, &il, &w));
+    BENCH("4 Dijkstra, 1,000,000 vertices, 8,000,000 edges, 4-ary heap  ",
+          s2 = dijkstra_dheap(&g, &il, &w));
+    if (s1 != s2) {
+        printf("Results differ\n");
+    }
+
+    igraph_inclist_destroy(&il);
+    igraph_vector_destroy(&w);
+    igraph_vector_destroy(&keys);
+    igraph_destroy(&g);
+
+    return 0;
+}
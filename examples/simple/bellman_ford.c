@@ -22,6 +22,7 @@
 */
 
 #include <igraph.h>
+#include <math.h>
 
 int print_matrix(const igraph_matrix_t *m) {
     long int nrow = igraph_matrix_nrow(m);
@@ -48,6 +49,111 @@ int print_matrix(const igraph_matrix_t *m) {
     return 0;
 }
 
+/* Distances by |V|-1 rounds of relaxing every edge */
+
+int naive_bellman_ford(const igraph_t *g, igraph_matrix_t *res,
+                       const igraph_vector_t *weights, igraph_neimode_t mode) {
+    long int n = igraph_vcount(g), m = igraph_ecount(g);
+    long int s, r, e;
+
+    igraph_matrix_resize(res, n, n);
+    igraph_matrix_fill(res, IGRAPH_INFINITY);
+    for (s = 0; s < n; s++) {
+        MATRIX(*res, s, s) = 0;
+        for (r = 0; r < n - 1; r++) {
+            for (e = 0; e < m; e++) {
+                long int from = IGRAPH_FROM(g, e), to = IGRAPH_TO(g, e);
+                igraph_real_t w = VECTOR(*weights)[e];
+                if (mode & IGRAPH_OUT && MATRIX(*res, s, from) + w < MATRIX(*res, s, to)) {
+                    MATRIX(*res, s, to) = MATRIX(*res, s, from) + w;
+                }
+                if (mode & IGRAPH_IN && MATRIX(*res, s, to) + w < MATRIX(*res, s, from)) {
+                    MATRIX(*res, s, from) = MATRIX(*res, s, to) + w;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+/* Random graph with negative integer weights from vertex potentials,
+   so there is no negative cycle */
+
+int check_random(igraph_integer_t n, igraph_integer_t m, igraph_neimode_t mode) {
+    igraph_t g;
+    igraph_vector_t weights, potential;
+    igraph_matrix_t res, res2;
+    long int i;
+    int bad;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, m, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&potential, n);
+    for (i = 0; i < n; i++) {
+        VECTOR(potential)[i] = RNG_INTEGER(0, 20);
+    }
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        igraph_real_t d = VECTOR(potential)[ (long int) IGRAPH_FROM(&g, i) ] -
+                          VECTOR(potential)[ (long int) IGRAPH_TO(&g, i) ];
+        VECTOR(weights)[i] = RNG_INTEGER(0, 5) + (mode == IGRAPH_IN ? -d : d);
+    }
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&res2, 0, 0);
+    igraph_shortest_paths_bellman_ford(&g, &res, igraph_vss_all(), igraph_vss_all(),
+                                       &weights, mode);
+    naive_bellman_ford(&g, &res2, &weights, mode);
+    bad = !igraph_matrix_all_e(&res, &res2);
+
+    igraph_matrix_destroy(&res2);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_vector_destroy(&potential);
+    igraph_destroy(&g);
+
+    return bad;
+}
+
+/* Non-negative weights that are multiples of 'unit', compared to
+   Dijkstra's algorithm. The sums are rounded, so decreases of a
+   distance can be lost further down the shortest path tree. */
+
+int check_rounding(igraph_integer_t n, igraph_integer_t m, igraph_real_t unit) {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_matrix_t res, res2;
+    long int i, j;
+    int bad = 0;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, m, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, m);
+    for (i = 0; i < m; i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 30) * unit;
+    }
+
+    igraph_matrix_init(&res, 0, 0);
+    igraph_matrix_init(&res2, 0, 0);
+    igraph_shortest_paths_bellman_ford(&g, &res, igraph_vss_all(), igraph_vss_all(),
+                                       &weights, IGRAPH_OUT);
+    igraph_shortest_paths_dijkstra(&g, &res2, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, IGRAPH_OUT);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            igraph_real_t a = MATRIX(res, i, j), b = MATRIX(res2, i, j);
+            bad += b == IGRAPH_INFINITY ? a != b : fabs(a - b) > 1e-9 * b;
+        }
+    }
+
+    igraph_matrix_destroy(&res2);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return bad;
+}
+
 int main() {
 
     igraph_t g;
@@ -56,6 +162,8 @@ int main() {
     igraph_real_t weights_data_1[] = { 6, 7, 8, -4, -2, -3, 9, 2, 7 };
     igraph_real_t weights_data_2[] = { 6, 7, 2, -4, -2, -3, 9, 2, 7 };
     igraph_matrix_t res;
+    igraph_vs_t to;
+    long int i;
 
     /* Graph with only positive weights */
     igraph_small(&g, 10, IGRAPH_DIRECTED,
@@ -109,6 +217,58 @@ int main() {
     igraph_matrix_destroy(&res);
     igraph_destroy(&g);
 
+    /***************************************/
+
+    /* Random graphs, compared to the textbook algorithm */
+    igraph_set_error_handler(igraph_error_handler_abort);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    if (check_random(100, 300, IGRAPH_OUT) || check_random(100, 150, IGRAPH_OUT) ||
+        check_random(60, 400, IGRAPH_IN)) {
+        return 2;
+    }
+    for (i = 0; i < 100; i++) {
+        if (check_rounding(60, 200, 0.1) || check_rounding(60, 200, 1.8e18)) {
+            return 5;
+        }
+    }
+
+    /* A long path with a negative cycle at its end, it cannot be
+       reached from the source backwards */
+    igraph_ring(&g, 10000, IGRAPH_DIRECTED, /* mutual= */ 0, /* circular= */ 0);
+    igraph_add_edge(&g, 9999, 9990);
+    igraph_add_edge(&g, 5, 0);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    igraph_vector_fill(&weights, 1);
+    VECTOR(weights)[igraph_ecount(&g) - 2] = -10;
+    VECTOR(weights)[igraph_ecount(&g) - 1] = -4;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_vs_vector_small(&to, 0, 3, 9990, -1);
+    igraph_shortest_paths_bellman_ford(&g, &res, igraph_vss_1(9000), to,
+                                       &weights, IGRAPH_IN);
+    igraph_vs_destroy(&to);
+    print_matrix(&res);
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_shortest_paths_bellman_ford(&g, &res, igraph_vss_1(1),
+                                           igraph_vss_all(), &weights,
+                                           IGRAPH_OUT) != IGRAPH_ENEGLOOP) {
+        return 3;
+    }
+    igraph_vector_destroy(&weights);
+
+    /* A negative undirected edge is a negative cycle */
+    igraph_to_undirected(&g, IGRAPH_TO_UNDIRECTED_EACH, 0);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    igraph_vector_fill(&weights, 1);
+    VECTOR(weights)[5000] = -1;
+    if (igraph_shortest_paths_bellman_ford(&g, &res, igraph_vss_1(0),
+                                           igraph_vss_all(), &weights,
+                                           IGRAPH_OUT) != IGRAPH_ENEGLOOP) {
+        return 4;
+    }
+    igraph_vector_destroy(&weights);
+    igraph_matrix_destroy(&res);
+    igraph_destroy(&g);
+
     if (!IGRAPH_FINALLY_STACK_EMPTY) {
         return 1;
     }
@@ -0,0 +1,149 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2008-2012  Gabor Csardi <csardi.gabor@gmail.com>
+   334 Harvard street, Cambridge, MA 02139 USA
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+#include <igraph.h>
+#include "igraph_types_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define N 1000
+#define B 100
+
+/* Smallest key among the elements that are still in the queue */
+igraph_real_t brute_min(const igraph_real_t *keys, const char *in) {
+    igraph_real_t min = IGRAPH_INFINITY;
+    long int i;
+    for (i = 0; i < N; i++) {
+        if (in[i] && keys[i] < min) {
+            min = keys[i];
+        }
+    }
+    return min;
+}
+
+int main() {
+
+    igraph_bucketqueue_t Q;
+    igraph_real_t keys[N], prev;
+    char in[N];
+    long int i, j, k;
+
+    srand(42); /* make tests deterministic */
+
+    igraph_bucketqueue_init(&Q, N, B);
+
+    /*****/
+
+    for (i = 0; i < N; i++) {
+        keys[i] = rand() % B;
+        igraph_bucketqueue_push_with_index(&Q, i, keys[i]);
+    }
+    if (igraph_bucketqueue_size(&Q) != N) {
+        return 1;
+    }
+    for (i = 0; i < N; i++) {
+        if (igraph_bucketqueue_get(&Q, i) != keys[i]) {
+            return 2;
+        }
+    }
+    prev = 0;
+    for (i = 0; i < N; i++) {
+        igraph_real_t tmp = igraph_bucketqueue_delete_min(&Q, &j);
+        if (tmp < prev || tmp != keys[j]) {
+            return 3;
+        }
+        if (igraph_bucketqueue_has_elem(&Q, j)) {
+            return 4;
+        }
+        prev = tmp;
+    }
+    if (!igraph_bucketqueue_empty(&Q)) {
+        return 5;
+    }
+
+    /*****/
+
+    /* Use as in Dijkstra's algorithm: new and decreased keys are
+       between the last minimum and the last minimum plus B-1, the
+       buckets are reused many times */
+    igraph_bucketqueue_clear(&Q);
+    memset(in, 0, sizeof(in));
+    keys[0] = 12345;
+    in[0] = 1;
+    igraph_bucketqueue_push_with_index(&Q, 0, keys[0]);
+    k = 1;
+    while (!igraph_bucketqueue_empty(&Q)) {
+        igraph_real_t tmp = igraph_bucketqueue_deactivate_min(&Q, &j);
+        if (tmp != brute_min(keys, in) || tmp != keys[j]) {
+            return 6;
+        }
+        if (!igraph_bucketqueue_has_elem(&Q, j) ||
+            igraph_bucketqueue_has_active(&Q, j)) {
+            return 7;
+        }
+        in[j] = 0;
+        prev = tmp;
+        for (i = 0; i < 3 && k < N; i++, k++) {
+            keys[k] = prev + rand() % B;
+            in[k] = 1;
+            igraph_bucketqueue_push_with_index(&Q, k, keys[k]);
+        }
+        for (i = 0; i < 3; i++) {
+            long int l = rand() % k;
+            if (in[l]) {
+                keys[l] = prev + floor((keys[l] - prev) / 2);
+                igraph_bucketqueue_modify(&Q, l, keys[l]);
+                if (igraph_bucketqueue_get(&Q, l) != keys[l]) {
+                    return 8;
+                }
+            }
+        }
+    }
+    if (k != N) {
+        return 9;
+    }
+
+    /*****/
+
+    /* Clearing a queue that is not empty */
+    igraph_bucketqueue_push_with_index(&Q, 5, 3);
+    igraph_bucketqueue_push_with_index(&Q, 6, 70);
+    igraph_bucketqueue_clear(&Q);
+    for (i = 0; i < N; i++) {
+        if (igraph_bucketqueue_has_elem(&Q, i)) {
+            return 10;
+        }
+    }
+    igraph_bucketqueue_push_with_index(&Q, 5, 1007);
+    igraph_bucketqueue_push_with_index(&Q, 3, 1007);
+    igraph_bucketqueue_push_with_index(&Q, 4, 1000 + B - 1);
+    if (igraph_bucketqueue_delete_min(&Q, &j) != 1007 ||
+        igraph_bucketqueue_delete_min(&Q, &j) != 1007 ||
+        igraph_bucketqueue_delete_min(&Q, &j) != 1000 + B - 1 || j != 4 ||
+        !igraph_bucketqueue_empty(&Q)) {
+        return 11;
+    }
+
+    igraph_bucketqueue_destroy(&Q);
+
+    return 0;
+}
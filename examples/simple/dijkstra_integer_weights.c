@@ -0,0 +1,194 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Small integer weights use a bucket queue, the same weights halved
+   use the binary heap. Halving is exact, so the results must be exactly
+   half, the same, or double, up to the rounding errors caused by
+   visiting vertices at equal distance in a different order. */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i, n = igraph_vector_size(v1);
+    for (i = 0; i < n; i++) {
+        igraph_real_t a = VECTOR(*v1)[i], b = VECTOR(*v2)[i];
+        if (fabs(a - b) > 1e-10 * (fabs(a) > 1 ? fabs(a) : 1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check(const igraph_t *g, const igraph_vector_t *weights, const char *name) {
+    igraph_vector_t half, b1, b2, e1, e2, c1, c2;
+    igraph_matrix_t d1, d2;
+    igraph_vector_ptr_t paths;
+    igraph_vector_long_t pred;
+    long int i, j, n = igraph_vcount(g);
+    int bad = 0;
+
+    igraph_vector_copy(&half, weights);
+    igraph_vector_scale(&half, 0.5);
+
+    igraph_matrix_init(&d1, 0, 0);
+    igraph_matrix_init(&d2, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &d1, igraph_vss_all(), igraph_vss_all(),
+                                   weights, IGRAPH_OUT);
+    igraph_shortest_paths_dijkstra(g, &d2, igraph_vss_all(), igraph_vss_all(),
+                                   &half, IGRAPH_OUT);
+    igraph_matrix_scale(&d2, 2);
+    bad += !igraph_matrix_all_e(&d1, &d2);
+
+    /* Paths from the first vertex, they must have the right length */
+    igraph_vector_ptr_init(&paths, n);
+    for (i = 0; i < n; i++) {
+        VECTOR(paths)[i] = igraph_Calloc(1, igraph_vector_t);
+        igraph_vector_init(VECTOR(paths)[i], 0);
+    }
+    igraph_vector_long_init(&pred, 0);
+    igraph_get_shortest_paths_dijkstra(g, 0, &paths, 0, igraph_vss_all(), weights,
+                                       IGRAPH_OUT, &pred, 0);
+    for (i = 0; i < n; i++) {
+        igraph_vector_t *path = VECTOR(paths)[i];
+        igraph_real_t len = 0;
+        for (j = 0; j < igraph_vector_size(path); j++) {
+            len += VECTOR(*weights)[ (long int) VECTOR(*path)[j] ];
+        }
+        if (MATRIX(d1, 0, i) == IGRAPH_INFINITY) {
+            bad += VECTOR(pred)[i] != -1;
+        } else {
+            bad += len != MATRIX(d1, 0, i);
+        }
+        igraph_vector_destroy(path);
+        igraph_free(path);
+    }
+
+    /* Centrality needs positive weights */
+    if (igraph_vector_min(weights) > 0) {
+        igraph_vector_init(&b1, 0);
+        igraph_vector_init(&b2, 0);
+        igraph_betweenness(g, &b1, igraph_vss_all(), IGRAPH_DIRECTED, weights, 1);
+        igraph_betweenness(g, &b2, igraph_vss_all(), IGRAPH_DIRECTED, &half, 1);
+        bad += !same(&b1, &b2);
+
+        igraph_vector_init(&e1, 0);
+        igraph_vector_init(&e2, 0);
+        igraph_edge_betweenness(g, &e1, IGRAPH_DIRECTED, weights);
+        igraph_edge_betweenness(g, &e2, IGRAPH_DIRECTED, &half);
+        bad += !same(&e1, &e2);
+
+        /* Unreachable vertices count as distance n, so closeness is
+           checked against the distance matrix instead */
+        igraph_vector_init(&c1, 0);
+        igraph_vector_init(&c2, n);
+        igraph_closeness(g, &c1, igraph_vss_all(), IGRAPH_OUT, weights, 0);
+        for (i = 0; i < n; i++) {
+            for (j = 0; j < n; j++) {
+                igraph_real_t d = MATRIX(d1, i, j);
+                VECTOR(c2)[i] += d == IGRAPH_INFINITY ? n : d;
+            }
+            VECTOR(c2)[i] = 1.0 / VECTOR(c2)[i];
+        }
+        bad += !same(&c1, &c2);
+
+        igraph_vector_destroy(&c2);
+        igraph_vector_destroy(&c1);
+        igraph_vector_destroy(&e2);
+        igraph_vector_destroy(&e1);
+        igraph_vector_destroy(&b2);
+        igraph_vector_destroy(&b1);
+    }
+
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_vector_long_destroy(&pred);
+    igraph_vector_ptr_destroy(&paths);
+    igraph_matrix_destroy(&d2);
+    igraph_matrix_destroy(&d1);
+    igraph_vector_destroy(&half);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_matrix_t res;
+    long int i;
+    int bad = 0;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Closeness warns about the disconnected graphs */
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    /* Small weights with many ties, and zero weights */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 800, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 4);
+    }
+    bad += check(&g, &weights, "small weights");
+    for (i = 0; i < igraph_ecount(&g); i += 5) {
+        VECTOR(weights)[i] = 0;
+    }
+    bad += check(&g, &weights, "zero weights");
+
+    /* Weights close to the number of buckets allowed */
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(900, 1023);
+    }
+    bad += check(&g, &weights, "large weights");
+    igraph_destroy(&g);
+
+    /* Undirected graph */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 400, IGRAPH_UNDIRECTED,
+                            IGRAPH_NO_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 100);
+    }
+    bad += check(&g, &weights, "undirected");
+    igraph_destroy(&g);
+
+    /* A small example, the multiple edge decreases the distance of
+       vertex 2 below all others in the queue */
+    igraph_small(&g, 5, IGRAPH_DIRECTED, 0, 1, 1, 2, 0, 2, 2, 3, 0, 2, -1);
+    igraph_vector_resize(&weights, 5);
+    VECTOR(weights)[0] = 2;
+    VECTOR(weights)[1] = 3;
+    VECTOR(weights)[2] = 6;
+    VECTOR(weights)[3] = 1;
+    VECTOR(weights)[4] = 1;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths_dijkstra(&g, &res, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, IGRAPH_OUT);
+    igraph_matrix_print(&res);
+    igraph_matrix_destroy(&res);
+    igraph_destroy(&g);
+
+    igraph_vector_destroy(&weights);
+
+    return bad ? 1 : 0;
+}
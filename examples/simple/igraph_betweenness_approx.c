@@ -0,0 +1,130 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the sampled scores to the exact ones, the error must be
+   within epsilon times the number of vertex pairs */
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_bool_t directed, const char *name) {
+    igraph_vector_t exact, approx, approx2;
+    igraph_integer_t samples;
+    igraph_real_t epsilon = 0.02, pairs, maxerr = 0;
+    long int i, n = igraph_vcount(g);
+    int ok;
+
+    igraph_vector_init(&exact, 0);
+    igraph_vector_init(&approx, 0);
+    igraph_vector_init(&approx2, 0);
+
+    igraph_betweenness(g, &exact, igraph_vss_all(), directed, weights, 1);
+
+    igraph_set_num_threads(1);
+    igraph_rng_seed(igraph_rng_default(), 3);
+    igraph_betweenness_approx(g, &approx, igraph_vss_all(), directed, weights,
+                              epsilon, 0.1, &samples);
+    igraph_set_num_threads(4);
+    igraph_rng_seed(igraph_rng_default(), 3);
+    igraph_betweenness_approx(g, &approx2, igraph_vss_all(), directed, weights,
+                              epsilon, 0.1, 0);
+    igraph_set_num_threads(1);
+
+    pairs = n * (n - 1.0);
+    if (!directed || !igraph_is_directed(g)) {
+        pairs /= 2;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t err = fabs(VECTOR(exact)[i] - VECTOR(approx)[i]) / pairs;
+        maxerr = err > maxerr ? err : maxerr;
+    }
+    ok = maxerr < epsilon && igraph_vector_all_e(&approx, &approx2);
+    printf("%s: %ld samples, %s\n", name, (long int) samples, ok ? "ok" : "wrong");
+
+    igraph_vector_destroy(&approx2);
+    igraph_vector_destroy(&approx);
+    igraph_vector_destroy(&exact);
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, res;
+    igraph_integer_t samples;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_star(&g, 100, IGRAPH_STAR_UNDIRECTED, 0);
+    ok = check(&g, 0, 1, "star") && ok;
+    igraph_destroy(&g);
+
+    igraph_tree(&g, 500, 3, IGRAPH_TREE_UNDIRECTED);
+    ok = check(&g, 0, 1, "tree") && ok;
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 400, 1000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 0, 1, "undirected random") && ok;
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 4);
+    }
+    ok = check(&g, &weights, 1, "undirected random, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 900,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 0, 1, "directed random") && ok;
+    ok = check(&g, 0, 0, "directed random, undirected paths") && ok;
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 2);
+    }
+    ok = check(&g, &weights, 1, "directed random, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Without paths of three vertices no samples are needed */
+    igraph_vector_init(&res, 0);
+    igraph_small(&g, 4, IGRAPH_UNDIRECTED, 0, 1, 2, 3, -1);
+    igraph_betweenness_approx(&g, &res, igraph_vss_all(), 1, 0, 0.1, 0.1, &samples);
+    printf("matching: %ld samples, %g %g %g %g\n", (long int) samples,
+           VECTOR(res)[0], VECTOR(res)[1], VECTOR(res)[2], VECTOR(res)[3]);
+    igraph_destroy(&g);
+    igraph_vector_destroy(&res);
+
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_ring(&g, 5, IGRAPH_UNDIRECTED, 0, 1);
+    if (igraph_betweenness_approx(&g, 0, igraph_vss_all(), 1, 0, 0, 0.1, 0) != IGRAPH_EINVAL) {
+        ok = 0;
+    }
+    if (igraph_betweenness_approx(&g, 0, igraph_vss_all(), 1, 0, 0.1, 1, 0) != IGRAPH_EINVAL) {
+        ok = 0;
+    }
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
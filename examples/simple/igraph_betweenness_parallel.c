@@ -0,0 +1,123 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the scores computed on one thread and on several threads */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2) {
+    long int i, n = igraph_vector_size(v1);
+    if (igraph_vector_size(v2) != n) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t a = VECTOR(*v1)[i], b = VECTOR(*v2)[i];
+        if (fabs(a - b) > 1e-9 * (fabs(a) + 1)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check(const igraph_t *g, const igraph_vector_t *weights, igraph_real_t cutoff,
+          igraph_bool_t nobigint, const char *name) {
+    igraph_vector_t v1, v2, e1, e2;
+    int ok;
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+    igraph_vector_init(&e1, 0);
+    igraph_vector_init(&e2, 0);
+
+    igraph_set_num_threads(1);
+    igraph_betweenness_estimate(g, &v1, igraph_vss_all(), /* directed= */ 1,
+                                cutoff, weights, nobigint);
+    igraph_edge_betweenness_estimate(g, &e1, /* directed= */ 1, cutoff, weights);
+
+    igraph_set_num_threads(4);
+    igraph_betweenness_estimate(g, &v2, igraph_vss_all(), /* directed= */ 1,
+                                cutoff, weights, nobigint);
+    igraph_edge_betweenness_estimate(g, &e2, /* directed= */ 1, cutoff, weights);
+
+    ok = same(&v1, &v2) && same(&e1, &e2);
+    printf("%s: %s\n", name, ok ? "same" : "different");
+
+    igraph_vector_destroy(&e2);
+    igraph_vector_destroy(&e1);
+    igraph_vector_destroy(&v2);
+    igraph_vector_destroy(&v1);
+
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_vector_t res;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Undirected graph, with multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 1200,
+                            IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 5);
+    }
+    ok = check(&g, 0, -1, 1, "undirected, unweighted") && ok;
+    ok = check(&g, 0, -1, 0, "undirected, unweighted, big integers") && ok;
+    ok = check(&g, 0, 3, 1, "undirected, unweighted, cutoff") && ok;
+    ok = check(&g, &weights, -1, 1, "undirected, weighted") && ok;
+    ok = check(&g, &weights, 4, 1, "undirected, weighted, cutoff") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Directed graph */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 1500,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 2);
+    }
+    ok = check(&g, 0, -1, 1, "directed, unweighted") && ok;
+    ok = check(&g, &weights, -1, 1, "directed, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* More threads than blocks of sources */
+    igraph_set_num_threads(64);
+    igraph_ring(&g, 10, IGRAPH_UNDIRECTED, /* mutual= */ 0, /* circular= */ 0);
+    igraph_vector_init(&res, 0);
+    igraph_betweenness(&g, &res, igraph_vss_all(), IGRAPH_UNDIRECTED,
+                       /* weights= */ 0, /* nobigint= */ 1);
+    for (i = 0; i < igraph_vector_size(&res); i++) {
+        printf(" %g", VECTOR(res)[i]);
+    }
+    printf("\n");
+    igraph_vector_destroy(&res);
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
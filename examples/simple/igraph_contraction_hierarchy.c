@@ -0,0 +1,189 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Length of a path given by its edges, or -1 if the edges do not
+   form a path from 'from' to 'to' in the graph */
+
+igraph_real_t path_length(const igraph_t *g, const igraph_vector_t *vertices,
+                          const igraph_vector_t *edges,
+                          const igraph_vector_t *weights,
+                          igraph_integer_t from, igraph_integer_t to,
+                          igraph_bool_t directed) {
+    long int i, n = igraph_vector_size(edges);
+    igraph_real_t len = 0;
+
+    if (igraph_vector_size(vertices) != n + 1 ||
+        VECTOR(*vertices)[0] != from || VECTOR(*vertices)[n] != to) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_integer_t e = (igraph_integer_t) VECTOR(*edges)[i];
+        igraph_integer_t v = (igraph_integer_t) VECTOR(*vertices)[i];
+        igraph_integer_t u = (igraph_integer_t) VECTOR(*vertices)[i + 1];
+        if (!(IGRAPH_FROM(g, e) == v && IGRAPH_TO(g, e) == u) &&
+            !((!directed || !igraph_is_directed(g)) &&
+              IGRAPH_FROM(g, e) == u && IGRAPH_TO(g, e) == v)) {
+            return -1;
+        }
+        len += VECTOR(*weights)[e];
+    }
+    return len;
+}
+
+/* Compares all queries of the hierarchy with Dijkstra's algorithm */
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_bool_t directed, const char *name) {
+    igraph_contraction_hierarchy_t ch, ch2;
+    igraph_matrix_t dist, table;
+    igraph_vector_t vertices, edges, all;
+    long int i, j, n = igraph_vcount(g);
+    int bad = 0;
+    FILE *file;
+
+    igraph_contraction_hierarchy_init(&ch, g, weights, directed);
+
+    /* Save and load it again */
+    file = tmpfile();
+    igraph_contraction_hierarchy_write(&ch, file);
+    rewind(file);
+    igraph_contraction_hierarchy_read(&ch2, file);
+    fclose(file);
+
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &dist, igraph_vss_all(), igraph_vss_all(),
+                                   weights, directed ? IGRAPH_OUT : IGRAPH_ALL);
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    igraph_vector_init_seq(&all, 0, n - 1);
+    igraph_matrix_init(&table, 0, 0);
+    igraph_contraction_hierarchy_distance_matrix(&ch2, &table, &all, &all);
+
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            igraph_real_t d, len;
+            igraph_contraction_hierarchy_distance(&ch, &d, i, j);
+            bad += d != MATRIX(dist, i, j);
+            bad += MATRIX(table, i, j) != MATRIX(dist, i, j);
+
+            igraph_contraction_hierarchy_get_shortest_path(&ch2, &vertices, &edges,
+                    &d, i, j);
+            if (d == IGRAPH_INFINITY) {
+                bad += igraph_vector_size(&vertices) != 0 ||
+                       MATRIX(dist, i, j) != IGRAPH_INFINITY;
+            } else {
+                len = path_length(g, &vertices, &edges, weights, i, j, directed);
+                bad += fabs(len - MATRIX(dist, i, j)) > 1e-9;
+            }
+        }
+    }
+    igraph_set_warning_handler(igraph_warning_handler_print);
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_matrix_destroy(&table);
+    igraph_vector_destroy(&all);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_matrix_destroy(&dist);
+    igraph_contraction_hierarchy_destroy(&ch2);
+    igraph_contraction_hierarchy_destroy(&ch);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, dim, from, to;
+    igraph_matrix_t table;
+    igraph_contraction_hierarchy_t ch;
+    long int i;
+    int bad = 0;
+    FILE *file;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* The distance tables are computed on several threads */
+    igraph_set_num_threads(4);
+
+    /* Random graph with multi-edges, loops and zero weights */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 80, 200, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 10);
+    }
+    bad += check(&g, &weights, 1, "directed");
+    bad += check(&g, &weights, 0, "directed graph, undirected hierarchy");
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 80, 160, IGRAPH_UNDIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0.5, 2);
+    }
+    bad += check(&g, &weights, 1, "undirected");
+    igraph_destroy(&g);
+
+    /* Grid, a road-like graph */
+    igraph_vector_init_int(&dim, 2, 12, 12);
+    igraph_lattice(&g, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 3);
+    }
+    bad += check(&g, &weights, 1, "grid");
+    igraph_destroy(&g);
+
+    /* Unit weights, and a path with a vertex that cannot be reached */
+    igraph_small(&g, 5, IGRAPH_DIRECTED, 0, 1, 1, 2, 2, 3, 3, 0, -1);
+    igraph_contraction_hierarchy_init(&ch, &g, 0, 1);
+    igraph_vector_init_int(&from, 3, 0, 2, 4);
+    igraph_vector_init_int(&to, 2, 3, 1);
+    igraph_matrix_init(&table, 0, 0);
+    igraph_contraction_hierarchy_distance_matrix(&ch, &table, &from, &to);
+    igraph_matrix_print(&table);
+    igraph_contraction_hierarchy_destroy(&ch);
+
+    /* Not a contraction hierarchy file */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    file = tmpfile();
+    igraph_write_graph_edgelist(&g, file);
+    rewind(file);
+    if (igraph_contraction_hierarchy_read(&ch, file) != IGRAPH_PARSEERROR) {
+        bad++;
+    }
+    fclose(file);
+
+    igraph_matrix_destroy(&table);
+    igraph_vector_destroy(&to);
+    igraph_vector_destroy(&from);
+    igraph_vector_destroy(&dim);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Compares the bounding algorithm to the eccentricities computed from
+   the full distance matrix */
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_bool_t directed, const char *name) {
+    igraph_matrix_t dist;
+    igraph_real_t diameter, radius, exp_diameter = 0, exp_radius = IGRAPH_INFINITY;
+    igraph_real_t dia2, rad2;
+    igraph_integer_t searches, idia;
+    igraph_bool_t connected = 1;
+    long int i, j, n = igraph_vcount(g);
+    igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
+    int ok = 1;
+
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &dist, igraph_vss_all(), igraph_vss_all(),
+                                   weights, mode);
+    for (i = 0; i < n; i++) {
+        igraph_real_t ecc = 0;
+        for (j = 0; j < n; j++) {
+            if (!igraph_finite(MATRIX(dist, i, j))) {
+                connected = 0;
+            } else if (MATRIX(dist, i, j) > ecc) {
+                ecc = MATRIX(dist, i, j);
+            }
+        }
+        exp_diameter = ecc > exp_diameter ? ecc : exp_diameter;
+        exp_radius = ecc < exp_radius ? ecc : exp_radius;
+    }
+    igraph_matrix_destroy(&dist);
+
+    igraph_diameter_radius(g, weights, &diameter, &radius, directed,
+                           /* unconn= */ 1, &searches);
+    if (diameter != exp_diameter || radius != exp_radius) {
+        ok = 0;
+    }
+
+    /* Only the diameter, only the radius */
+    igraph_diameter_radius(g, weights, &dia2, 0, directed, 1, 0);
+    igraph_diameter_radius(g, weights, 0, &rad2, directed, 1, 0);
+    if (dia2 != exp_diameter || rad2 != exp_radius) {
+        ok = 0;
+    }
+
+    igraph_diameter_radius(g, weights, &dia2, 0, directed, /* unconn= */ 0, 0);
+    if (dia2 != (connected ? exp_diameter : IGRAPH_INFINITY)) {
+        ok = 0;
+    }
+
+    if (weights) {
+        igraph_diameter_dijkstra(g, weights, &dia2, 0, 0, 0, directed, 1);
+        if (dia2 != exp_diameter) {
+            ok = 0;
+        }
+    } else {
+        igraph_diameter(g, &idia, 0, 0, 0, directed, 1);
+        if (idia != exp_diameter) {
+            ok = 0;
+        }
+        igraph_diameter(g, &idia, 0, 0, 0, directed, 0);
+        if (idia != (connected ? exp_diameter : n)) {
+            ok = 0;
+        }
+        igraph_radius(g, &rad2, mode);
+        if (rad2 != exp_radius) {
+            ok = 0;
+        }
+    }
+
+    printf("%s: diameter %g, radius %g, %ld searches for %ld vertices, %s\n",
+           name, diameter, radius, (long int) searches, n, ok ? "ok" : "wrong");
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_real_t diameter, radius;
+    igraph_integer_t searches;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_tree(&g, 1023, 3, IGRAPH_TREE_UNDIRECTED);
+    ok = check(&g, 0, 1, "tree") && ok;
+    igraph_destroy(&g);
+
+    igraph_ring(&g, 51, IGRAPH_UNDIRECTED, /* mutual= */ 0, /* circular= */ 1);
+    ok = check(&g, 0, 1, "ring") && ok;
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 500, 1000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 0, 1, "undirected random") && ok;
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(1, 5);
+    }
+    ok = check(&g, &weights, 1, "undirected random, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 2000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 0, 1, "strongly connected") && ok;
+    ok = check(&g, 0, 0, "strongly connected, undirected paths") && ok;
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 3);
+    }
+    ok = check(&g, &weights, 1, "strongly connected, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 400,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 0, 1, "directed, not strongly connected") && ok;
+    igraph_destroy(&g);
+
+    igraph_small(&g, 6, IGRAPH_UNDIRECTED, 0, 1, 1, 2, 3, 4, -1);
+    ok = check(&g, 0, 1, "components and isolated vertex") && ok;
+    igraph_destroy(&g);
+
+    /* Null graph */
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_diameter_radius(&g, 0, &diameter, &radius, 1, 1, &searches);
+    printf("null graph: %g %g %ld\n", diameter, radius, (long int) searches);
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Checks that a path is a walk from 'from' to 'to' along the given
+   edges and returns its length, or -1 if it is not */
+
+igraph_real_t path_length(const igraph_t *g, const igraph_vector_t *vertices,
+                          const igraph_vector_t *edges,
+                          const igraph_vector_t *weights,
+                          igraph_integer_t from, igraph_integer_t to,
+                          igraph_neimode_t mode) {
+    long int i, n = igraph_vector_size(edges);
+    igraph_real_t len = 0;
+
+    if (igraph_vector_size(vertices) != n + 1 ||
+        VECTOR(*vertices)[0] != from || VECTOR(*vertices)[n] != to) {
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_integer_t e = (igraph_integer_t) VECTOR(*edges)[i];
+        igraph_integer_t v = (igraph_integer_t) VECTOR(*vertices)[i];
+        igraph_integer_t u = (igraph_integer_t) VECTOR(*vertices)[i + 1];
+        igraph_bool_t ok = 0;
+        if (!igraph_is_directed(g) || mode == IGRAPH_ALL) {
+            ok = (IGRAPH_FROM(g, e) == v && IGRAPH_TO(g, e) == u) ||
+                 (IGRAPH_FROM(g, e) == u && IGRAPH_TO(g, e) == v);
+        } else if (mode == IGRAPH_OUT) {
+            ok = IGRAPH_FROM(g, e) == v && IGRAPH_TO(g, e) == u;
+        } else {
+            ok = IGRAPH_FROM(g, e) == u && IGRAPH_TO(g, e) == v;
+        }
+        if (!ok) {
+            return -1;
+        }
+        len += VECTOR(*weights)[e];
+    }
+    return len;
+}
+
+/* Zero heuristic, A* is Dijkstra's algorithm with it */
+
+int zero(igraph_real_t *result, igraph_integer_t from, igraph_integer_t to,
+         void *extra) {
+    IGRAPH_UNUSED(from);
+    IGRAPH_UNUSED(to);
+    IGRAPH_UNUSED(extra);
+    *result = 0;
+    return 0;
+}
+
+/* Compares the point-to-point paths with the distances from Dijkstra's
+   algorithm on all pairs of a random graph */
+
+int check_random(igraph_bool_t directed, igraph_neimode_t mode, const char *name) {
+    igraph_t g;
+    igraph_vector_t weights, vertices, edges;
+    igraph_matrix_t dist;
+    long int i, from, to, n = 60;
+    int bad = 0;
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, n, 150, directed,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 10);
+    }
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_all(), igraph_vss_all(),
+                                   &weights, mode);
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    for (from = 0; from < n; from++) {
+        for (to = 0; to < n; to++) {
+            igraph_real_t d = MATRIX(dist, from, to), len;
+
+            igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, from, to,
+                                              &weights, mode);
+            len = d == IGRAPH_INFINITY ?
+                  (igraph_vector_size(&vertices) == 0 ? d : -1) :
+                  path_length(&g, &vertices, &edges, &weights, from, to, mode);
+            bad += len != d;
+
+            igraph_get_shortest_path_astar(&g, &vertices, &edges, from, to,
+                                           &weights, mode, zero, 0);
+            len = d == IGRAPH_INFINITY ?
+                  (igraph_vector_size(&vertices) == 0 ? d : -1) :
+                  path_length(&g, &vertices, &edges, &weights, from, to, mode);
+            bad += len != d;
+        }
+    }
+    igraph_set_warning_handler(igraph_warning_handler_print);
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_matrix_destroy(&dist);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, vertices, edges, dim;
+    igraph_matrix_t coords;
+    long int i, j, side = 20;
+    int bad = 0;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    bad += check_random(IGRAPH_UNDIRECTED, IGRAPH_ALL, "undirected");
+    bad += check_random(IGRAPH_DIRECTED, IGRAPH_OUT, "directed, out");
+    bad += check_random(IGRAPH_DIRECTED, IGRAPH_IN, "directed, in");
+    bad += check_random(IGRAPH_DIRECTED, IGRAPH_ALL, "directed, all");
+
+    /* A* on a grid with random edge lengths, at least as long as the
+       distance of the endpoints */
+    igraph_vector_init_int(&dim, 2, side, side);
+    igraph_lattice(&g, &dim, 1, IGRAPH_UNDIRECTED, 0, 0);
+    igraph_matrix_init(&coords, side * side, 2);
+    for (i = 0; i < side; i++) {
+        for (j = 0; j < side; j++) {
+            MATRIX(coords, i * side + j, 0) = j;
+            MATRIX(coords, i * side + j, 1) = i;
+        }
+    }
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 3);
+    }
+    igraph_vector_init(&vertices, 0);
+    igraph_vector_init(&edges, 0);
+    for (i = 0; i < 20; i++) {
+        igraph_integer_t from = RNG_INTEGER(0, side * side - 1);
+        igraph_integer_t to = RNG_INTEGER(0, side * side - 1);
+        igraph_real_t d, len;
+        igraph_matrix_t dist;
+
+        igraph_matrix_init(&dist, 0, 0);
+        igraph_shortest_paths_dijkstra(&g, &dist, igraph_vss_1(from),
+                                       igraph_vss_1(to), &weights, IGRAPH_ALL);
+        d = MATRIX(dist, 0, 0);
+        igraph_matrix_destroy(&dist);
+
+        igraph_get_shortest_path_astar(&g, &vertices, &edges, from, to, &weights,
+                                       IGRAPH_ALL, igraph_astar_heuristic_euclidean,
+                                       &coords);
+        len = path_length(&g, &vertices, &edges, &weights, from, to, IGRAPH_ALL);
+        bad += fabs(len - d) > 1e-9;
+    }
+    printf("grid: %s\n", bad ? "wrong" : "ok");
+
+    /* Same source and target */
+    igraph_get_shortest_path_astar(&g, &vertices, &edges, 5, 5, &weights,
+                                   IGRAPH_ALL, igraph_astar_heuristic_euclidean,
+                                   &coords);
+    igraph_vector_print(&vertices);
+    igraph_vector_print(&edges);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 5, 5, &weights,
+                                      IGRAPH_ALL);
+    igraph_vector_print(&vertices);
+    igraph_vector_print(&edges);
+
+    /* A path in a ring */
+    igraph_destroy(&g);
+    igraph_ring(&g, 6, IGRAPH_DIRECTED, 0, 1);
+    igraph_vector_resize(&weights, 6);
+    igraph_vector_fill(&weights, 1);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 1, 4, &weights,
+                                      IGRAPH_OUT);
+    igraph_vector_print(&vertices);
+    igraph_vector_print(&edges);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 1, 4, &weights,
+                                      IGRAPH_IN);
+    igraph_vector_print(&vertices);
+    igraph_vector_print(&edges);
+
+    /* Unreachable target, this gives a warning */
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_destroy(&g);
+    igraph_small(&g, 4, IGRAPH_DIRECTED, 0, 1, 2, 3, -1);
+    igraph_vector_resize(&weights, 2);
+    igraph_vector_fill(&weights, 1);
+    igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 0, 3, &weights,
+                                      IGRAPH_OUT);
+    printf("unreachable: %ld %ld\n", igraph_vector_size(&vertices),
+           igraph_vector_size(&edges));
+
+    /* Negative weight */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    VECTOR(weights)[0] = -1;
+    if (igraph_get_shortest_path_dijkstra(&g, &vertices, &edges, 0, 1, &weights,
+                                          IGRAPH_OUT) != IGRAPH_EINVAL) {
+        bad++;
+    }
+
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&vertices);
+    igraph_vector_destroy(&weights);
+    igraph_matrix_destroy(&coords);
+    igraph_vector_destroy(&dim);
+    igraph_destroy(&g);
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,128 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Compares all distances from the labels with a breadth-first search */
+
+int check(const igraph_t *g, igraph_bool_t directed, const char *name) {
+    igraph_landmark_labeling_t ll, ll2;
+    igraph_matrix_t dist;
+    long int i, j, n = igraph_vcount(g);
+    int bad = 0;
+    FILE *file;
+
+    igraph_landmark_labeling_init(&ll, g, directed);
+
+    /* Save and load it again */
+    file = tmpfile();
+    igraph_landmark_labeling_write(&ll, file);
+    rewind(file);
+    igraph_landmark_labeling_read(&ll2, file);
+    fclose(file);
+
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_shortest_paths(g, &dist, igraph_vss_all(), igraph_vss_all(),
+                          directed ? IGRAPH_OUT : IGRAPH_ALL);
+
+    for (i = 0; i < n; i++) {
+        for (j = 0; j < n; j++) {
+            igraph_real_t d;
+            igraph_landmark_labeling_distance(&ll, &d, i, j);
+            bad += d != MATRIX(dist, i, j);
+            igraph_landmark_labeling_distance(&ll2, &d, i, j);
+            bad += d != MATRIX(dist, i, j);
+        }
+    }
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_matrix_destroy(&dist);
+    igraph_landmark_labeling_destroy(&ll2);
+    igraph_landmark_labeling_destroy(&ll);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_landmark_labeling_t ll;
+    igraph_real_t d, entries, bytes;
+    int bad = 0;
+    FILE *file;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Random graphs with multi-edges and loops, not connected */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 150, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    bad += check(&g, 1, "directed");
+    bad += check(&g, 0, "directed graph, undirected labeling");
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 100, 90, IGRAPH_UNDIRECTED,
+                            IGRAPH_LOOPS);
+    bad += check(&g, 1, "undirected");
+    igraph_destroy(&g);
+
+    /* Scale-free graph, where the labels are short */
+    igraph_barabasi_game(&g, 200, 1, 2, 0, 0, 1, IGRAPH_UNDIRECTED,
+                         IGRAPH_BARABASI_PSUMTREE, 0);
+    bad += check(&g, 0, "scale-free");
+    igraph_destroy(&g);
+
+    /* Star: the center is the only hub needed */
+    igraph_star(&g, 6, IGRAPH_STAR_UNDIRECTED, 0);
+    igraph_landmark_labeling_init(&ll, &g, 0);
+    igraph_landmark_labeling_size(&ll, &entries, &bytes);
+    igraph_landmark_labeling_distance(&ll, &d, 1, 2);
+    printf("star: %g entries, distance %g\n", entries, d);
+    igraph_landmark_labeling_destroy(&ll);
+    igraph_destroy(&g);
+
+    /* A path with a vertex that cannot be reached */
+    igraph_small(&g, 4, IGRAPH_DIRECTED, 0, 1, 1, 2, -1);
+    igraph_landmark_labeling_init(&ll, &g, 1);
+    igraph_landmark_labeling_distance(&ll, &d, 0, 2);
+    printf("%g", d);
+    igraph_landmark_labeling_distance(&ll, &d, 2, 0);
+    printf(" %g", d);
+    igraph_landmark_labeling_distance(&ll, &d, 0, 3);
+    printf(" %g\n", d);
+
+    /* Invalid vertex, not a labeling file */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    if (igraph_landmark_labeling_distance(&ll, &d, 0, 4) != IGRAPH_EINVVID) {
+        bad++;
+    }
+    igraph_landmark_labeling_destroy(&ll);
+    file = tmpfile();
+    igraph_write_graph_edgelist(&g, file);
+    rewind(file);
+    if (igraph_landmark_labeling_read(&ll, file) != IGRAPH_PARSEERROR) {
+        bad++;
+    }
+    fclose(file);
+
+    igraph_destroy(&g);
+
+    return bad ? 1 : 0;
+}
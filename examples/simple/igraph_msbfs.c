@@ -0,0 +1,138 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* The all-sources distance functions search from 64 vertices at once.
+   This compares them with values computed from the distance matrix. */
+
+int check(const igraph_t *g, igraph_neimode_t mode, igraph_real_t cutoff,
+          const char *name) {
+    igraph_matrix_t dist;
+    igraph_vector_t clo, ecc, hist, exp_hist;
+    igraph_real_t apl, exp_apl = 0, npairs = 0, unconn, exp_unconn = 0;
+    long int i, j, n = igraph_vcount(g);
+    igraph_bool_t directed = mode != IGRAPH_ALL;
+    int ok_clo = 1, ok_ecc = 1, ok_apl, ok_hist;
+
+    igraph_matrix_init(&dist, 0, 0);
+    igraph_vector_init(&clo, 0);
+    igraph_vector_init(&ecc, 0);
+    igraph_vector_init(&hist, 0);
+    igraph_vector_init(&exp_hist, 0);
+
+    igraph_shortest_paths(g, &dist, igraph_vss_all(), igraph_vss_all(), mode);
+    igraph_closeness_estimate(g, &clo, igraph_vss_all(), mode, cutoff, 0, 1);
+    igraph_eccentricity(g, &ecc, igraph_vss_all(), mode);
+    igraph_average_path_length(g, &apl, directed, /* unconn= */ 0);
+    igraph_path_length_hist(g, &hist, &unconn, directed);
+
+    for (i = 0; i < n; i++) {
+        igraph_real_t sum = 0, maxd = 0;
+        for (j = 0; j < n; j++) {
+            igraph_real_t d = MATRIX(dist, i, j);
+            if (d == IGRAPH_INFINITY) {
+                exp_apl += n;
+                npairs++;
+                exp_unconn++;
+            } else {
+                if (d > maxd) {
+                    maxd = d;
+                }
+                if (j != i) {
+                    exp_apl += d;
+                    npairs++;
+                    if (igraph_vector_size(&exp_hist) < d) {
+                        igraph_vector_resize(&exp_hist, (long int) d);
+                        VECTOR(exp_hist)[(long int) d - 1] = 0;
+                    }
+                    VECTOR(exp_hist)[(long int) d - 1] += 1;
+                }
+            }
+            sum += (d == IGRAPH_INFINITY || (cutoff > 0 && d >= cutoff + 1)) ? n : d;
+        }
+        if (fabs(VECTOR(clo)[i] - (n - 1) / sum) > 1e-12) {
+            ok_clo = 0;
+        }
+        if (VECTOR(ecc)[i] != maxd) {
+            ok_ecc = 0;
+        }
+    }
+    if (!directed) {
+        igraph_vector_scale(&exp_hist, 0.5);
+        exp_unconn /= 2;
+    }
+    ok_apl = fabs(apl - exp_apl / npairs) < 1e-12;
+    ok_hist = igraph_vector_all_e(&hist, &exp_hist) && unconn == exp_unconn;
+
+    printf("%s: closeness %d, eccentricity %d, average path length %d, "
+           "histogram %d\n", name, ok_clo, ok_ecc, ok_apl, ok_hist);
+
+    igraph_vector_destroy(&exp_hist);
+    igraph_vector_destroy(&hist);
+    igraph_vector_destroy(&ecc);
+    igraph_vector_destroy(&clo);
+    igraph_matrix_destroy(&dist);
+
+    return ok_clo && ok_ecc && ok_apl && ok_hist;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t res, vids;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 3000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_set_num_threads(1);
+    ok = check(&g, IGRAPH_OUT, -1, "directed, out") && ok;
+    ok = check(&g, IGRAPH_IN, 3, "directed, in, cutoff") && ok;
+    igraph_set_num_threads(4);
+    ok = check(&g, IGRAPH_OUT, -1, "directed, out, 4 threads") && ok;
+    ok = check(&g, IGRAPH_ALL, -1, "directed, all, 4 threads") && ok;
+    igraph_destroy(&g);
+
+    /* Disconnected, with long paths */
+    igraph_ring(&g, 300, IGRAPH_UNDIRECTED, /* mutual= */ 0, /* circular= */ 1);
+    igraph_add_vertices(&g, 5, 0);
+    ok = check(&g, IGRAPH_ALL, -1, "ring") && ok;
+    ok = check(&g, IGRAPH_ALL, 2.5, "ring, cutoff") && ok;
+    igraph_destroy(&g);
+
+    /* Duplicate vertices */
+    igraph_star(&g, 5, IGRAPH_STAR_UNDIRECTED, 0);
+    igraph_vector_init_int(&vids, 4, 0, 1, 0, 4);
+    igraph_vector_init(&res, 0);
+    igraph_closeness(&g, &res, igraph_vss_vector(&vids), IGRAPH_ALL, 0, 1);
+    igraph_vector_print(&res);
+    igraph_eccentricity(&g, &res, igraph_vss_vector(&vids), IGRAPH_ALL);
+    igraph_vector_print(&res);
+    igraph_vector_destroy(&res);
+    igraph_vector_destroy(&vids);
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the estimates to the exact path length statistics */
+
+int check(const igraph_t *g, igraph_bool_t directed, const char *name) {
+    igraph_vector_t nf, hist, nf2, exact;
+    igraph_real_t apl, ed, apl2, ed2, exact_apl, unconn, pairs = 0, est = 0;
+    long int i;
+    int ok = 1;
+
+    igraph_vector_init(&nf, 0);
+    igraph_vector_init(&nf2, 0);
+    igraph_vector_init(&hist, 0);
+    igraph_vector_init(&exact, 0);
+
+    igraph_set_num_threads(1);
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_neighborhood_function_approx(g, &nf, &hist, &apl, &ed, directed, 10);
+
+    /* The estimate does not depend on the number of threads */
+    igraph_set_num_threads(4);
+    igraph_rng_seed(igraph_rng_default(), 7);
+    igraph_neighborhood_function_approx(g, &nf2, 0, &apl2, &ed2, directed, 10);
+    igraph_set_num_threads(1);
+    if (!igraph_vector_all_e(&nf, &nf2) || apl != apl2 || ed != ed2) {
+        printf("%s: threads differ\n", name);
+        ok = 0;
+    }
+
+    igraph_path_length_hist(g, &exact, &unconn, directed);
+    igraph_average_path_length(g, &exact_apl, directed, /* unconn= */ 1);
+
+    for (i = 0; i < igraph_vector_size(&exact); i++) {
+        pairs += VECTOR(exact)[i];
+    }
+    for (i = 0; i < igraph_vector_size(&hist); i++) {
+        est += VECTOR(hist)[i];
+    }
+    if (fabs(igraph_vector_size(&hist) - igraph_vector_size(&exact)) > 1) {
+        printf("%s: diameter %ld instead of %ld\n", name,
+               igraph_vector_size(&hist), igraph_vector_size(&exact));
+        ok = 0;
+    }
+    if (fabs(VECTOR(nf)[0] - igraph_vcount(g)) > 0.05 * igraph_vcount(g)) {
+        printf("%s: N(0) is %g\n", name, VECTOR(nf)[0]);
+        ok = 0;
+    }
+    if (fabs(est - pairs) > 0.1 * pairs) {
+        printf("%s: %g connected pairs instead of %g\n", name, est, pairs);
+        ok = 0;
+    }
+    if (fabs(apl - exact_apl) > 0.1 * exact_apl) {
+        printf("%s: average path length %g instead of %g\n", name, apl, exact_apl);
+        ok = 0;
+    }
+    printf("%s: %s\n", name, ok ? "ok" : "wrong");
+
+    igraph_vector_destroy(&exact);
+    igraph_vector_destroy(&hist);
+    igraph_vector_destroy(&nf2);
+    igraph_vector_destroy(&nf);
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t nf;
+    igraph_real_t apl, ed;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_ring(&g, 200, IGRAPH_UNDIRECTED, /* mutual= */ 0, /* circular= */ 1);
+    ok = check(&g, 1, "ring") && ok;
+    igraph_destroy(&g);
+
+    igraph_tree(&g, 1023, 2, IGRAPH_TREE_UNDIRECTED);
+    ok = check(&g, 1, "tree") && ok;
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 1500,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 1, "undirected random") && ok;
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 2000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    ok = check(&g, 1, "directed random") && ok;
+    ok = check(&g, 0, "directed random, undirected paths") && ok;
+    igraph_destroy(&g);
+
+    /* Graphs without paths */
+    igraph_vector_init(&nf, 0);
+    igraph_empty(&g, 3, IGRAPH_UNDIRECTED);
+    igraph_neighborhood_function_approx(&g, &nf, 0, &apl, &ed, 1, 6);
+    printf("isolated: %ld %g %g %g\n", igraph_vector_size(&nf),
+           VECTOR(nf)[0], apl, ed);
+    igraph_destroy(&g);
+
+    igraph_empty(&g, 0, IGRAPH_UNDIRECTED);
+    igraph_neighborhood_function_approx(&g, &nf, 0, &apl, &ed, 1, 6);
+    printf("null graph: %ld %g %g\n", igraph_vector_size(&nf), apl, ed);
+    igraph_destroy(&g);
+    igraph_vector_destroy(&nf);
+
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_small(&g, 2, IGRAPH_UNDIRECTED, 0, 1, -1);
+    if (igraph_neighborhood_function_approx(&g, 0, 0, 0, 0, 1, 3) != IGRAPH_EINVAL) {
+        ok = 0;
+    }
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the parallel power iteration to ARPACK, and the results
+   on one thread and on several threads */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2, igraph_real_t tol) {
+    long int i, n = igraph_vector_size(v1);
+    if (igraph_vector_size(v2) != n) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        if (fabs(VECTOR(*v1)[i] - VECTOR(*v2)[i]) > tol) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int check(const igraph_t *g, igraph_bool_t directed, igraph_vector_t *reset,
+          const igraph_vector_t *weights, const char *name) {
+    igraph_vector_t arpack, par1, par4;
+    igraph_arpack_options_t arpack_options;
+    igraph_pagerank_power_options_t options = { 1000, 1e-12 };
+    int ok;
+
+    igraph_vector_init(&arpack, 0);
+    igraph_vector_init(&par1, 0);
+    igraph_vector_init(&par4, 0);
+    igraph_arpack_options_init(&arpack_options);
+
+    igraph_personalized_pagerank(g, IGRAPH_PAGERANK_ALGO_ARPACK, &arpack, 0,
+                                 igraph_vss_all(), directed, 0.85, reset,
+                                 weights, &arpack_options);
+
+    igraph_set_num_threads(1);
+    igraph_personalized_pagerank(g, IGRAPH_PAGERANK_ALGO_PARALLEL, &par1, 0,
+                                 igraph_vss_all(), directed, 0.85, reset,
+                                 weights, &options);
+    igraph_set_num_threads(4);
+    igraph_personalized_pagerank(g, IGRAPH_PAGERANK_ALGO_PARALLEL, &par4, 0,
+                                 igraph_vss_all(), directed, 0.85, reset,
+                                 weights, &options);
+
+    ok = same(&arpack, &par1, 1e-8) && same(&par1, &par4, 0);
+    printf("%s: %s\n", name, ok ? "ok" : "different");
+
+    igraph_vector_destroy(&par4);
+    igraph_vector_destroy(&par1);
+    igraph_vector_destroy(&arpack);
+
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, reset, res;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Directed graph, with vertices without outgoing edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 3000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0, 2);
+    }
+    igraph_vector_init(&reset, igraph_vcount(&g));
+    for (i = 0; i < 10; i++) {
+        VECTOR(reset)[RNG_INTEGER(0, igraph_vcount(&g) - 1)] += 1;
+    }
+    ok = check(&g, 1, 0, 0, "directed") && ok;
+    ok = check(&g, 1, 0, &weights, "directed, weighted") && ok;
+    ok = check(&g, 1, &reset, &weights, "directed, personalized") && ok;
+    ok = check(&g, 0, 0, &weights, "as undirected") && ok;
+    igraph_vector_destroy(&reset);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Undirected graph with multi-edges */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 500, 2000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_add_edge(&g, 0, 1);
+    igraph_add_edge(&g, 0, 1);
+    igraph_vector_init(&reset, igraph_vcount(&g));
+    VECTOR(reset)[7] = 1;
+    ok = check(&g, 0, 0, 0, "undirected") && ok;
+    ok = check(&g, 0, &reset, 0, "undirected, personalized") && ok;
+    igraph_vector_destroy(&reset);
+    igraph_destroy(&g);
+
+    /* Default options, and a subset of the vertices */
+    igraph_star(&g, 5, IGRAPH_STAR_IN, 0);
+    igraph_vector_init(&res, 0);
+    igraph_pagerank(&g, IGRAPH_PAGERANK_ALGO_PARALLEL, &res, 0,
+                    igraph_vss_seq(0, 1), IGRAPH_DIRECTED, 0.85, 0, 0);
+    printf("star: %.6f %.6f\n", VECTOR(res)[0], VECTOR(res)[1]);
+    igraph_vector_destroy(&res);
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Solves a batch of personalized PageRank problems with a single
+   solver, and compares the results with igraph_personalized_pagerank() */
+
+int check(const igraph_t *g, igraph_bool_t directed,
+          const igraph_vector_t *weights, const char *name) {
+    igraph_pagerank_solver_t solver;
+    igraph_matrix_t reset, res1, res4;
+    igraph_vector_t reset_col, exact;
+    long int i, j, n = igraph_vcount(g), k = 21;
+    igraph_real_t maxdiff = 0;
+    int ok;
+
+    /* Single seeds, pairs of seeds and a random vector */
+    igraph_matrix_init(&reset, n, k);
+    for (j = 0; j < k - 1; j++) {
+        MATRIX(reset, RNG_INTEGER(0, n - 1), j) += 1;
+        if (j % 2) {
+            MATRIX(reset, RNG_INTEGER(0, n - 1), j) += 2;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        MATRIX(reset, i, k - 1) = RNG_UNIF01();
+    }
+
+    igraph_matrix_init(&res1, 0, 0);
+    igraph_matrix_init(&res4, 0, 0);
+    igraph_pagerank_solver_init(&solver, g, directed, 0.85, weights);
+    igraph_set_num_threads(1);
+    igraph_pagerank_solver_solve(&solver, &res1, &reset, 0);
+    igraph_set_num_threads(4);
+    igraph_pagerank_solver_solve(&solver, &res4, &reset, 0);
+    igraph_pagerank_solver_destroy(&solver);
+
+    igraph_vector_init(&reset_col, n);
+    igraph_vector_init(&exact, 0);
+    for (j = 0; j < k; j++) {
+        igraph_matrix_get_col(&reset, &reset_col, j);
+        igraph_personalized_pagerank(g, IGRAPH_PAGERANK_ALGO_PARALLEL, &exact, 0,
+                                     igraph_vss_all(), directed, 0.85,
+                                     &reset_col, weights, 0);
+        for (i = 0; i < n; i++) {
+            igraph_real_t d = fabs(VECTOR(exact)[i] - MATRIX(res1, i, j));
+            if (d > maxdiff) {
+                maxdiff = d;
+            }
+        }
+    }
+
+    ok = maxdiff < 1e-9 && igraph_matrix_all_e(&res1, &res4);
+    printf("%s: %ld x %ld, same as single vectors: %d, same on 4 threads: %d\n",
+           name, igraph_matrix_nrow(&res1), igraph_matrix_ncol(&res1),
+           maxdiff < 1e-9, igraph_matrix_all_e(&res1, &res4));
+
+    igraph_vector_destroy(&exact);
+    igraph_vector_destroy(&reset_col);
+    igraph_matrix_destroy(&res4);
+    igraph_matrix_destroy(&res1);
+    igraph_matrix_destroy(&reset);
+
+    return ok;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Directed graph with dangling vertices */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 3000, 6000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0, 2);
+    }
+    ok = check(&g, IGRAPH_DIRECTED, 0, "directed") && ok;
+    ok = check(&g, IGRAPH_DIRECTED, &weights, "directed, weighted") && ok;
+    ok = check(&g, IGRAPH_UNDIRECTED, &weights, "as undirected, weighted") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Undirected graph with multi-edges and loops */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 8000,
+                            IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    ok = check(&g, IGRAPH_UNDIRECTED, 0, "undirected") && ok;
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
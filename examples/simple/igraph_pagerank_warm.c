@@ -0,0 +1,140 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Recomputes the scores after changing a few edges, starting from the
+   previous result. The power iteration needs fewer iterations then;
+   ARPACK saves little or nothing, depending on the graph, so only its
+   result is checked */
+
+int same(const igraph_vector_t *v1, const igraph_vector_t *v2, igraph_real_t tol) {
+    long int i, n = igraph_vector_size(v1);
+    if (igraph_vector_size(v2) != n) {
+        return 0;
+    }
+    for (i = 0; i < n; i++) {
+        if (fabs(VECTOR(*v1)[i] - VECTOR(*v2)[i]) > tol) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+void change_edges(igraph_t *g) {
+    igraph_vector_t edges;
+    long int i, n = igraph_vcount(g);
+
+    igraph_delete_edges(g, igraph_ess_seq(0, 9));
+    igraph_vector_init(&edges, 20);
+    for (i = 0; i < 20; i++) {
+        VECTOR(edges)[i] = RNG_INTEGER(0, n - 1);
+    }
+    igraph_add_edges(g, &edges, 0);
+    igraph_vector_destroy(&edges);
+}
+
+void pagerank(const igraph_t *g, igraph_t *g2, igraph_pagerank_algo_t algo,
+              void *options, const char *name, igraph_bool_t fewer) {
+    igraph_vector_t old, cold, warm;
+    igraph_integer_t cold_iter, warm_iter;
+
+    igraph_vector_init(&old, 0);
+    igraph_vector_init(&cold, 0);
+    igraph_vector_init(&warm, 0);
+
+    igraph_personalized_pagerank_warm(g, algo, &old, 0, igraph_vss_all(),
+                                      IGRAPH_DIRECTED, 0.85, 0, 0, 0, 0, options);
+
+    igraph_personalized_pagerank_warm(g2, algo, &cold, 0, igraph_vss_all(),
+                                      IGRAPH_DIRECTED, 0.85, 0, 0, 0,
+                                      &cold_iter, options);
+    igraph_personalized_pagerank_warm(g2, algo, &warm, 0, igraph_vss_all(),
+                                      IGRAPH_DIRECTED, 0.85, 0, 0, &old,
+                                      &warm_iter, options);
+
+    printf("%s: same result: %d", name, same(&cold, &warm, 1e-8));
+    if (fewer) {
+        printf(", fewer iterations: %d", warm_iter < cold_iter);
+    }
+    printf("\n");
+
+    igraph_vector_destroy(&warm);
+    igraph_vector_destroy(&cold);
+    igraph_vector_destroy(&old);
+}
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t old, cold, warm;
+    igraph_arpack_options_t arpack_options;
+    igraph_pagerank_power_options_t power_options = { 1000, 1e-10 };
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 2000, 10000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_copy(&g2, &g);
+    change_edges(&g2);
+
+    igraph_arpack_options_init(&arpack_options);
+    pagerank(&g, &g2, IGRAPH_PAGERANK_ALGO_ARPACK, &arpack_options, "ARPACK", 0);
+    pagerank(&g, &g2, IGRAPH_PAGERANK_ALGO_PARALLEL, &power_options, "parallel", 1);
+
+    /* Eigenvector centrality of the undirected graph */
+    igraph_vector_init(&old, 0);
+    igraph_vector_init(&cold, 0);
+    igraph_vector_init(&warm, 0);
+    igraph_eigenvector_centrality(&g, &old, 0, IGRAPH_UNDIRECTED, 1, 0,
+                                  &arpack_options);
+    igraph_eigenvector_centrality(&g2, &cold, 0, IGRAPH_UNDIRECTED, 1, 0,
+                                  &arpack_options);
+    igraph_eigenvector_centrality_warm(&g2, &warm, 0, IGRAPH_UNDIRECTED, 1, 0,
+                                       &old, &arpack_options);
+    printf("eigenvector: same result: %d\n", same(&cold, &warm, 1e-8));
+    igraph_vector_destroy(&warm);
+    igraph_vector_destroy(&cold);
+    igraph_vector_destroy(&old);
+
+    /* Errors */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_vector_init(&old, 10);
+    ret = igraph_personalized_pagerank_warm(&g, IGRAPH_PAGERANK_ALGO_PARALLEL,
+                                            &cold, 0, igraph_vss_all(),
+                                            IGRAPH_DIRECTED, 0.85, 0, 0, &old,
+                                            0, 0);
+    printf("short start vector: %d\n", ret == IGRAPH_EINVAL);
+    igraph_vector_resize(&old, igraph_vcount(&g));
+    ret = igraph_personalized_pagerank_warm(&g, IGRAPH_PAGERANK_ALGO_PRPACK,
+                                            &cold, 0, igraph_vss_all(),
+                                            IGRAPH_DIRECTED, 0.85, 0, 0, 0,
+                                            0, 0);
+    printf("PRPACK: %d\n", ret == IGRAPH_UNIMPLEMENTED);
+    igraph_vector_destroy(&old);
+
+    igraph_destroy(&g2);
+    igraph_destroy(&g);
+
+    return 0;
+}
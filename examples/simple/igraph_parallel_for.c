@@ -0,0 +1,259 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+#if IGRAPH_PARALLEL
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+typedef struct {
+    igraph_vector_t *v;
+    int nthreads;
+    igraph_bool_t bad_thread;
+} data_t;
+
+int square(igraph_integer_t from, igraph_integer_t to, int thread, void *arg) {
+    data_t *data = (data_t *) arg;
+    igraph_integer_t i;
+    if (thread < 0 || thread >= data->nthreads) {
+        data->bad_thread = 1;
+    }
+    for (i = from; i < to; i++) {
+        VECTOR(*data->v)[i] = (igraph_real_t) i * i;
+    }
+    return 0;
+}
+
+int sum(igraph_integer_t from, igraph_integer_t to, int thread,
+        igraph_real_t *result, void *arg) {
+    data_t *data = (data_t *) arg;
+    igraph_integer_t i;
+    IGRAPH_UNUSED(thread);
+    for (i = from; i < to; i++) {
+        *result += 1.0 / (1.0 + VECTOR(*data->v)[i]);
+    }
+    return 0;
+}
+
+/* Allocates memory on every thread and fails at index 777 */
+int fail(igraph_integer_t from, igraph_integer_t to, int thread, void *arg) {
+    igraph_vector_t tmp;
+    igraph_integer_t i;
+    IGRAPH_UNUSED(thread);
+    IGRAPH_UNUSED(arg);
+    IGRAPH_VECTOR_INIT_FINALLY(&tmp, 10);
+    for (i = from; i < to; i++) {
+        if (i == 777) {
+            IGRAPH_ERROR("Failure at index 777", IGRAPH_EINVAL);
+        }
+    }
+    igraph_vector_destroy(&tmp);
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+int warn(igraph_integer_t from, igraph_integer_t to, int thread, void *arg) {
+    IGRAPH_UNUSED(to);
+    IGRAPH_UNUSED(thread);
+    IGRAPH_UNUSED(arg);
+    if (from == 0) {
+        IGRAPH_WARNING("Warning from the first chunk");
+    }
+    return 0;
+}
+
+int spin(igraph_integer_t from, igraph_integer_t to, int thread, void *arg) {
+    igraph_integer_t i;
+    IGRAPH_UNUSED(thread);
+    IGRAPH_UNUSED(arg);
+    for (i = from; i < to; i++) {
+        if (igraph_allow_interruption(NULL) != IGRAPH_SUCCESS) {
+            return IGRAPH_INTERRUPTED;
+        }
+    }
+    return 0;
+}
+
+typedef struct {
+    data_t *data;
+    igraph_integer_t offset;
+} block_t;
+
+int square_block(igraph_integer_t from, igraph_integer_t to, int thread,
+                 void *arg) {
+    block_t *block = (block_t *) arg;
+    return square(block->offset + from, block->offset + to, thread, block->data);
+}
+
+/* Each of the 8 outer chunks fills a block of 1250 elements */
+int nested(igraph_integer_t from, igraph_integer_t to, int thread, void *arg) {
+    block_t block;
+    IGRAPH_UNUSED(thread);
+    IGRAPH_UNUSED(to);
+    block.data = (data_t *) arg;
+    block.offset = from * 1250;
+    /* Runs serially, on the thread of the outer loop */
+    return igraph_parallel_for(1250, 0, square_block, &block);
+}
+
+int error_count = 0;
+
+void count_errors(const char *reason, const char *file, int line,
+                  int igraph_errno) {
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    if (error_count++ == 0) {
+        printf("error: %s (%s)\n", reason, igraph_strerror(igraph_errno));
+    }
+    IGRAPH_FINALLY_FREE();
+}
+
+void print_warning(const char *reason, const char *file, int line,
+                   int igraph_errno) {
+    IGRAPH_UNUSED(file);
+    IGRAPH_UNUSED(line);
+    IGRAPH_UNUSED(igraph_errno);
+    printf("warning: %s\n", reason);
+}
+
+int interrupt(void *data) {
+    IGRAPH_UNUSED(data);
+    return IGRAPH_INTERRUPTED;
+}
+
+/* Runs a parallel loop and checks its result */
+
+int check_loop(igraph_vector_t *v) {
+    data_t data;
+    long int i;
+    data.v = v;
+    data.nthreads = igraph_get_num_threads();
+    data.bad_thread = 0;
+    igraph_vector_null(v);
+    igraph_parallel_for(igraph_vector_size(v), 0, square, &data);
+    for (i = 0; i < igraph_vector_size(v); i++) {
+        if (VECTOR(*v)[i] != (igraph_real_t) i * i) {
+            return 1;
+        }
+    }
+    return data.bad_thread;
+}
+
+/* The child of fork() does not inherit the worker threads, it must
+   start its own instead of waiting for the ones of the parent */
+
+int check_fork(igraph_vector_t *v) {
+#if IGRAPH_PARALLEL
+    int status;
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(check_loop(v) || check_loop(v));
+    }
+    if (pid < 0 || waitpid(pid, &status, 0) != pid) {
+        return 1;
+    }
+    return !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+#else
+    return check_loop(v);
+#endif
+}
+
+int main() {
+    igraph_vector_t v;
+    igraph_real_t s1, s4;
+    data_t data;
+    long int i;
+    int ret;
+
+    igraph_vector_init(&v, 10000);
+    data.v = &v;
+    data.bad_thread = 0;
+
+    /* Parallel loop */
+    igraph_set_num_threads(4);
+    data.nthreads = 4;
+    igraph_parallel_for(igraph_vector_size(&v), 0, square, &data);
+    for (i = 0; i < igraph_vector_size(&v); i++) {
+        if (VECTOR(v)[i] != (igraph_real_t) i * i) {
+            printf("wrong value at %ld\n", i);
+            return 1;
+        }
+    }
+    printf("loop: ok%s\n", data.bad_thread ? ", bad thread index" : "");
+
+    /* Empty loop */
+    igraph_parallel_for(0, 0, square, &data);
+
+    /* Nested loop */
+    igraph_vector_null(&v);
+    igraph_parallel_for(8, 1, nested, &data);
+    for (i = 0; i < igraph_vector_size(&v); i++) {
+        if (VECTOR(v)[i] != (igraph_real_t) i * i) {
+            printf("wrong value at %ld\n", i);
+            return 2;
+        }
+    }
+    printf("nested: ok\n");
+
+    /* The sum does not depend on the number of threads */
+    igraph_parallel_reduce(igraph_vector_size(&v), 100, sum, &data, &s4);
+    igraph_set_num_threads(1);
+    data.nthreads = 1;
+    igraph_parallel_reduce(igraph_vector_size(&v), 100, sum, &data, &s1);
+    printf("reduce: %s\n", s1 == s4 ? "same" : "different");
+    igraph_set_num_threads(4);
+    data.nthreads = 4;
+
+    /* Errors on the worker threads are raised on the calling thread */
+    igraph_set_error_handler(count_errors);
+    ret = igraph_parallel_for(10000, 10, fail, 0);
+    printf("error code: %d, finally stack: %d\n",
+           ret, IGRAPH_FINALLY_STACK_SIZE());
+    igraph_set_error_handler(igraph_error_handler_abort);
+
+    /* Warnings */
+    igraph_set_warning_handler(print_warning);
+    igraph_parallel_for(10000, 10, warn, 0);
+    igraph_set_warning_handler(0);
+
+    /* Interruption */
+    igraph_set_interruption_handler(interrupt);
+    ret = igraph_parallel_for(10000, 10, spin, 0);
+    printf("interrupted: %s\n", ret == IGRAPH_INTERRUPTED ? "yes" : "no");
+    igraph_set_interruption_handler(0);
+
+    /* Fork while the pool is running */
+    printf("fork: %s\n", check_fork(&v) || check_loop(&v) ? "wrong" : "ok");
+
+    /* Stopping the threads, the next loop starts them again */
+    igraph_parallel_shutdown();
+    ret = check_loop(&v);
+    igraph_parallel_shutdown();
+    igraph_parallel_shutdown();
+    printf("shutdown: %s\n", ret ? "wrong" : "ok");
+
+    igraph_vector_destroy(&v);
+
+    return 0;
+}
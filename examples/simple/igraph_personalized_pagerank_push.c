@@ -0,0 +1,154 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the result of the local push algorithm with the exact
+   personalized PageRank */
+
+int check(const igraph_t *g, igraph_vs_t seeds, igraph_bool_t directed,
+          const igraph_vector_t *weights, igraph_real_t eps, const char *name) {
+    igraph_vector_t exact, approx, scores, degree;
+    igraph_vector_int_t vids;
+    igraph_real_t error = 0, maxerror = 0;
+    igraph_bool_t lower = 1;
+    long int i, n = igraph_vcount(g);
+
+    igraph_vector_init(&exact, 0);
+    igraph_vector_init(&approx, n);
+    igraph_vector_init(&scores, 0);
+    igraph_vector_init(&degree, 0);
+    igraph_vector_int_init(&vids, 0);
+
+    igraph_personalized_pagerank_vs(g, IGRAPH_PAGERANK_ALGO_PARALLEL, &exact, 0,
+                                    igraph_vss_all(), directed, 0.85, seeds,
+                                    weights, 0);
+    igraph_personalized_pagerank_push(g, &vids, &scores, seeds, directed, 0.85,
+                                      weights, eps);
+    igraph_degree(g, &degree, igraph_vss_all(),
+                  directed ? IGRAPH_OUT : IGRAPH_ALL, IGRAPH_LOOPS);
+
+    for (i = 0; i < igraph_vector_int_size(&vids); i++) {
+        VECTOR(approx)[ VECTOR(vids)[i] ] = VECTOR(scores)[i];
+        if (i > 0 && VECTOR(scores)[i] > VECTOR(scores)[i - 1]) {
+            printf("%s: not sorted\n", name);
+        }
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t d = VECTOR(exact)[i] - VECTOR(approx)[i];
+        igraph_real_t deg = VECTOR(degree)[i] > 1 ? VECTOR(degree)[i] : 1;
+        if (d < -1e-9) {
+            lower = 0;
+        }
+        error += fabs(d);
+        if (d / deg > maxerror) {
+            maxerror = d / deg;
+        }
+    }
+
+    printf("%s: %ld of %ld vertices, lower bound: %d, ", name,
+           (long int) igraph_vector_int_size(&vids), n, lower);
+    if (directed && igraph_is_directed(g)) {
+        printf("L1 error below 0.01: %d\n", error < 0.01);
+    } else {
+        printf("error within eps * degree: %d\n", maxerror < eps);
+    }
+
+    igraph_vector_int_destroy(&vids);
+    igraph_vector_destroy(&degree);
+    igraph_vector_destroy(&scores);
+    igraph_vector_destroy(&approx);
+    igraph_vector_destroy(&exact);
+
+    return lower;
+}
+
+int main() {
+    igraph_t g, g2;
+    igraph_vector_t weights, scores;
+    igraph_vector_int_t vids;
+    igraph_vector_t seeds;
+    long int i;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Small example */
+    igraph_ring(&g, 6, IGRAPH_UNDIRECTED, /* mutual= */ 0, /* circular= */ 0);
+    igraph_vector_init(&scores, 0);
+    igraph_vector_int_init(&vids, 0);
+    igraph_personalized_pagerank_push(&g, &vids, &scores, igraph_vss_1(0),
+                                      IGRAPH_UNDIRECTED, 0.85, 0, 1e-3);
+    for (i = 0; i < igraph_vector_int_size(&vids); i++) {
+        printf("%ld: %.3f\n", (long int) VECTOR(vids)[i], VECTOR(scores)[i]);
+    }
+    igraph_destroy(&g);
+
+    /* Undirected graph with a small component, which is all the
+       algorithm sees when the seeds are there */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 5000,
+                            IGRAPH_UNDIRECTED, IGRAPH_LOOPS);
+    igraph_full(&g2, 10, IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_disjoint_union(&g, &g, &g2);
+    igraph_destroy(&g2);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 3);
+    }
+    igraph_vector_init_int(&seeds, 2, 1000, 1001);
+    ok = check(&g, igraph_vss_vector(&seeds), IGRAPH_UNDIRECTED, 0, 1e-6,
+               "small component") && ok;
+    igraph_vector_destroy(&seeds);
+
+    igraph_vector_init_int(&seeds, 3, 0, 1, 1);
+    ok = check(&g, igraph_vss_vector(&seeds), IGRAPH_UNDIRECTED, 0, 1e-6,
+               "undirected") && ok;
+    ok = check(&g, igraph_vss_vector(&seeds), IGRAPH_UNDIRECTED, &weights, 1e-6,
+               "undirected, weighted") && ok;
+    ok = check(&g, igraph_vss_vector(&seeds), IGRAPH_UNDIRECTED, 0, 1e-4,
+               "undirected, large eps") && ok;
+    igraph_vector_destroy(&seeds);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    /* Directed graph with dangling vertices */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 1000, 2000,
+                            IGRAPH_DIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(1, 3);
+    }
+    ok = check(&g, igraph_vss_1(5), IGRAPH_DIRECTED, 0, 1e-7,
+               "directed") && ok;
+    ok = check(&g, igraph_vss_1(5), IGRAPH_DIRECTED, &weights, 1e-7,
+               "directed, weighted") && ok;
+    ok = check(&g, igraph_vss_1(5), IGRAPH_UNDIRECTED, 0, 1e-6,
+               "directed as undirected") && ok;
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_vector_int_destroy(&vids);
+    igraph_vector_destroy(&scores);
+
+    return ok ? 0 : 1;
+}
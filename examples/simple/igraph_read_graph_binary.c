@@ -0,0 +1,220 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <stdio.h>
+
+int same_graph(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t v1, v2;
+    long int i, n = igraph_vcount(g1);
+    int res = igraph_vcount(g2) == n && igraph_ecount(g1) == igraph_ecount(g2) &&
+              igraph_is_directed(g1) == igraph_is_directed(g2);
+
+    igraph_vector_init(&v1, 0);
+    igraph_vector_init(&v2, 0);
+    for (i = 0; i < n && res; i++) {
+        igraph_incident(g1, &v1, i, IGRAPH_OUT);
+        igraph_incident(g2, &v2, i, IGRAPH_OUT);
+        res = igraph_vector_all_e(&v1, &v2);
+        igraph_incident(g1, &v1, i, IGRAPH_IN);
+        igraph_incident(g2, &v2, i, IGRAPH_IN);
+        res = res && igraph_vector_all_e(&v1, &v2);
+    }
+    igraph_vector_destroy(&v1);
+    igraph_vector_destroy(&v2);
+    return res;
+}
+
+/* Writes a graph to a file, overwrites the integer at position 'pos'
+   of the arrays after the 64 byte header, and reads it back */
+
+int read_corrupt(const igraph_t *g, long int pos, igraph_integer_t value) {
+    igraph_t r;
+    FILE *file = tmpfile();
+    int ret;
+
+    igraph_write_graph_binary(g, file);
+    fseek(file, 64 + pos * (long int) sizeof(igraph_integer_t), SEEK_SET);
+    fwrite(&value, sizeof(value), 1, file);
+    rewind(file);
+    ret = igraph_read_graph_binary(&r, file);
+    if (ret == 0) {
+        igraph_destroy(&r);
+    }
+    fclose(file);
+
+    return ret;
+}
+
+/* A file of a single vertex that claims to have 2^30 edges, but is
+   only 120 bytes long: the edge list does not fit, while the short
+   indices os = is = (0, 2^30) after it would */
+
+int read_truncated(void) {
+    igraph_t g, r;
+    FILE *file = tmpfile();
+    int64_t no_of_edges = 0x40000000;
+    igraph_integer_t index[4] = { 0, 0x40000000, 0, 0x40000000 };
+    char zero = 0;
+    int ret;
+
+    igraph_empty(&g, 1, IGRAPH_DIRECTED);
+    igraph_write_graph_binary(&g, file);
+    fseek(file, 119, SEEK_SET);
+    fwrite(&zero, 1, 1, file);
+    fseek(file, 32, SEEK_SET);
+    fwrite(&no_of_edges, sizeof(no_of_edges), 1, file);
+    fseek(file, 64, SEEK_SET);
+    fwrite(index, sizeof(igraph_integer_t), 4, file);
+    rewind(file);
+    ret = igraph_read_graph_binary(&r, file);
+    if (ret == 0) {
+        igraph_destroy(&r);
+    }
+    fclose(file);
+    igraph_destroy(&g);
+
+    return ret;
+}
+
+int main() {
+    igraph_t g1, g2, r1, r2, r3, copy, ring, star;
+    igraph_vector_t values, edges;
+    FILE *file;
+    long int i;
+    int ret;
+
+    igraph_i_set_attribute_table(&igraph_cattribute_table);
+
+    /* An undirected graph with numeric and string attributes */
+    igraph_famous(&g1, "Zachary");
+    SETGAN(&g1, "answer", 42);
+    igraph_vector_init_seq(&values, 1, igraph_vcount(&g1));
+    SETVANV(&g1, "weight", &values);
+    igraph_vector_resize(&values, igraph_ecount(&g1));
+    for (i = 0; i < igraph_ecount(&g1); i++) {
+        VECTOR(values)[i] = i / 4.0;
+    }
+    SETEANV(&g1, "capacity", &values);
+    SETGAS(&g1, "name", "Zachary karate club");
+    igraph_vector_destroy(&values);
+
+    /* A directed multigraph with loops and no attributes */
+    igraph_vector_init_int(&edges, 12, 0, 1, 1, 2, 2, 0, 0, 1, 3, 3, 3, 0);
+    igraph_create(&g2, &edges, 5, IGRAPH_DIRECTED);
+    igraph_vector_destroy(&edges);
+
+    /* Write both graphs into the same file */
+    file = tmpfile();
+    if (!file) {
+        return 1;
+    }
+    if (igraph_write_graph_binary(&g1, file) ||
+        igraph_write_graph_binary(&g2, file)) {
+        return 2;
+    }
+    rewind(file);
+
+    if (igraph_read_graph_binary(&r1, file) ||
+        igraph_read_graph_binary(&r2, file)) {
+        return 3;
+    }
+    fclose(file);
+
+    printf("first graph: %s, %s\n", same_graph(&g1, &r1) ? "same" : "different",
+           igraph_is_directed(&r1) ? "directed" : "undirected");
+    printf("second graph: %s, %s\n", same_graph(&g2, &r2) ? "same" : "different",
+           igraph_is_directed(&r2) ? "directed" : "undirected");
+
+    /* Only numeric attributes are stored */
+    printf("graph attributes: answer=%g, has name: %d\n", GAN(&r1, "answer"),
+           (int) igraph_cattribute_has_attr(&r1, IGRAPH_ATTRIBUTE_GRAPH, "name"));
+    printf("vertex weights:");
+    for (i = 0; i < 5; i++) {
+        printf(" %g", VAN(&r1, "weight", i));
+    }
+    printf(" ... %g\n", VAN(&r1, "weight", igraph_vcount(&r1) - 1));
+    printf("edge capacities:");
+    for (i = 0; i < 5; i++) {
+        printf(" %g", EAN(&r1, "capacity", i));
+    }
+    printf(" ... %g\n", EAN(&r1, "capacity", igraph_ecount(&r1) - 1));
+
+    /* The graphs are read-only, but copies can be modified */
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    igraph_vector_init_int(&edges, 2, 0, 4);
+    ret = igraph_add_edges(&r2, &edges, 0);
+    printf("adding edges to the read graph: %s\n",
+           ret == IGRAPH_EINVAL ? "refused" : "accepted");
+    igraph_copy(&copy, &r2);
+    ret = igraph_add_edges(&copy, &edges, 0);
+    printf("adding edges to its copy: %s, %d edges\n",
+           ret == 0 ? "accepted" : "refused", (int) igraph_ecount(&copy));
+    igraph_vector_destroy(&edges);
+
+    /* Deleting vertices creates a new, ordinary graph */
+    igraph_delete_vertices(&r2, igraph_vss_1(4));
+    printf("after deleting a vertex: %d vertices, %d edges\n",
+           (int) igraph_vcount(&r2), (int) igraph_ecount(&r2));
+
+    /* Not a binary graph file */
+    file = tmpfile();
+    fprintf(file, "0 1\n1 2\n");
+    rewind(file);
+    ret = igraph_read_graph_binary(&r3, file);
+    printf("reading an edge list: %s\n",
+           ret == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    fclose(file);
+
+    /* Corrupt edge lists and indices; a ring of 10 vertices has the
+       arrays from, to, oi, ii of length 10 and os, is of length 11 */
+    igraph_ring(&ring, 10, IGRAPH_DIRECTED, 0, 1);
+    printf("vertex out of range: %s\n",
+           read_corrupt(&ring, 10, 100000000) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    printf("edge out of range: %s\n",
+           read_corrupt(&ring, 20, -1) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    printf("decreasing index: %s\n",
+           read_corrupt(&ring, 42, 7) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    printf("wrong index: %s\n",
+           read_corrupt(&ring, 20, 1) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    printf("unchanged: %s\n",
+           read_corrupt(&ring, 0, 0) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    igraph_destroy(&ring);
+
+    /* The edges 0->1 and 0->2 have oi = (0, 1) at position 4; listing
+       edge 0 twice still gives edges that start at vertex 0 */
+    igraph_small(&star, 3, IGRAPH_DIRECTED, 0, 1, 0, 2, -1);
+    printf("repeated edge in index: %s\n",
+           read_corrupt(&star, 5, 0) == IGRAPH_PARSEERROR ? "parse error" : "no error");
+    igraph_destroy(&star);
+
+    printf("truncated edge list: %s\n",
+           read_truncated() == IGRAPH_PARSEERROR ? "parse error" : "no error");
+
+    igraph_destroy(&copy);
+    igraph_destroy(&r2);
+    igraph_destroy(&r1);
+    igraph_destroy(&g2);
+    igraph_destroy(&g1);
+
+    return 0;
+}
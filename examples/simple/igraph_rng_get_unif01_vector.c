@@ -0,0 +1,117 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* The bulk functions must give the same numbers as single calls */
+
+int check(const igraph_rng_type_t *type) {
+    igraph_rng_t rng;
+    igraph_vector_t unif, geom;
+    igraph_vector_int_t integers;
+    int i, n = 1000, ok = 1;
+
+    igraph_rng_init(&rng, type);
+    igraph_vector_init(&unif, 0);
+    igraph_vector_init(&geom, 0);
+    igraph_vector_int_init(&integers, 0);
+
+    igraph_rng_seed(&rng, 42);
+    igraph_rng_get_unif01_vector(&rng, &unif, n);
+    igraph_rng_get_integer_vector(&rng, &integers, n, -5, 5);
+    igraph_rng_get_geom_vector(&rng, &geom, n, 0.2);
+
+    igraph_rng_seed(&rng, 42);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(unif)[i] != igraph_rng_get_unif01(&rng) ||
+            VECTOR(unif)[i] < 0 || VECTOR(unif)[i] >= 1) {
+            ok = 0;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (VECTOR(integers)[i] != igraph_rng_get_integer(&rng, -5, 5) ||
+            VECTOR(integers)[i] < -5 || VECTOR(integers)[i] > 5) {
+            ok = 0;
+        }
+    }
+    for (i = 0; i < n; i++) {
+        if (VECTOR(geom)[i] != igraph_rng_get_geom(&rng, 0.2)) {
+            ok = 0;
+        }
+    }
+    printf("%s: %s\n", igraph_rng_name(&rng), ok ? "same" : "different");
+
+    igraph_vector_int_destroy(&integers);
+    igraph_vector_destroy(&geom);
+    igraph_vector_destroy(&unif);
+    igraph_rng_destroy(&rng);
+
+    return ok;
+}
+
+int main() {
+    igraph_rng_t rng, *def = igraph_rng_default();
+    igraph_rng_t oldrng = *def;
+    igraph_vector_t unif;
+    igraph_t graph;
+    igraph_real_t mean = 0;
+    int i, ok = 1;
+
+    ok = check(&igraph_rngtype_mt19937) && ok;
+    ok = check(&igraph_rngtype_philox4x32) && ok;
+    ok = check(&igraph_rngtype_xoshiro256ss) && ok;
+
+    /* Known answer */
+    igraph_rng_init(&rng, &igraph_rngtype_xoshiro256ss);
+    igraph_rng_seed(&rng, 0);
+    printf("%s:", igraph_rng_name(&rng));
+    for (i = 0; i < 4; i++) {
+        printf(" %08lx", rng.type->get(rng.state));
+    }
+    printf("\n");
+
+    igraph_vector_init(&unif, 0);
+    igraph_rng_get_unif01_vector(&rng, &unif, 100000);
+    for (i = 0; i < 100000; i++) {
+        mean += VECTOR(unif)[i];
+    }
+    mean /= 100000;
+    printf("mean: %s\n", fabs(mean - 0.5) < 0.005 ? "ok" : "unlikely");
+    igraph_vector_destroy(&unif);
+
+    /* The graph generators work with the new generator as well */
+    igraph_rng_set_default(&rng);
+    igraph_erdos_renyi_game(&graph, IGRAPH_ERDOS_RENYI_GNP, 1000, 0.01,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    printf("G(n,p) edges: %s\n",
+           fabs(igraph_ecount(&graph) - 4995) < 5 * sqrt(4995 * 0.99) ? "ok" : "unlikely");
+    igraph_destroy(&graph);
+    igraph_barabasi_game(&graph, 1000, 1, 3, 0, 0, 1, 0,
+                         IGRAPH_BARABASI_PSUMTREE, 0);
+    printf("BA edges: %d\n", (int) igraph_ecount(&graph));
+    igraph_destroy(&graph);
+    igraph_rng_set_default(&oldrng);
+    igraph_rng_destroy(&rng);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,96 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+int same_stream(const igraph_rng_type_t *type, unsigned long int seed,
+                igraph_integer_t s1, igraph_integer_t s2) {
+    igraph_rng_t r1, r2;
+    int i, same = 1;
+    igraph_rng_init(&r1, type);
+    igraph_rng_init(&r2, type);
+    igraph_rng_seed_stream(&r1, seed, s1);
+    igraph_rng_seed_stream(&r2, seed, s2);
+    for (i = 0; i < 100; i++) {
+        if (igraph_rng_get_integer(&r1, 0, 1000000) !=
+            igraph_rng_get_integer(&r2, 0, 1000000)) {
+            same = 0;
+        }
+    }
+    igraph_rng_destroy(&r2);
+    igraph_rng_destroy(&r1);
+    return same;
+}
+
+int gnp(igraph_t *graph, int nthreads) {
+    igraph_set_num_threads(nthreads);
+    igraph_rng_seed(igraph_rng_default(), 42);
+    return igraph_erdos_renyi_game(graph, IGRAPH_ERDOS_RENYI_GNP, 2000, 0.1,
+                                   IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+}
+
+int main() {
+    igraph_rng_t rng;
+    igraph_t g1, g2;
+    igraph_vector_t e1, e2;
+    igraph_real_t expected, sd;
+    int i;
+
+    /* Known answer, from the Random123 library */
+    igraph_rng_init(&rng, &igraph_rngtype_philox4x32);
+    igraph_rng_seed_stream(&rng, 0, 0);
+    printf("%s:", igraph_rng_name(&rng));
+    for (i = 0; i < 4; i++) {
+        printf(" %08lx", rng.type->get(rng.state));
+    }
+    printf("\n");
+    igraph_rng_destroy(&rng);
+
+    printf("same stream: %d %d\n",
+           same_stream(&igraph_rngtype_philox4x32, 42, 7, 7),
+           same_stream(&igraph_rngtype_mt19937, 42, 7, 7));
+    printf("different streams: %d %d\n",
+           !same_stream(&igraph_rngtype_philox4x32, 42, 7, 8),
+           !same_stream(&igraph_rngtype_mt19937, 42, 7, 8));
+
+    /* G(n,p) graphs do not depend on the number of threads */
+    gnp(&g1, 2);
+    gnp(&g2, 4);
+    igraph_vector_init(&e1, 0);
+    igraph_vector_init(&e2, 0);
+    igraph_get_edgelist(&g1, &e1, 0);
+    igraph_get_edgelist(&g2, &e2, 0);
+    printf("same graph: %d\n", igraph_vector_all_e(&e1, &e2));
+
+    expected = 2000 * 1999 / 2 * 0.1;
+    sd = sqrt(expected * 0.9);
+    printf("edge count: %s\n",
+           fabs(igraph_ecount(&g1) - expected) < 5 * sd ? "ok" : "unlikely");
+
+    igraph_vector_destroy(&e2);
+    igraph_vector_destroy(&e1);
+    igraph_destroy(&g2);
+    igraph_destroy(&g1);
+
+    return 0;
+}
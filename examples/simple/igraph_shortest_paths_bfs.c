@@ -0,0 +1,125 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+
+/* Compares the unweighted distance functions, which switch between
+   top-down and bottom-up search steps and use several threads, with
+   the distances computed by igraph_bfs() */
+
+int check(const igraph_t *g, igraph_neimode_t mode, const char *name) {
+    igraph_vector_t dist, ecc, size;
+    igraph_matrix_t res;
+    long int i, j, n = igraph_vcount(g);
+    int paths = 1, eccentricity = 1, neighborhood = 1;
+
+    igraph_vector_init(&dist, 0);
+    igraph_vector_init(&ecc, 0);
+    igraph_vector_init(&size, 0);
+    igraph_matrix_init(&res, 0, 0);
+
+    igraph_shortest_paths(g, &res, igraph_vss_seq(0, 9), igraph_vss_all(), mode);
+    igraph_eccentricity(g, &ecc, igraph_vss_seq(0, 9), mode);
+    igraph_neighborhood_size(g, &size, igraph_vss_seq(0, 9), 2, mode, 1);
+
+    for (i = 0; i < 10; i++) {
+        igraph_real_t maxdist = 0;
+        long int count = 0;
+        igraph_bfs(g, (igraph_integer_t) i, 0, mode, /* unreachable= */ 0, 0,
+                   0, 0, 0, 0, 0, &dist, 0, 0);
+        for (j = 0; j < n; j++) {
+            /* igraph_bfs() gives NaN for the unreached vertices */
+            igraph_real_t d = igraph_is_nan(VECTOR(dist)[j]) ?
+                              IGRAPH_INFINITY : VECTOR(dist)[j];
+            if (MATRIX(res, i, j) != d) {
+                paths = 0;
+            }
+            if (d != IGRAPH_INFINITY && d > maxdist) {
+                maxdist = d;
+            }
+            if (d >= 1 && d <= 2) {
+                count++;
+            }
+        }
+        if (VECTOR(ecc)[i] != maxdist) {
+            eccentricity = 0;
+        }
+        if (VECTOR(size)[i] != count) {
+            neighborhood = 0;
+        }
+    }
+
+    printf("%s: paths %d, eccentricity %d, neighborhood size %d\n",
+           name, paths, eccentricity, neighborhood);
+
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&size);
+    igraph_vector_destroy(&ecc);
+    igraph_vector_destroy(&dist);
+
+    return paths && eccentricity && neighborhood;
+}
+
+int main() {
+    igraph_t g;
+    igraph_matrix_t res;
+    int ok = 1;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+    igraph_set_num_threads(4);
+
+    /* Large frontiers, the searches go bottom-up */
+    igraph_barabasi_game(&g, 20000, /* power= */ 1, /* m= */ 5, 0, 0,
+                         /* A= */ 1, /* directed= */ 0,
+                         IGRAPH_BARABASI_PSUMTREE, /* start_from= */ 0);
+    ok = check(&g, IGRAPH_ALL, "undirected, small diameter") && ok;
+    igraph_destroy(&g);
+
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 20000, 100000,
+                            IGRAPH_DIRECTED, IGRAPH_LOOPS);
+    ok = check(&g, IGRAPH_OUT, "directed, out") && ok;
+    ok = check(&g, IGRAPH_IN, "directed, in") && ok;
+    ok = check(&g, IGRAPH_ALL, "directed, all") && ok;
+    igraph_destroy(&g);
+
+    /* Large frontiers with few edges, parallel top-down steps */
+    igraph_tree(&g, 131071, 2, IGRAPH_TREE_UNDIRECTED);
+    ok = check(&g, IGRAPH_ALL, "binary tree") && ok;
+    igraph_destroy(&g);
+
+    /* Long paths, the searches stay top-down */
+    igraph_ring(&g, 5000, IGRAPH_DIRECTED, /* mutual= */ 0, /* circular= */ 1);
+    ok = check(&g, IGRAPH_OUT, "directed ring") && ok;
+    igraph_destroy(&g);
+
+    /* Unreachable vertices, and a path that stops early */
+    igraph_small(&g, 5, IGRAPH_DIRECTED, 0, 1, 1, 2, 3, 4, -1);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths(&g, &res, igraph_vss_1(0), igraph_vss_1(1), IGRAPH_OUT);
+    igraph_matrix_print(&res);
+    igraph_shortest_paths(&g, &res, igraph_vss_all(), igraph_vss_all(), IGRAPH_ALL);
+    igraph_matrix_print(&res);
+    igraph_matrix_destroy(&res);
+    igraph_destroy(&g);
+
+    return ok ? 0 : 1;
+}
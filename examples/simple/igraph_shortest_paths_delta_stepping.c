@@ -0,0 +1,152 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Compares the distances and paths with Dijkstra's algorithm */
+
+int check(const igraph_t *g, const igraph_vector_t *weights,
+          igraph_neimode_t mode, igraph_real_t delta, const char *name) {
+    igraph_matrix_t d1, d2;
+    igraph_vector_ptr_t paths;
+    igraph_vector_long_t pred, inbound;
+    igraph_vs_t from;
+    long int i, j, n = igraph_vcount(g);
+    int bad = 0;
+
+    igraph_vs_vector_small(&from, 0, 1, n / 2, n - 1, -1);
+    igraph_matrix_init(&d1, 0, 0);
+    igraph_matrix_init(&d2, 0, 0);
+    igraph_shortest_paths_dijkstra(g, &d1, from, igraph_vss_all(), weights, mode);
+    igraph_shortest_paths_delta_stepping(g, &d2, from, igraph_vss_all(), weights,
+                                         mode, delta);
+    bad += !igraph_matrix_all_e(&d1, &d2);
+
+    /* The paths must have the right length */
+    igraph_vector_ptr_init(&paths, n);
+    for (i = 0; i < n; i++) {
+        VECTOR(paths)[i] = igraph_Calloc(1, igraph_vector_t);
+        igraph_vector_init(VECTOR(paths)[i], 0);
+    }
+    igraph_vector_long_init(&pred, 0);
+    igraph_vector_long_init(&inbound, 0);
+    igraph_set_warning_handler(igraph_warning_handler_ignore);
+    igraph_get_shortest_paths_delta_stepping(g, 0, &paths, 0, igraph_vss_all(),
+            weights, mode, delta, &pred, &inbound);
+    igraph_set_warning_handler(igraph_warning_handler_print);
+    for (i = 0; i < n; i++) {
+        igraph_vector_t *path = VECTOR(paths)[i];
+        igraph_real_t len = 0;
+        for (j = 0; j < igraph_vector_size(path); j++) {
+            len += VECTOR(*weights)[ (long int) VECTOR(*path)[j] ];
+        }
+        if (MATRIX(d1, 0, i) == IGRAPH_INFINITY) {
+            bad += igraph_vector_size(path) != 0 || VECTOR(pred)[i] != -1;
+        } else {
+            bad += fabs(len - MATRIX(d1, 0, i)) > 1e-9 * (len + 1);
+            if (i != 0) {
+                bad += VECTOR(pred)[i] !=
+                       IGRAPH_OTHER(g, VECTOR(inbound)[i], i);
+            }
+        }
+        igraph_vector_destroy(path);
+        igraph_free(path);
+    }
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_vector_long_destroy(&inbound);
+    igraph_vector_long_destroy(&pred);
+    igraph_vector_ptr_destroy(&paths);
+    igraph_matrix_destroy(&d2);
+    igraph_matrix_destroy(&d1);
+    igraph_vs_destroy(&from);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights;
+    igraph_matrix_t res;
+    long int i;
+    int bad = 0;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Large enough for the steps to run on several threads */
+    igraph_set_num_threads(4);
+
+    /* Random directed graph, integer weights with many ties */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 5000, 40000, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 20);
+    }
+    bad += check(&g, &weights, IGRAPH_OUT, 0, "directed, default delta");
+    bad += check(&g, &weights, IGRAPH_IN, 3, "directed, in");
+    bad += check(&g, &weights, IGRAPH_ALL, 100, "directed, all, large delta");
+    bad += check(&g, &weights, IGRAPH_OUT, 1e-6, "directed, small delta");
+    igraph_destroy(&g);
+
+    /* Undirected graph, real weights, some of them infinite */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 3000, 6000,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = i % 10 == 0 ? IGRAPH_INFINITY : RNG_UNIF(0, 1);
+    }
+    bad += check(&g, &weights, IGRAPH_OUT, 0, "undirected");
+    bad += check(&g, &weights, IGRAPH_OUT, 0.1, "undirected, delta 0.1");
+    igraph_destroy(&g);
+
+    /* All weights are zero */
+    igraph_ring(&g, 10, IGRAPH_DIRECTED, /* mutual= */ 1, /* circular= */ 1);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    igraph_vector_null(&weights);
+    bad += check(&g, &weights, IGRAPH_OUT, 0, "zero weights");
+    igraph_destroy(&g);
+
+    /* Unreachable vertices, negative weights */
+    igraph_small(&g, 4, IGRAPH_DIRECTED, 0, 1, 1, 2, -1);
+    igraph_vector_resize(&weights, 2);
+    VECTOR(weights)[0] = 1.5;
+    VECTOR(weights)[1] = 2;
+    igraph_matrix_init(&res, 0, 0);
+    igraph_shortest_paths_delta_stepping(&g, &res, igraph_vss_all(), igraph_vss_all(),
+                                         &weights, IGRAPH_OUT, 0);
+    igraph_matrix_print(&res);
+
+    igraph_set_error_handler(igraph_error_handler_ignore);
+    VECTOR(weights)[1] = -1;
+    if (igraph_shortest_paths_delta_stepping(&g, &res, igraph_vss_all(),
+            igraph_vss_all(), &weights, IGRAPH_OUT, 0) != IGRAPH_EINVAL) {
+        bad++;
+    }
+
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    return bad ? 1 : 0;
+}
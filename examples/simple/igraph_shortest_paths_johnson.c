@@ -0,0 +1,229 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc.,  51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include <igraph.h>
+#include <math.h>
+
+/* Row handler that collects the rows into a matrix, and stops after
+   'limit' rows */
+
+typedef struct {
+    igraph_matrix_t *res;
+    igraph_vector_t *sources;
+    long int row, limit;
+    int bad;
+} rows_t;
+
+igraph_bool_t collect(igraph_integer_t source, const igraph_vector_t *distances,
+                      void *arg) {
+    rows_t *data = arg;
+    long int j;
+    if (source != VECTOR(*data->sources)[data->row] ||
+        igraph_vector_size(distances) != igraph_matrix_ncol(data->res)) {
+        data->bad++;
+        return 0;
+    }
+    for (j = 0; j < igraph_vector_size(distances); j++) {
+        MATRIX(*data->res, data->row, j) = VECTOR(*distances)[j];
+    }
+    data->row++;
+    return data->row < data->limit;
+}
+
+/* Row handler that stores the distances in 16 bits, in units of 1/100 */
+
+igraph_bool_t quantize(igraph_integer_t source, const igraph_vector_t *distances,
+                       void *arg) {
+    unsigned short **res = arg;
+    long int j;
+    IGRAPH_UNUSED(source);
+    for (j = 0; j < igraph_vector_size(distances); j++) {
+        igraph_real_t d = VECTOR(*distances)[j];
+        (*res)[j] = d < 655.35 ? (unsigned short) floor(d * 100 + 0.5) : 65535;
+    }
+    *res += igraph_vector_size(distances);
+    return 1;
+}
+
+/* Compares Johnson's algorithm with the other shortest path functions */
+
+int check(const igraph_t *g, const igraph_vector_t *weights, igraph_vs_t from,
+          igraph_vs_t to, const char *name) {
+    igraph_matrix_t d1, d2, d3;
+    igraph_vector_t sources;
+    rows_t data;
+    float *f;
+    unsigned short *q, *qp;
+    long int i, j, nr, nc;
+    int bad = 0;
+
+    igraph_matrix_init(&d1, 0, 0);
+    igraph_matrix_init(&d2, 0, 0);
+    igraph_matrix_init(&d3, 0, 0);
+    igraph_vector_init(&sources, 0);
+    igraph_vs_as_vector(g, from, &sources);
+
+    if (weights) {
+        igraph_shortest_paths_bellman_ford(g, &d1, from, to, weights, IGRAPH_OUT);
+    } else {
+        igraph_shortest_paths(g, &d1, from, to, IGRAPH_OUT);
+    }
+    nr = igraph_matrix_nrow(&d1);
+    nc = igraph_matrix_ncol(&d1);
+
+    /* The matrix, on one and on several threads */
+    igraph_set_num_threads(1);
+    igraph_shortest_paths_johnson(g, &d2, from, to, weights);
+    for (i = 0; i < nr; i++) {
+        for (j = 0; j < nc; j++) {
+            igraph_real_t a = MATRIX(d1, i, j), b = MATRIX(d2, i, j);
+            bad += a == IGRAPH_INFINITY ? b != a : fabs(a - b) > 1e-9 * (fabs(a) + 1);
+        }
+    }
+    igraph_set_num_threads(4);
+    igraph_shortest_paths_johnson(g, &d3, from, to, weights);
+    bad += !igraph_matrix_all_e(&d2, &d3);
+
+    /* The rows, in the order of the sources */
+    igraph_matrix_resize(&d3, nr, nc);
+    igraph_matrix_null(&d3);
+    data.res = &d3;
+    data.sources = &sources;
+    data.row = 0;
+    data.limit = nr;
+    data.bad = 0;
+    igraph_shortest_paths_johnson_callback(g, from, to, weights, collect, &data);
+    bad += data.bad + (data.row != nr) + !igraph_matrix_all_e(&d2, &d3);
+
+    /* Stopping early */
+    if (nr > 3) {
+        data.row = 0;
+        data.limit = 3;
+        igraph_shortest_paths_johnson_callback(g, from, to, weights, collect, &data);
+        bad += data.bad + (data.row != 3);
+    }
+
+    /* Single precision */
+    f = igraph_Calloc(nr * nc + 1, float);
+    igraph_shortest_paths_johnson_float(g, f, from, to, weights);
+    for (i = 0; i < nr; i++) {
+        for (j = 0; j < nc; j++) {
+            bad += f[i * nc + j] != (float) MATRIX(d2, i, j);
+        }
+    }
+    igraph_free(f);
+
+    /* Quantized, this needs non-negative distances */
+    if (!weights || igraph_vector_min(weights) >= 0) {
+        q = igraph_Calloc(nr * nc + 1, unsigned short);
+        qp = q;
+        igraph_shortest_paths_johnson_callback(g, from, to, weights, quantize, &qp);
+        for (i = 0; i < nr; i++) {
+            for (j = 0; j < nc; j++) {
+                igraph_real_t d = MATRIX(d2, i, j);
+                bad += d < 655.35 ? fabs(q[i * nc + j] / 100.0 - d) > 0.005 + 1e-9 :
+                       q[i * nc + j] != 65535;
+            }
+        }
+        igraph_free(q);
+    }
+
+    printf("%s: %s\n", name, bad ? "wrong" : "ok");
+
+    igraph_vector_destroy(&sources);
+    igraph_matrix_destroy(&d3);
+    igraph_matrix_destroy(&d2);
+    igraph_matrix_destroy(&d1);
+
+    return bad;
+}
+
+int main() {
+    igraph_t g;
+    igraph_vector_t weights, potential;
+    igraph_matrix_t res;
+    igraph_vs_t from, to;
+    long int i;
+    int bad = 0;
+
+    /* A small graph with negative weights, and only some targets */
+    igraph_small(&g, 0, IGRAPH_DIRECTED,
+                 0, 1, 0, 2, 1, 2, 2, 3, 3, 1, 3, 4, 4, 0, 5, 4,
+                 -1);
+    igraph_vector_init_int(&weights, 8, 3, 8, -2, 4, 1, -3, 2, 7);
+    igraph_matrix_init(&res, 0, 0);
+    igraph_vs_vector_small(&to, 4, 1, 3, -1);
+    igraph_shortest_paths_johnson(&g, &res, igraph_vss_all(), to, &weights);
+    igraph_matrix_print(&res);
+    igraph_vs_destroy(&to);
+    igraph_matrix_destroy(&res);
+    igraph_vector_destroy(&weights);
+    igraph_destroy(&g);
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    /* Random directed graph, negative weights from vertex potentials,
+       so there is no negative cycle */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 300, 1500, IGRAPH_DIRECTED,
+                            IGRAPH_LOOPS);
+    igraph_vector_init(&potential, igraph_vcount(&g));
+    for (i = 0; i < igraph_vcount(&g); i++) {
+        VECTOR(potential)[i] = RNG_UNIF(0, 5);
+    }
+    igraph_vector_init(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0, 2) +
+                             VECTOR(potential)[ (long int) IGRAPH_FROM(&g, i) ] -
+                             VECTOR(potential)[ (long int) IGRAPH_TO(&g, i) ];
+    }
+    igraph_vs_vector_small(&from, 0, 7, 299, 150, 7, 42, -1);
+    igraph_vs_vector_small(&to, 299, 3, 0, 77, 150, -1);
+    bad += check(&g, &weights, igraph_vss_all(), igraph_vss_all(), "negative, all");
+    bad += check(&g, &weights, from, to, "negative, some");
+
+    /* Non-negative integer weights */
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_INTEGER(0, 9);
+    }
+    bad += check(&g, &weights, from, igraph_vss_all(), "integer");
+
+    /* No weights */
+    bad += check(&g, 0, igraph_vss_all(), to, "unweighted");
+    igraph_destroy(&g);
+
+    /* Undirected graph */
+    igraph_erdos_renyi_game(&g, IGRAPH_ERDOS_RENYI_GNM, 200, 300,
+                            IGRAPH_UNDIRECTED, IGRAPH_NO_LOOPS);
+    igraph_vector_resize(&weights, igraph_ecount(&g));
+    for (i = 0; i < igraph_ecount(&g); i++) {
+        VECTOR(weights)[i] = RNG_UNIF(0, 1);
+    }
+    bad += check(&g, &weights, igraph_vss_all(), igraph_vss_all(), "undirected");
+    igraph_destroy(&g);
+
+    igraph_vs_destroy(&to);
+    igraph_vs_destroy(&from);
+    igraph_vector_destroy(&potential);
+    igraph_vector_destroy(&weights);
+
+    return bad;
+}
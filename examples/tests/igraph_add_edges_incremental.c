@@ -0,0 +1,105 @@
+
+#include <igraph.h>
+
+/* Adding edges in small batches merges them into the existing index.
+   The result must be identical to creating the graph in one step. */
+
+int compare_incident(const igraph_t *g1, const igraph_t *g2) {
+    igraph_vector_t inc1, inc2;
+    igraph_neimode_t modes[] = { IGRAPH_OUT, IGRAPH_IN, IGRAPH_ALL };
+    long int i, m, n = igraph_vcount(g1);
+    int res = 0;
+
+    igraph_vector_init(&inc1, 0);
+    igraph_vector_init(&inc2, 0);
+    for (m = 0; m < 3 && !res; m++) {
+        for (i = 0; i < n && !res; i++) {
+            igraph_incident(g1, &inc1, i, modes[m]);
+            igraph_incident(g2, &inc2, i, modes[m]);
+            res = !igraph_vector_all_e(&inc1, &inc2);
+            igraph_neighbors(g1, &inc1, i, modes[m]);
+            igraph_neighbors(g2, &inc2, i, modes[m]);
+            res = res || !igraph_vector_all_e(&inc1, &inc2);
+        }
+    }
+    igraph_vector_destroy(&inc1);
+    igraph_vector_destroy(&inc2);
+    return res;
+}
+
+int test(igraph_bool_t directed) {
+    igraph_t full, incr, base;
+    igraph_vector_t edges, batch;
+    long int no_of_edges, i, j;
+    igraph_integer_t eid1, eid2;
+    int batch_sizes[] = { 1, 2, 3, 7, 20 };
+
+    igraph_vector_init(&batch, 0);
+    igraph_vector_init(&edges, 0);
+
+    /* a multigraph with loops, so that the order of edges with equal
+       endpoints matters, too */
+    igraph_erdos_renyi_game(&base, IGRAPH_ERDOS_RENYI_GNM, 30, 300,
+                            directed, IGRAPH_LOOPS);
+    igraph_get_edgelist(&base, &edges, 0);
+    igraph_vector_append(&edges, &edges);
+    no_of_edges = igraph_vector_size(&edges) / 2;
+    igraph_destroy(&base);
+
+    igraph_create(&full, &edges, 30, directed);
+
+    /* start with a third of the edges, add the rest in batches */
+    igraph_vector_resize(&batch, 2 * (no_of_edges / 3));
+    for (i = 0; i < igraph_vector_size(&batch); i++) {
+        VECTOR(batch)[i] = VECTOR(edges)[i];
+    }
+    igraph_create(&incr, &batch, 30, directed);
+    for (i = igraph_vector_size(&batch), j = 0; i < 2 * no_of_edges; j++) {
+        long int k, size = 2 * batch_sizes[j % 5];
+        if (i + size > 2 * no_of_edges) {
+            size = 2 * no_of_edges - i;
+        }
+        igraph_vector_resize(&batch, size);
+        for (k = 0; k < size; k++) {
+            VECTOR(batch)[k] = VECTOR(edges)[i + k];
+        }
+        igraph_add_edges(&incr, &batch, 0);
+        i += size;
+    }
+
+    if (igraph_ecount(&incr) != igraph_ecount(&full)) {
+        return 1;
+    }
+    if (compare_incident(&incr, &full)) {
+        return 2;
+    }
+    for (i = 0; i < no_of_edges; i++) {
+        igraph_integer_t from = VECTOR(edges)[2 * i], to = VECTOR(edges)[2 * i + 1];
+        igraph_get_eid(&full, &eid1, from, to, IGRAPH_DIRECTED, 1);
+        igraph_get_eid(&incr, &eid2, from, to, IGRAPH_DIRECTED, 1);
+        if (eid1 != eid2) {
+            return 3;
+        }
+    }
+
+    igraph_destroy(&full);
+    igraph_destroy(&incr);
+    igraph_vector_destroy(&edges);
+    igraph_vector_destroy(&batch);
+    return 0;
+}
+
+int main() {
+    int ret;
+
+    igraph_rng_seed(igraph_rng_default(), 42);
+
+    if ((ret = test(IGRAPH_UNDIRECTED))) {
+        return ret;
+    }
+    if ((ret = test(IGRAPH_DIRECTED))) {
+        return 10 + ret;
+    }
+
+    return 0;
+}
@@ -0,0 +1,115 @@
+
+#include <igraph.h>
+#include <stdlib.h>
+
+/* Builds and traverses a graph with more than 2^31 edges. This needs
+   64 bit vertex and edge ids (configure --enable-int64) and about
+   100GB of memory, so it only runs if the IGRAPH_STRESS_TESTS
+   environment variable is set. */
+
+#define NO_OF_NODES (1 << 24)
+#define CHUNK_SIZE (1 << 26)
+#define NO_OF_CHUNKS 33
+
+/* Edge 'i' of chunk 'c' goes from 'i' to '7i+c', modulo the number of
+   vertices. 7 is invertible modulo 2^24, so the edges of the first two
+   chunks already connect 'w' and 'w+1' for every 'w' via some 'v'. */
+
+#define FROM(c, i) ((i) % NO_OF_NODES)
+#define TO(c, i)   ((7 * (i) + (c)) % NO_OF_NODES)
+
+int main() {
+#if IGRAPH_INTEGER_SIZE == 64
+    igraph_t g;
+    igraph_vector_t edges, neis, deg;
+    igraph_vector_char_t seen;
+    igraph_dqueue_t q;
+    igraph_integer_t from, to, no_of_edges, last;
+    long int c, i, reached;
+    igraph_real_t degsum;
+
+    if (!getenv("IGRAPH_STRESS_TESTS")) {
+        return 77;
+    }
+
+    igraph_empty(&g, NO_OF_NODES, IGRAPH_DIRECTED);
+
+    /* The first chunk builds the index from scratch, the later ones
+       are merged into it */
+    igraph_vector_init(&edges, 2 * CHUNK_SIZE);
+    for (c = 0; c < NO_OF_CHUNKS; c++) {
+        for (i = 0; i < CHUNK_SIZE; i++) {
+            VECTOR(edges)[2 * i] = FROM(c, i);
+            VECTOR(edges)[2 * i + 1] = TO(c, i);
+        }
+        if (igraph_add_edges(&g, &edges, 0)) {
+            return 1;
+        }
+    }
+    igraph_vector_destroy(&edges);
+
+    no_of_edges = igraph_ecount(&g);
+    if (no_of_edges != (igraph_integer_t) NO_OF_CHUNKS * CHUNK_SIZE) {
+        return 2;
+    }
+    if (no_of_edges <= (igraph_integer_t) 2147483647) {
+        return 3;
+    }
+
+    /* Endpoints of the last edge */
+    last = no_of_edges - 1;
+    igraph_edge(&g, last, &from, &to);
+    if (from != FROM(NO_OF_CHUNKS - 1, (long int) CHUNK_SIZE - 1) ||
+        to != TO(NO_OF_CHUNKS - 1, (long int) CHUNK_SIZE - 1)) {
+        return 4;
+    }
+    igraph_get_eid(&g, &last, from, to, IGRAPH_DIRECTED, /*error=*/ 1);
+    if (igraph_edge(&g, last, &from, &to) ||
+        from != FROM(NO_OF_CHUNKS - 1, (long int) CHUNK_SIZE - 1)) {
+        return 5;
+    }
+
+    /* Degrees must add up to the number of edges */
+    igraph_vector_init(&deg, 0);
+    igraph_degree(&g, &deg, igraph_vss_all(), IGRAPH_OUT, IGRAPH_LOOPS);
+    degsum = igraph_vector_sum(&deg);
+    igraph_degree(&g, &deg, igraph_vss_all(), IGRAPH_IN, IGRAPH_LOOPS);
+    if (degsum != no_of_edges || igraph_vector_sum(&deg) != no_of_edges) {
+        return 6;
+    }
+    igraph_vector_destroy(&deg);
+
+    /* Breadth first search over all edges, without building an
+       adjacency list */
+    igraph_vector_init(&neis, 0);
+    igraph_vector_char_init(&seen, NO_OF_NODES);
+    igraph_dqueue_init(&q, 100);
+    igraph_dqueue_push(&q, 0);
+    VECTOR(seen)[0] = 1;
+    reached = 1;
+    while (!igraph_dqueue_empty(&q)) {
+        long int act = (long int) igraph_dqueue_pop(&q);
+        igraph_neighbors(&g, &neis, (igraph_integer_t) act, IGRAPH_ALL);
+        for (i = 0; i < igraph_vector_size(&neis); i++) {
+            long int nei = (long int) VECTOR(neis)[i];
+            if (!VECTOR(seen)[nei]) {
+                VECTOR(seen)[nei] = 1;
+                reached++;
+                igraph_dqueue_push(&q, nei);
+            }
+        }
+    }
+    if (reached != NO_OF_NODES) {
+        return 7;
+    }
+
+    igraph_dqueue_destroy(&q);
+    igraph_vector_char_destroy(&seen);
+    igraph_vector_destroy(&neis);
+    igraph_destroy(&g);
+
+    return 0;
+#else
+    return 77;
+#endif
+}
@@ -54,6 +54,11 @@ DECLDIR int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *
                                         igraph_real_t cutoff,
                                         const igraph_vector_t *weights,
                                         igraph_bool_t nobigint);
+DECLDIR int igraph_betweenness_approx(const igraph_t *graph, igraph_vector_t *res,
+                                      const igraph_vs_t vids, igraph_bool_t directed,
+                                      const igraph_vector_t *weights,
+                                      igraph_real_t epsilon, igraph_real_t delta,
+                                      igraph_integer_t *samples);
 DECLDIR int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
                                     igraph_bool_t directed,
                                     const igraph_vector_t *weigths);
@@ -77,12 +82,18 @@ DECLDIR int igraph_pagerank_old(const igraph_t *graph, igraph_vector_t *res,
  *   version 0.7.
  * \enumval IGRAPH_PAGERANK_ALGO_PRPACK Use the PRPACK
  *   library. Currently this implementation is recommended.
+ * \enumval IGRAPH_PAGERANK_ALGO_PARALLEL Use a power iteration that
+ *   works directly on the edge index of the graph and runs on
+ *   multiple threads, see \ref igraph_set_num_threads(). It is
+ *   meant for very large graphs, where copying the graph for the
+ *   other implementations is costly.
  */
 
 typedef enum {
     IGRAPH_PAGERANK_ALGO_POWER = 0,
     IGRAPH_PAGERANK_ALGO_ARPACK = 1,
-    IGRAPH_PAGERANK_ALGO_PRPACK = 2
+    IGRAPH_PAGERANK_ALGO_PRPACK = 2,
+    IGRAPH_PAGERANK_ALGO_PARALLEL = 3
 } igraph_pagerank_algo_t;
 
 /**
@@ -92,7 +103,9 @@ typedef enum {
  * \member niter The number of iterations to perform, integer.
  * \member eps  The algorithm will consider the calculation as complete
  *        if the difference of values between iterations change
- *        less than this value for every vertex.
+ *        less than this value for every vertex. For \c
+ *        IGRAPH_PAGERANK_ALGO_PARALLEL the sum of the absolute
+ *        differences over all vertices is compared to this value.
  */
 
 typedef struct igraph_pagerank_power_options_t {
@@ -111,6 +124,19 @@ DECLDIR int igraph_personalized_pagerank(const igraph_t *graph,
         igraph_bool_t directed, igraph_real_t damping,
         igraph_vector_t *reset,
         const igraph_vector_t *weights, void *options);
+DECLDIR int igraph_personalized_pagerank_warm(const igraph_t *graph,
+        igraph_pagerank_algo_t algo, igraph_vector_t *vector,
+        igraph_real_t *value, const igraph_vs_t vids,
+        igraph_bool_t directed, igraph_real_t damping,
+        igraph_vector_t *reset,
+        const igraph_vector_t *weights,
+        const igraph_vector_t *start,
+        igraph_integer_t *iterations, void *options);
+DECLDIR int igraph_personalized_pagerank_push(const igraph_t *graph,
+        igraph_vector_int_t *vids, igraph_vector_t *scores,
+        igraph_vs_t seeds, igraph_bool_t directed,
+        igraph_real_t damping, const igraph_vector_t *weights,
+        igraph_real_t eps);
 DECLDIR int igraph_personalized_pagerank_vs(const igraph_t *graph,
         igraph_pagerank_algo_t algo,
         igraph_vector_t *vector,
@@ -119,11 +145,59 @@ DECLDIR int igraph_personalized_pagerank_vs(const igraph_t *graph,
         igraph_vs_t reset_vids,
         const igraph_vector_t *weights, void *options);
 
+/**
+ * \struct igraph_pagerank_solver_t
+ * \brief A graph preprocessed for solving many PageRank problems
+ *
+ * This structure stores the transition probabilities of the random
+ * walk on a graph, so that the personalized PageRank can be computed
+ * for many reset vectors without processing the graph again. Use
+ * \ref igraph_pagerank_solver_init() to create it and \ref
+ * igraph_pagerank_solver_solve() to use it. The members should not be
+ * used directly.
+ *
+ * \member no_of_nodes The number of vertices.
+ * \member damping The damping factor.
+ * \member in_start The incoming transitions of vertex \c v are at
+ *    positions <code>in_start[v]</code> to
+ *    <code>in_start[v+1]-1</code> of \c in_from and \c in_prob.
+ * \member in_from The source vertices of the incoming transitions.
+ * \member in_prob The probabilities of the incoming transitions.
+ * \member dangling The vertices without outgoing edges.
+ */
+
+typedef struct igraph_pagerank_solver_t {
+    igraph_integer_t no_of_nodes;
+    igraph_real_t damping;
+    igraph_vector_int_t in_start;
+    igraph_vector_int_t in_from;
+    igraph_vector_t in_prob;
+    igraph_vector_int_t dangling;
+} igraph_pagerank_solver_t;
+
+DECLDIR int igraph_pagerank_solver_init(igraph_pagerank_solver_t *solver,
+                                        const igraph_t *graph,
+                                        igraph_bool_t directed,
+                                        igraph_real_t damping,
+                                        const igraph_vector_t *weights);
+DECLDIR void igraph_pagerank_solver_destroy(igraph_pagerank_solver_t *solver);
+DECLDIR int igraph_pagerank_solver_solve(const igraph_pagerank_solver_t *solver,
+        igraph_matrix_t *res,
+        const igraph_matrix_t *reset,
+        igraph_pagerank_power_options_t *options);
+
 DECLDIR int igraph_eigenvector_centrality(const igraph_t *graph, igraph_vector_t *vector,
         igraph_real_t *value,
         igraph_bool_t directed, igraph_bool_t scale,
         const igraph_vector_t *weights,
         igraph_arpack_options_t *options);
+DECLDIR int igraph_eigenvector_centrality_warm(const igraph_t *graph,
+        igraph_vector_t *vector,
+        igraph_real_t *value,
+        igraph_bool_t directed, igraph_bool_t scale,
+        const igraph_vector_t *weights,
+        const igraph_vector_t *start,
+        igraph_arpack_options_t *options);
 
 DECLDIR int igraph_hub_score(const igraph_t *graph, igraph_vector_t *vector,
                              igraph_real_t *value, igraph_bool_t scale,
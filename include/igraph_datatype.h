@@ -56,6 +56,10 @@ __BEGIN_DECLS
  *   queries.
  * - <b>is</b> This is basically the same as <b>os</b>, but this time
  *   for the incoming edges.
+ * - <b>mapping</b> Null pointer for ordinary graphs. For graphs read
+ *   by \ref igraph_read_graph_binary() it owns the memory that the six
+ *   vectors above are views of. Such graphs are read-only,
+ *   \ref igraph_destroy() releases the mapping instead of the vectors.
  *
  * For undirected graph, the same edge list is stored, ie. an
  * undirected edge is stored only once, and for checking whether there
@@ -63,19 +67,25 @@ __BEGIN_DECLS
  * should search for both \c from=v1, \c to=v2 and
  * \c from=v2, \c to=v1.
  *
+ * All six vectors hold native integers (\type igraph_vector_int_t),
+ * so no floating point conversion is needed when the index is
+ * traversed, and each entry takes half the space of an
+ * \type igraph_real_t.
+ *
  * The storage requirements for a graph with \c |V| vertices
  * and \c |E| edges is \c O(|E|+|V|).
  */
 typedef struct igraph_s {
     igraph_integer_t n;
     igraph_bool_t directed;
-    igraph_vector_t from;
-    igraph_vector_t to;
-    igraph_vector_t oi;
-    igraph_vector_t ii;
-    igraph_vector_t os;
-    igraph_vector_t is;
+    igraph_vector_int_t from;
+    igraph_vector_int_t to;
+    igraph_vector_int_t oi;
+    igraph_vector_int_t ii;
+    igraph_vector_int_t os;
+    igraph_vector_int_t is;
     void *attr;
+    void *mapping;
 } igraph_t;
 
 __END_DECLS
@@ -59,6 +59,7 @@ DECLDIR int igraph_read_graph_dimacs(igraph_t *graph, FILE *instream,
 DECLDIR int igraph_read_graph_graphdb(igraph_t *graph, FILE *instream,
                                       igraph_bool_t directed);
 DECLDIR int igraph_read_graph_gml(igraph_t *graph, FILE *instream);
+DECLDIR int igraph_read_graph_binary(igraph_t *graph, FILE *instream);
 DECLDIR int igraph_read_graph_dl(igraph_t *graph, FILE *instream,
                                  igraph_bool_t directed);
 
@@ -77,6 +78,7 @@ DECLDIR int igraph_write_graph_dimacs(const igraph_t *graph, FILE *outstream,
 DECLDIR int igraph_write_graph_gml(const igraph_t *graph, FILE *outstream,
                                    const igraph_vector_t *id, const char *creator);
 DECLDIR int igraph_write_graph_dot(const igraph_t *graph, FILE *outstream);
+DECLDIR int igraph_write_graph_binary(const igraph_t *graph, FILE *outstream);
 DECLDIR int igraph_write_graph_leda(const igraph_t *graph, FILE *outstream,
                                     const char* vertex_attr_name, const char* edge_attr_name);
 
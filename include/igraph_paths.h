@@ -32,8 +32,33 @@
 #include "igraph_matrix.h"
 #include "igraph_iterators.h"
 
+#include <stdio.h>
+
 __BEGIN_DECLS
 
+/**
+ * \typedef igraph_astar_heuristic_func_t
+ * Heuristic function type for A* search
+ *
+ * \ref igraph_get_shortest_path_astar() calls this function to
+ * estimate the distance of a vertex from the target of the search.
+ * The estimate must not be larger than the real distance, otherwise
+ * the path found is not always a shortest one.
+ * \param result The estimate must be stored here.
+ * \param from The id of the vertex whose distance is estimated.
+ * \param to The id of the target vertex.
+ * \param extra The extra argument that was passed to \ref
+ *   igraph_get_shortest_path_astar().
+ * \return Error code, the search stops if it is not \c IGRAPH_SUCCESS.
+ *
+ * \sa \ref igraph_astar_heuristic_euclidean()
+ */
+
+typedef int igraph_astar_heuristic_func_t(igraph_real_t *result,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        void *extra);
+
 DECLDIR int igraph_diameter(const igraph_t *graph, igraph_integer_t *res,
                             igraph_integer_t *from, igraph_integer_t *to,
                             igraph_vector_t *path,
@@ -97,23 +122,220 @@ DECLDIR int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
         igraph_integer_t to,
         const igraph_vector_t *weights,
         igraph_neimode_t mode);
+DECLDIR int igraph_shortest_paths_delta_stepping(const igraph_t *graph,
+        igraph_matrix_t *res,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_real_t delta);
+DECLDIR int igraph_get_shortest_paths_delta_stepping(const igraph_t *graph,
+        igraph_vector_ptr_t *vertices,
+        igraph_vector_ptr_t *edges,
+        igraph_integer_t from,
+        igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_real_t delta,
+        igraph_vector_long_t *predecessors,
+        igraph_vector_long_t *inbound_edges);
 DECLDIR int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
         igraph_vector_ptr_t *res,
         igraph_vector_t *nrgeo,
         igraph_integer_t from, igraph_vs_t to,
         const igraph_vector_t *weights,
         igraph_neimode_t mode);
+DECLDIR int igraph_get_shortest_path_astar(const igraph_t *graph,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_astar_heuristic_func_t *heuristic,
+        void *extra);
+DECLDIR int igraph_astar_heuristic_euclidean(igraph_real_t *result,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        void *extra);
 DECLDIR int igraph_shortest_paths_johnson(const igraph_t *graph,
         igraph_matrix_t *res,
         const igraph_vs_t from,
         const igraph_vs_t to,
         const igraph_vector_t *weights);
 
+/**
+ * \typedef igraph_shortest_paths_row_handler_t
+ * Type of functions that receive the distances from a source
+ *
+ * \ref igraph_shortest_paths_johnson_callback() calls this function
+ * once for each source vertex, in the order of the sources.
+ * \param source The id of the source vertex.
+ * \param distances The lengths of the shortest paths from \p source
+ *   to the target vertices, in the order of the targets, \c
+ *   IGRAPH_INFINITY for the unreachable ones. The vector belongs to
+ *   igraph and it is only valid during the call, copy it if needed.
+ * \param arg The extra argument that was passed to \ref
+ *   igraph_shortest_paths_johnson_callback().
+ * \return Boolean, whether to continue with the next source.
+ */
+
+typedef igraph_bool_t igraph_shortest_paths_row_handler_t(igraph_integer_t source,
+        const igraph_vector_t *distances,
+        void *arg);
+
+DECLDIR int igraph_shortest_paths_johnson_callback(const igraph_t *graph,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_shortest_paths_row_handler_t *handler,
+        void *arg);
+DECLDIR int igraph_shortest_paths_johnson_float(const igraph_t *graph,
+        float *res,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights);
+
+/**
+ * \struct igraph_contraction_hierarchy_t
+ * \brief A graph preprocessed for fast shortest path queries
+ *
+ * A contraction hierarchy stores the edges of a weighted graph and
+ * the shortcuts added to it, at their endpoint that is lower in the
+ * vertex order. Use \ref igraph_contraction_hierarchy_init() to build
+ * it from a graph or \ref igraph_contraction_hierarchy_read() to load
+ * it from a file. The members should not be used directly.
+ *
+ * \member no_of_nodes The number of vertices.
+ * \member directed Whether the hierarchy follows edge directions.
+ * \member rank The position of each vertex in the order.
+ * \member out_start The arcs leaving vertex \c v towards higher
+ *    vertices are at positions <code>out_start[v]</code> to
+ *    <code>out_start[v+1]-1</code> of the other <code>out_</code>
+ *    vectors. In undirected hierarchies these are all the arcs.
+ * \member out_head The higher endpoints of the arcs.
+ * \member out_via For a shortcut, the vertex it goes through, -1
+ *    for an edge of the graph.
+ * \member out_edge For an edge of the graph, its id, -1 for a shortcut.
+ * \member out_weight The lengths of the arcs.
+ * \member in_start Like \c out_start, for the arcs entering the
+ *    vertices from higher vertices; these vectors are empty in
+ *    undirected hierarchies.
+ * \member in_head The higher endpoints of the entering arcs.
+ * \member in_via The vertex a shortcut goes through, or -1.
+ * \member in_edge The id of an edge of the graph, or -1.
+ * \member in_weight The lengths of the entering arcs.
+ */
+
+typedef struct igraph_contraction_hierarchy_t {
+    igraph_integer_t no_of_nodes;
+    igraph_bool_t directed;
+    igraph_vector_int_t rank;
+    igraph_vector_int_t out_start;
+    igraph_vector_int_t out_head;
+    igraph_vector_int_t out_via;
+    igraph_vector_int_t out_edge;
+    igraph_vector_t out_weight;
+    igraph_vector_int_t in_start;
+    igraph_vector_int_t in_head;
+    igraph_vector_int_t in_via;
+    igraph_vector_int_t in_edge;
+    igraph_vector_t in_weight;
+} igraph_contraction_hierarchy_t;
+
+DECLDIR int igraph_contraction_hierarchy_init(igraph_contraction_hierarchy_t *ch,
+        const igraph_t *graph,
+        const igraph_vector_t *weights,
+        igraph_bool_t directed);
+DECLDIR void igraph_contraction_hierarchy_destroy(igraph_contraction_hierarchy_t *ch);
+DECLDIR int igraph_contraction_hierarchy_distance(const igraph_contraction_hierarchy_t *ch,
+        igraph_real_t *res,
+        igraph_integer_t from,
+        igraph_integer_t to);
+DECLDIR int igraph_contraction_hierarchy_get_shortest_path(
+    const igraph_contraction_hierarchy_t *ch,
+    igraph_vector_t *vertices,
+    igraph_vector_t *edges,
+    igraph_real_t *res,
+    igraph_integer_t from,
+    igraph_integer_t to);
+DECLDIR int igraph_contraction_hierarchy_distance_matrix(
+    const igraph_contraction_hierarchy_t *ch,
+    igraph_matrix_t *res,
+    const igraph_vector_t *from,
+    const igraph_vector_t *to);
+DECLDIR int igraph_contraction_hierarchy_write(const igraph_contraction_hierarchy_t *ch,
+        FILE *outstream);
+DECLDIR int igraph_contraction_hierarchy_read(igraph_contraction_hierarchy_t *ch,
+        FILE *instream);
+
+/**
+ * \struct igraph_landmark_labeling_t
+ * \brief A distance labeling of an unweighted graph
+ *
+ * A landmark labeling stores for every vertex a list of hubs and its
+ * distances to them, sorted by hub. Use \ref
+ * igraph_landmark_labeling_init() to build it from a graph or \ref
+ * igraph_landmark_labeling_read() to load it from a file. The members
+ * should not be used directly.
+ *
+ * \member no_of_nodes The number of vertices.
+ * \member directed Whether the labeling follows edge directions.
+ * \member order The vertices in the order they were used as hubs.
+ * \member out_start The label of vertex \c v is at positions
+ *    <code>out_start[v]</code> to <code>out_start[v+1]-1</code> of
+ *    \c out_hub and \c out_dist. In directed labelings it holds the
+ *    distances from the vertex to the hubs.
+ * \member out_hub The hubs of the labels, as positions in \c order.
+ * \member out_dist The distances to the hubs.
+ * \member in_start Like \c out_start, for the distances from the
+ *    hubs to the vertices; these vectors are empty in undirected
+ *    labelings.
+ * \member in_hub The hubs of the 'in' labels.
+ * \member in_dist The distances from the hubs.
+ */
+
+typedef struct igraph_landmark_labeling_t {
+    igraph_integer_t no_of_nodes;
+    igraph_bool_t directed;
+    igraph_vector_int_t order;
+    igraph_vector_int_t out_start;
+    igraph_vector_int_t out_hub;
+    igraph_vector_int_t out_dist;
+    igraph_vector_int_t in_start;
+    igraph_vector_int_t in_hub;
+    igraph_vector_int_t in_dist;
+} igraph_landmark_labeling_t;
+
+DECLDIR int igraph_landmark_labeling_init(igraph_landmark_labeling_t *ll,
+        const igraph_t *graph,
+        igraph_bool_t directed);
+DECLDIR void igraph_landmark_labeling_destroy(igraph_landmark_labeling_t *ll);
+DECLDIR int igraph_landmark_labeling_distance(const igraph_landmark_labeling_t *ll,
+        igraph_real_t *res,
+        igraph_integer_t from,
+        igraph_integer_t to);
+DECLDIR int igraph_landmark_labeling_size(const igraph_landmark_labeling_t *ll,
+        igraph_real_t *entries,
+        igraph_real_t *bytes);
+DECLDIR int igraph_landmark_labeling_write(const igraph_landmark_labeling_t *ll,
+        FILE *outstream);
+DECLDIR int igraph_landmark_labeling_read(igraph_landmark_labeling_t *ll,
+        FILE *instream);
+
 DECLDIR int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
                                        igraph_bool_t directed, igraph_bool_t unconn);
 DECLDIR int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
                                     igraph_real_t *unconnected, igraph_bool_t directed);
 
+DECLDIR int igraph_neighborhood_function_approx(const igraph_t *graph,
+        igraph_vector_t *nf,
+        igraph_vector_t *hist,
+        igraph_real_t *average_path_length,
+        igraph_real_t *effective_diameter,
+        igraph_bool_t directed,
+        igraph_integer_t log2m);
+
 DECLDIR int igraph_eccentricity(const igraph_t *graph,
                                 igraph_vector_t *res,
                                 igraph_vs_t vids,
@@ -121,6 +343,13 @@ DECLDIR int igraph_eccentricity(const igraph_t *graph,
 
 DECLDIR int igraph_radius(const igraph_t *graph, igraph_real_t *radius,
                           igraph_neimode_t mode);
+DECLDIR int igraph_diameter_radius(const igraph_t *graph,
+                                   const igraph_vector_t *weights,
+                                   igraph_real_t *diameter,
+                                   igraph_real_t *radius,
+                                   igraph_bool_t directed,
+                                   igraph_bool_t unconn,
+                                   igraph_integer_t *searches);
 
 DECLDIR int igraph_get_all_simple_paths(const igraph_t *graph,
                                         igraph_vector_int_t *res,
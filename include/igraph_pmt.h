@@ -71,9 +71,9 @@
     #define MULTIPLICITY 1
 
 #elif defined(BASE_INT)
-    #define BASE int
+    #define BASE igraph_integer_t
     #define SHORT int
-    #define OUT_FORMAT "%d"
+    #define OUT_FORMAT "%" IGRAPH_PRId
     #define ZERO 0
     #define ONE 1
     #define MULTIPLICITY 1
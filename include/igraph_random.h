@@ -51,6 +51,9 @@ typedef struct igraph_rng_type_t {
     igraph_real_t (*get_exp)(void *state, igraph_real_t rate);
     igraph_real_t (*get_gamma)(void *state, igraph_real_t shape,
                                igraph_real_t scale);
+    int (*seed_stream)(void *state, unsigned long int seed,
+                       igraph_integer_t stream);
+    void (*fill_real)(void *state, igraph_real_t *res, long int n);
 } igraph_rng_type_t;
 
 typedef struct igraph_rng_t {
@@ -65,6 +68,8 @@ DECLDIR int igraph_rng_init(igraph_rng_t *rng, const igraph_rng_type_t *type);
 DECLDIR void igraph_rng_destroy(igraph_rng_t *rng);
 
 DECLDIR int igraph_rng_seed(igraph_rng_t *rng, unsigned long int seed);
+DECLDIR int igraph_rng_seed_stream(igraph_rng_t *rng, unsigned long int seed,
+                                   igraph_integer_t stream);
 DECLDIR unsigned long int igraph_rng_max(igraph_rng_t *rng);
 DECLDIR unsigned long int igraph_rng_min(igraph_rng_t *rng);
 DECLDIR const char *igraph_rng_name(igraph_rng_t *rng);
@@ -83,6 +88,16 @@ DECLDIR igraph_real_t igraph_rng_get_exp(igraph_rng_t *rng, igraph_real_t rate);
 DECLDIR unsigned long int igraph_rng_get_int31(igraph_rng_t *rng);
 DECLDIR igraph_real_t igraph_rng_get_gamma(igraph_rng_t *rng, igraph_real_t shape,
         igraph_real_t scale);
+DECLDIR int igraph_rng_get_unif01_vector(igraph_rng_t *rng,
+        igraph_vector_t *res,
+        igraph_integer_t n);
+DECLDIR int igraph_rng_get_integer_vector(igraph_rng_t *rng,
+        igraph_vector_int_t *res,
+        igraph_integer_t n,
+        long int l, long int h);
+DECLDIR int igraph_rng_get_geom_vector(igraph_rng_t *rng,
+                                       igraph_vector_t *res,
+                                       igraph_integer_t n, igraph_real_t p);
 DECLDIR int igraph_rng_get_dirichlet(igraph_rng_t *rng,
                                      const igraph_vector_t *alpha,
                                      igraph_vector_t *result);
@@ -92,6 +107,8 @@ DECLDIR int igraph_rng_get_dirichlet(igraph_rng_t *rng,
 extern const igraph_rng_type_t igraph_rngtype_glibc2;
 extern const igraph_rng_type_t igraph_rngtype_rand;
 extern const igraph_rng_type_t igraph_rngtype_mt19937;
+extern const igraph_rng_type_t igraph_rngtype_philox4x32;
+extern const igraph_rng_type_t igraph_rngtype_xoshiro256ss;
 
 DECLDIR igraph_rng_t *igraph_rng_default(void);
 DECLDIR void igraph_rng_set_default(igraph_rng_t *rng);
@@ -33,6 +33,7 @@ __BEGIN_DECLS
 #endif
 
 #include "igraph_error.h"
+#include "igraph_config.h"
 #include <stddef.h>
 #include <math.h>
 #include <stdio.h>
@@ -40,7 +41,18 @@ __BEGIN_DECLS
 /* This is to eliminate gcc warnings about unused parameters */
 #define IGRAPH_UNUSED(x) (void)(x)
 
+#if IGRAPH_INTEGER_SIZE == 64
+#include <stdint.h>
+#include <inttypes.h>
+typedef int64_t igraph_integer_t;
+#define IGRAPH_INTEGER_MAX INT64_MAX
+#define IGRAPH_PRId PRId64
+#else
 typedef int    igraph_integer_t;
+#define IGRAPH_INTEGER_MAX 2147483647
+#define IGRAPH_PRId "d"
+#endif
+
 typedef double igraph_real_t;
 typedef int    igraph_bool_t;
 
@@ -176,6 +176,9 @@ int igraph_vector_order1(const igraph_vector_t* v,
 int igraph_vector_order1_int(const igraph_vector_t* v,
                              igraph_vector_int_t* res, igraph_real_t maxval);
 int igraph_vector_order2(igraph_vector_t *v);
+int igraph_vector_int_order(const igraph_vector_int_t* v,
+                            const igraph_vector_int_t *v2,
+                            igraph_vector_int_t* res, igraph_integer_t nodes);
 int igraph_vector_rank(const igraph_vector_t *v, igraph_vector_t *res,
                        long int nodes);
 
@@ -116,7 +116,7 @@ int igraph_adjlist_init(const igraph_t *graph, igraph_adjlist_t *al,
 
     IGRAPH_FINALLY(igraph_adjlist_destroy, al);
     for (i = 0; i < al->length; i++) {
-        int j, n;
+        long int j, n;
         IGRAPH_ALLOW_INTERRUPTION();
         IGRAPH_CHECK(igraph_neighbors(graph, &tmp, i, mode));
         n = igraph_vector_size(&tmp);
@@ -588,7 +588,7 @@ int igraph_inclist_init(const igraph_t *graph,
 
     IGRAPH_FINALLY(igraph_inclist_destroy, il);
     for (i = 0; i < il->length; i++) {
-        int j, n;
+        long int j, n;
         IGRAPH_ALLOW_INTERRUPTION();
         IGRAPH_CHECK(igraph_incident(graph, &tmp, i, mode));
         n = igraph_vector_size(&tmp);
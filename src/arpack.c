@@ -862,7 +862,7 @@ int igraph_arpack_rssolve(igraph_arpack_function_t *fun, void *extra,
     igraph_bool_t free_them = 0;
     int *select, i;
 
-    int ido = 0;
+    int ido = 0, numop = 0;
     int rvec = vectors || storage ? 1 : 0; /* calculate eigenvectors? */
     char *all = "All";
 
@@ -988,6 +988,7 @@ int igraph_arpack_rssolve(igraph_arpack_function_t *fun, void *extra,
                 IGRAPH_ERROR("ARPACK error while evaluating matrix-vector product",
                              IGRAPH_ARPACK_PROD);
             }
+            numop++;
 
         } else {
             break;
@@ -1027,7 +1028,8 @@ int igraph_arpack_rssolve(igraph_arpack_function_t *fun, void *extra,
 
     options->noiter = options->iparam[2];
     options->nconv = options->iparam[4];
-    options->numop = options->iparam[8];
+    /* The translated ARPACK code does not count the products */
+    options->numop = numop;
     options->numopb = options->iparam[9];
     options->numreo = options->iparam[10];
 
@@ -1117,7 +1119,7 @@ int igraph_arpack_rnsolve(igraph_arpack_function_t *fun, void *extra,
     igraph_bool_t free_them = 0;
     int *select, i;
 
-    int ido = 0;
+    int ido = 0, numop = 0;
     int rvec = vectors || storage ? 1 : 0;
     char *all = "All";
 
@@ -1242,6 +1244,7 @@ int igraph_arpack_rnsolve(igraph_arpack_function_t *fun, void *extra,
                 IGRAPH_ERROR("ARPACK error while evaluating matrix-vector product",
                              IGRAPH_ARPACK_PROD);
             }
+            numop++;
         } else {
             break;
         }
@@ -1280,7 +1283,8 @@ int igraph_arpack_rnsolve(igraph_arpack_function_t *fun, void *extra,
 
     options->noiter = options->iparam[2];
     options->nconv = options->iparam[4];
-    options->numop = options->iparam[8];
+    /* The translated ARPACK code does not count the products */
+    options->numop = numop;
     options->numopb = options->iparam[9];
     options->numreo = options->iparam[10];
 
@@ -0,0 +1,652 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_bfs_internal.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_threading.h"
+#include "config.h"
+
+#include <string.h>
+
+/* The search goes bottom-up when the edges of the frontier are more
+ * than 1/ALPHA of the edges of the unreached vertices, and top-down
+ * again when the frontier has less than 1/BETA of the vertices. These
+ * are the constants of Beamer, Asanovic and Patterson:
+ * Direction-optimizing breadth-first search, SC 2012.
+ *
+ * Top-down steps with a frontier of at least IGRAPH_I_BFS_GRAIN
+ * vertices run in parallel. Each thread collects the unreached
+ * neighbors of its part of the frontier, and these are merged on the
+ * calling thread. In the bottom-up steps the vertices are divided into
+ * chunks of IGRAPH_I_BFS_GRAIN, which is a multiple of 64, so every
+ * word of the bitmaps is written by a single thread. */
+
+#define IGRAPH_I_BFS_ALPHA 14
+#define IGRAPH_I_BFS_BETA 24
+#define IGRAPH_I_BFS_GRAIN 4096
+
+/* The number of edges that a top-down step follows from a vertex */
+
+static igraph_integer_t igraph_i_bfs_degree(const igraph_t *graph,
+        igraph_neimode_t mode,
+        igraph_integer_t v) {
+    igraph_integer_t d = 0;
+    if (mode & IGRAPH_OUT) {
+        d += VECTOR(graph->os)[v + 1] - VECTOR(graph->os)[v];
+    }
+    if (mode & IGRAPH_IN) {
+        d += VECTOR(graph->is)[v + 1] - VECTOR(graph->is)[v];
+    }
+    return d;
+}
+
+
+int igraph_i_bfs_init(igraph_i_bfs_t *bfs, const igraph_t *graph,
+                      igraph_neimode_t mode) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t words = (no_of_nodes + 63) / 64;
+
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    bfs->graph = graph;
+    bfs->mode = igraph_is_directed(graph) ? mode : IGRAPH_ALL;
+    bfs->no_of_nodes = no_of_nodes;
+    bfs->level = -1;
+    bfs->level_begin = bfs->level_end = 0;
+    bfs->bottom_up = 0;
+
+    IGRAPH_CHECK(igraph_vector_int_init(&bfs->dist, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bfs->dist);
+    igraph_vector_int_fill(&bfs->dist, -1);
+    IGRAPH_CHECK(igraph_vector_int_init(&bfs->order, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bfs->order);
+    IGRAPH_CHECK(igraph_vector_int_reserve(&bfs->order, no_of_nodes));
+
+    bfs->frontier = igraph_Calloc(words > 0 ? words : 1, uint64_t);
+    if (!bfs->frontier) {
+        IGRAPH_ERROR("Cannot initialize breadth-first search", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, bfs->frontier);
+    bfs->next = igraph_Calloc(words > 0 ? words : 1, uint64_t);
+    if (!bfs->next) {
+        IGRAPH_ERROR("Cannot initialize breadth-first search", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, bfs->next);
+
+    IGRAPH_CHECK(igraph_vector_ptr_init(&bfs->buffers, 0));
+
+    IGRAPH_FINALLY_CLEAN(4);
+    return 0;
+}
+
+void igraph_i_bfs_destroy(igraph_i_bfs_t *bfs) {
+    long int i, n = igraph_vector_ptr_size(&bfs->buffers);
+    for (i = 0; i < n; i++) {
+        igraph_vector_int_t *buf = VECTOR(bfs->buffers)[i];
+        igraph_vector_int_destroy(buf);
+        igraph_Free(buf);
+    }
+    igraph_vector_ptr_destroy(&bfs->buffers);
+    igraph_Free(bfs->next);
+    igraph_Free(bfs->frontier);
+    igraph_vector_int_destroy(&bfs->order);
+    igraph_vector_int_destroy(&bfs->dist);
+}
+
+/* Starts a new search, the root is the current level afterwards */
+
+int igraph_i_bfs_start(igraph_i_bfs_t *bfs, igraph_integer_t root) {
+    const igraph_t *graph = bfs->graph;
+    igraph_integer_t i, n = igraph_vector_int_size(&bfs->order);
+
+    if (root < 0 || root >= bfs->no_of_nodes) {
+        IGRAPH_ERROR("Invalid root vertex for breadth-first search", IGRAPH_EINVVID);
+    }
+
+    for (i = 0; i < n; i++) {
+        VECTOR(bfs->dist)[ VECTOR(bfs->order)[i] ] = -1;
+    }
+    igraph_vector_int_clear(&bfs->order);
+
+    bfs->unexplored = igraph_ecount(graph) * (bfs->mode == IGRAPH_ALL ? 2.0 : 1.0);
+    bfs->unexplored -= igraph_i_bfs_degree(graph, bfs->mode, root);
+    bfs->bottom_up = 0;
+    bfs->level = 0;
+    bfs->level_begin = 0;
+    bfs->level_end = 1;
+    VECTOR(bfs->dist)[root] = 0;
+    igraph_vector_int_push_back(&bfs->order, root); /* reserved */
+
+    return 0;
+}
+
+/* Top-down step on a single thread */
+
+static void igraph_i_bfs_top_down(igraph_i_bfs_t *bfs) {
+    const igraph_t *graph = bfs->graph;
+    igraph_integer_t *dist = VECTOR(bfs->dist);
+    igraph_integer_t level = bfs->level + 1;
+    igraph_integer_t i, k;
+
+    for (i = bfs->level_begin; i < bfs->level_end; i++) {
+        igraph_integer_t u = VECTOR(bfs->order)[i];
+        if (bfs->mode & IGRAPH_OUT) {
+            for (k = VECTOR(graph->os)[u]; k < VECTOR(graph->os)[u + 1]; k++) {
+                igraph_integer_t v = VECTOR(graph->to)[ VECTOR(graph->oi)[k] ];
+                if (dist[v] < 0) {
+                    dist[v] = level;
+                    igraph_vector_int_push_back(&bfs->order, v); /* reserved */
+                }
+            }
+        }
+        if (bfs->mode & IGRAPH_IN) {
+            for (k = VECTOR(graph->is)[u]; k < VECTOR(graph->is)[u + 1]; k++) {
+                igraph_integer_t v = VECTOR(graph->from)[ VECTOR(graph->ii)[k] ];
+                if (dist[v] < 0) {
+                    dist[v] = level;
+                    igraph_vector_int_push_back(&bfs->order, v); /* reserved */
+                }
+            }
+        }
+    }
+}
+
+/* Parallel top-down step: collects the unreached neighbors of a part
+   of the frontier, without modifying 'dist' */
+
+static int igraph_i_bfs_top_down_chunk(igraph_integer_t from,
+                                       igraph_integer_t to,
+                                       int thread, void *arg) {
+    igraph_i_bfs_t *bfs = arg;
+    const igraph_t *graph = bfs->graph;
+    const igraph_integer_t *dist = VECTOR(bfs->dist);
+    igraph_vector_int_t *buf = VECTOR(bfs->buffers)[thread];
+    igraph_integer_t i, k;
+
+    for (i = bfs->level_begin + from; i < bfs->level_begin + to; i++) {
+        igraph_integer_t u = VECTOR(bfs->order)[i];
+        if (bfs->mode & IGRAPH_OUT) {
+            for (k = VECTOR(graph->os)[u]; k < VECTOR(graph->os)[u + 1]; k++) {
+                igraph_integer_t v = VECTOR(graph->to)[ VECTOR(graph->oi)[k] ];
+                if (dist[v] < 0) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(buf, v));
+                }
+            }
+        }
+        if (bfs->mode & IGRAPH_IN) {
+            for (k = VECTOR(graph->is)[u]; k < VECTOR(graph->is)[u + 1]; k++) {
+                igraph_integer_t v = VECTOR(graph->from)[ VECTOR(graph->ii)[k] ];
+                if (dist[v] < 0) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(buf, v));
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_bfs_top_down_parallel(igraph_i_bfs_t *bfs) {
+    igraph_integer_t *dist = VECTOR(bfs->dist);
+    igraph_integer_t level = bfs->level + 1;
+    long int t, nthreads = igraph_get_num_threads();
+    igraph_integer_t i, n;
+
+    while (igraph_vector_ptr_size(&bfs->buffers) < nthreads) {
+        igraph_vector_int_t *buf = igraph_Calloc(1, igraph_vector_int_t);
+        if (!buf) {
+            IGRAPH_ERROR("Cannot run breadth-first search", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, buf);
+        IGRAPH_CHECK(igraph_vector_int_init(buf, 0));
+        IGRAPH_FINALLY(igraph_vector_int_destroy, buf);
+        IGRAPH_CHECK(igraph_vector_ptr_push_back(&bfs->buffers, buf));
+        IGRAPH_FINALLY_CLEAN(2);
+    }
+    for (t = 0; t < nthreads; t++) {
+        igraph_vector_int_clear(VECTOR(bfs->buffers)[t]);
+    }
+
+    IGRAPH_CHECK(igraph_parallel_for(bfs->level_end - bfs->level_begin,
+                                     IGRAPH_I_BFS_GRAIN / 4,
+                                     igraph_i_bfs_top_down_chunk, bfs));
+
+    for (t = 0; t < nthreads; t++) {
+        igraph_vector_int_t *buf = VECTOR(bfs->buffers)[t];
+        n = igraph_vector_int_size(buf);
+        for (i = 0; i < n; i++) {
+            igraph_integer_t v = VECTOR(*buf)[i];
+            if (dist[v] < 0) {
+                dist[v] = level;
+                igraph_vector_int_push_back(&bfs->order, v); /* reserved */
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Bottom-up step: every unreached vertex of the chunk looks for a
+   neighbor in the frontier. The result is the number of vertices
+   reached. */
+
+static int igraph_i_bfs_bottom_up_chunk(igraph_integer_t from,
+                                        igraph_integer_t to,
+                                        int thread, igraph_real_t *result,
+                                        void *arg) {
+    igraph_i_bfs_t *bfs = arg;
+    const igraph_t *graph = bfs->graph;
+    igraph_integer_t *dist = VECTOR(bfs->dist);
+    const uint64_t *frontier = bfs->frontier;
+    igraph_integer_t level = bfs->level + 1;
+    igraph_integer_t v, k, found = 0;
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        igraph_bool_t reached = 0;
+        if (dist[v] >= 0) {
+            continue;
+        }
+        if (bfs->mode & IGRAPH_OUT) {
+            for (k = VECTOR(graph->is)[v]; !reached && k < VECTOR(graph->is)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->from)[ VECTOR(graph->ii)[k] ];
+                reached = (frontier[u / 64] >> (u % 64)) & 1;
+            }
+        }
+        if (bfs->mode & IGRAPH_IN) {
+            for (k = VECTOR(graph->os)[v]; !reached && k < VECTOR(graph->os)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->to)[ VECTOR(graph->oi)[k] ];
+                reached = (frontier[u / 64] >> (u % 64)) & 1;
+            }
+        }
+        if (reached) {
+            dist[v] = level;
+            bfs->next[v / 64] |= (uint64_t) 1 << (v % 64);
+            found++;
+        }
+    }
+
+    *result = found;
+    return 0;
+}
+
+static int igraph_i_bfs_bottom_up(igraph_i_bfs_t *bfs) {
+    igraph_integer_t words = (bfs->no_of_nodes + 63) / 64;
+    igraph_integer_t w, i;
+    igraph_real_t found;
+
+    memset(bfs->frontier, 0, sizeof(uint64_t) * (size_t) words);
+    memset(bfs->next, 0, sizeof(uint64_t) * (size_t) words);
+    for (i = bfs->level_begin; i < bfs->level_end; i++) {
+        igraph_integer_t u = VECTOR(bfs->order)[i];
+        bfs->frontier[u / 64] |= (uint64_t) 1 << (u % 64);
+    }
+
+    IGRAPH_CHECK(igraph_parallel_reduce(bfs->no_of_nodes, IGRAPH_I_BFS_GRAIN,
+                                        igraph_i_bfs_bottom_up_chunk, bfs,
+                                        &found));
+
+    /* Append the new level to the order */
+    for (w = 0; w < words && found > 0; w++) {
+        uint64_t word = bfs->next[w];
+        while (word) {
+            int bit = 0;
+            while (!((word >> bit) & 1)) {
+                bit++;
+            }
+            word &= word - 1;
+            igraph_vector_int_push_back(&bfs->order, w * 64 + bit); /* reserved */
+            found--;
+        }
+    }
+
+    return 0;
+}
+
+/* Reaches the next level of the search. If no vertex was reached,
+   'found' is set to false and the current level is empty. */
+
+int igraph_i_bfs_next_level(igraph_i_bfs_t *bfs, igraph_bool_t *found) {
+    const igraph_t *graph = bfs->graph;
+    igraph_integer_t size = bfs->level_end - bfs->level_begin;
+    igraph_integer_t i;
+    igraph_real_t frontier_edges = 0;
+
+    for (i = bfs->level_begin; i < bfs->level_end; i++) {
+        frontier_edges += igraph_i_bfs_degree(graph, bfs->mode,
+                                              VECTOR(bfs->order)[i]);
+    }
+    if (!bfs->bottom_up) {
+        bfs->bottom_up = frontier_edges > bfs->unexplored / IGRAPH_I_BFS_ALPHA;
+    } else {
+        bfs->bottom_up = size >= bfs->no_of_nodes / IGRAPH_I_BFS_BETA;
+    }
+
+    if (bfs->bottom_up) {
+        IGRAPH_CHECK(igraph_i_bfs_bottom_up(bfs));
+    } else if (size >= IGRAPH_I_BFS_GRAIN && igraph_get_num_threads() > 1) {
+        IGRAPH_CHECK(igraph_i_bfs_top_down_parallel(bfs));
+    } else {
+        igraph_i_bfs_top_down(bfs);
+    }
+
+    bfs->level++;
+    bfs->level_begin = bfs->level_end;
+    bfs->level_end = igraph_vector_int_size(&bfs->order);
+    for (i = bfs->level_begin; i < bfs->level_end; i++) {
+        bfs->unexplored -= igraph_i_bfs_degree(graph, bfs->mode,
+                                               VECTOR(bfs->order)[i]);
+    }
+    *found = bfs->level_end > bfs->level_begin;
+
+    return 0;
+}
+
+/* Multi-source search, see igraph_bfs_internal.h and
+ * Then, Kaufmann, Chirigati, Hoang-Vu, Pham, Kemper, Neumann and Vo:
+ * The more the merrier: efficient multi-source graph traversal,
+ * VLDB 2014. */
+
+static int igraph_i_popcount64(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return (int) ((x * 0x0101010101010101ULL) >> 56);
+}
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *msbfs, const igraph_t *graph,
+                        igraph_neimode_t mode) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    size_t size = no_of_nodes > 0 ? (size_t) no_of_nodes : 1;
+
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+
+    msbfs->graph = graph;
+    msbfs->mode = igraph_is_directed(graph) ? mode : IGRAPH_ALL;
+    msbfs->no_of_nodes = no_of_nodes;
+    msbfs->level = -1;
+    msbfs->active = 0;
+    msbfs->listed = 1;
+
+    msbfs->seen = igraph_Calloc(size, uint64_t);
+    if (!msbfs->seen) {
+        IGRAPH_ERROR("Cannot initialize breadth-first search", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->seen);
+    msbfs->visit = igraph_Calloc(size, uint64_t);
+    if (!msbfs->visit) {
+        IGRAPH_ERROR("Cannot initialize breadth-first search", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->visit);
+    msbfs->next = igraph_Calloc(size, uint64_t);
+    if (!msbfs->next) {
+        IGRAPH_ERROR("Cannot initialize breadth-first search", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, msbfs->next);
+    IGRAPH_CHECK(igraph_vector_int_init(&msbfs->frontier, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &msbfs->frontier);
+    IGRAPH_CHECK(igraph_vector_int_init(&msbfs->touched, 0));
+
+    IGRAPH_FINALLY_CLEAN(4);
+    return 0;
+}
+
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *msbfs) {
+    igraph_vector_int_destroy(&msbfs->touched);
+    igraph_vector_int_destroy(&msbfs->frontier);
+    igraph_Free(msbfs->next);
+    igraph_Free(msbfs->visit);
+    igraph_Free(msbfs->seen);
+}
+
+/* Starts the searches, the k-th source gets bit k. A vertex may be
+   given several times. The sources are the current level afterwards. */
+
+int igraph_i_msbfs_start(igraph_i_msbfs_t *msbfs,
+                         const igraph_integer_t *sources, int no_of_sources) {
+    size_t size = (size_t) msbfs->no_of_nodes;
+    int k;
+
+    if (no_of_sources > IGRAPH_I_MSBFS_WIDTH) {
+        IGRAPH_ERROR("Too many sources for multi-source breadth-first search",
+                     IGRAPH_EINVAL);
+    }
+
+    memset(msbfs->seen, 0, sizeof(uint64_t) * size);
+    memset(msbfs->visit, 0, sizeof(uint64_t) * size);
+    memset(msbfs->next, 0, sizeof(uint64_t) * size);
+    igraph_vector_int_clear(&msbfs->frontier);
+
+    for (k = 0; k < no_of_sources; k++) {
+        igraph_integer_t v = sources[k];
+        if (v < 0 || v >= msbfs->no_of_nodes) {
+            IGRAPH_ERROR("Invalid source vertex for breadth-first search",
+                         IGRAPH_EINVVID);
+        }
+        if (!msbfs->visit[v]) {
+            IGRAPH_CHECK(igraph_vector_int_push_back(&msbfs->frontier, v));
+        }
+        msbfs->visit[v] |= (uint64_t) 1 << k;
+        msbfs->seen[v] |= (uint64_t) 1 << k;
+    }
+
+    msbfs->level = 0;
+    msbfs->active = igraph_vector_int_size(&msbfs->frontier);
+    msbfs->listed = 1;
+
+    return 0;
+}
+
+/* Top-down step from the list of the frontier, on a single thread */
+
+static int igraph_i_msbfs_top_down(igraph_i_msbfs_t *msbfs) {
+    const igraph_t *graph = msbfs->graph;
+    uint64_t *seen = msbfs->seen, *visit = msbfs->visit, *next = msbfs->next;
+    igraph_integer_t i, k, n = igraph_vector_int_size(&msbfs->frontier);
+    igraph_vector_int_t tmp;
+
+    igraph_vector_int_clear(&msbfs->touched);
+
+    for (i = 0; i < n; i++) {
+        igraph_integer_t v = VECTOR(msbfs->frontier)[i];
+        uint64_t bits = visit[v];
+        if (msbfs->mode & IGRAPH_OUT) {
+            for (k = VECTOR(graph->os)[v]; k < VECTOR(graph->os)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->to)[ VECTOR(graph->oi)[k] ];
+                uint64_t x = bits & ~seen[u];
+                if (x) {
+                    if (!next[u]) {
+                        IGRAPH_CHECK(igraph_vector_int_push_back(&msbfs->touched, u));
+                    }
+                    next[u] |= x;
+                }
+            }
+        }
+        if (msbfs->mode & IGRAPH_IN) {
+            for (k = VECTOR(graph->is)[v]; k < VECTOR(graph->is)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->from)[ VECTOR(graph->ii)[k] ];
+                uint64_t x = bits & ~seen[u];
+                if (x) {
+                    if (!next[u]) {
+                        IGRAPH_CHECK(igraph_vector_int_push_back(&msbfs->touched, u));
+                    }
+                    next[u] |= x;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < n; i++) {
+        visit[ VECTOR(msbfs->frontier)[i] ] = 0;
+    }
+    n = igraph_vector_int_size(&msbfs->touched);
+    for (i = 0; i < n; i++) {
+        igraph_integer_t u = VECTOR(msbfs->touched)[i];
+        seen[u] |= next[u];
+    }
+
+    msbfs->visit = next;
+    msbfs->next = visit;
+    tmp = msbfs->frontier; msbfs->frontier = msbfs->touched; msbfs->touched = tmp;
+    msbfs->active = n;
+
+    return 0;
+}
+
+/* Bottom-up step, every vertex collects the searches from its
+   neighbors in the frontier. The result is the number of vertices in
+   the new level. */
+
+static int igraph_i_msbfs_bottom_up_chunk(igraph_integer_t from,
+        igraph_integer_t to,
+        int thread, igraph_real_t *result,
+        void *arg) {
+    igraph_i_msbfs_t *msbfs = arg;
+    const igraph_t *graph = msbfs->graph;
+    uint64_t *seen = msbfs->seen, *next = msbfs->next;
+    const uint64_t *visit = msbfs->visit;
+    igraph_integer_t u, k, found = 0;
+
+    IGRAPH_UNUSED(thread);
+
+    for (u = from; u < to; u++) {
+        uint64_t unseen = ~seen[u], x = 0;
+        if (unseen) {
+            if (msbfs->mode & IGRAPH_OUT) {
+                for (k = VECTOR(graph->is)[u]; k < VECTOR(graph->is)[u + 1]; k++) {
+                    x |= visit[ VECTOR(graph->from)[ VECTOR(graph->ii)[k] ] ];
+                    if ((x & unseen) == unseen) {
+                        break;
+                    }
+                }
+            }
+            if ((msbfs->mode & IGRAPH_IN) && (x & unseen) != unseen) {
+                for (k = VECTOR(graph->os)[u]; k < VECTOR(graph->os)[u + 1]; k++) {
+                    x |= visit[ VECTOR(graph->to)[ VECTOR(graph->oi)[k] ] ];
+                    if ((x & unseen) == unseen) {
+                        break;
+                    }
+                }
+            }
+            x &= unseen;
+            seen[u] |= x;
+        }
+        next[u] = x;
+        if (x) {
+            found++;
+        }
+    }
+
+    *result = found;
+    return 0;
+}
+
+static int igraph_i_msbfs_bottom_up(igraph_i_msbfs_t *msbfs) {
+    igraph_real_t found;
+    uint64_t *tmp;
+
+    IGRAPH_CHECK(igraph_parallel_reduce(msbfs->no_of_nodes, IGRAPH_I_BFS_GRAIN,
+                                        igraph_i_msbfs_bottom_up_chunk, msbfs,
+                                        &found));
+
+    tmp = msbfs->visit; msbfs->visit = msbfs->next; msbfs->next = tmp;
+    memset(msbfs->next, 0, sizeof(uint64_t) * (size_t) msbfs->no_of_nodes);
+    msbfs->active = (igraph_integer_t) found;
+    msbfs->listed = 0;
+
+    return 0;
+}
+
+/* Reaches the next level of the searches */
+
+int igraph_i_msbfs_next_level(igraph_i_msbfs_t *msbfs, igraph_bool_t *found) {
+    igraph_integer_t v;
+
+    if (msbfs->active >= msbfs->no_of_nodes / IGRAPH_I_BFS_BETA) {
+        IGRAPH_CHECK(igraph_i_msbfs_bottom_up(msbfs));
+    } else {
+        if (!msbfs->listed) {
+            igraph_vector_int_clear(&msbfs->frontier);
+            for (v = 0; v < msbfs->no_of_nodes; v++) {
+                if (msbfs->visit[v]) {
+                    IGRAPH_CHECK(igraph_vector_int_push_back(&msbfs->frontier, v));
+                }
+            }
+            msbfs->listed = 1;
+        }
+        IGRAPH_CHECK(igraph_i_msbfs_top_down(msbfs));
+    }
+
+    msbfs->level++;
+    *found = msbfs->active > 0;
+
+    return 0;
+}
+
+/* Summarizes the current level: 'pairs' is the number of (source,
+   vertex) pairs, 'mask' has the bits of the sources that reached at
+   least one vertex, and counts[k] is the number of vertices reached by
+   the k-th source. Any of these can be a null pointer. */
+
+void igraph_i_msbfs_level_stats(const igraph_i_msbfs_t *msbfs,
+                                igraph_real_t *pairs, uint64_t *mask,
+                                igraph_real_t *counts) {
+    igraph_integer_t i, n;
+    igraph_real_t p = 0;
+    uint64_t m = 0;
+
+    if (msbfs->listed) {
+        n = igraph_vector_int_size(&msbfs->frontier);
+    } else {
+        n = msbfs->no_of_nodes;
+    }
+
+    for (i = 0; i < n; i++) {
+        uint64_t x = msbfs->visit[ msbfs->listed ? VECTOR(msbfs->frontier)[i] : i ];
+        if (!x) {
+            continue;
+        }
+        p += igraph_i_popcount64(x);
+        m |= x;
+        if (counts) {
+            int bit;
+            for (bit = 0; x; bit++, x >>= 1) {
+                if (x & 1) {
+                    counts[bit] += 1;
+                }
+            }
+        }
+    }
+
+    if (pairs) {
+        *pairs = p;
+    }
+    if (mask) {
+        *mask = m;
+    }
+}
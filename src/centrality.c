@@ -37,6 +37,9 @@
 #include "igraph_types_internal.h"
 #include "igraph_stack.h"
 #include "igraph_dqueue.h"
+#include "igraph_threading_internal.h"
+#include "igraph_bfs_internal.h"
+#include "igraph_components.h"
 #include "config.h"
 
 #include "bigint.h"
@@ -48,7 +51,38 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph,
                                         igraph_bool_t directed, igraph_real_t damping,
                                         igraph_vector_t *reset,
                                         const igraph_vector_t *weights,
+                                        const igraph_vector_t *start,
                                         igraph_arpack_options_t *options);
+int igraph_i_personalized_pagerank_parallel(const igraph_t *graph,
+        igraph_vector_t *vector,
+        igraph_real_t *value, const igraph_vs_t vids,
+        igraph_bool_t directed, igraph_real_t damping,
+        igraph_vector_t *reset,
+        const igraph_vector_t *weights,
+        const igraph_vector_t *start,
+        igraph_integer_t *iterations,
+        igraph_pagerank_power_options_t *options);
+
+/* Checks a start vector given for a warm start, it must have an element
+ * for every vertex, and it must not be all zeros. */
+
+static int igraph_i_check_start_vector(const igraph_t *graph,
+                                       const igraph_vector_t *start,
+                                       igraph_bool_t nonnegative) {
+    if (igraph_vector_size(start) != igraph_vcount(graph)) {
+        IGRAPH_ERROR("Invalid length of start vector", IGRAPH_EINVAL);
+    }
+    if (igraph_vector_size(start) > 0) {
+        if (nonnegative && igraph_vector_min(start) < 0) {
+            IGRAPH_ERROR("The start vector must not contain negative elements",
+                         IGRAPH_EINVAL);
+        }
+        if (igraph_vector_isnull(start)) {
+            IGRAPH_ERROR("The start vector must not be all zeros", IGRAPH_EINVAL);
+        }
+    }
+    return 0;
+}
 
 igraph_bool_t igraph_i_vector_mostly_negative(const igraph_vector_t *vector) {
     /* Many of the centrality measures correspond to the eigenvector of some
@@ -162,6 +196,7 @@ int igraph_i_eigenvector_centrality_loop(igraph_adjlist_t *adjlist) {
 int igraph_eigenvector_centrality_undirected(const igraph_t *graph, igraph_vector_t *vector,
         igraph_real_t *value, igraph_bool_t scale,
         const igraph_vector_t *weights,
+        const igraph_vector_t *start,
         igraph_arpack_options_t *options) {
 
     igraph_vector_t values;
@@ -208,20 +243,27 @@ int igraph_eigenvector_centrality_undirected(const igraph_t *graph, igraph_vecto
     IGRAPH_VECTOR_INIT_FINALLY(&values, 0);
     IGRAPH_MATRIX_INIT_FINALLY(&vectors, options->n, 1);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&degree, options->n);
-    IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(),
-                               IGRAPH_ALL, /*loops=*/ 0));
-    RNG_BEGIN();
-    for (i = 0; i < options->n; i++) {
-        if (VECTOR(degree)[i]) {
-            MATRIX(vectors, i, 0) = VECTOR(degree)[i] + RNG_UNIF(-1e-4, 1e-4);
-        } else {
-            MATRIX(vectors, i, 0) = 1.0;
+    if (start) {
+        /* Warm start from a previous result */
+        for (i = 0; i < options->n; i++) {
+            MATRIX(vectors, i, 0) = VECTOR(*start)[i];
+        }
+    } else {
+        IGRAPH_VECTOR_INIT_FINALLY(&degree, options->n);
+        IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(),
+                                   IGRAPH_ALL, /*loops=*/ 0));
+        RNG_BEGIN();
+        for (i = 0; i < options->n; i++) {
+            if (VECTOR(degree)[i]) {
+                MATRIX(vectors, i, 0) = VECTOR(degree)[i] + RNG_UNIF(-1e-4, 1e-4);
+            } else {
+                MATRIX(vectors, i, 0) = 1.0;
+            }
         }
+        RNG_END();
+        igraph_vector_destroy(&degree);
+        IGRAPH_FINALLY_CLEAN(1);
     }
-    RNG_END();
-    igraph_vector_destroy(&degree);
-    IGRAPH_FINALLY_CLEAN(1);
 
     options->n = igraph_vcount(graph);
     options->nev = 1;
@@ -327,6 +369,7 @@ int igraph_eigenvector_centrality_undirected(const igraph_t *graph, igraph_vecto
 int igraph_eigenvector_centrality_directed(const igraph_t *graph, igraph_vector_t *vector,
         igraph_real_t *value, igraph_bool_t scale,
         const igraph_vector_t *weights,
+        const igraph_vector_t *start,
         igraph_arpack_options_t *options) {
 
     igraph_matrix_t values;
@@ -404,20 +447,27 @@ int igraph_eigenvector_centrality_directed(const igraph_t *graph, igraph_vector_
     IGRAPH_MATRIX_INIT_FINALLY(&values, 0, 0);
     IGRAPH_MATRIX_INIT_FINALLY(&vectors, options->n, 1);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&indegree, options->n);
-    IGRAPH_CHECK(igraph_strength(graph, &indegree, igraph_vss_all(),
-                                 IGRAPH_IN, /*loops=*/ 1, weights));
-    RNG_BEGIN();
-    for (i = 0; i < options->n; i++) {
-        if (VECTOR(indegree)[i]) {
-            MATRIX(vectors, i, 0) = VECTOR(indegree)[i] + RNG_UNIF(-1e-4, 1e-4);
-        } else {
-            MATRIX(vectors, i, 0) = 1.0;
+    if (start) {
+        /* Warm start from a previous result */
+        for (i = 0; i < options->n; i++) {
+            MATRIX(vectors, i, 0) = VECTOR(*start)[i];
+        }
+    } else {
+        IGRAPH_VECTOR_INIT_FINALLY(&indegree, options->n);
+        IGRAPH_CHECK(igraph_strength(graph, &indegree, igraph_vss_all(),
+                                     IGRAPH_IN, /*loops=*/ 1, weights));
+        RNG_BEGIN();
+        for (i = 0; i < options->n; i++) {
+            if (VECTOR(indegree)[i]) {
+                MATRIX(vectors, i, 0) = VECTOR(indegree)[i] + RNG_UNIF(-1e-4, 1e-4);
+            } else {
+                MATRIX(vectors, i, 0) = 1.0;
+            }
         }
+        RNG_END();
+        igraph_vector_destroy(&indegree);
+        IGRAPH_FINALLY_CLEAN(1);
     }
-    RNG_END();
-    igraph_vector_destroy(&indegree);
-    IGRAPH_FINALLY_CLEAN(1);
 
     if (!weights) {
         igraph_adjlist_t adjlist;
@@ -564,13 +614,76 @@ int igraph_eigenvector_centrality(const igraph_t *graph,
                                   igraph_bool_t directed, igraph_bool_t scale,
                                   const igraph_vector_t *weights,
                                   igraph_arpack_options_t *options) {
+    return igraph_eigenvector_centrality_warm(graph, vector, value, directed,
+            scale, weights, /* start= */ 0,
+            options);
+}
+
+/**
+ * \function igraph_eigenvector_centrality_warm
+ * Eigenvector centrality, starting from a previous result
+ *
+ * This function is the same as \ref igraph_eigenvector_centrality(),
+ * but ARPACK starts from the given vector instead of the degrees of
+ * the vertices, e.g. from the result for the graph before a few
+ * edges were added or removed.
+ *
+ * </para><para>
+ * Do not expect large savings: ARPACK builds a full Krylov basis of
+ * <code>ncv</code> vectors before it checks for convergence, and the
+ * number of restarts depends mostly on the spectral gap of the graph,
+ * not on the start vector. A warm start usually saves a few
+ * matrix-vector multiplications, and sometimes none at all.
+ *
+ * \param graph The input graph. It might be directed.
+ * \param vector Pointer to an initialized vector, it will be resized
+ *     as needed. The result of the computation is stored here. It can
+ *     be a null pointer, then it is ignored. It may be the same
+ *     vector as \p start.
+ * \param value If not a null pointer, then the eigenvalue
+ *     corresponding to the found eigenvector is stored here.
+ * \param directed Boolean scalar, whether to consider edge directions
+ *     in a directed graph. It is ignored for undirected graphs.
+ * \param scale If not zero then the result will be scaled such that
+ *     the absolute value of the maximum centrality is one.
+ * \param weights A null pointer (=no edge weights), or a vector
+ *     giving the weights of the edges.
+ * \param start The start vector, typically the result of a previous
+ *     call, scaled or not. It must have an element for each vertex,
+ *     and it must not be all zeros. If it is a null pointer, then
+ *     this function is the same as \ref igraph_eigenvector_centrality().
+ * \param options Options to ARPACK. See \ref igraph_arpack_options_t
+ *    for details. Note that the function overwrites the
+ *    <code>n</code> (number of vertices) parameter. The number of
+ *    iterations and matrix-vector multiplications ARPACK needed is
+ *    stored in its <code>noiter</code> and <code>numop</code> members.
+ * \return Error code.
+ *
+ * Time complexity: depends on the input graph and on the start
+ * vector, usually it is O(|V|+|E|).
+ *
+ * \sa \ref igraph_eigenvector_centrality(), \ref
+ * igraph_personalized_pagerank_warm().
+ */
+
+int igraph_eigenvector_centrality_warm(const igraph_t *graph,
+                                       igraph_vector_t *vector,
+                                       igraph_real_t *value,
+                                       igraph_bool_t directed, igraph_bool_t scale,
+                                       const igraph_vector_t *weights,
+                                       const igraph_vector_t *start,
+                                       igraph_arpack_options_t *options) {
+
+    if (start) {
+        IGRAPH_CHECK(igraph_i_check_start_vector(graph, start, /* nonnegative= */ 0));
+    }
 
     if (directed && igraph_is_directed(graph)) {
         return igraph_eigenvector_centrality_directed(graph, vector, value,
-                scale, weights, options);
+                scale, weights, start, options);
     } else {
         return igraph_eigenvector_centrality_undirected(graph, vector, value,
-                scale, weights, options);
+                scale, weights, start, options);
     }
 }
 
@@ -1074,6 +1187,16 @@ int igraph_i_pagerank2(igraph_real_t *to, const igraph_real_t *from,
  * see https://github.com/dgleich/prpack .
  *
  * </para><para>
+ * The fourth implementation, \c IGRAPH_PAGERANK_ALGO_PARALLEL, is a
+ * power iteration for very large graphs. It reads the edges directly
+ * from the graph, without building an adjacency list or a copy of
+ * the graph, and it uses multiple threads if they were enabled with
+ * \ref igraph_set_num_threads(). The result does not depend on the
+ * number of threads. Random walkers on vertices without outgoing
+ * edges jump according to the reset distribution. Negative weights
+ * are not allowed.
+ *
+ * </para><para>
  * Please note that the PageRank of a given vertex depends on the PageRank
  * of all other vertices, so even if you want to calculate the PageRank for
  * only some of the vertices, all of them must be calculated. Requesting
@@ -1097,7 +1220,7 @@ int igraph_i_pagerank2(igraph_real_t *to, const igraph_real_t *from,
  * \param graph The graph object.
  * \param algo The PageRank implementation to use. Possible values:
  *    \c IGRAPH_PAGERANK_ALGO_POWER, \c IGRAPH_PAGERANK_ALGO_ARPACK,
- *    \c IGRAPH_PAGERANK_ALGO_PRPACK.
+ *    \c IGRAPH_PAGERANK_ALGO_PRPACK, \c IGRAPH_PAGERANK_ALGO_PARALLEL.
  * \param vector Pointer to an initialized vector, the result is
  *    stored here. It is resized as needed.
  * \param value Pointer to a real variable, the eigenvalue
@@ -1112,7 +1235,10 @@ int igraph_i_pagerank2(igraph_real_t *to, const igraph_real_t *from,
  *    as the number of edges.
  * \param options Options to the power method or ARPACK. For the power
  *    method, \c IGRAPH_PAGERANK_ALGO_POWER it must be a pointer to
- *    a \ref igraph_pagerank_power_options_t object.
+ *    a \ref igraph_pagerank_power_options_t object. For \c
+ *    IGRAPH_PAGERANK_ALGO_PARALLEL it is a pointer to a \ref
+ *    igraph_pagerank_power_options_t object too, or a null pointer
+ *    for 1000 iterations at most and a tolerance of 1e-10.
  *    For \c IGRAPH_PAGERANK_ALGO_ARPACK it must be a pointer to an
  *    \ref igraph_arpack_options_t object. See \ref igraph_arpack_options_t
  *    for details. Note that the function overwrites the
@@ -1174,7 +1300,7 @@ int igraph_pagerank(const igraph_t *graph, igraph_pagerank_algo_t algo,
  * \param graph The graph object.
  * \param algo The PageRank implementation to use. Possible values:
  *    \c IGRAPH_PAGERANK_ALGO_POWER, \c IGRAPH_PAGERANK_ALGO_ARPACK,
- *    \c IGRAPH_PAGERANK_ALGO_PRPACK.
+ *    \c IGRAPH_PAGERANK_ALGO_PRPACK, \c IGRAPH_PAGERANK_ALGO_PARALLEL.
  * \param vector Pointer to an initialized vector, the result is
  *    stored here. It is resized as needed.
  * \param value Pointer to a real variable, the eigenvalue
@@ -1190,7 +1316,10 @@ int igraph_pagerank(const igraph_t *graph, igraph_pagerank_algo_t algo,
  *    as the number of edges.
  * \param options Options to the power method or ARPACK. For the power
  *    method, \c IGRAPH_PAGERANK_ALGO_POWER it must be a pointer to
- *    a \ref igraph_pagerank_power_options_t object.
+ *    a \ref igraph_pagerank_power_options_t object. For \c
+ *    IGRAPH_PAGERANK_ALGO_PARALLEL it is a pointer to a \ref
+ *    igraph_pagerank_power_options_t object too, or a null pointer
+ *    for 1000 iterations at most and a tolerance of 1e-10.
  *    For \c IGRAPH_PAGERANK_ALGO_ARPACK it must be a pointer to an
  *    \ref igraph_arpack_options_t object. See \ref igraph_arpack_options_t
  *    for details. Note that the function overwrites the
@@ -1265,7 +1394,7 @@ int igraph_personalized_pagerank_vs(const igraph_t *graph,
  * \param graph The graph object.
  * \param algo The PageRank implementation to use. Possible values:
  *    \c IGRAPH_PAGERANK_ALGO_POWER, \c IGRAPH_PAGERANK_ALGO_ARPACK,
- *    \c IGRAPH_PAGERANK_ALGO_PRPACK.
+ *    \c IGRAPH_PAGERANK_ALGO_PRPACK, \c IGRAPH_PAGERANK_ALGO_PARALLEL.
  * \param vector Pointer to an initialized vector, the result is
  *    stored here. It is resized as needed.
  * \param value Pointer to a real variable, the eigenvalue
@@ -1284,7 +1413,10 @@ int igraph_personalized_pagerank_vs(const igraph_t *graph,
  *    as the number of edges.
  * \param options Options to the power method or ARPACK. For the power
  *    method, \c IGRAPH_PAGERANK_ALGO_POWER it must be a pointer to
- *    a \ref igraph_pagerank_power_options_t object.
+ *    a \ref igraph_pagerank_power_options_t object. For \c
+ *    IGRAPH_PAGERANK_ALGO_PARALLEL it is a pointer to a \ref
+ *    igraph_pagerank_power_options_t object too, or a null pointer
+ *    for 1000 iterations at most and a tolerance of 1e-10.
  *    For \c IGRAPH_PAGERANK_ALGO_ARPACK it must be a pointer to an
  *    \ref igraph_arpack_options_t object. See \ref igraph_arpack_options_t
  *    for details. Note that the function overwrites the
@@ -1327,11 +1459,17 @@ int igraph_personalized_pagerank(const igraph_t *graph,
         igraph_arpack_options_t *o = (igraph_arpack_options_t*) options;
         return igraph_personalized_pagerank_arpack(graph, vector, value, vids,
                 directed, damping, reset,
-                weights, o);
+                weights, /* start= */ 0, o);
     } else if (algo == IGRAPH_PAGERANK_ALGO_PRPACK) {
         return igraph_personalized_pagerank_prpack(graph, vector, value, vids,
                 directed, damping, reset,
                 weights);
+    } else if (algo == IGRAPH_PAGERANK_ALGO_PARALLEL) {
+        igraph_pagerank_power_options_t *o =
+            (igraph_pagerank_power_options_t *) options;
+        return igraph_i_personalized_pagerank_parallel(graph, vector, value, vids,
+                directed, damping, reset,
+                weights, /* start= */ 0, /* iterations= */ 0, o);
     } else {
         IGRAPH_ERROR("Unknown PageRank algorithm", IGRAPH_EINVAL);
     }
@@ -1339,6 +1477,436 @@ int igraph_personalized_pagerank(const igraph_t *graph,
     return 0;
 }
 
+/**
+ * \function igraph_personalized_pagerank_warm
+ * \brief Personalized PageRank, starting from a previous result.
+ *
+ * This function is the same as \ref igraph_personalized_pagerank(),
+ * but the iteration starts from the given vector, instead of the
+ * degrees of the vertices (ARPACK) or the reset distribution
+ * (parallel power iteration). If the graph changed only a little
+ * since \p start was computed, e.g. a few edges were added or
+ * removed, then the power iteration needs fewer iterations than
+ * without a warm start.
+ *
+ * </para><para>
+ * How many fewer depends on the graph. The power iteration converges
+ * geometrically, so it saves about the iterations needed to get from
+ * the usual start vector as close to the result as \p start is. This
+ * ranges from a few iterations to about half of them, the fewer edges
+ * changed, the more. ARPACK builds a full Krylov basis of
+ * <code>ncv</code> vectors before it checks for convergence, so the
+ * savings are smaller and depend on the spectral gap of the graph; a
+ * warm start may even need a few more matrix-vector multiplications.
+ *
+ * </para><para>
+ * Only the \c IGRAPH_PAGERANK_ALGO_ARPACK and \c
+ * IGRAPH_PAGERANK_ALGO_PARALLEL implementations support a start
+ * vector.
+ *
+ * \param graph The graph object.
+ * \param algo The PageRank implementation to use, \c
+ *    IGRAPH_PAGERANK_ALGO_ARPACK or \c IGRAPH_PAGERANK_ALGO_PARALLEL.
+ * \param vector Pointer to an initialized vector, the result is
+ *    stored here. It is resized as needed. It may be the same vector
+ *    as \p start.
+ * \param value Pointer to a real variable, the eigenvalue
+ *    corresponding to the PageRank vector is stored here. It should
+ *    be always exactly one.
+ * \param vids The vertex ids for which the PageRank is returned.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor ("d" in the original paper)
+ * \param reset The probability distribution over the vertices used when
+ *    resetting the random walk, or a null pointer for the uniform
+ *    distribution, see \ref igraph_personalized_pagerank().
+ * \param weights Optional edge weights, it is either a null pointer,
+ *    then the edges are not weighted, or a vector of the same length
+ *    as the number of edges.
+ * \param start The start vector, typically the PageRank of all the
+ *    vertices from a previous call. It must have a non-negative
+ *    element for each vertex, and it must not be all zeros; it does
+ *    not need to be normalized. If it is a null pointer, then the
+ *    usual start vector is used.
+ * \param iterations If not a null pointer, the number of iterations
+ *    is stored here. For ARPACK this is the number of matrix-vector
+ *    multiplications, each of which costs about as much as an
+ *    iteration of the power method.
+ * \param options Options to ARPACK (an \ref igraph_arpack_options_t
+ *    object) or to the power method (an \ref
+ *    igraph_pagerank_power_options_t object or a null pointer), see
+ *    \ref igraph_personalized_pagerank().
+ * \return Error code:
+ *         \c IGRAPH_EINVAL, invalid start vector, or any error of
+ *         \ref igraph_personalized_pagerank();
+ *         \c IGRAPH_UNIMPLEMENTED, the chosen implementation does
+ *         not support starting from a given vector.
+ *
+ * Time complexity: depends on the input graph and on the start
+ * vector, usually it is O(|E|) per iteration.
+ *
+ * \sa \ref igraph_personalized_pagerank(), \ref
+ * igraph_eigenvector_centrality_warm().
+ */
+
+int igraph_personalized_pagerank_warm(const igraph_t *graph,
+                                      igraph_pagerank_algo_t algo, igraph_vector_t *vector,
+                                      igraph_real_t *value, const igraph_vs_t vids,
+                                      igraph_bool_t directed, igraph_real_t damping,
+                                      igraph_vector_t *reset,
+                                      const igraph_vector_t *weights,
+                                      const igraph_vector_t *start,
+                                      igraph_integer_t *iterations,
+                                      void *options) {
+
+    if (start) {
+        IGRAPH_CHECK(igraph_i_check_start_vector(graph, start, /* nonnegative= */ 1));
+    }
+
+    if (algo == IGRAPH_PAGERANK_ALGO_ARPACK) {
+        igraph_arpack_options_t *o = (igraph_arpack_options_t*) options;
+        IGRAPH_CHECK(igraph_personalized_pagerank_arpack(graph, vector, value, vids,
+                     directed, damping, reset,
+                     weights, start, o));
+        if (iterations) {
+            *iterations = o->numop;
+        }
+    } else if (algo == IGRAPH_PAGERANK_ALGO_PARALLEL) {
+        igraph_pagerank_power_options_t *o =
+            (igraph_pagerank_power_options_t *) options;
+        IGRAPH_CHECK(igraph_i_personalized_pagerank_parallel(graph, vector, value, vids,
+                     directed, damping, reset,
+                     weights, start, iterations, o));
+    } else {
+        IGRAPH_ERROR("This PageRank implementation cannot start from a given vector",
+                     IGRAPH_UNIMPLEMENTED);
+    }
+
+    return 0;
+}
+
+/* The local push algorithm of igraph_personalized_pagerank_push()
+ * touches only the vertices around the seeds, so it keeps its state
+ * in dense vectors indexed by "slots", and a hash table with open
+ * addressing maps the vertex ids to the slots. */
+
+typedef struct igraph_i_ppr_push_t {
+    igraph_vector_int_t keys;     /* hash table: vertex ids, -1 if empty */
+    igraph_vector_int_t slots;    /* hash table: slot of the vertex */
+    igraph_vector_int_t vertex;   /* vertex id of the slot */
+    igraph_vector_t p;            /* approximate PageRank of the slot */
+    igraph_vector_t r;            /* residual of the slot */
+    igraph_vector_bool_t queued;
+} igraph_i_ppr_push_t;
+
+static void igraph_i_ppr_push_destroy(igraph_i_ppr_push_t *state) {
+    igraph_vector_bool_destroy(&state->queued);
+    igraph_vector_destroy(&state->r);
+    igraph_vector_destroy(&state->p);
+    igraph_vector_int_destroy(&state->vertex);
+    igraph_vector_int_destroy(&state->slots);
+    igraph_vector_int_destroy(&state->keys);
+}
+
+static int igraph_i_ppr_push_init(igraph_i_ppr_push_t *state) {
+    IGRAPH_CHECK(igraph_vector_int_init(&state->keys, 64));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &state->keys);
+    IGRAPH_CHECK(igraph_vector_int_init(&state->slots, 64));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &state->slots);
+    IGRAPH_CHECK(igraph_vector_int_init(&state->vertex, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &state->vertex);
+    IGRAPH_VECTOR_INIT_FINALLY(&state->p, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&state->r, 0);
+    IGRAPH_CHECK(igraph_vector_bool_init(&state->queued, 0));
+    igraph_vector_int_fill(&state->keys, -1);
+    IGRAPH_FINALLY_CLEAN(5);
+    return 0;
+}
+
+static igraph_integer_t igraph_i_ppr_push_hash(igraph_integer_t vertex,
+        igraph_integer_t mask) {
+    return (igraph_integer_t) (((unsigned long int) vertex * 2654435761UL) & mask);
+}
+
+/* Returns the slot of a vertex, creating a new slot if needed */
+
+static int igraph_i_ppr_push_slot(igraph_i_ppr_push_t *state,
+                                  igraph_integer_t vertex,
+                                  igraph_integer_t *slot) {
+    igraph_integer_t capacity = igraph_vector_int_size(&state->keys);
+    igraph_integer_t mask = capacity - 1;
+    igraph_integer_t h = igraph_i_ppr_push_hash(vertex, mask);
+    igraph_integer_t size;
+
+    while (VECTOR(state->keys)[h] != -1) {
+        if (VECTOR(state->keys)[h] == vertex) {
+            *slot = VECTOR(state->slots)[h];
+            return 0;
+        }
+        h = (h + 1) & mask;
+    }
+
+    size = igraph_vector_int_size(&state->vertex);
+    IGRAPH_CHECK(igraph_vector_int_push_back(&state->vertex, vertex));
+    IGRAPH_CHECK(igraph_vector_push_back(&state->p, 0.0));
+    IGRAPH_CHECK(igraph_vector_push_back(&state->r, 0.0));
+    IGRAPH_CHECK(igraph_vector_bool_push_back(&state->queued, 0));
+    VECTOR(state->keys)[h] = vertex;
+    VECTOR(state->slots)[h] = size;
+    *slot = size;
+
+    /* Keep the table at most half full */
+    if (2 * (size + 1) > capacity) {
+        igraph_integer_t i;
+        capacity *= 2;
+        mask = capacity - 1;
+        IGRAPH_CHECK(igraph_vector_int_resize(&state->keys, capacity));
+        IGRAPH_CHECK(igraph_vector_int_resize(&state->slots, capacity));
+        igraph_vector_int_fill(&state->keys, -1);
+        for (i = 0; i <= size; i++) {
+            h = igraph_i_ppr_push_hash(VECTOR(state->vertex)[i], mask);
+            while (VECTOR(state->keys)[h] != -1) {
+                h = (h + 1) & mask;
+            }
+            VECTOR(state->keys)[h] = VECTOR(state->vertex)[i];
+            VECTOR(state->slots)[h] = i;
+        }
+    }
+
+    return 0;
+}
+
+/* Adds to the residual of a vertex, and queues it if the residual
+ * reaches the threshold */
+
+static int igraph_i_ppr_push_add(const igraph_t *graph,
+                                 igraph_i_ppr_push_t *state,
+                                 igraph_dqueue_int_t *queue,
+                                 igraph_integer_t vertex, igraph_real_t amount,
+                                 igraph_bool_t directed, igraph_real_t eps) {
+    igraph_integer_t slot, degree;
+
+    IGRAPH_CHECK(igraph_i_ppr_push_slot(state, vertex, &slot));
+    VECTOR(state->r)[slot] += amount;
+    if (!VECTOR(state->queued)[slot]) {
+        degree = VECTOR(graph->os)[vertex + 1] - VECTOR(graph->os)[vertex];
+        if (!directed) {
+            degree += VECTOR(graph->is)[vertex + 1] - VECTOR(graph->is)[vertex];
+        }
+        if (VECTOR(state->r)[slot] >= eps * (degree > 0 ? degree : 1)) {
+            IGRAPH_CHECK(igraph_dqueue_int_push(queue, slot));
+            VECTOR(state->queued)[slot] = 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_personalized_pagerank_push
+ * \brief Approximate personalized PageRank from a few seed vertices.
+ *
+ * This function approximates the personalized PageRank with the same
+ * reset distribution as \ref igraph_personalized_pagerank_vs(), using
+ * the local "push" algorithm of Andersen, Chung and Lang. Each vertex
+ * has an estimate and a residual; initially the residual of the seeds
+ * is one in total. Pushing a vertex moves <code>1-damping</code> of
+ * its residual to its estimate, and spreads the rest among the
+ * residuals of its out-neighbors. A vertex is pushed while its
+ * residual is at least \p eps times its out-degree.
+ *
+ * </para><para>
+ * The algorithm only visits the vertices close to the seeds, and its
+ * running time does not depend on the size of the graph, only on \p
+ * eps and on the neighborhood of the seeds: it pushes at most
+ * 1/((1-damping) eps) times. This makes it suitable for answering
+ * many queries with a few seeds each on a large graph. The estimate
+ * never exceeds the exact personalized PageRank; the error is at most
+ * \p eps times the degree for undirected graphs.
+ *
+ * </para><para>
+ * Random walkers on vertices without outgoing edges restart from the
+ * seeds, as in \c IGRAPH_PAGERANK_ALGO_ARPACK.
+ *
+ * </para><para>
+ * Reference:
+ * Reid Andersen, Fan Chung and Kevin Lang: Local graph partitioning
+ * using PageRank vectors. Proceedings of the 47th Annual IEEE Symposium
+ * on Foundations of Computer Science (FOCS), 475-486, 2006.
+ *
+ * \param graph The graph object.
+ * \param vids An initialized integer vector, the ids of the vertices
+ *    with a non-zero estimate are stored here, in decreasing order of
+ *    their estimates.
+ * \param scores An initialized vector, the estimates of the vertices
+ *    in \p vids are stored here.
+ * \param seeds The vertices to restart the random walk from, chosen
+ *    uniformly. A vertex may be given several times, this increases
+ *    its probability.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor, it must be at least zero and
+ *    smaller than one.
+ * \param weights Optional non-negative edge weights, or a null
+ *    pointer for an unweighted graph.
+ * \param eps The residual tolerance, a positive number. Smaller
+ *    values give more accurate results, but need more time.
+ * \return Error code:
+ *         \c IGRAPH_EINVAL, invalid argument, e.g. an empty seed
+ *         set or negative weights;
+ *         \c IGRAPH_EINVVID, invalid vertex id in \p seeds.
+ *
+ * Time complexity: O(d/((1-damping) eps)) where d is the maximum
+ * degree of the visited vertices.
+ *
+ * \sa \ref igraph_personalized_pagerank_vs() for the exact result.
+ */
+
+int igraph_personalized_pagerank_push(const igraph_t *graph,
+                                      igraph_vector_int_t *vids,
+                                      igraph_vector_t *scores,
+                                      igraph_vs_t seeds,
+                                      igraph_bool_t directed,
+                                      igraph_real_t damping,
+                                      const igraph_vector_t *weights,
+                                      igraph_real_t eps) {
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_i_ppr_push_t state;
+    igraph_dqueue_int_t queue;
+    igraph_vector_int_t seedvec;
+    igraph_vector_t order;
+    igraph_vit_t vit;
+    igraph_integer_t i, k, nseeds, found;
+
+    directed = directed && igraph_is_directed(graph);
+
+    if (damping < 0 || damping >= 1) {
+        IGRAPH_ERROR("Invalid damping factor", IGRAPH_EINVAL);
+    }
+    if (eps <= 0) {
+        IGRAPH_ERROR("Invalid residual tolerance", IGRAPH_EINVAL);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Invalid length of weights vector when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+            IGRAPH_ERROR("Weights must not be negative when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_init(&seedvec, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &seedvec);
+    IGRAPH_CHECK(igraph_vit_create(graph, seeds, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    for (; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit)) {
+        IGRAPH_CHECK(igraph_vector_int_push_back(&seedvec, IGRAPH_VIT_GET(vit)));
+    }
+    igraph_vit_destroy(&vit);
+    IGRAPH_FINALLY_CLEAN(1);
+    nseeds = igraph_vector_int_size(&seedvec);
+    if (nseeds == 0) {
+        IGRAPH_ERROR("The seed set must not be empty", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_i_ppr_push_init(&state));
+    IGRAPH_FINALLY(igraph_i_ppr_push_destroy, &state);
+    IGRAPH_CHECK(igraph_dqueue_int_init(&queue, 64));
+    IGRAPH_FINALLY(igraph_dqueue_int_destroy, &queue);
+
+    for (i = 0; i < nseeds; i++) {
+        IGRAPH_CHECK(igraph_i_ppr_push_add(graph, &state, &queue,
+                                           VECTOR(seedvec)[i], 1.0 / nseeds,
+                                           directed, eps));
+    }
+
+    while (!igraph_dqueue_int_empty(&queue)) {
+        igraph_integer_t slot = igraph_dqueue_int_pop(&queue);
+        igraph_integer_t u = VECTOR(state.vertex)[slot];
+        igraph_integer_t os = VECTOR(graph->os)[u], oe = VECTOR(graph->os)[u + 1];
+        igraph_integer_t is = VECTOR(graph->is)[u], ie = VECTOR(graph->is)[u + 1];
+        igraph_real_t ru = VECTOR(state.r)[slot], mass, strength;
+
+        VECTOR(state.r)[slot] = 0.0;
+        VECTOR(state.queued)[slot] = 0;
+        VECTOR(state.p)[slot] += (1 - damping) * ru;
+        mass = damping * ru;
+
+        if (weights) {
+            strength = 0.0;
+            for (k = os; k < oe; k++) {
+                strength += VECTOR(*weights)[ VECTOR(graph->oi)[k] ];
+            }
+            if (!directed) {
+                for (k = is; k < ie; k++) {
+                    strength += VECTOR(*weights)[ VECTOR(graph->ii)[k] ];
+                }
+            }
+        } else {
+            strength = (oe - os) + (directed ? 0 : ie - is);
+        }
+
+        if (strength == 0) {
+            /* No outgoing edges, restart from the seeds */
+            for (i = 0; i < nseeds; i++) {
+                IGRAPH_CHECK(igraph_i_ppr_push_add(graph, &state, &queue,
+                                                   VECTOR(seedvec)[i], mass / nseeds,
+                                                   directed, eps));
+            }
+            continue;
+        }
+
+        for (k = os; k < oe; k++) {
+            igraph_integer_t e = VECTOR(graph->oi)[k];
+            igraph_real_t w = weights ? VECTOR(*weights)[e] : 1.0;
+            if (w > 0) {
+                IGRAPH_CHECK(igraph_i_ppr_push_add(graph, &state, &queue,
+                                                   VECTOR(graph->to)[e],
+                                                   mass * w / strength,
+                                                   directed, eps));
+            }
+        }
+        if (!directed) {
+            for (k = is; k < ie; k++) {
+                igraph_integer_t e = VECTOR(graph->ii)[k];
+                igraph_real_t w = weights ? VECTOR(*weights)[e] : 1.0;
+                if (w > 0) {
+                    IGRAPH_CHECK(igraph_i_ppr_push_add(graph, &state, &queue,
+                                                       VECTOR(graph->from)[e],
+                                                       mass * w / strength,
+                                                       directed, eps));
+                }
+            }
+        }
+    }
+
+    /* Collect the vertices with a non-zero estimate, best first */
+    IGRAPH_VECTOR_INIT_FINALLY(&order, 0);
+    IGRAPH_CHECK(igraph_vector_qsort_ind(&state.p, &order, /* descending= */ 1));
+    for (found = 0; found < igraph_vector_size(&order); found++) {
+        if (VECTOR(state.p)[ (long int) VECTOR(order)[found] ] <= 0) {
+            break;
+        }
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(vids, found));
+    IGRAPH_CHECK(igraph_vector_resize(scores, found));
+    for (i = 0; i < found; i++) {
+        igraph_integer_t slot = (igraph_integer_t) VECTOR(order)[i];
+        VECTOR(*vids)[i] = VECTOR(state.vertex)[slot];
+        VECTOR(*scores)[i] = VECTOR(state.p)[slot];
+    }
+
+    igraph_vector_destroy(&order);
+    igraph_dqueue_int_destroy(&queue);
+    igraph_i_ppr_push_destroy(&state);
+    igraph_vector_int_destroy(&seedvec);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return 0;
+}
+
 /*
  * ARPACK-based implementation of \c igraph_personalized_pagerank.
  *
@@ -1349,6 +1917,7 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
                                         igraph_bool_t directed, igraph_real_t damping,
                                         igraph_vector_t *reset,
                                         const igraph_vector_t *weights,
+                                        const igraph_vector_t *start,
                                         igraph_arpack_options_t *options) {
     igraph_matrix_t values;
     igraph_matrix_t vectors;
@@ -1448,9 +2017,12 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
         IGRAPH_CHECK(igraph_degree(graph, &indegree, igraph_vss_all(),
                                    directed ? IGRAPH_IN : IGRAPH_ALL, /*loops=*/ 0));
         /* Set up an appropriate starting vector. We start from the in-degrees
-         * plus some small random noise to avoid convergence problems */
+         * plus some small random noise to avoid convergence problems, or
+         * from the given vector */
         for (i = 0; i < options->n; i++) {
-            if (VECTOR(indegree)[i]) {
+            if (start) {
+                MATRIX(vectors, i, 0) = VECTOR(*start)[i];
+            } else if (VECTOR(indegree)[i]) {
                 MATRIX(vectors, i, 0) = VECTOR(indegree)[i] + RNG_UNIF(-1e-4, 1e-4);
             } else {
                 MATRIX(vectors, i, 0) = 1;
@@ -1495,9 +2067,12 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
             }
         }
         /* Set up an appropriate starting vector. We start from the in-degrees
-         * plus some small random noise to avoid convergence problems */
+         * plus some small random noise to avoid convergence problems, or
+         * from the given vector */
         for (i = 0; i < options->n; i++) {
-            if (VECTOR(indegree)[i]) {
+            if (start) {
+                MATRIX(vectors, i, 0) = VECTOR(*start)[i];
+            } else if (VECTOR(indegree)[i]) {
                 MATRIX(vectors, i, 0) = VECTOR(indegree)[i] + RNG_UNIF(-1e-4, 1e-4);
             } else {
                 MATRIX(vectors, i, 0) = 1;
@@ -1557,59 +2132,1034 @@ int igraph_personalized_pagerank_arpack(const igraph_t *graph, igraph_vector_t *
     return 0;
 }
 
-/**
- * \ingroup structural
- * \function igraph_betweenness
- * \brief Betweenness centrality of some vertices.
- *
- * </para><para>
- * The betweenness centrality of a vertex is the number of geodesics
- * going through it. If there are more than one geodesic between two
- * vertices, the value of these geodesics are weighted by one over the
- * number of geodesics.
- * \param graph The graph object.
- * \param res The result of the computation, a vector containing the
- *        betweenness scores for the specified vertices.
- * \param vids The vertices of which the betweenness centrality scores
- *        will be calculated.
- * \param directed Logical, if true directed paths will be considered
- *        for directed graphs. It is ignored for undirected graphs.
- * \param weights An optional vector containing edge weights for
- *        calculating weighted betweenness. Supply a null pointer here
- *        for unweighted betweenness.
- * \param nobigint Logical, if true, then we don't use big integers
- *        for the calculation, setting this to 1 (=true) should
- *        work for most graphs. It is currently ignored for weighted
- *        graphs.
- * \return Error code:
- *        \c IGRAPH_ENOMEM, not enough memory for
- *        temporary data.
- *        \c IGRAPH_EINVVID, invalid vertex id passed in
- *        \p vids.
- *
- * Time complexity: O(|V||E|),
- * |V| and
- * |E| are the number of vertices and
- * edges in the graph.
- * Note that the time complexity is independent of the number of
- * vertices for which the score is calculated.
- *
- * \sa Other centrality types: \ref igraph_degree(), \ref igraph_closeness().
- *     See \ref igraph_edge_betweenness() for calculating the betweenness score
- *     of the edges in a graph. See \ref igraph_betweenness_estimate() to
- *     estimate the betweenness score of the vertices in a graph.
- *
- * \example examples/simple/igraph_betweenness.c
- */
-int igraph_betweenness(const igraph_t *graph, igraph_vector_t *res,
-                       const igraph_vs_t vids, igraph_bool_t directed,
-                       const igraph_vector_t* weights, igraph_bool_t nobigint) {
-    return igraph_betweenness_estimate(graph, res, vids, directed, -1, weights,
-                                       nobigint);
-}
+/* Parallel power iteration for igraph_personalized_pagerank(). Each
+ * iteration pulls the scores along the incoming edges of every
+ * vertex, reading the edge list and its index in the igraph_t
+ * directly, so the graph is not copied into an adjacency list. The
+ * vertices are cut into chunks of a fixed size, so that the sums,
+ * and therefore the result, do not depend on the number of threads. */
 
-int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
-        igraph_vector_t *res,
+#define IGRAPH_I_PAGERANK_GRAIN 1024
+
+typedef struct igraph_i_pagerank_parallel_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_bool_t directed;
+    igraph_real_t damping;
+    igraph_real_t teleport;
+    const igraph_real_t *reset;
+    igraph_real_t uniform;
+    igraph_real_t *strength;
+    igraph_real_t *scaled;
+    igraph_real_t *prvec;
+    igraph_real_t *prvec_new;
+} igraph_i_pagerank_parallel_t;
+
+static int igraph_i_pagerank_parallel_strength(igraph_integer_t from,
+        igraph_integer_t to,
+        int thread, void *arg) {
+    igraph_i_pagerank_parallel_t *data = arg;
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    igraph_integer_t v, k;
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        igraph_integer_t os = VECTOR(graph->os)[v], oe = VECTOR(graph->os)[v + 1];
+        igraph_real_t s = 0;
+        if (weights) {
+            for (k = os; k < oe; k++) {
+                s += VECTOR(*weights)[ VECTOR(graph->oi)[k] ];
+            }
+        } else {
+            s = oe - os;
+        }
+        if (!data->directed) {
+            igraph_integer_t is = VECTOR(graph->is)[v], ie = VECTOR(graph->is)[v + 1];
+            if (weights) {
+                for (k = is; k < ie; k++) {
+                    s += VECTOR(*weights)[ VECTOR(graph->ii)[k] ];
+                }
+            } else {
+                s += ie - is;
+            }
+        }
+        data->strength[v] = s;
+    }
+
+    return 0;
+}
+
+/* Divides the scores by the out-strengths, the result is the sum of
+ * the scores of the vertices without outgoing edges. */
+
+static int igraph_i_pagerank_parallel_scale(igraph_integer_t from,
+        igraph_integer_t to,
+        int thread, igraph_real_t *result,
+        void *arg) {
+    igraph_i_pagerank_parallel_t *data = arg;
+    igraph_integer_t v;
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        if (data->strength[v] > 0) {
+            data->scaled[v] = data->prvec[v] / data->strength[v];
+        } else {
+            data->scaled[v] = 0.0;
+            *result += data->prvec[v];
+        }
+    }
+
+    return 0;
+}
+
+/* Computes the new scores, the result is the L1 norm of the change. */
+
+static int igraph_i_pagerank_parallel_pull(igraph_integer_t from,
+        igraph_integer_t to,
+        int thread, igraph_real_t *result,
+        void *arg) {
+    igraph_i_pagerank_parallel_t *data = arg;
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    const igraph_real_t *scaled = data->scaled;
+    igraph_integer_t v, k;
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        igraph_integer_t is = VECTOR(graph->is)[v], ie = VECTOR(graph->is)[v + 1];
+        igraph_real_t sum = 0, newval;
+        if (weights) {
+            for (k = is; k < ie; k++) {
+                igraph_integer_t e = VECTOR(graph->ii)[k];
+                sum += VECTOR(*weights)[e] * scaled[ VECTOR(graph->from)[e] ];
+            }
+        } else {
+            for (k = is; k < ie; k++) {
+                sum += scaled[ VECTOR(graph->from)[ VECTOR(graph->ii)[k] ] ];
+            }
+        }
+        if (!data->directed) {
+            igraph_integer_t os = VECTOR(graph->os)[v], oe = VECTOR(graph->os)[v + 1];
+            if (weights) {
+                for (k = os; k < oe; k++) {
+                    igraph_integer_t e = VECTOR(graph->oi)[k];
+                    sum += VECTOR(*weights)[e] * scaled[ VECTOR(graph->to)[e] ];
+                }
+            } else {
+                for (k = os; k < oe; k++) {
+                    sum += scaled[ VECTOR(graph->to)[ VECTOR(graph->oi)[k] ] ];
+                }
+            }
+        }
+        newval = data->damping * sum + data->teleport *
+                 (data->reset ? data->reset[v] : data->uniform);
+        *result += fabs(newval - data->prvec[v]);
+        data->prvec_new[v] = newval;
+    }
+
+    return 0;
+}
+
+int igraph_i_personalized_pagerank_parallel(const igraph_t *graph,
+        igraph_vector_t *vector,
+        igraph_real_t *value, const igraph_vs_t vids,
+        igraph_bool_t directed, igraph_real_t damping,
+        igraph_vector_t *reset,
+        const igraph_vector_t *weights,
+        const igraph_vector_t *start,
+        igraph_integer_t *iterations,
+        igraph_pagerank_power_options_t *options) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_integer_t niter = options ? options->niter : 1000;
+    igraph_real_t eps = options ? options->eps : 1e-10;
+    igraph_i_pagerank_parallel_t data;
+    igraph_vector_t strength, scaled, prvec, prvec_new, reset_norm;
+    igraph_real_t dangling, change = 0;
+    igraph_integer_t i, iter;
+    igraph_vit_t vit;
+
+    if (niter <= 0) {
+        IGRAPH_ERROR("Invalid iteration count", IGRAPH_EINVAL);
+    }
+    if (eps <= 0) {
+        IGRAPH_ERROR("Invalid epsilon value", IGRAPH_EINVAL);
+    }
+    if (damping < 0 || damping > 1) {
+        IGRAPH_ERROR("Invalid damping factor", IGRAPH_EINVAL);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Invalid length of weights vector when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+            IGRAPH_ERROR("Weights must not be negative when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+    }
+    if (reset && igraph_vector_size(reset) != no_of_nodes) {
+        IGRAPH_ERROR("Invalid length of reset vector when calculating "
+                     "personalized PageRank scores", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&reset_norm, 0);
+    if (reset) {
+        /* Normalize a copy of the reset vector so the sum is 1 */
+        double reset_sum;
+        if (no_of_nodes > 0 && igraph_vector_min(reset) < 0) {
+            IGRAPH_ERROR("the reset vector must not contain negative elements", IGRAPH_EINVAL);
+        }
+        reset_sum = igraph_vector_sum(reset);
+        if (reset_sum == 0) {
+            IGRAPH_ERROR("the sum of the elements in the reset vector must not be zero", IGRAPH_EINVAL);
+        }
+        IGRAPH_CHECK(igraph_vector_update(&reset_norm, reset));
+        igraph_vector_scale(&reset_norm, 1.0 / reset_sum);
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&strength, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&scaled, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&prvec, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&prvec_new, no_of_nodes);
+
+    data.graph = graph;
+    data.weights = weights;
+    data.directed = directed && igraph_is_directed(graph);
+    data.damping = damping;
+    data.reset = reset ? VECTOR(reset_norm) : 0;
+    data.uniform = 1.0 / no_of_nodes;
+    data.strength = VECTOR(strength);
+    data.scaled = VECTOR(scaled);
+    data.prvec = VECTOR(prvec);
+    data.prvec_new = VECTOR(prvec_new);
+
+    IGRAPH_CHECK(igraph_parallel_for(no_of_nodes, IGRAPH_I_PAGERANK_GRAIN,
+                                     igraph_i_pagerank_parallel_strength, &data));
+
+    if (start) {
+        /* Warm start, the scores must sum up to one */
+        igraph_real_t start_sum = igraph_vector_sum(start);
+        for (i = 0; i < no_of_nodes; i++) {
+            data.prvec[i] = VECTOR(*start)[i] / start_sum;
+        }
+    } else {
+        for (i = 0; i < no_of_nodes; i++) {
+            data.prvec[i] = reset ? data.reset[i] : data.uniform;
+        }
+    }
+
+    for (iter = 0; iter < niter; iter++) {
+        igraph_real_t *tmp;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        IGRAPH_CHECK(igraph_parallel_reduce(no_of_nodes, IGRAPH_I_PAGERANK_GRAIN,
+                                            igraph_i_pagerank_parallel_scale,
+                                            &data, &dangling));
+        /* The walk teleports with probability 1-damping, and always
+           from vertices without outgoing edges */
+        data.teleport = 1 - damping + damping * dangling;
+        IGRAPH_CHECK(igraph_parallel_reduce(no_of_nodes, IGRAPH_I_PAGERANK_GRAIN,
+                                            igraph_i_pagerank_parallel_pull,
+                                            &data, &change));
+
+        tmp = data.prvec; data.prvec = data.prvec_new; data.prvec_new = tmp;
+        if (change < eps) {
+            break;
+        }
+    }
+
+    if (iter == niter) {
+        IGRAPH_WARNING("PageRank power iteration did not converge");
+    } else {
+        iter++;
+    }
+    if (iterations) {
+        *iterations = iter;
+    }
+
+    if (value) {
+        *value = 1.0;
+    }
+
+    if (vector) {
+        IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+        IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+
+        IGRAPH_CHECK(igraph_vector_resize(vector, IGRAPH_VIT_SIZE(vit)));
+        for (IGRAPH_VIT_RESET(vit), i = 0; !IGRAPH_VIT_END(vit);
+             IGRAPH_VIT_NEXT(vit), i++) {
+            VECTOR(*vector)[i] = data.prvec[ (long int) IGRAPH_VIT_GET(vit) ];
+        }
+
+        igraph_vit_destroy(&vit);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    igraph_vector_destroy(&prvec_new);
+    igraph_vector_destroy(&prvec);
+    igraph_vector_destroy(&scaled);
+    igraph_vector_destroy(&strength);
+    igraph_vector_destroy(&reset_norm);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return 0;
+}
+
+/* igraph_pagerank_solver_solve() iterates a block of reset vectors at
+ * once. The scores of the vectors in a block are interleaved, so the
+ * incoming transitions of a vertex are read once per iteration for
+ * all vectors of the block. */
+
+#define IGRAPH_I_PAGERANK_BLOCK 8
+
+typedef struct igraph_i_pagerank_block_t {
+    const igraph_pagerank_solver_t *solver;
+    igraph_integer_t width;
+    const igraph_real_t *reset;
+    igraph_real_t teleport[IGRAPH_I_PAGERANK_BLOCK];
+    igraph_real_t *prvec;
+    igraph_real_t *prvec_new;
+} igraph_i_pagerank_block_t;
+
+/* Computes the new scores of a block, the result is the sum of the L1
+ * norms of the changes. */
+
+static int igraph_i_pagerank_block_pull(igraph_integer_t from,
+                                        igraph_integer_t to,
+                                        int thread, igraph_real_t *result,
+                                        void *arg) {
+    igraph_i_pagerank_block_t *data = arg;
+    const igraph_pagerank_solver_t *solver = data->solver;
+    const igraph_integer_t *in_start = VECTOR(solver->in_start);
+    const igraph_integer_t *in_from = VECTOR(solver->in_from);
+    const igraph_real_t *in_prob = VECTOR(solver->in_prob);
+    igraph_integer_t width = data->width, v, k, j;
+    igraph_real_t sum[IGRAPH_I_PAGERANK_BLOCK];
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        const igraph_real_t *reset = data->reset + v * IGRAPH_I_PAGERANK_BLOCK;
+        const igraph_real_t *old = data->prvec + v * IGRAPH_I_PAGERANK_BLOCK;
+        igraph_real_t *next = data->prvec_new + v * IGRAPH_I_PAGERANK_BLOCK;
+
+        for (j = 0; j < width; j++) {
+            sum[j] = 0.0;
+        }
+        for (k = in_start[v]; k < in_start[v + 1]; k++) {
+            const igraph_real_t *x = data->prvec + in_from[k] * IGRAPH_I_PAGERANK_BLOCK;
+            igraph_real_t p = in_prob[k];
+            for (j = 0; j < width; j++) {
+                sum[j] += p * x[j];
+            }
+        }
+        for (j = 0; j < width; j++) {
+            next[j] = solver->damping * sum[j] + data->teleport[j] * reset[j];
+            *result += fabs(next[j] - old[j]);
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_pagerank_solver_init
+ * \brief Preprocesses a graph for computing many personalized PageRanks.
+ *
+ * Computes the transition probabilities of the random walk once, so
+ * that \ref igraph_pagerank_solver_solve() can compute the personalized
+ * PageRank of many reset vectors. The graph is not needed after this
+ * function returns, the solver does not refer to it.
+ *
+ * \param solver Pointer to an uninitialized solver object, it must be
+ *    destroyed with \ref igraph_pagerank_solver_destroy().
+ * \param graph The graph object.
+ * \param directed Boolean, whether to consider the directedness of
+ *    the edges. This is ignored for undirected graphs.
+ * \param damping The damping factor ("d" in the original paper), it
+ *    must be between zero and one.
+ * \param weights Optional non-negative edge weights, or a null
+ *    pointer for an unweighted graph.
+ * \return Error code.
+ *
+ * Time complexity: O(|V|+|E|).
+ */
+
+int igraph_pagerank_solver_init(igraph_pagerank_solver_t *solver,
+                                const igraph_t *graph,
+                                igraph_bool_t directed,
+                                igraph_real_t damping,
+                                const igraph_vector_t *weights) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+    igraph_vector_t strength;
+    igraph_integer_t v, k, pos;
+
+    directed = directed && igraph_is_directed(graph);
+
+    if (damping < 0 || damping > 1) {
+        IGRAPH_ERROR("Invalid damping factor", IGRAPH_EINVAL);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Invalid length of weights vector when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && igraph_vector_min(weights) < 0) {
+            IGRAPH_ERROR("Weights must not be negative when calculating "
+                         "PageRank scores", IGRAPH_EINVAL);
+        }
+    }
+
+    solver->no_of_nodes = no_of_nodes;
+    solver->damping = damping;
+    IGRAPH_CHECK(igraph_vector_int_init(&solver->in_start, no_of_nodes + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &solver->in_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&solver->in_from,
+                                        directed ? no_of_edges : 2 * no_of_edges));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &solver->in_from);
+    IGRAPH_VECTOR_INIT_FINALLY(&solver->in_prob, directed ? no_of_edges : 2 * no_of_edges);
+    IGRAPH_CHECK(igraph_vector_int_init(&solver->dangling, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &solver->dangling);
+
+    IGRAPH_VECTOR_INIT_FINALLY(&strength, no_of_nodes);
+    IGRAPH_CHECK(igraph_strength(graph, &strength, igraph_vss_all(),
+                                 directed ? IGRAPH_OUT : IGRAPH_ALL,
+                                 IGRAPH_LOOPS, weights));
+    for (v = 0; v < no_of_nodes; v++) {
+        if (VECTOR(strength)[v] == 0) {
+            IGRAPH_CHECK(igraph_vector_int_push_back(&solver->dangling, v));
+        }
+    }
+
+    /* The incoming transitions of a vertex are its incoming edges, and
+       also its outgoing edges if the graph is treated as undirected */
+    for (v = 0, pos = 0; v < no_of_nodes; v++) {
+        VECTOR(solver->in_start)[v] = pos;
+        for (k = VECTOR(graph->is)[v]; k < VECTOR(graph->is)[v + 1]; k++, pos++) {
+            igraph_integer_t e = VECTOR(graph->ii)[k];
+            igraph_integer_t u = VECTOR(graph->from)[e];
+            VECTOR(solver->in_from)[pos] = u;
+            VECTOR(solver->in_prob)[pos] = VECTOR(strength)[u] == 0 ? 0.0 :
+                                           (weights ? VECTOR(*weights)[e] : 1.0) / VECTOR(strength)[u];
+        }
+        if (!directed) {
+            for (k = VECTOR(graph->os)[v]; k < VECTOR(graph->os)[v + 1]; k++, pos++) {
+                igraph_integer_t e = VECTOR(graph->oi)[k];
+                igraph_integer_t u = VECTOR(graph->to)[e];
+                VECTOR(solver->in_from)[pos] = u;
+                VECTOR(solver->in_prob)[pos] = VECTOR(strength)[u] == 0 ? 0.0 :
+                                               (weights ? VECTOR(*weights)[e] : 1.0) / VECTOR(strength)[u];
+            }
+        }
+    }
+    VECTOR(solver->in_start)[no_of_nodes] = pos;
+
+    igraph_vector_destroy(&strength);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return 0;
+}
+
+/**
+ * \function igraph_pagerank_solver_destroy
+ * \brief Deallocates the memory of a PageRank solver.
+ *
+ * \param solver The solver object to destroy.
+ *
+ * Time complexity: operating system dependent.
+ */
+
+void igraph_pagerank_solver_destroy(igraph_pagerank_solver_t *solver) {
+    igraph_vector_int_destroy(&solver->dangling);
+    igraph_vector_destroy(&solver->in_prob);
+    igraph_vector_int_destroy(&solver->in_from);
+    igraph_vector_int_destroy(&solver->in_start);
+}
+
+/**
+ * \function igraph_pagerank_solver_solve
+ * \brief Computes the personalized PageRank for many reset vectors.
+ *
+ * Every column of \p reset is a reset vector, see \ref
+ * igraph_personalized_pagerank(); the walkers on vertices without
+ * outgoing edges also restart according to it. The columns are
+ * solved with the power method, in blocks of eight: the scores of the
+ * vectors in a block are stored together, and the graph is traversed
+ * once per iteration for the whole block. The vertices are divided
+ * among igraph_get_num_threads() threads. The result does not depend
+ * on the number of threads.
+ *
+ * \param solver The solver, see \ref igraph_pagerank_solver_init().
+ * \param res Pointer to an initialized matrix, the result is stored
+ *    here, one column for each column of \p reset.
+ * \param reset The reset vectors, a matrix with one row for each
+ *    vertex. The columns must be non-negative and must not sum to
+ *    zero, they are normalized to sum to one.
+ * \param options The number of iterations and the tolerance, or a null
+ *    pointer for 1000 iterations and a tolerance of 1e-10. A block is
+ *    finished when the sum of the L1 norms of the changes of its
+ *    columns is less than the tolerance. A warning is given if this
+ *    does not happen within the given number of iterations.
+ * \return Error code.
+ *
+ * Time complexity: O(k i (|V|+|E|)) for k reset vectors and i
+ * iterations per block, but the graph is read only once per iteration
+ * of a block.
+ *
+ * \example examples/simple/igraph_pagerank_solver.c
+ */
+
+int igraph_pagerank_solver_solve(const igraph_pagerank_solver_t *solver,
+                                 igraph_matrix_t *res,
+                                 const igraph_matrix_t *reset,
+                                 igraph_pagerank_power_options_t *options) {
+    igraph_integer_t no_of_nodes = solver->no_of_nodes;
+    igraph_integer_t no_of_dangling = igraph_vector_int_size(&solver->dangling);
+    igraph_integer_t niter = options ? options->niter : 1000;
+    igraph_real_t eps = options ? options->eps : 1e-10;
+    long int no_of_vectors = igraph_matrix_ncol(reset);
+    igraph_i_pagerank_block_t data;
+    igraph_vector_t resetblock, prvec, prvec_new;
+    igraph_real_t dangling[IGRAPH_I_PAGERANK_BLOCK];
+    igraph_real_t change = 0;
+    igraph_integer_t v, j, iter;
+    long int first;
+
+    if (niter <= 0) {
+        IGRAPH_ERROR("Invalid iteration count", IGRAPH_EINVAL);
+    }
+    if (eps <= 0) {
+        IGRAPH_ERROR("Invalid epsilon value", IGRAPH_EINVAL);
+    }
+    if (igraph_matrix_nrow(reset) != no_of_nodes) {
+        IGRAPH_ERROR("Invalid number of rows in reset matrix when calculating "
+                     "personalized PageRank scores", IGRAPH_EINVAL);
+    }
+    if (no_of_nodes > 0 && no_of_vectors > 0 && igraph_matrix_min(reset) < 0) {
+        IGRAPH_ERROR("the reset vector must not contain negative elements", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_nodes, no_of_vectors));
+
+    IGRAPH_VECTOR_INIT_FINALLY(&resetblock, no_of_nodes * IGRAPH_I_PAGERANK_BLOCK);
+    IGRAPH_VECTOR_INIT_FINALLY(&prvec, no_of_nodes * IGRAPH_I_PAGERANK_BLOCK);
+    IGRAPH_VECTOR_INIT_FINALLY(&prvec_new, no_of_nodes * IGRAPH_I_PAGERANK_BLOCK);
+
+    data.solver = solver;
+    data.reset = VECTOR(resetblock);
+
+    for (first = 0; first < no_of_vectors; first += IGRAPH_I_PAGERANK_BLOCK) {
+        data.width = no_of_vectors - first < IGRAPH_I_PAGERANK_BLOCK ?
+                     no_of_vectors - first : IGRAPH_I_PAGERANK_BLOCK;
+        data.prvec = VECTOR(prvec);
+        data.prvec_new = VECTOR(prvec_new);
+
+        /* Interleave and normalize the reset vectors of the block, and
+           start the iteration from them */
+        for (j = 0; j < data.width; j++) {
+            igraph_real_t reset_sum = 0;
+            for (v = 0; v < no_of_nodes; v++) {
+                reset_sum += MATRIX(*reset, v, first + j);
+            }
+            if (reset_sum == 0) {
+                IGRAPH_ERROR("the sum of the elements in the reset vector must not be zero", IGRAPH_EINVAL);
+            }
+            for (v = 0; v < no_of_nodes; v++) {
+                VECTOR(resetblock)[v * IGRAPH_I_PAGERANK_BLOCK + j] =
+                    MATRIX(*reset, v, first + j) / reset_sum;
+            }
+        }
+        for (v = 0; v < no_of_nodes * IGRAPH_I_PAGERANK_BLOCK; v++) {
+            data.prvec[v] = VECTOR(resetblock)[v];
+        }
+
+        for (iter = 0; iter < niter; iter++) {
+            igraph_real_t *tmp;
+
+            IGRAPH_ALLOW_INTERRUPTION();
+
+            /* The walk teleports with probability 1-damping, and always
+               from vertices without outgoing edges */
+            for (j = 0; j < data.width; j++) {
+                dangling[j] = 0.0;
+            }
+            for (v = 0; v < no_of_dangling; v++) {
+                const igraph_real_t *x = data.prvec +
+                                         VECTOR(solver->dangling)[v] * IGRAPH_I_PAGERANK_BLOCK;
+                for (j = 0; j < data.width; j++) {
+                    dangling[j] += x[j];
+                }
+            }
+            for (j = 0; j < data.width; j++) {
+                data.teleport[j] = 1 - solver->damping + solver->damping * dangling[j];
+            }
+
+            IGRAPH_CHECK(igraph_parallel_reduce(no_of_nodes, IGRAPH_I_PAGERANK_GRAIN,
+                                                igraph_i_pagerank_block_pull,
+                                                &data, &change));
+
+            tmp = data.prvec; data.prvec = data.prvec_new; data.prvec_new = tmp;
+            if (change < eps) {
+                break;
+            }
+        }
+
+        if (iter == niter) {
+            IGRAPH_WARNING("PageRank power iteration did not converge");
+        }
+
+        for (j = 0; j < data.width; j++) {
+            for (v = 0; v < no_of_nodes; v++) {
+                MATRIX(*res, v, first + j) = data.prvec[v * IGRAPH_I_PAGERANK_BLOCK + j];
+            }
+        }
+    }
+
+    igraph_vector_destroy(&prvec_new);
+    igraph_vector_destroy(&prvec);
+    igraph_vector_destroy(&resetblock);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/* The betweenness functions run Brandes' algorithm from every vertex.
+ * The sources are divided among igraph_get_num_threads() threads:
+ * the vertices are cut into blocks of IGRAPH_I_BETWEENNESS_BLOCK, and
+ * block b is processed by thread b % nthreads. Each thread has its own
+ * scratch space and adds the scores to its own vector, these are
+ * summed at the end. The assignment of the sources does not depend on
+ * timing, so the results are deterministic for a given number of
+ * threads, and with a single thread the sources are processed in
+ * order, as in the serial algorithm.
+ *
+ * All scratch memory is allocated beforehand, on the calling thread.
+ * Errors raised in the per-source functions stop the other threads and
+ * are raised again on the calling thread by igraph_i_parallel_run(). */
+
+#define IGRAPH_I_BETWEENNESS_BLOCK 16
+
+typedef int igraph_i_betweenness_source_t(void *arg, int thread,
+        long int source);
+
+typedef struct igraph_i_betweenness_run_t {
+    igraph_i_betweenness_source_t *source;
+    void *arg;
+    const char *message;
+    long int no_of_nodes;
+    int nthreads;
+} igraph_i_betweenness_run_t;
+
+static int igraph_i_betweenness_nthreads(long int no_of_nodes) {
+    long int blocks = (no_of_nodes + IGRAPH_I_BETWEENNESS_BLOCK - 1) /
+                      IGRAPH_I_BETWEENNESS_BLOCK;
+    int nthreads = igraph_get_num_threads();
+    if (nthreads > blocks) {
+        nthreads = (int) blocks;
+    }
+    return nthreads > 0 ? nthreads : 1;
+}
+
+static int igraph_i_betweenness_thread(void *arg, int thread) {
+    igraph_i_betweenness_run_t *run = (igraph_i_betweenness_run_t *) arg;
+    long int step = (long int) run->nthreads * IGRAPH_I_BETWEENNESS_BLOCK;
+    long int block, source, done = 0;
+
+    for (block = (long int) thread * IGRAPH_I_BETWEENNESS_BLOCK;
+         block < run->no_of_nodes; block += step) {
+        long int end = block + IGRAPH_I_BETWEENNESS_BLOCK;
+        if (end > run->no_of_nodes) {
+            end = run->no_of_nodes;
+        }
+        for (source = block; source < end; source++, done++) {
+            /* Only reported by the calling thread */
+            igraph_real_t percent = 100.0 * done * run->nthreads / run->no_of_nodes;
+            IGRAPH_PROGRESS(run->message, percent < 100.0 ? percent : 100.0, 0);
+            IGRAPH_ALLOW_INTERRUPTION();
+            IGRAPH_CHECK(run->source(run->arg, thread, source));
+        }
+    }
+
+    return 0;
+}
+
+/* Runs 'run->source' for every source vertex, returns from the caller
+   on error or interruption */
+
+#define IGRAPH_I_BETWEENNESS_RUN(run) \
+    do { \
+        int igraph_i_ret; \
+        igraph_i_ret = igraph_i_parallel_run(igraph_i_betweenness_thread, \
+                                             (run), (run)->nthreads); \
+        if (igraph_i_ret == IGRAPH_INTERRUPTED) { \
+            IGRAPH_FINALLY_FREE(); \
+            return IGRAPH_INTERRUPTED; \
+        } else if (igraph_i_ret != 0) { \
+            IGRAPH_ERROR("", igraph_i_ret); \
+        } \
+    } while (0)
+
+/* Scratch space of a thread, for the unweighted vertex and edge
+   betweenness. 'res' is the vector the thread adds the scores to, for
+   thread zero this is the result vector itself, for the others it
+   is 'score'. */
+
+typedef struct igraph_i_betweenness_scratch_t {
+    igraph_dqueue_t q;
+    igraph_stack_t stack;
+    long int *distance;
+    unsigned long long int *nrgeo;
+    igraph_biguint_t *big_nrgeo;
+    igraph_biguint_t D, R, T;
+    double *tmpscore;
+    igraph_vector_t score;
+    igraph_vector_t *res;
+} igraph_i_betweenness_scratch_t;
+
+/* Scratch space of a thread, for the weighted vertex and edge
+   betweenness. Vertex betweenness uses 'fathers' and 'nrgeo', edge
+   betweenness uses 'inclist_fathers' and 'nrgeo_long'. */
+
+typedef struct igraph_i_betweenness_weighted_scratch_t {
+    igraph_i_spqueue_t Q;
+    igraph_stack_t S;
+    igraph_adjlist_t fathers;
+    igraph_inclist_t inclist_fathers;
+    igraph_vector_t dist, tmpscore, nrgeo;
+    igraph_vector_long_t nrgeo_long;
+    igraph_vector_t score;
+    igraph_vector_t *res;
+} igraph_i_betweenness_weighted_scratch_t;
+
+typedef struct igraph_i_betweenness_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_adjlist_t *adjlist_out, *adjlist_in;
+    igraph_inclist_t *inclist_out, *inclist_in;
+    igraph_real_t cutoff;
+    igraph_bool_t nobigint;
+    int nthreads;
+    igraph_i_betweenness_scratch_t *scratch;
+    igraph_i_betweenness_weighted_scratch_t *wscratch;
+} igraph_i_betweenness_t;
+
+void igraph_i_destroy_biguints(igraph_biguint_t *p) {
+    igraph_biguint_t *p2 = p;
+    while ( *((long int*)(p)) ) {
+        igraph_biguint_destroy(p);
+        p++;
+    }
+    igraph_Free(p2);
+}
+
+static void igraph_i_betweenness_destroy(igraph_i_betweenness_t *data) {
+    int i;
+    if (data->scratch) {
+        for (i = 0; i < data->nthreads; i++) {
+            igraph_i_betweenness_scratch_t *s = &data->scratch[i];
+            igraph_dqueue_destroy(&s->q);
+            igraph_stack_destroy(&s->stack);
+            igraph_Free(s->distance);
+            igraph_Free(s->nrgeo);
+            if (s->big_nrgeo) {
+                igraph_i_destroy_biguints(s->big_nrgeo);
+            }
+            igraph_biguint_destroy(&s->D);
+            igraph_biguint_destroy(&s->R);
+            igraph_biguint_destroy(&s->T);
+            igraph_Free(s->tmpscore);
+            igraph_vector_destroy(&s->score);
+        }
+        igraph_Free(data->scratch);
+    }
+    if (data->wscratch) {
+        for (i = 0; i < data->nthreads; i++) {
+            igraph_i_betweenness_weighted_scratch_t *s = &data->wscratch[i];
+            igraph_i_spqueue_destroy(&s->Q);
+            igraph_stack_destroy(&s->S);
+            igraph_adjlist_destroy(&s->fathers);
+            igraph_inclist_destroy(&s->inclist_fathers);
+            igraph_vector_destroy(&s->dist);
+            igraph_vector_destroy(&s->tmpscore);
+            igraph_vector_destroy(&s->nrgeo);
+            igraph_vector_long_destroy(&s->nrgeo_long);
+            igraph_vector_destroy(&s->score);
+        }
+        igraph_Free(data->wscratch);
+    }
+}
+
+/* Allocates the scratch space of all threads. 'res' is the result
+   vector of thread zero, 'size' is its length. The scratch space is
+   freed by igraph_i_betweenness_destroy(), even if this function
+   fails. */
+
+static int igraph_i_betweenness_scratch_init(igraph_i_betweenness_t *data,
+        long int no_of_nodes,
+        igraph_vector_t *res,
+        long int size,
+        igraph_bool_t bigint) {
+    int i;
+    long int j;
+
+    data->scratch = igraph_Calloc(data->nthreads, igraph_i_betweenness_scratch_t);
+    if (!data->scratch) {
+        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+    }
+
+    for (i = 0; i < data->nthreads; i++) {
+        igraph_i_betweenness_scratch_t *s = &data->scratch[i];
+        IGRAPH_CHECK(igraph_dqueue_init(&s->q, no_of_nodes));
+        IGRAPH_CHECK(igraph_stack_init(&s->stack, no_of_nodes));
+        s->distance = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, long int);
+        s->tmpscore = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, double);
+        if (!s->distance || !s->tmpscore) {
+            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+        }
+        if (!bigint) {
+            s->nrgeo = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1,
+                                     unsigned long long int);
+            if (!s->nrgeo) {
+                IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+            }
+        } else {
+            /* +1 is to have one containing zeros, when we free it, we stop
+               at the zero */
+            s->big_nrgeo = igraph_Calloc(no_of_nodes + 1, igraph_biguint_t);
+            if (!s->big_nrgeo) {
+                IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+            }
+            for (j = 0; j < no_of_nodes; j++) {
+                IGRAPH_CHECK(igraph_biguint_init(&s->big_nrgeo[j]));
+            }
+            IGRAPH_CHECK(igraph_biguint_init(&s->D));
+            IGRAPH_CHECK(igraph_biguint_init(&s->R));
+            IGRAPH_CHECK(igraph_biguint_init(&s->T));
+        }
+        if (i == 0) {
+            s->res = res;
+        } else {
+            IGRAPH_CHECK(igraph_vector_init(&s->score, size));
+            s->res = &s->score;
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_betweenness_weighted_scratch_init(igraph_i_betweenness_t *data,
+        long int no_of_nodes,
+        igraph_vector_t *res,
+        long int size,
+        igraph_bool_t edges) {
+    int i;
+
+    data->wscratch = igraph_Calloc(data->nthreads,
+                                   igraph_i_betweenness_weighted_scratch_t);
+    if (!data->wscratch) {
+        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+    }
+
+    for (i = 0; i < data->nthreads; i++) {
+        igraph_i_betweenness_weighted_scratch_t *s = &data->wscratch[i];
+        IGRAPH_CHECK(igraph_i_spqueue_init(&s->Q, no_of_nodes, data->weights));
+        IGRAPH_CHECK(igraph_stack_init(&s->S, no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_init(&s->dist, no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_init(&s->tmpscore, no_of_nodes));
+        if (edges) {
+            IGRAPH_CHECK(igraph_inclist_init_empty(&s->inclist_fathers,
+                                                   (igraph_integer_t) no_of_nodes));
+            IGRAPH_CHECK(igraph_vector_long_init(&s->nrgeo_long, no_of_nodes));
+        } else {
+            IGRAPH_CHECK(igraph_adjlist_init_empty(&s->fathers,
+                                                   (igraph_integer_t) no_of_nodes));
+            IGRAPH_CHECK(igraph_vector_init(&s->nrgeo, no_of_nodes));
+        }
+        if (i == 0) {
+            s->res = res;
+        } else {
+            IGRAPH_CHECK(igraph_vector_init(&s->score, size));
+            s->res = &s->score;
+        }
+    }
+
+    return 0;
+}
+
+/* Adds the scores of the other threads to the result of thread zero */
+
+static void igraph_i_betweenness_reduce(igraph_i_betweenness_t *data) {
+    int i;
+    for (i = 1; i < data->nthreads; i++) {
+        if (data->scratch) {
+            igraph_vector_add(data->scratch[0].res, &data->scratch[i].score);
+        } else {
+            igraph_vector_add(data->wscratch[0].res, &data->wscratch[i].score);
+        }
+    }
+}
+
+/**
+ * \ingroup structural
+ * \function igraph_betweenness
+ * \brief Betweenness centrality of some vertices.
+ *
+ * </para><para>
+ * The betweenness centrality of a vertex is the number of geodesics
+ * going through it. If there are more than one geodesic between two
+ * vertices, the value of these geodesics are weighted by one over the
+ * number of geodesics.
+ *
+ * </para><para>
+ * The calculation is divided among the threads set by \ref
+ * igraph_set_num_threads(). With more than one thread the scores may
+ * differ from the single threaded result by rounding errors.
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        betweenness scores for the specified vertices.
+ * \param vids The vertices of which the betweenness centrality scores
+ *        will be calculated.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ * \param weights An optional vector containing edge weights for
+ *        calculating weighted betweenness. Supply a null pointer here
+ *        for unweighted betweenness.
+ * \param nobigint Logical, if true, then we don't use big integers
+ *        for the calculation, setting this to 1 (=true) should
+ *        work for most graphs. It is currently ignored for weighted
+ *        graphs.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data.
+ *        \c IGRAPH_EINVVID, invalid vertex id passed in
+ *        \p vids.
+ *
+ * Time complexity: O(|V||E|),
+ * |V| and
+ * |E| are the number of vertices and
+ * edges in the graph.
+ * Note that the time complexity is independent of the number of
+ * vertices for which the score is calculated.
+ *
+ * \sa Other centrality types: \ref igraph_degree(), \ref igraph_closeness().
+ *     See \ref igraph_edge_betweenness() for calculating the betweenness score
+ *     of the edges in a graph. See \ref igraph_betweenness_estimate() to
+ *     estimate the betweenness score of the vertices in a graph.
+ *
+ * \example examples/simple/igraph_betweenness.c
+ */
+int igraph_betweenness(const igraph_t *graph, igraph_vector_t *res,
+                       const igraph_vs_t vids, igraph_bool_t directed,
+                       const igraph_vector_t* weights, igraph_bool_t nobigint) {
+    return igraph_betweenness_estimate(graph, res, vids, directed, -1, weights,
+                                       nobigint);
+}
+
+static int igraph_i_betweenness_weighted_source(void *arg, int thread,
+        long int source) {
+    igraph_i_betweenness_t *data = (igraph_i_betweenness_t *) arg;
+    igraph_i_betweenness_weighted_scratch_t *s = &data->wscratch[thread];
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    igraph_real_t cutoff = data->cutoff;
+    igraph_i_spqueue_t *Q = &s->Q;
+    igraph_adjlist_t *fathers = &s->fathers;
+    igraph_stack_t *S = &s->S;
+    igraph_vector_t *dist = &s->dist, *nrgeo = &s->nrgeo;
+    igraph_vector_t *tmpscore = &s->tmpscore, *tmpres = s->res;
+    long int j;
+    int cmp_result;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+
+    IGRAPH_CHECK(igraph_i_spqueue_push(Q, source, 1.0));
+    VECTOR(*dist)[source] = 1.0;
+    VECTOR(*nrgeo)[source] = 1;
+
+    while (!igraph_i_spqueue_empty(Q)) {
+        long int minnei;
+        igraph_real_t mindist = igraph_i_spqueue_delete_min(Q, &minnei);
+        igraph_vector_int_t *neis;
+        long int nlen;
+
+        igraph_stack_push(S, minnei);
+        if (cutoff > 0 && VECTOR(*dist)[minnei] >= cutoff + 1.0) {
+            continue;
+        }
+
+        /* Now check all neighbors of 'minnei' for a shorter path */
+        neis = igraph_inclist_get(data->inclist_out, minnei);
+        nlen = igraph_vector_int_size(neis);
+        for (j = 0; j < nlen; j++) {
+            long int edge = (long int) VECTOR(*neis)[j];
+            long int to = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+            igraph_real_t curdist = VECTOR(*dist)[to];
+
+            if (curdist == 0) {
+                /* this means curdist is infinity */
+                cmp_result = -1;
+            } else {
+                cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
+            }
+
+            if (curdist == 0) {
+                /* This is the first non-infinite distance */
+                igraph_vector_int_t *v = igraph_adjlist_get(fathers, to);
+                IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                VECTOR(*v)[0] = minnei;
+                VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+
+                VECTOR(*dist)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_spqueue_push(Q, to, altdist));
+            } else if (cmp_result < 0) {
+                /* This is a shorter path */
+                igraph_vector_int_t *v = igraph_adjlist_get(fathers, to);
+                IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                VECTOR(*v)[0] = minnei;
+                VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+
+                VECTOR(*dist)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_spqueue_modify(Q, to, altdist));
+            } else if (cmp_result == 0) {
+                igraph_vector_int_t *v = igraph_adjlist_get(fathers, to);
+                IGRAPH_CHECK(igraph_vector_int_push_back(v, minnei));
+                VECTOR(*nrgeo)[to] += VECTOR(*nrgeo)[minnei];
+            }
+        }
+
+    } /* !igraph_i_spqueue_empty(Q) */
+
+    while (!igraph_stack_empty(S)) {
+        long int w = (long int) igraph_stack_pop(S);
+        igraph_vector_int_t *fatv = igraph_adjlist_get(fathers, w);
+        long int fatv_len = igraph_vector_int_size(fatv);
+        for (j = 0; j < fatv_len; j++) {
+            long int f = (long int) VECTOR(*fatv)[j];
+            VECTOR(*tmpscore)[f] += VECTOR(*nrgeo)[f] / VECTOR(*nrgeo)[w] * (1 + VECTOR(*tmpscore)[w]);
+        }
+        if (w != source) {
+            VECTOR(*tmpres)[w] += VECTOR(*tmpscore)[w];
+        }
+
+        VECTOR(*tmpscore)[w] = 0;
+        VECTOR(*dist)[w] = 0;
+        VECTOR(*nrgeo)[w] = 0;
+        igraph_vector_int_clear(fatv);
+    }
+
+    return 0;
+}
+
+int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
+        igraph_vector_t *res,
         const igraph_vs_t vids,
         igraph_bool_t directed,
         igraph_real_t cutoff,
@@ -1619,16 +3169,13 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
     igraph_real_t minweight;
     igraph_integer_t no_of_nodes = (igraph_integer_t) igraph_vcount(graph);
     igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
-    igraph_2wheap_t Q;
     igraph_inclist_t inclist;
-    igraph_adjlist_t fathers;
-    long int source, j;
-    igraph_stack_t S;
+    long int j;
     igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
-    igraph_vector_t dist, nrgeo, tmpscore;
     igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
     igraph_vit_t vit;
-    int cmp_result;
+    igraph_i_betweenness_t data;
+    igraph_i_betweenness_run_t run;
     const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
     IGRAPH_UNUSED(nobigint);
@@ -1643,18 +3190,8 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
         IGRAPH_WARNING("Some weights are smaller than epsilon, calculations may suffer from numerical precision.");
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
     IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-    IGRAPH_CHECK(igraph_adjlist_init_empty(&fathers, no_of_nodes));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &fathers);
-
-    IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &S);
-    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmpscore, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&nrgeo, no_of_nodes);
 
     if (igraph_vs_is_all(&vids)) {
         IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
@@ -1664,87 +3201,26 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
         IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
     }
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-        VECTOR(dist)[source] = 1.0;
-        VECTOR(nrgeo)[source] = 1;
-
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-            igraph_vector_int_t *neis;
-            long int nlen;
-
-            igraph_stack_push(&S, minnei);
-            if (cutoff > 0 && VECTOR(dist)[minnei] >= cutoff + 1.0) {
-                continue;
-            }
-
-            /* Now check all neighbors of 'minnei' for a shorter path */
-            neis = igraph_inclist_get(&inclist, minnei);
-            nlen = igraph_vector_int_size(neis);
-            for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int to = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_real_t curdist = VECTOR(dist)[to];
-
-                if (curdist == 0) {
-                    /* this means curdist is infinity */
-                    cmp_result = -1;
-                } else {
-                    cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
-                }
-
-                if (curdist == 0) {
-                    /* This is the first non-infinite distance */
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_resize(v, 1);
-                    VECTOR(*v)[0] = minnei;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
-                } else if (cmp_result < 0) {
-                    /* This is a shorter path */
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_resize(v, 1);
-                    VECTOR(*v)[0] = minnei;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-
-                    VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
-                } else if (cmp_result == 0) {
-                    igraph_vector_int_t *v = igraph_adjlist_get(&fathers, to);
-                    igraph_vector_int_push_back(v, minnei);
-                    VECTOR(nrgeo)[to] += VECTOR(nrgeo)[minnei];
-                }
-            }
-
-        } /* !igraph_2wheap_empty(&Q) */
-
-        while (!igraph_stack_empty(&S)) {
-            long int w = (long int) igraph_stack_pop(&S);
-            igraph_vector_int_t *fatv = igraph_adjlist_get(&fathers, w);
-            long int fatv_len = igraph_vector_int_size(fatv);
-            for (j = 0; j < fatv_len; j++) {
-                long int f = (long int) VECTOR(*fatv)[j];
-                VECTOR(tmpscore)[f] += VECTOR(nrgeo)[f] / VECTOR(nrgeo)[w] * (1 + VECTOR(tmpscore)[w]);
-            }
-            if (w != source) {
-                VECTOR(*tmpres)[w] += VECTOR(tmpscore)[w];
-            }
-
-            VECTOR(tmpscore)[w] = 0;
-            VECTOR(dist)[w] = 0;
-            VECTOR(nrgeo)[w] = 0;
-            igraph_vector_int_clear(igraph_adjlist_get(&fathers, w));
-        }
-
-    } /* source < no_of_nodes */
+    memset(&data, 0, sizeof(data));
+    data.graph = graph;
+    data.weights = weights;
+    data.inclist_out = &inclist;
+    data.cutoff = cutoff;
+    data.nthreads = igraph_i_betweenness_nthreads(no_of_nodes);
+    IGRAPH_FINALLY(igraph_i_betweenness_destroy, &data);
+    IGRAPH_CHECK(igraph_i_betweenness_weighted_scratch_init(&data, no_of_nodes,
+                 tmpres, no_of_nodes, /* edges= */ 0));
+
+    run.source = igraph_i_betweenness_weighted_source;
+    run.arg = &data;
+    run.message = "Betweenness centrality: ";
+    run.no_of_nodes = no_of_nodes;
+    run.nthreads = data.nthreads;
+    IGRAPH_I_BETWEENNESS_RUN(&run);
+    igraph_i_betweenness_reduce(&data);
+
+    igraph_i_betweenness_destroy(&data);
+    IGRAPH_FINALLY_CLEAN(1);
 
     if (!igraph_vs_is_all(&vids)) {
         IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
@@ -1770,29 +3246,118 @@ int igraph_i_betweenness_estimate_weighted(const igraph_t *graph,
         }
     }
 
-    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
-
-    igraph_vector_destroy(&nrgeo);
-    igraph_vector_destroy(&tmpscore);
-    igraph_vector_destroy(&dist);
-    igraph_stack_destroy(&S);
-    igraph_adjlist_destroy(&fathers);
-    igraph_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
-    IGRAPH_FINALLY_CLEAN(7);
-
+    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
+
+    igraph_inclist_destroy(&inclist);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static int igraph_i_betweenness_source(void *arg, int thread, long int source) {
+    igraph_i_betweenness_t *data = (igraph_i_betweenness_t *) arg;
+    igraph_i_betweenness_scratch_t *s = &data->scratch[thread];
+    igraph_real_t cutoff = data->cutoff;
+    igraph_bool_t nobigint = data->nobigint;
+    igraph_dqueue_t *q = &s->q;
+    igraph_stack_t *stack = &s->stack;
+    long int *distance = s->distance;
+    unsigned long long int *nrgeo = s->nrgeo;
+    igraph_biguint_t *big_nrgeo = s->big_nrgeo;
+    double *tmpscore = s->tmpscore;
+    igraph_vector_t *tmpres = s->res;
+    igraph_vector_int_t *neis;
+    long int j, nneis;
+
+    IGRAPH_CHECK(igraph_dqueue_push(q, source));
+    if (nobigint) {
+        nrgeo[source] = 1;
+    } else {
+        igraph_biguint_set_limb(&big_nrgeo[source], 1);
+    }
+    distance[source] = 1;
+
+    while (!igraph_dqueue_empty(q)) {
+        long int actnode = (long int) igraph_dqueue_pop(q);
+        IGRAPH_CHECK(igraph_stack_push(stack, actnode));
+
+        if (cutoff > 0 && distance[actnode] >= cutoff + 1) {
+            continue;
+        }
+
+        neis = igraph_adjlist_get(data->adjlist_out, actnode);
+        nneis = igraph_vector_int_size(neis);
+        for (j = 0; j < nneis; j++) {
+            long int neighbor = (long int) VECTOR(*neis)[j];
+            if (distance[neighbor] == 0) {
+                distance[neighbor] = distance[actnode] + 1;
+                IGRAPH_CHECK(igraph_dqueue_push(q, neighbor));
+            }
+            if (distance[neighbor] == distance[actnode] + 1) {
+                if (nobigint) {
+                    nrgeo[neighbor] += nrgeo[actnode];
+                } else {
+                    IGRAPH_CHECK(igraph_biguint_add(&big_nrgeo[neighbor],
+                                               &big_nrgeo[neighbor],
+                                               &big_nrgeo[actnode]));
+                }
+            }
+        }
+    } /* while !igraph_dqueue_empty */
+
+    /* Ok, we've the distance of each node and also the number of
+       shortest paths to them. Now we do an inverse search, starting
+       with the farthest nodes. The predecessors of a node on the
+       shortest paths are its in-neighbors one step closer to the
+       source. Nodes farther away are already reset to zero distance
+       here, so this cannot match them. */
+    while (!igraph_stack_empty(stack)) {
+        long int actnode = (long int) igraph_stack_pop(stack);
+        if (actnode != source) {
+            neis = igraph_adjlist_get(data->adjlist_in, actnode);
+            nneis = igraph_vector_int_size(neis);
+        } else {
+            nneis = 0;
+        }
+        for (j = 0; j < nneis; j++) {
+            long int neighbor = (long int) VECTOR(*neis)[j];
+            if (distance[neighbor] != distance[actnode] - 1) {
+                continue;
+            }
+            if (nobigint) {
+                tmpscore[neighbor] +=  (tmpscore[actnode] + 1) *
+                                       ((double)(nrgeo[neighbor])) / nrgeo[actnode];
+            } else {
+                if (!igraph_biguint_compare_limb(&big_nrgeo[actnode], 0)) {
+                    tmpscore[neighbor] = IGRAPH_INFINITY;
+                } else {
+                    double div;
+                    limb_t shift = 1000000000L;
+                    IGRAPH_CHECK(igraph_biguint_mul_limb(&s->T,
+                                               &big_nrgeo[neighbor], shift));
+                    igraph_biguint_div(&s->D, &s->R, &s->T, &big_nrgeo[actnode]);
+                    div = igraph_biguint_get(&s->D) / shift;
+                    tmpscore[neighbor] += (tmpscore[actnode] + 1) * div;
+                }
+            }
+        }
+
+        if (actnode != source) {
+            VECTOR(*tmpres)[actnode] += tmpscore[actnode];
+        }
+
+        distance[actnode] = 0;
+        if (nobigint) {
+            nrgeo[actnode] = 0;
+        } else {
+            igraph_biguint_set_limb(&big_nrgeo[actnode], 0);
+        }
+        tmpscore[actnode] = 0;
+    }
+
     return 0;
 }
 
-void igraph_i_destroy_biguints(igraph_biguint_t *p) {
-    igraph_biguint_t *p2 = p;
-    while ( *((long int*)(p)) ) {
-        igraph_biguint_destroy(p);
-        p++;
-    }
-    igraph_Free(p2);
-}
-
 /**
  * \ingroup structural
  * \function igraph_betweenness_estimate
@@ -1807,6 +3372,10 @@ void igraph_i_destroy_biguints(igraph_biguint_t *p) {
  * equal to a prescribed length. Note that the estimated centrality
  * will always be less than the real one.
  *
+ * </para><para>
+ * The calculation is divided among the threads set by \ref
+ * igraph_set_num_threads(), see \ref igraph_betweenness().
+ *
  * \param graph The graph object.
  * \param res The result of the computation, a vector containing the
  *        estimated betweenness scores for the specified vertices.
@@ -1848,233 +3417,828 @@ int igraph_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res,
                                 igraph_bool_t nobigint) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    long int *distance;
-    unsigned long long int *nrgeo = 0;  /* must be long long; consider grid
-                       graphs for example */
-    igraph_biguint_t *big_nrgeo = 0;
-    double *tmpscore;
-    igraph_stack_t stack = IGRAPH_STACK_NULL;
-    long int source;
     long int j, k, nneis;
-    igraph_vector_int_t *neis;
     igraph_vector_t v_tmpres, *tmpres = &v_tmpres;
     igraph_vit_t vit;
+    igraph_i_betweenness_t data;
+    igraph_i_betweenness_run_t run;
 
     igraph_adjlist_t adjlist_out, adjlist_in;
-    igraph_adjlist_t *adjlist_out_p, *adjlist_in_p;
 
-    igraph_biguint_t D, R, T;
+    if (weights) {
+        return igraph_i_betweenness_estimate_weighted(graph, res, vids, directed,
+                cutoff, weights, nobigint);
+    }
+
+    if (!igraph_vs_is_all(&vids)) {
+        /* subset */
+        IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
+    } else {
+        /* only  */
+        IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
+        igraph_vector_null(res);
+        tmpres = res;
+    }
+
+    memset(&data, 0, sizeof(data));
+    directed = directed && igraph_is_directed(graph);
+    if (directed) {
+        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_OUT));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
+        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_IN));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
+        data.adjlist_out = &adjlist_out;
+        data.adjlist_in = &adjlist_in;
+    } else {
+        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_ALL));
+        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
+        data.adjlist_out = data.adjlist_in = &adjlist_out;
+    }
+
+    data.graph = graph;
+    data.cutoff = cutoff;
+    data.nobigint = nobigint;
+    data.nthreads = igraph_i_betweenness_nthreads(no_of_nodes);
+    IGRAPH_FINALLY(igraph_i_betweenness_destroy, &data);
+    IGRAPH_CHECK(igraph_i_betweenness_scratch_init(&data, no_of_nodes, tmpres,
+                 no_of_nodes, !nobigint));
+
+    /* here we go */
+
+    run.source = igraph_i_betweenness_source;
+    run.arg = &data;
+    run.message = "Betweenness centrality: ";
+    run.no_of_nodes = no_of_nodes;
+    run.nthreads = data.nthreads;
+    IGRAPH_I_BETWEENNESS_RUN(&run);
+    igraph_i_betweenness_reduce(&data);
+
+    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
+
+    /* clean  */
+    igraph_i_betweenness_destroy(&data);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    /* Keep only the requested vertices */
+    if (!igraph_vs_is_all(&vids)) {
+        IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+        IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+        IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+
+        for (k = 0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
+             IGRAPH_VIT_NEXT(vit), k++) {
+            long int node = IGRAPH_VIT_GET(vit);
+            VECTOR(*res)[k] = VECTOR(*tmpres)[node];
+        }
+
+        igraph_vit_destroy(&vit);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    /* divide by 2 for undirected graph */
+    if (!directed) {
+        nneis = igraph_vector_size(res);
+        for (j = 0; j < nneis; j++) {
+            VECTOR(*res)[j] /= 2.0;
+        }
+    }
+
+    if (directed) {
+        igraph_adjlist_destroy(&adjlist_in);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_adjlist_destroy(&adjlist_out);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    if (!igraph_vs_is_all(&vids)) {
+        igraph_vector_destroy(tmpres);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    return 0;
+}
+
+/* Sampling estimate of betweenness, after Matteo Riondato and Evgenios
+ * M. Kornaropoulos: Fast approximation of betweenness centrality
+ * through sampling, WSDM 2014. Every sample is a random ordered pair
+ * of vertices (u, v) and a shortest path between them chosen
+ * uniformly at random; the interior vertices of the path get a hit.
+ * The samples are distributed among the threads like the sources of
+ * the exact betweenness, sample i draws from the random stream i of a
+ * seed taken from the default generator, and the hits are counted in
+ * integers, so the result does not depend on the number of threads.
+ *
+ * In weighted graphs Dijkstra's algorithm from u stops when v is
+ * reached: the vertices that are closer to u than v, which are the
+ * only ones the path can go through, have their final number of
+ * shortest paths by then. Unweighted graphs use a bidirectional
+ * search. */
+
+typedef struct igraph_i_betweenness_sample_scratch_t {
+    igraph_rng_t rng;
+    igraph_dqueue_t q;
+    igraph_i_spqueue_t Q;
+    igraph_vector_int_t touched;
+    igraph_vector_t dist, nrgeo;
+    igraph_vector_t bdist, bnrgeo;
+    igraph_vector_int_t ffront, bfront, next;
+    igraph_vector_t hits;
+} igraph_i_betweenness_sample_scratch_t;
+
+typedef struct igraph_i_betweenness_sample_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_inclist_t *inclist_out, *inclist_in;
+    unsigned long int seed;
+    int nthreads;
+    igraph_i_betweenness_sample_scratch_t *scratch;
+} igraph_i_betweenness_sample_t;
+
+static void igraph_i_betweenness_sample_destroy(igraph_i_betweenness_sample_t *data) {
+    int i;
+    if (data->scratch) {
+        for (i = 0; i < data->nthreads; i++) {
+            igraph_i_betweenness_sample_scratch_t *s = &data->scratch[i];
+            if (s->rng.type) {
+                igraph_rng_destroy(&s->rng);
+            }
+            igraph_dqueue_destroy(&s->q);
+            igraph_i_spqueue_destroy(&s->Q);
+            igraph_vector_int_destroy(&s->touched);
+            igraph_vector_destroy(&s->dist);
+            igraph_vector_destroy(&s->nrgeo);
+            igraph_vector_destroy(&s->bdist);
+            igraph_vector_destroy(&s->bnrgeo);
+            igraph_vector_int_destroy(&s->ffront);
+            igraph_vector_int_destroy(&s->bfront);
+            igraph_vector_int_destroy(&s->next);
+            igraph_vector_destroy(&s->hits);
+        }
+        igraph_Free(data->scratch);
+    }
+}
+
+static int igraph_i_betweenness_sample_scratch_init(igraph_i_betweenness_sample_t *data,
+        long int no_of_nodes) {
+    int i;
+
+    data->scratch = igraph_Calloc(data->nthreads,
+                                  igraph_i_betweenness_sample_scratch_t);
+    if (!data->scratch) {
+        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+    }
+
+    for (i = 0; i < data->nthreads; i++) {
+        igraph_i_betweenness_sample_scratch_t *s = &data->scratch[i];
+        IGRAPH_CHECK(igraph_rng_init(&s->rng, &igraph_rngtype_philox4x32));
+        IGRAPH_CHECK(igraph_dqueue_init(&s->q, no_of_nodes));
+        IGRAPH_CHECK(igraph_i_spqueue_init(&s->Q, no_of_nodes, data->weights));
+        IGRAPH_CHECK(igraph_vector_int_init(&s->touched, 0));
+        IGRAPH_CHECK(igraph_vector_init(&s->dist, no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_init(&s->nrgeo, no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_init(&s->bdist, data->weights ? 0 : no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_init(&s->bnrgeo, data->weights ? 0 : no_of_nodes));
+        IGRAPH_CHECK(igraph_vector_int_init(&s->ffront, 0));
+        IGRAPH_CHECK(igraph_vector_int_init(&s->bfront, 0));
+        IGRAPH_CHECK(igraph_vector_int_init(&s->next, 0));
+        IGRAPH_CHECK(igraph_vector_init(&s->hits, no_of_nodes));
+    }
+
+    return 0;
+}
+
+/* Dijkstra's algorithm from 'source' until 'target' is reached.
+   dist[v] is the distance plus one, or zero if v was not reached. */
+
+static int igraph_i_betweenness_sample_dijkstra(igraph_i_betweenness_sample_t *data,
+        igraph_i_betweenness_sample_scratch_t *s,
+        long int source, long int target,
+        igraph_bool_t *reached) {
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    igraph_vector_t *dist = &s->dist, *nrgeo = &s->nrgeo;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+    long int j;
+
+    *reached = 0;
+    VECTOR(*dist)[source] = 1.0;
+    VECTOR(*nrgeo)[source] = 1.0;
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->touched, source));
+
+    IGRAPH_CHECK(igraph_i_spqueue_push(&s->Q, source, 1.0));
+    while (!igraph_i_spqueue_empty(&s->Q)) {
+        long int minnei;
+        igraph_real_t mindist = igraph_i_spqueue_delete_min(&s->Q, &minnei);
+        igraph_vector_int_t *neis;
+        long int nlen;
+        if (minnei == target) {
+            *reached = 1;
+            break;
+        }
+        neis = igraph_inclist_get(data->inclist_out, minnei);
+        nlen = igraph_vector_int_size(neis);
+        for (j = 0; j < nlen; j++) {
+            long int edge = (long int) VECTOR(*neis)[j];
+            long int to = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+            igraph_real_t curdist = VECTOR(*dist)[to];
+            if (curdist == 0) {
+                /* This is the first non-infinite distance */
+                VECTOR(*dist)[to] = altdist;
+                VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                IGRAPH_CHECK(igraph_vector_int_push_back(&s->touched, to));
+                IGRAPH_CHECK(igraph_i_spqueue_push(&s->Q, to, altdist));
+            } else {
+                int cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
+                if (cmp_result < 0) {
+                    /* This is a shorter path */
+                    VECTOR(*dist)[to] = altdist;
+                    VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(&s->Q, to, altdist));
+                } else if (cmp_result == 0) {
+                    VECTOR(*nrgeo)[to] += VECTOR(*nrgeo)[minnei];
+                }
+            }
+        }
+    }
+    igraph_i_spqueue_clear(&s->Q);
+
+    return 0;
+}
+
+/* Walks from 'w' back to the root of a search, the one with distance
+   one in 'dist'. Every step chooses a predecessor with probability
+   proportional to its number of shortest paths, the vertices before
+   the root get a hit. 'inclist' has the edges towards the root. */
+
+static void igraph_i_betweenness_sample_walk(igraph_i_betweenness_sample_t *data,
+        igraph_i_betweenness_sample_scratch_t *s,
+        igraph_inclist_t *inclist,
+        const igraph_vector_t *dist,
+        const igraph_vector_t *nrgeo,
+        long int w) {
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
+    long int j;
+
+    while (VECTOR(*dist)[w] != 1.0) {
+        igraph_vector_int_t *neis = igraph_inclist_get(inclist, w);
+        long int nneis = igraph_vector_int_size(neis), pred = -1;
+        igraph_real_t x = igraph_rng_get_unif(&s->rng, 0, VECTOR(*nrgeo)[w]);
+        for (j = 0; j < nneis; j++) {
+            long int edge = (long int) VECTOR(*neis)[j];
+            long int f = IGRAPH_OTHER(graph, edge, w);
+            igraph_bool_t before;
+            if (VECTOR(*dist)[f] == 0) {
+                continue;
+            }
+            if (weights) {
+                before = igraph_cmp_epsilon(VECTOR(*dist)[f] + VECTOR(*weights)[edge],
+                                            VECTOR(*dist)[w], eps) == 0;
+            } else {
+                before = VECTOR(*dist)[f] == VECTOR(*dist)[w] - 1;
+            }
+            if (before) {
+                pred = f;
+                x -= VECTOR(*nrgeo)[f];
+                if (x < 0) {
+                    break;
+                }
+            }
+        }
+        if (VECTOR(*dist)[pred] != 1.0) {
+            VECTOR(s->hits)[pred] += 1;
+        }
+        w = pred;
+    }
+}
+
+/* Balanced bidirectional breadth-first search, as in Michele Borassi
+ * and Emanuele Natale: KADABRA is an adaptive algorithm for betweenness
+ * via random approximation, ESA 2016. The side with fewer edges in its
+ * frontier is expanded by a full level. Once the new level meets the
+ * other search, every shortest path goes through exactly one of the
+ * meeting vertices, which is chosen with probability proportional to
+ * the paths through it, and the two halves of the path are sampled
+ * from the two searches. On most networks this visits a small part of
+ * the graph. */
+
+static int igraph_i_betweenness_sample_bidir(igraph_i_betweenness_sample_t *data,
+        igraph_i_betweenness_sample_scratch_t *s,
+        long int source, long int target) {
+    const igraph_t *graph = data->graph;
+    igraph_vector_t *fdist = &s->dist, *fnrgeo = &s->nrgeo;
+    igraph_vector_t *bdist = &s->bdist, *bnrgeo = &s->bnrgeo;
+    igraph_vector_int_t *ffront = &s->ffront, *bfront = &s->bfront;
+    igraph_vector_int_t *next = &s->next, *met = 0, *tmp;
+    igraph_real_t fvol, bvol, total = 0;
+    long int i, j;
+
+    VECTOR(*fdist)[source] = VECTOR(*fnrgeo)[source] = 1.0;
+    VECTOR(*bdist)[target] = VECTOR(*bnrgeo)[target] = 1.0;
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->touched, source));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->touched, target));
+    igraph_vector_int_clear(ffront);
+    igraph_vector_int_clear(bfront);
+    IGRAPH_CHECK(igraph_vector_int_push_back(ffront, source));
+    IGRAPH_CHECK(igraph_vector_int_push_back(bfront, target));
+    fvol = igraph_vector_int_size(igraph_inclist_get(data->inclist_out, source));
+    bvol = igraph_vector_int_size(igraph_inclist_get(data->inclist_in, target));
+
+    while (total == 0 && igraph_vector_int_size(ffront) > 0 &&
+           igraph_vector_int_size(bfront) > 0) {
+        igraph_bool_t forward = fvol <= bvol;
+        igraph_vector_int_t *front = forward ? ffront : bfront;
+        igraph_inclist_t *inclist = forward ? data->inclist_out : data->inclist_in;
+        igraph_vector_t *dist = forward ? fdist : bdist;
+        igraph_vector_t *nrgeo = forward ? fnrgeo : bnrgeo;
+        igraph_vector_t *odist = forward ? bdist : fdist;
+        igraph_vector_t *onrgeo = forward ? bnrgeo : fnrgeo;
+        igraph_real_t vol = 0;
+
+        igraph_vector_int_clear(next);
+        for (i = 0; i < igraph_vector_int_size(front); i++) {
+            long int actnode = VECTOR(*front)[i];
+            igraph_vector_int_t *neis = igraph_inclist_get(inclist, actnode);
+            long int nneis = igraph_vector_int_size(neis);
+            for (j = 0; j < nneis; j++) {
+                long int neighbor = IGRAPH_OTHER(graph, VECTOR(*neis)[j], actnode);
+                if (VECTOR(*dist)[neighbor] == 0) {
+                    VECTOR(*dist)[neighbor] = VECTOR(*dist)[actnode] + 1;
+                    IGRAPH_CHECK(igraph_vector_int_push_back(next, neighbor));
+                    if (VECTOR(*odist)[neighbor] == 0) {
+                        IGRAPH_CHECK(igraph_vector_int_push_back(&s->touched, neighbor));
+                    }
+                }
+                if (VECTOR(*dist)[neighbor] == VECTOR(*dist)[actnode] + 1) {
+                    VECTOR(*nrgeo)[neighbor] += VECTOR(*nrgeo)[actnode];
+                }
+            }
+        }
+
+        for (i = 0; i < igraph_vector_int_size(next); i++) {
+            long int v = VECTOR(*next)[i];
+            if (VECTOR(*odist)[v] != 0) {
+                total += VECTOR(*nrgeo)[v] * VECTOR(*onrgeo)[v];
+            }
+            vol += igraph_vector_int_size(igraph_inclist_get(inclist, v));
+        }
+
+        tmp = front; met = next; next = tmp;
+        if (forward) {
+            ffront = met; fvol = vol;
+        } else {
+            bfront = met; bvol = vol;
+        }
+    }
+
+    if (total > 0) {
+        igraph_real_t x = igraph_rng_get_unif(&s->rng, 0, total);
+        long int mid = -1;
+        for (i = 0; i < igraph_vector_int_size(met); i++) {
+            long int v = VECTOR(*met)[i];
+            if (VECTOR(*fdist)[v] != 0 && VECTOR(*bdist)[v] != 0) {
+                mid = v;
+                x -= VECTOR(*fnrgeo)[v] * VECTOR(*bnrgeo)[v];
+                if (x < 0) {
+                    break;
+                }
+            }
+        }
+        if (mid != source && mid != target) {
+            VECTOR(s->hits)[mid] += 1;
+        }
+        igraph_i_betweenness_sample_walk(data, s, data->inclist_in, fdist,
+                                         fnrgeo, mid);
+        igraph_i_betweenness_sample_walk(data, s, data->inclist_out, bdist,
+                                         bnrgeo, mid);
+    }
+
+    return 0;
+}
+
+static int igraph_i_betweenness_sample_one(void *arg, int thread,
+        long int sample) {
+    igraph_i_betweenness_sample_t *data = (igraph_i_betweenness_sample_t *) arg;
+    igraph_i_betweenness_sample_scratch_t *s = &data->scratch[thread];
+    long int no_of_nodes = igraph_vcount(data->graph);
+    long int source, target, j;
+    igraph_bool_t reached;
+
+    IGRAPH_CHECK(igraph_rng_seed_stream(&s->rng, data->seed, sample));
+    source = igraph_rng_get_integer(&s->rng, 0, no_of_nodes - 1);
+    target = igraph_rng_get_integer(&s->rng, 0, no_of_nodes - 2);
+    if (target >= source) {
+        target++;
+    }
+
+    if (data->weights) {
+        IGRAPH_CHECK(igraph_i_betweenness_sample_dijkstra(data, s, source, target,
+                     &reached));
+        if (reached) {
+            igraph_i_betweenness_sample_walk(data, s, data->inclist_in, &s->dist,
+                                             &s->nrgeo, target);
+        }
+    } else {
+        IGRAPH_CHECK(igraph_i_betweenness_sample_bidir(data, s, source, target));
+    }
+
+    for (j = 0; j < igraph_vector_int_size(&s->touched); j++) {
+        long int v = VECTOR(s->touched)[j];
+        VECTOR(s->dist)[v] = VECTOR(s->nrgeo)[v] = 0;
+        if (!data->weights) {
+            VECTOR(s->bdist)[v] = VECTOR(s->bnrgeo)[v] = 0;
+        }
+    }
+    igraph_vector_int_clear(&s->touched);
+
+    return 0;
+}
+
+/* An upper bound on the vertex diameter, the number of vertices on the
+   longest shortest path. Undirected graphs run one search from a
+   vertex of every component, the distances from it give a factor two
+   bound, and in weighted graphs a path cannot have more edges than its
+   length over the smallest weight. Directed paths are only bounded by
+   the size of the weak components. */
+
+static int igraph_i_betweenness_sample_vd(const igraph_t *graph,
+        const igraph_vector_t *weights,
+        igraph_bool_t directed,
+        igraph_real_t *vd) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vector_t membership, csize, ecc, dist;
+    igraph_integer_t no_of_clusters;
+    igraph_inclist_t inclist;
+    igraph_i_spqueue_t Q;
+    long int i, j;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&membership, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&csize, 0);
+    IGRAPH_CHECK(igraph_clusters(graph, &membership, &csize, &no_of_clusters,
+                                 IGRAPH_WEAK));
+    *vd = igraph_vector_max(&csize);
+
+    if (!directed && *vd > 2) {
+        igraph_real_t minweight = weights ? igraph_vector_min(weights) : 1;
+
+        IGRAPH_VECTOR_INIT_FINALLY(&ecc, no_of_clusters);
+        IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
+        IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, IGRAPH_ALL));
+        IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
+        IGRAPH_CHECK(igraph_i_spqueue_init(&Q, no_of_nodes, weights));
+        IGRAPH_FINALLY(igraph_i_spqueue_destroy, &Q);
+
+        /* The searches from the first vertex of each component are run
+           together, they do not meet */
+        igraph_vector_fill(&ecc, -1);
+        for (i = 0; i < no_of_nodes; i++) {
+            long int c = (long int) VECTOR(membership)[i];
+            if (VECTOR(ecc)[c] < 0) {
+                VECTOR(ecc)[c] = 0;
+                IGRAPH_CHECK(igraph_i_spqueue_push(&Q, i, 1.0));
+                VECTOR(dist)[i] = 1.0;
+            }
+        }
+        while (!igraph_i_spqueue_empty(&Q)) {
+            long int minnei;
+            igraph_real_t mindist = igraph_i_spqueue_delete_min(&Q, &minnei);
+            igraph_vector_int_t *neis = igraph_inclist_get(&inclist, minnei);
+            long int nlen = igraph_vector_int_size(neis);
+            long int c = (long int) VECTOR(membership)[minnei];
+            if (mindist - 1 > VECTOR(ecc)[c]) {
+                VECTOR(ecc)[c] = mindist - 1;
+            }
+            for (j = 0; j < nlen; j++) {
+                long int edge = (long int) VECTOR(*neis)[j];
+                long int to = IGRAPH_OTHER(graph, edge, minnei);
+                igraph_real_t altdist = mindist + (weights ? VECTOR(*weights)[edge] : 1);
+                if (VECTOR(dist)[to] == 0) {
+                    VECTOR(dist)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_spqueue_push(&Q, to, altdist));
+                } else if (altdist < VECTOR(dist)[to] &&
+                           igraph_i_spqueue_has_active(&Q, to)) {
+                    VECTOR(dist)[to] = altdist;
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(&Q, to, altdist));
+                }
+            }
+        }
+
+        *vd = 0;
+        for (i = 0; i < no_of_clusters; i++) {
+            igraph_real_t bound = floor(2 * VECTOR(ecc)[i] / minweight) + 1;
+            if (bound > VECTOR(csize)[i]) {
+                bound = VECTOR(csize)[i];
+            }
+            if (bound > *vd) {
+                *vd = bound;
+            }
+        }
+
+        igraph_i_spqueue_destroy(&Q);
+        igraph_inclist_destroy(&inclist);
+        igraph_vector_destroy(&dist);
+        igraph_vector_destroy(&ecc);
+        IGRAPH_FINALLY_CLEAN(4);
+    }
+
+    igraph_vector_destroy(&csize);
+    igraph_vector_destroy(&membership);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \ingroup structural
+ * \function igraph_betweenness_approx
+ * \brief Betweenness centrality estimated from random shortest paths.
+ *
+ * </para><para>
+ * This function samples random vertex pairs, and a uniformly random
+ * shortest path between each pair, and counts how often each vertex
+ * is inside the sampled paths. The number of samples is chosen so that
+ * with probability at least 1 - \p delta the error of every score is
+ * less than \p epsilon, relative to the number of vertex pairs:
+ * n(n-1) for directed and n(n-1)/2 for undirected paths, where n is
+ * the number of vertices. The number of samples depends on the vertex
+ * diameter (the largest number of vertices on a shortest path) only
+ * logarithmically and not on the size of the graph, see Matteo Riondato
+ * and Evgenios M. Kornaropoulos: Fast approximation of betweenness
+ * centrality through sampling, WSDM 2014.
+ *
+ * </para><para>
+ * Unlike \ref igraph_betweenness_estimate(), which ignores the long
+ * paths, this estimate is unbiased: it is the exact betweenness in
+ * expectation. The scores have the same scale as the ones of \ref
+ * igraph_betweenness().
+ *
+ * </para><para>
+ * The random vertex pairs are taken from random streams seeded from
+ * igraph's default random number generator. The samples are divided
+ * among the threads set by \ref igraph_set_num_threads(), the result
+ * does not depend on the number of threads.
+ *
+ * \param graph The graph object.
+ * \param res The result of the computation, a vector containing the
+ *        estimated betweenness scores for the specified vertices.
+ * \param vids The vertices of which the betweenness centrality scores
+ *        will be estimated.
+ * \param directed Logical, if true directed paths will be considered
+ *        for directed graphs. It is ignored for undirected graphs.
+ * \param weights An optional vector containing positive edge weights,
+ *        supply a null pointer for unweighted betweenness.
+ * \param epsilon The largest allowed error of the scores, as a fraction
+ *        of the number of vertex pairs, between zero and one.
+ * \param delta The probability that the error of some score is larger
+ *        than \p epsilon, between zero and one.
+ * \param samples Pointer to an integer or a null pointer. If not null,
+ *        the number of sampled vertex pairs is stored here.
+ * \return Error code:
+ *        \c IGRAPH_ENOMEM, not enough memory for
+ *        temporary data.
+ *        \c IGRAPH_EINVAL, invalid \p epsilon, \p delta or weights.
+ *        \c IGRAPH_EINVVID, invalid vertex id passed in
+ *        \p vids.
+ *
+ * Time complexity: O(r |E| log|V|) in the worst case, where r =
+ * (log2(vd-2) + 1 + ln(1/delta)) / (2 epsilon^2) is the number of
+ * samples and vd is the vertex diameter, but the searches stop when
+ * they reach the target vertex.
+ *
+ * \sa \ref igraph_betweenness() for the exact scores.
+ */
+int igraph_betweenness_approx(const igraph_t *graph, igraph_vector_t *res,
+                              const igraph_vs_t vids, igraph_bool_t directed,
+                              const igraph_vector_t *weights,
+                              igraph_real_t epsilon, igraph_real_t delta,
+                              igraph_integer_t *samples) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_i_betweenness_sample_t data;
+    igraph_i_betweenness_run_t run;
+    igraph_inclist_t inclist_out, inclist_in;
+    igraph_vector_t tmpres;
+    igraph_vit_t vit;
+    igraph_real_t vd, r, pairs;
+    long int j, k, no_of_samples = 0;
+    int i;
 
-    if (weights) {
-        return igraph_i_betweenness_estimate_weighted(graph, res, vids, directed,
-                cutoff, weights, nobigint);
+    if (epsilon <= 0 || epsilon >= 1) {
+        IGRAPH_ERROR("epsilon must be between zero and one", IGRAPH_EINVAL);
     }
-
-    if (!igraph_vs_is_all(&vids)) {
-        /* subset */
-        IGRAPH_VECTOR_INIT_FINALLY(tmpres, no_of_nodes);
-    } else {
-        /* only  */
-        IGRAPH_CHECK(igraph_vector_resize(res, no_of_nodes));
-        igraph_vector_null(res);
-        tmpres = res;
+    if (delta <= 0 || delta >= 1) {
+        IGRAPH_ERROR("delta must be between zero and one", IGRAPH_EINVAL);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0 && !(igraph_vector_min(weights) > 0)) {
+            IGRAPH_ERROR("Weight vector must be positive", IGRAPH_EINVAL);
+        }
     }
 
     directed = directed && igraph_is_directed(graph);
-    if (directed) {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_OUT));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_IN));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
-        adjlist_out_p = &adjlist_out;
-        adjlist_in_p = &adjlist_in;
-    } else {
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_out, IGRAPH_ALL));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_out);
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist_in, IGRAPH_ALL));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist_in);
-        adjlist_out_p = &adjlist_out;
-        adjlist_in_p = &adjlist_in;
-    }
-    for (j = 0; j < no_of_nodes; j++) {
-        igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, j));
+    IGRAPH_VECTOR_INIT_FINALLY(&tmpres, no_of_nodes);
+
+    if (no_of_nodes > 2) {
+        IGRAPH_CHECK(igraph_i_betweenness_sample_vd(graph, weights, directed, &vd));
+        if (vd > 2) {
+            r = ceil(0.5 / (epsilon * epsilon) *
+                     (floor(log(vd - 2) / log(2.0)) + 1 + log(1 / delta)));
+            if (r > IGRAPH_INTEGER_MAX) {
+                IGRAPH_ERROR("Too many samples, increase epsilon", IGRAPH_EINVAL);
+            }
+            no_of_samples = (long int) r;
+        }
     }
 
-    distance = igraph_Calloc(no_of_nodes, long int);
-    if (distance == 0) {
-        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, distance);
-    if (nobigint) {
-        nrgeo = igraph_Calloc(no_of_nodes, unsigned long long int);
-        if (nrgeo == 0) {
-            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+    if (no_of_samples > 0) {
+        if (directed) {
+            IGRAPH_CHECK(igraph_inclist_init(graph, &inclist_out, IGRAPH_OUT));
+            IGRAPH_FINALLY(igraph_inclist_destroy, &inclist_out);
+            IGRAPH_CHECK(igraph_inclist_init(graph, &inclist_in, IGRAPH_IN));
+            IGRAPH_FINALLY(igraph_inclist_destroy, &inclist_in);
+            data.inclist_out = &inclist_out;
+            data.inclist_in = &inclist_in;
+        } else {
+            IGRAPH_CHECK(igraph_inclist_init(graph, &inclist_out, IGRAPH_ALL));
+            IGRAPH_FINALLY(igraph_inclist_destroy, &inclist_out);
+            data.inclist_out = data.inclist_in = &inclist_out;
         }
-        IGRAPH_FINALLY(igraph_free, nrgeo);
-    } else {
-        /* +1 is to have one containing zeros, when we free it, we stop
-           at the zero */
-        big_nrgeo = igraph_Calloc(no_of_nodes + 1, igraph_biguint_t);
-        if (!big_nrgeo) {
-            IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+
+        data.graph = graph;
+        data.weights = weights;
+        RNG_BEGIN();
+        data.seed = RNG_INT31();
+        data.seed = (data.seed << 16 << 15) ^ RNG_INT31();
+        RNG_END();
+        data.nthreads = igraph_i_betweenness_nthreads(no_of_samples);
+        data.scratch = 0;
+        IGRAPH_FINALLY(igraph_i_betweenness_sample_destroy, &data);
+        IGRAPH_CHECK(igraph_i_betweenness_sample_scratch_init(&data, no_of_nodes));
+
+        run.source = igraph_i_betweenness_sample_one;
+        run.arg = &data;
+        run.message = "Betweenness sampling: ";
+        run.no_of_nodes = no_of_samples;
+        run.nthreads = data.nthreads;
+        IGRAPH_I_BETWEENNESS_RUN(&run);
+
+        for (i = 0; i < data.nthreads; i++) {
+            igraph_vector_add(&tmpres, &data.scratch[i].hits);
         }
-        IGRAPH_FINALLY(igraph_i_destroy_biguints, big_nrgeo);
-        for (j = 0; j < no_of_nodes; j++) {
-            IGRAPH_CHECK(igraph_biguint_init(&big_nrgeo[j]));
+
+        igraph_i_betweenness_sample_destroy(&data);
+        IGRAPH_FINALLY_CLEAN(1);
+        if (directed) {
+            igraph_inclist_destroy(&inclist_in);
+            IGRAPH_FINALLY_CLEAN(1);
         }
-        IGRAPH_CHECK(igraph_biguint_init(&D));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &D);
-        IGRAPH_CHECK(igraph_biguint_init(&R));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &R);
-        IGRAPH_CHECK(igraph_biguint_init(&T));
-        IGRAPH_FINALLY(igraph_biguint_destroy, &T);
-    }
-    tmpscore = igraph_Calloc(no_of_nodes, double);
-    if (tmpscore == 0) {
-        IGRAPH_ERROR("betweenness failed", IGRAPH_ENOMEM);
+        igraph_inclist_destroy(&inclist_out);
+        IGRAPH_FINALLY_CLEAN(1);
+
+        pairs = (igraph_real_t) no_of_nodes * (no_of_nodes - 1);
+        if (!directed) {
+            pairs /= 2.0;
+        }
+        igraph_vector_scale(&tmpres, pairs / no_of_samples);
     }
-    IGRAPH_FINALLY(igraph_free, tmpscore);
 
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    igraph_stack_init(&stack, no_of_nodes);
-    IGRAPH_FINALLY(igraph_stack_destroy, &stack);
+    IGRAPH_PROGRESS("Betweenness sampling: ", 100.0, 0);
 
-    /* here we go */
+    IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+    for (k = 0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
+         IGRAPH_VIT_NEXT(vit), k++) {
+        j = IGRAPH_VIT_GET(vit);
+        VECTOR(*res)[k] = VECTOR(tmpres)[j];
+    }
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
+    if (samples) {
+        *samples = (igraph_integer_t) no_of_samples;
+    }
 
-        IGRAPH_CHECK(igraph_dqueue_push(&q, source));
-        if (nobigint) {
-            nrgeo[source] = 1;
-        } else {
-            igraph_biguint_set_limb(&big_nrgeo[source], 1);
-        }
-        distance[source] = 1;
+    igraph_vit_destroy(&vit);
+    igraph_vector_destroy(&tmpres);
+    IGRAPH_FINALLY_CLEAN(2);
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            IGRAPH_CHECK(igraph_stack_push(&stack, actnode));
+    return 0;
+}
 
-            if (cutoff > 0 && distance[actnode] >= cutoff + 1) {
-                continue;
-            }
+static int igraph_i_edge_betweenness_weighted_source(void *arg, int thread,
+        long int source) {
+    igraph_i_betweenness_t *data = (igraph_i_betweenness_t *) arg;
+    igraph_i_betweenness_weighted_scratch_t *s = &data->wscratch[thread];
+    const igraph_t *graph = data->graph;
+    const igraph_vector_t *weights = data->weights;
+    igraph_real_t cutoff = data->cutoff;
+    igraph_i_spqueue_t *Q = &s->Q;
+    igraph_inclist_t *fathers = &s->inclist_fathers;
+    igraph_stack_t *S = &s->S;
+    igraph_vector_t *distance = &s->dist, *tmpscore = &s->tmpscore;
+    igraph_vector_long_t *nrgeo = &s->nrgeo_long;
+    igraph_vector_t *result = s->res;
+    long int j;
+    int cmp_result;
+    const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
 
-            neis = igraph_adjlist_get(adjlist_out_p, actnode);
-            nneis = igraph_vector_int_size(neis);
-            for (j = 0; j < nneis; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (distance[neighbor] == 0) {
-                    distance[neighbor] = distance[actnode] + 1;
-                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                }
-                if (distance[neighbor] == distance[actnode] + 1) {
-                    igraph_vector_int_t *v = igraph_adjlist_get(adjlist_in_p,
-                                             neighbor);
-                    igraph_vector_int_push_back(v, actnode);
-                    if (nobigint) {
-                        nrgeo[neighbor] += nrgeo[actnode];
-                    } else {
-                        IGRAPH_CHECK(igraph_biguint_add(&big_nrgeo[neighbor],
-                                                        &big_nrgeo[neighbor],
-                                                        &big_nrgeo[actnode]));
-                    }
-                }
-            }
-        } /* while !igraph_dqueue_empty */
+    /*     printf("source: %li\n", source); */
 
-        /* Ok, we've the distance of each node and also the number of
-           shortest paths to them. Now we do an inverse search, starting
-           with the farthest nodes. */
-        while (!igraph_stack_empty(&stack)) {
-            long int actnode = (long int) igraph_stack_pop(&stack);
-            neis = igraph_adjlist_get(adjlist_in_p, actnode);
-            nneis = igraph_vector_int_size(neis);
-            for (j = 0; j < nneis; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (nobigint) {
-                    tmpscore[neighbor] +=  (tmpscore[actnode] + 1) *
-                                           ((double)(nrgeo[neighbor])) / nrgeo[actnode];
-                } else {
-                    if (!igraph_biguint_compare_limb(&big_nrgeo[actnode], 0)) {
-                        tmpscore[neighbor] = IGRAPH_INFINITY;
-                    } else {
-                        double div;
-                        limb_t shift = 1000000000L;
-                        IGRAPH_CHECK(igraph_biguint_mul_limb(&T, &big_nrgeo[neighbor],
-                                                             shift));
-                        igraph_biguint_div(&D, &R, &T, &big_nrgeo[actnode]);
-                        div = igraph_biguint_get(&D) / shift;
-                        tmpscore[neighbor] += (tmpscore[actnode] + 1) * div;
-                    }
-                }
-            }
+    igraph_vector_null(distance);
+    igraph_vector_null(tmpscore);
+    igraph_vector_long_null(nrgeo);
 
-            if (actnode != source) {
-                VECTOR(*tmpres)[actnode] += tmpscore[actnode];
-            }
+    IGRAPH_CHECK(igraph_i_spqueue_push(Q, source, 1.0));
+    VECTOR(*distance)[source] = 1.0;
+    VECTOR(*nrgeo)[source] = 1;
 
-            distance[actnode] = 0;
-            if (nobigint) {
-                nrgeo[actnode] = 0;
-            } else {
-                igraph_biguint_set_limb(&big_nrgeo[actnode], 0);
-            }
-            tmpscore[actnode] = 0;
-            igraph_vector_int_clear(igraph_adjlist_get(adjlist_in_p, actnode));
-        }
+    while (!igraph_i_spqueue_empty(Q)) {
+        long int minnei;
+        igraph_real_t mindist = igraph_i_spqueue_delete_min(Q, &minnei);
+        igraph_vector_int_t *neis;
+        long int nlen;
 
-    } /* for source < no_of_nodes */
+        /* printf("SP to %li is final, dist: %g, nrgeo: %li\n", minnei, */
+        /* VECTOR(distance)[minnei]-1.0, VECTOR(nrgeo)[minnei]); */
 
-    IGRAPH_PROGRESS("Betweenness centrality: ", 100.0, 0);
+        igraph_stack_push(S, minnei);
 
-    /* clean  */
-    igraph_Free(distance);
-    if (nobigint) {
-        igraph_Free(nrgeo);
-    } else {
-        igraph_biguint_destroy(&T);
-        igraph_biguint_destroy(&R);
-        igraph_biguint_destroy(&D);
-        IGRAPH_FINALLY_CLEAN(3);
-        igraph_i_destroy_biguints(big_nrgeo);
-    }
-    igraph_Free(tmpscore);
+        if (cutoff > 0 && VECTOR(*distance)[minnei] >= cutoff + 1.0) {
+            continue;
+        }
 
-    igraph_dqueue_destroy(&q);
-    igraph_stack_destroy(&stack);
-    IGRAPH_FINALLY_CLEAN(5);
+        neis = igraph_inclist_get(data->inclist_out, minnei);
+        nlen = igraph_vector_int_size(neis);
+        for (j = 0; j < nlen; j++) {
+            long int edge = (long int) VECTOR(*neis)[j];
+            long int to = IGRAPH_OTHER(graph, edge, minnei);
+            igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
+            igraph_real_t curdist = VECTOR(*distance)[to];
 
-    /* Keep only the requested vertices */
-    if (!igraph_vs_is_all(&vids)) {
-        IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
-        IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-        IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
+            if (curdist == 0) {
+                /* this means curdist is infinity */
+                cmp_result = -1;
+            } else {
+                cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
+            }
 
-        for (k = 0, IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit);
-             IGRAPH_VIT_NEXT(vit), k++) {
-            long int node = IGRAPH_VIT_GET(vit);
-            VECTOR(*res)[k] = VECTOR(*tmpres)[node];
+            /* printf("to=%ld, altdist = %lg, curdist = %lg, cmp = %d\n",
+              to, altdist, curdist-1, cmp_result); */
+            if (curdist == 0) {
+                /* This is the first finite distance to 'to' */
+                igraph_vector_int_t *v = igraph_inclist_get(fathers, to);
+                /* printf("Found first path to %li (from %li)\n", to, minnei); */
+                IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                VECTOR(*v)[0] = edge;
+                VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                VECTOR(*distance)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_spqueue_push(Q, to, altdist));
+            } else if (cmp_result < 0) {
+                /* This is a shorter path */
+                igraph_vector_int_t *v = igraph_inclist_get(fathers, to);
+                /* printf("Found a shorter path to %li (from %li)\n", to, minnei); */
+                IGRAPH_CHECK(igraph_vector_int_resize(v, 1));
+                VECTOR(*v)[0] = edge;
+                VECTOR(*nrgeo)[to] = VECTOR(*nrgeo)[minnei];
+                VECTOR(*distance)[to] = altdist;
+                IGRAPH_CHECK(igraph_i_spqueue_modify(Q, to, altdist));
+            } else if (cmp_result == 0) {
+                igraph_vector_int_t *v = igraph_inclist_get(fathers, to);
+                /* printf("Found a second SP to %li (from %li)\n", to, minnei); */
+                IGRAPH_CHECK(igraph_vector_int_push_back(v, edge));
+                VECTOR(*nrgeo)[to] += VECTOR(*nrgeo)[minnei];
+            }
         }
 
-        igraph_vit_destroy(&vit);
-        igraph_vector_destroy(tmpres);
-        IGRAPH_FINALLY_CLEAN(2);
-    }
-
-    /* divide by 2 for undirected graph */
-    if (!directed) {
-        nneis = igraph_vector_size(res);
-        for (j = 0; j < nneis; j++) {
-            VECTOR(*res)[j] /= 2.0;
+    } /* igraph_i_spqueue_empty(Q) */
+
+    while (!igraph_stack_empty(S)) {
+        long int w = (long int) igraph_stack_pop(S);
+        igraph_vector_int_t *fatv = igraph_inclist_get(fathers, w);
+        long int fatv_len = igraph_vector_int_size(fatv);
+        /* printf("Popping %li.\n", w); */
+        for (j = 0; j < fatv_len; j++) {
+            long int fedge = (long int) VECTOR(*fatv)[j];
+            long int neighbor = IGRAPH_OTHER(graph, fedge, w);
+            VECTOR(*tmpscore)[neighbor] += ((double)VECTOR(*nrgeo)[neighbor]) /
+                                           VECTOR(*nrgeo)[w] * (1.0 + VECTOR(*tmpscore)[w]);
+            /* printf("Scoring %li (edge %li)\n", neighbor, fedge); */
+            VECTOR(*result)[fedge] +=
+                ((VECTOR(*tmpscore)[w] + 1) * VECTOR(*nrgeo)[neighbor]) /
+                VECTOR(*nrgeo)[w];
         }
-    }
 
-    igraph_adjlist_destroy(&adjlist_out);
-    igraph_adjlist_destroy(&adjlist_in);
-    IGRAPH_FINALLY_CLEAN(2);
+        VECTOR(*tmpscore)[w] = 0;
+        VECTOR(*distance)[w] = 0;
+        VECTOR(*nrgeo)[w] = 0;
+        igraph_vector_int_clear(fatv);
+    }
 
     return 0;
 }
@@ -2088,16 +4252,12 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
     igraph_real_t minweight;
     igraph_integer_t no_of_nodes = (igraph_integer_t) igraph_vcount(graph);
     igraph_integer_t no_of_edges = (igraph_integer_t) igraph_ecount(graph);
-    igraph_2wheap_t Q;
     igraph_inclist_t inclist;
-    igraph_inclist_t fathers;
     igraph_neimode_t mode = directed ? IGRAPH_OUT : IGRAPH_ALL;
-    igraph_vector_t distance, tmpscore;
-    igraph_vector_long_t nrgeo;
-    long int source, j;
-    int cmp_result;
+    long int j;
+    igraph_i_betweenness_t data;
+    igraph_i_betweenness_run_t run;
     const double eps = IGRAPH_SHORTEST_PATH_EPSILON;
-    igraph_stack_t S;
 
     if (igraph_vector_size(weights) != no_of_edges) {
         IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
@@ -2111,119 +4271,27 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 
     IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, mode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
-    IGRAPH_CHECK(igraph_inclist_init_empty(&fathers, no_of_nodes));
-    IGRAPH_FINALLY(igraph_inclist_destroy, &fathers);
-
-    IGRAPH_VECTOR_INIT_FINALLY(&distance, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&tmpscore, no_of_nodes);
-    IGRAPH_CHECK(igraph_vector_long_init(&nrgeo, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &nrgeo);
-
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_stack_init(&S, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &S);
 
     IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
     igraph_vector_null(result);
 
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        /*     printf("source: %li\n", source); */
-
-        igraph_vector_null(&distance);
-        igraph_vector_null(&tmpscore);
-        igraph_vector_long_null(&nrgeo);
-
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-        VECTOR(distance)[source] = 1.0;
-        VECTOR(nrgeo)[source] = 1;
-
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
-            igraph_vector_int_t *neis;
-            long int nlen;
-
-            /* printf("SP to %li is final, dist: %g, nrgeo: %li\n", minnei, */
-            /* VECTOR(distance)[minnei]-1.0, VECTOR(nrgeo)[minnei]); */
-
-            igraph_stack_push(&S, minnei);
-
-            if (cutoff > 0 && VECTOR(distance)[minnei] >= cutoff + 1.0) {
-                continue;
-            }
-
-            neis = igraph_inclist_get(&inclist, minnei);
-            nlen = igraph_vector_int_size(neis);
-            for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int to = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_real_t curdist = VECTOR(distance)[to];
-
-                if (curdist == 0) {
-                    /* this means curdist is infinity */
-                    cmp_result = -1;
-                } else {
-                    cmp_result = igraph_cmp_epsilon(altdist, curdist, eps);
-                }
-
-                /* printf("to=%ld, altdist = %lg, curdist = %lg, cmp = %d\n",
-                  to, altdist, curdist-1, cmp_result); */
-                if (curdist == 0) {
-                    /* This is the first finite distance to 'to' */
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found first path to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_resize(v, 1);
-                    VECTOR(*v)[0] = edge;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-                    VECTOR(distance)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
-                } else if (cmp_result < 0) {
-                    /* This is a shorter path */
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found a shorter path to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_resize(v, 1);
-                    VECTOR(*v)[0] = edge;
-                    VECTOR(nrgeo)[to] = VECTOR(nrgeo)[minnei];
-                    VECTOR(distance)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
-                } else if (cmp_result == 0) {
-                    igraph_vector_int_t *v = igraph_inclist_get(&fathers, to);
-                    /* printf("Found a second SP to %li (from %li)\n", to, minnei); */
-                    igraph_vector_int_push_back(v, edge);
-                    VECTOR(nrgeo)[to] += VECTOR(nrgeo)[minnei];
-                }
-            }
-
-        } /* igraph_2wheap_empty(&Q) */
-
-        while (!igraph_stack_empty(&S)) {
-            long int w = (long int) igraph_stack_pop(&S);
-            igraph_vector_int_t *fatv = igraph_inclist_get(&fathers, w);
-            long int fatv_len = igraph_vector_int_size(fatv);
-            /* printf("Popping %li.\n", w); */
-            for (j = 0; j < fatv_len; j++) {
-                long int fedge = (long int) VECTOR(*fatv)[j];
-                long int neighbor = IGRAPH_OTHER(graph, fedge, w);
-                VECTOR(tmpscore)[neighbor] += ((double)VECTOR(nrgeo)[neighbor]) /
-                                              VECTOR(nrgeo)[w] * (1.0 + VECTOR(tmpscore)[w]);
-                /* printf("Scoring %li (edge %li)\n", neighbor, fedge); */
-                VECTOR(*result)[fedge] +=
-                    ((VECTOR(tmpscore)[w] + 1) * VECTOR(nrgeo)[neighbor]) /
-                    VECTOR(nrgeo)[w];
-            }
-
-            VECTOR(tmpscore)[w] = 0;
-            VECTOR(distance)[w] = 0;
-            VECTOR(nrgeo)[w] = 0;
-            igraph_vector_int_clear(fatv);
-        }
-
-    } /* source < no_of_nodes */
+    memset(&data, 0, sizeof(data));
+    data.graph = graph;
+    data.weights = weights;
+    data.inclist_out = &inclist;
+    data.cutoff = cutoff;
+    data.nthreads = igraph_i_betweenness_nthreads(no_of_nodes);
+    IGRAPH_FINALLY(igraph_i_betweenness_destroy, &data);
+    IGRAPH_CHECK(igraph_i_betweenness_weighted_scratch_init(&data, no_of_nodes,
+                 result, no_of_edges, /* edges= */ 1));
+
+    run.source = igraph_i_edge_betweenness_weighted_source;
+    run.arg = &data;
+    run.message = "Edge betweenness centrality: ";
+    run.no_of_nodes = no_of_nodes;
+    run.nthreads = data.nthreads;
+    IGRAPH_I_BETWEENNESS_RUN(&run);
+    igraph_i_betweenness_reduce(&data);
 
     if (!directed || !igraph_is_directed(graph)) {
         for (j = 0; j < no_of_edges; j++) {
@@ -2233,16 +4301,9 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
 
     IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
-    igraph_stack_destroy(&S);
-    igraph_2wheap_destroy(&Q);
-    IGRAPH_FINALLY_CLEAN(2);
-
+    igraph_i_betweenness_destroy(&data);
     igraph_inclist_destroy(&inclist);
-    igraph_inclist_destroy(&fathers);
-    igraph_vector_destroy(&distance);
-    igraph_vector_destroy(&tmpscore);
-    igraph_vector_long_destroy(&nrgeo);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -2257,6 +4318,12 @@ int igraph_i_edge_betweenness_estimate_weighted(const igraph_t *graph,
  * going through it. If there are more than one geodesics between two
  * vertices, the value of these geodesics are weighted by one over the
  * number of geodesics.
+ *
+ * </para><para>
+ * The calculation is divided among the threads set by \ref
+ * igraph_set_num_threads(). With more than one thread the scores may
+ * differ from the single threaded result by rounding errors.
+ *
  * \param graph The graph object.
  * \param result The result of the computation, vector containing the
  *        betweenness scores for the edges.
@@ -2288,6 +4355,90 @@ int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
                                             weights);
 }
 
+static int igraph_i_edge_betweenness_source(void *arg, int thread,
+        long int source) {
+    igraph_i_betweenness_t *data = (igraph_i_betweenness_t *) arg;
+    igraph_i_betweenness_scratch_t *s = &data->scratch[thread];
+    const igraph_t *graph = data->graph;
+    igraph_real_t cutoff = data->cutoff;
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_dqueue_t *q = &s->q;
+    igraph_stack_t *stack = &s->stack;
+    long int *distance = s->distance;
+    unsigned long long int *nrgeo = s->nrgeo;
+    double *tmpscore = s->tmpscore;
+    igraph_vector_t *result = s->res;
+    igraph_vector_int_t *neip;
+    long int neino;
+    long int i;
+
+    memset(distance, 0, (size_t) no_of_nodes * sizeof(long int));
+    memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(unsigned long long int));
+    memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
+    igraph_stack_clear(stack); /* it should be empty anyway... */
+
+    IGRAPH_CHECK(igraph_dqueue_push(q, source));
+
+    nrgeo[source] = 1;
+    distance[source] = 0;
+
+    while (!igraph_dqueue_empty(q)) {
+        long int actnode = (long int) igraph_dqueue_pop(q);
+
+        if (cutoff > 0 && distance[actnode] >= cutoff ) {
+            continue;
+        }
+
+        /* check the neighbors and add to them to the queue if unseen before */
+        neip = igraph_inclist_get(data->inclist_out, actnode);
+        neino = igraph_vector_int_size(neip);
+        for (i = 0; i < neino; i++) {
+            igraph_integer_t edge = (igraph_integer_t) VECTOR(*neip)[i];
+            long int neighbor = IGRAPH_OTHER(graph, edge, actnode);
+            if (nrgeo[neighbor] != 0) {
+                /* we've already seen this node, another shortest path? */
+                if (distance[neighbor] == distance[actnode] + 1) {
+                    nrgeo[neighbor] += nrgeo[actnode];
+                }
+            } else {
+                /* we haven't seen this node yet */
+                nrgeo[neighbor] += nrgeo[actnode];
+                distance[neighbor] = distance[actnode] + 1;
+                IGRAPH_CHECK(igraph_dqueue_push(q, neighbor));
+                IGRAPH_CHECK(igraph_stack_push(stack, neighbor));
+            }
+        }
+    } /* while !igraph_dqueue_empty */
+
+    /* Ok, we've the distance of each node and also the number of
+       shortest paths to them. Now we do an inverse search, starting
+       with the farthest nodes. */
+    while (!igraph_stack_empty(stack)) {
+        long int actnode = (long int) igraph_stack_pop(stack);
+        if (distance[actnode] < 1) {
+            continue;    /* skip source node */
+        }
+
+        /* set the temporary score of the friends */
+        neip = igraph_inclist_get(data->inclist_in, actnode);
+        neino = igraph_vector_int_size(neip);
+        for (i = 0; i < neino; i++) {
+            igraph_integer_t edgeno = (igraph_integer_t) VECTOR(*neip)[i];
+            long int neighbor = IGRAPH_OTHER(graph, edgeno, actnode);
+            if (distance[neighbor] == distance[actnode] - 1 &&
+                nrgeo[neighbor] != 0) {
+                tmpscore[neighbor] +=
+                    (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
+                VECTOR(*result)[edgeno] +=
+                    (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
+            }
+        }
+    }
+    /* Ok, we've the scores for this source */
+
+    return 0;
+}
+
 /**
  * \ingroup structural
  * \function igraph_edge_betweenness_estimate
@@ -2301,6 +4452,11 @@ int igraph_edge_betweenness(const igraph_t *graph, igraph_vector_t *result,
  * takes into consideration only those paths that are shorter than or
  * equal to a prescribed length. Note that the estimated centrality
  * will always be less than the real one.
+ *
+ * </para><para>
+ * The calculation is divided among the threads set by \ref
+ * igraph_set_num_threads(), see \ref igraph_edge_betweenness().
+ *
  * \param graph The graph object.
  * \param result The result of the computation, vector containing the
  *        betweenness scores for the edges.
@@ -2330,147 +4486,58 @@ int igraph_edge_betweenness_estimate(const igraph_t *graph, igraph_vector_t *res
                                      const igraph_vector_t *weights) {
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    long int *distance;
-    unsigned long long int *nrgeo;
-    double *tmpscore;
-    igraph_stack_t stack = IGRAPH_STACK_NULL;
-    long int source;
     long int j;
+    igraph_i_betweenness_t data;
+    igraph_i_betweenness_run_t run;
 
     igraph_inclist_t elist_out, elist_in;
-    igraph_inclist_t *elist_out_p, *elist_in_p;
-    igraph_vector_int_t *neip;
-    long int neino;
-    long int i;
 
     if (weights) {
         return igraph_i_edge_betweenness_estimate_weighted(graph, result,
                 directed, cutoff, weights);
     }
 
+    memset(&data, 0, sizeof(data));
     directed = directed && igraph_is_directed(graph);
     if (directed) {
         IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_OUT));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
         IGRAPH_CHECK(igraph_inclist_init(graph, &elist_in, IGRAPH_IN));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_in);
-        elist_out_p = &elist_out;
-        elist_in_p = &elist_in;
+        data.inclist_out = &elist_out;
+        data.inclist_in = &elist_in;
     } else {
         IGRAPH_CHECK(igraph_inclist_init(graph, &elist_out, IGRAPH_ALL));
         IGRAPH_FINALLY(igraph_inclist_destroy, &elist_out);
-        elist_out_p = elist_in_p = &elist_out;
-    }
-
-    distance = igraph_Calloc(no_of_nodes, long int);
-    if (distance == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
+        data.inclist_out = data.inclist_in = &elist_out;
     }
-    IGRAPH_FINALLY(igraph_free, distance);
-    nrgeo = igraph_Calloc(no_of_nodes, unsigned long long int);
-    if (nrgeo == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, nrgeo);
-    tmpscore = igraph_Calloc(no_of_nodes, double);
-    if (tmpscore == 0) {
-        IGRAPH_ERROR("edge betweenness failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, tmpscore);
-
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    IGRAPH_CHECK(igraph_stack_init(&stack, no_of_nodes));
-    IGRAPH_FINALLY(igraph_stack_destroy, &stack);
 
     IGRAPH_CHECK(igraph_vector_resize(result, no_of_edges));
 
     igraph_vector_null(result);
 
-    /* here we go */
-
-    for (source = 0; source < no_of_nodes; source++) {
-        IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0 * source / no_of_nodes, 0);
-        IGRAPH_ALLOW_INTERRUPTION();
-
-        memset(distance, 0, (size_t) no_of_nodes * sizeof(long int));
-        memset(nrgeo, 0, (size_t) no_of_nodes * sizeof(unsigned long long int));
-        memset(tmpscore, 0, (size_t) no_of_nodes * sizeof(double));
-        igraph_stack_clear(&stack); /* it should be empty anyway... */
-
-        IGRAPH_CHECK(igraph_dqueue_push(&q, source));
+    data.graph = graph;
+    data.cutoff = cutoff;
+    data.nthreads = igraph_i_betweenness_nthreads(no_of_nodes);
+    IGRAPH_FINALLY(igraph_i_betweenness_destroy, &data);
+    IGRAPH_CHECK(igraph_i_betweenness_scratch_init(&data, no_of_nodes, result,
+                 no_of_edges, /* bigint= */ 0));
 
-        nrgeo[source] = 1;
-        distance[source] = 0;
-
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
+    /* here we go */
 
-            if (cutoff > 0 && distance[actnode] >= cutoff ) {
-                continue;
-            }
+    run.source = igraph_i_edge_betweenness_source;
+    run.arg = &data;
+    run.message = "Edge betweenness centrality: ";
+    run.no_of_nodes = no_of_nodes;
+    run.nthreads = data.nthreads;
+    IGRAPH_I_BETWEENNESS_RUN(&run);
+    igraph_i_betweenness_reduce(&data);
 
-            /* check the neighbors and add to them to the queue if unseen before */
-            neip = igraph_inclist_get(elist_out_p, actnode);
-            neino = igraph_vector_int_size(neip);
-            for (i = 0; i < neino; i++) {
-                igraph_integer_t edge = (igraph_integer_t) VECTOR(*neip)[i], from, to;
-                long int neighbor;
-                igraph_edge(graph, edge, &from, &to);
-                neighbor = actnode != from ? from : to;
-                if (nrgeo[neighbor] != 0) {
-                    /* we've already seen this node, another shortest path? */
-                    if (distance[neighbor] == distance[actnode] + 1) {
-                        nrgeo[neighbor] += nrgeo[actnode];
-                    }
-                } else {
-                    /* we haven't seen this node yet */
-                    nrgeo[neighbor] += nrgeo[actnode];
-                    distance[neighbor] = distance[actnode] + 1;
-                    IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                    IGRAPH_CHECK(igraph_stack_push(&stack, neighbor));
-                }
-            }
-        } /* while !igraph_dqueue_empty */
-
-        /* Ok, we've the distance of each node and also the number of
-           shortest paths to them. Now we do an inverse search, starting
-           with the farthest nodes. */
-        while (!igraph_stack_empty(&stack)) {
-            long int actnode = (long int) igraph_stack_pop(&stack);
-            if (distance[actnode] < 1) {
-                continue;    /* skip source node */
-            }
-
-            /* set the temporary score of the friends */
-            neip = igraph_inclist_get(elist_in_p, actnode);
-            neino = igraph_vector_int_size(neip);
-            for (i = 0; i < neino; i++) {
-                igraph_integer_t from, to;
-                long int neighbor;
-                igraph_integer_t edgeno = (igraph_integer_t) VECTOR(*neip)[i];
-                igraph_edge(graph, edgeno, &from, &to);
-                neighbor = actnode != from ? from : to;
-                if (distance[neighbor] == distance[actnode] - 1 &&
-                    nrgeo[neighbor] != 0) {
-                    tmpscore[neighbor] +=
-                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                    VECTOR(*result)[edgeno] +=
-                        (tmpscore[actnode] + 1) * nrgeo[neighbor] / nrgeo[actnode];
-                }
-            }
-        }
-        /* Ok, we've the scores for this source */
-    } /* for source <= no_of_nodes */
     IGRAPH_PROGRESS("Edge betweenness centrality: ", 100.0, 0);
 
     /* clean and return */
-    igraph_Free(distance);
-    igraph_Free(nrgeo);
-    igraph_Free(tmpscore);
-    igraph_dqueue_destroy(&q);
-    igraph_stack_destroy(&stack);
-    IGRAPH_FINALLY_CLEAN(5);
+    igraph_i_betweenness_destroy(&data);
+    IGRAPH_FINALLY_CLEAN(1);
 
     if (directed) {
         igraph_inclist_destroy(&elist_out);
@@ -2578,7 +4645,7 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
 
-    igraph_2wheap_t Q;
+    igraph_i_spqueue_t Q;
     igraph_vit_t vit;
     long int nodes_to_calc;
 
@@ -2611,8 +4678,8 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
 
     nodes_to_calc = IGRAPH_VIT_SIZE(vit);
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+    IGRAPH_CHECK(igraph_i_spqueue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_spqueue_destroy, &Q);
     IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
     IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
 
@@ -2626,19 +4693,22 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
     for (i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
 
         long int source = IGRAPH_VIT_GET(vit);
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
+        igraph_i_spqueue_clear(&Q);
+        igraph_i_spqueue_push(&Q, source, 1.0);
         VECTOR(which)[source] = i + 1;
         VECTOR(dist)[source] = 1.0;     /* actual distance is zero but we need to store distance + 1 */
         nodes_reached = 0;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            igraph_integer_t minnei = (igraph_integer_t) igraph_2wheap_max_index(&Q);
-            /* Now check all neighbors of minnei for a shorter path */
-            igraph_vector_t *neis = igraph_lazy_inclist_get(&inclist, minnei);
-            long int nlen = igraph_vector_size(neis);
+        while (!igraph_i_spqueue_empty(&Q)) {
+            long int minnei;
+            igraph_vector_t *neis;
+            long int nlen;
+
+            mindist = igraph_i_spqueue_delete_min(&Q, &minnei);
 
-            mindist = -igraph_2wheap_delete_max(&Q);
+            /* Now check all neighbors of minnei for a shorter path */
+            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
+            nlen = igraph_vector_size(neis);
 
             VECTOR(*res)[i] += (mindist - 1.0);
             nodes_reached++;
@@ -2663,15 +4733,15 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
                     /* First non-infinite distance */
                     VECTOR(which)[to] = i + 1;
                     VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, to, -altdist));
+                    IGRAPH_CHECK(igraph_i_spqueue_push(&Q, to, altdist));
                 } else if (cmp_result < 0) {
                     /* This is a shorter path */
                     VECTOR(dist)[to] = altdist;
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, to, -altdist));
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(&Q, to, altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_spqueue_empty(&Q) */
 
         /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
         VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
@@ -2693,7 +4763,7 @@ int igraph_i_closeness_estimate_weighted(const igraph_t *graph,
     igraph_vector_long_destroy(&which);
     igraph_vector_destroy(&dist);
     igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_spqueue_destroy(&Q);
     igraph_vit_destroy(&vit);
     IGRAPH_FINALLY_CLEAN(5);
 
@@ -2773,14 +4843,12 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
                               igraph_bool_t normalized) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    igraph_vector_t already_counted;
-    igraph_vector_int_t *neis;
-    long int i, j;
-    long int nodes_reached;
-    long int actdist;
-    igraph_adjlist_t allneis;
-
-    igraph_dqueue_t q;
+    long int i, k, batch;
+    igraph_integer_t sources[IGRAPH_I_MSBFS_WIDTH];
+    igraph_real_t counts[IGRAPH_I_MSBFS_WIDTH];
+    igraph_real_t nodes_reached[IGRAPH_I_MSBFS_WIDTH];
+    long int lastdist[IGRAPH_I_MSBFS_WIDTH];
+    igraph_i_msbfs_t msbfs;
 
     long int nodes_to_calc;
     igraph_vit_t vit;
@@ -2802,59 +4870,56 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
         IGRAPH_ERROR("calculating closeness", IGRAPH_EINVMODE);
     }
 
-    IGRAPH_VECTOR_INIT_FINALLY(&already_counted, no_of_nodes);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, graph, mode));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
     IGRAPH_CHECK(igraph_vector_resize(res, nodes_to_calc));
     igraph_vector_null(res);
 
-    for (IGRAPH_VIT_RESET(vit), i = 0;
-         !IGRAPH_VIT_END(vit);
-         IGRAPH_VIT_NEXT(vit), i++) {
-        igraph_dqueue_clear(&q);
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(vit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        nodes_reached = 1;
-        VECTOR(already_counted)[(long int)IGRAPH_VIT_GET(vit)] = i + 1;
+    /* The searches from IGRAPH_I_MSBFS_WIDTH vertices run together */
+    for (IGRAPH_VIT_RESET(vit), i = 0; i < nodes_to_calc; i += batch) {
+        igraph_bool_t found;
+
+        batch = nodes_to_calc - i < IGRAPH_I_MSBFS_WIDTH ?
+                nodes_to_calc - i : IGRAPH_I_MSBFS_WIDTH;
+        for (k = 0; k < batch; k++, IGRAPH_VIT_NEXT(vit)) {
+            sources[k] = IGRAPH_VIT_GET(vit);
+            nodes_reached[k] = 1;
+            lastdist[k] = 0;
+        }
 
         IGRAPH_PROGRESS("Closeness: ", 100.0 * i / no_of_nodes, NULL);
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            actdist = (long int) igraph_dqueue_pop(&q);
-
-            VECTOR(*res)[i] += actdist;
-
-            if (cutoff > 0 && actdist >= cutoff) {
-                continue;    /* NOT break!!! */
+        IGRAPH_CHECK(igraph_i_msbfs_start(&msbfs, sources, (int) batch));
+        while (cutoff <= 0 || msbfs.level < cutoff) {
+            IGRAPH_CHECK(igraph_i_msbfs_next_level(&msbfs, &found));
+            if (!found) {
+                break;
             }
-
-            /* check the neighbors */
-            neis = igraph_adjlist_get(&allneis, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_counted)[neighbor] == i + 1) {
-                    continue;
+            for (k = 0; k < batch; k++) {
+                counts[k] = 0;
+            }
+            igraph_i_msbfs_level_stats(&msbfs, 0, 0, counts);
+            for (k = 0; k < batch; k++) {
+                if (counts[k] > 0) {
+                    VECTOR(*res)[i + k] += msbfs.level * counts[k];
+                    nodes_reached[k] += counts[k];
+                    lastdist[k] = msbfs.level;
                 }
-                VECTOR(already_counted)[neighbor] = i + 1;
-                nodes_reached++;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
             }
         }
 
-        /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
-        VECTOR(*res)[i] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached));
-        VECTOR(*res)[i] = (no_of_nodes - 1) / VECTOR(*res)[i];
+        for (k = 0; k < batch; k++) {
+            /* using igraph_real_t here instead of igraph_integer_t to avoid overflow */
+            VECTOR(*res)[i + k] += ((igraph_real_t)no_of_nodes * (no_of_nodes - nodes_reached[k]));
+            VECTOR(*res)[i + k] = (no_of_nodes - 1) / VECTOR(*res)[i + k];
 
-        if (((cutoff > 0 && actdist < cutoff) || cutoff <= 0) &&
-            no_of_nodes > nodes_reached && !warning_shown) {
-            IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
-            warning_shown = 1;
+            if (((cutoff > 0 && lastdist[k] < cutoff) || cutoff <= 0) &&
+                no_of_nodes > nodes_reached[k] && !warning_shown) {
+                IGRAPH_WARNING("closeness centrality is not well-defined for disconnected graphs");
+                warning_shown = 1;
+            }
         }
     }
 
@@ -2867,11 +4932,9 @@ int igraph_closeness_estimate(const igraph_t *graph, igraph_vector_t *res,
     IGRAPH_PROGRESS("Closeness: ", 100.0, NULL);
 
     /* Clean */
-    igraph_dqueue_destroy(&q);
-    igraph_vector_destroy(&already_counted);
+    igraph_i_msbfs_destroy(&msbfs);
     igraph_vit_destroy(&vit);
-    igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
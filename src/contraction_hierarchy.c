@@ -0,0 +1,1594 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_interface.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_memory.h"
+#include "igraph_threading.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+
+#include <string.h>
+#include <stdint.h>
+
+/* A contraction hierarchy orders the vertices by importance and
+ * contracts them in this order: a contracted vertex is removed from
+ * the graph, and a shortcut arc is added between each pair of its
+ * remaining neighbours whose shortest path went through it. A witness
+ * search, i.e. a Dijkstra search that avoids the vertex, decides
+ * whether the shortcut is needed. The searches are limited in size,
+ * so sometimes shortcuts are added that are not needed; they do not
+ * make the results wrong.
+ *
+ * Every arc, original or shortcut, is stored at the endpoint that was
+ * contracted first: the arcs leaving a vertex towards more important
+ * vertices are its 'out' arcs, the arcs entering it from more
+ * important vertices are its 'in' arcs. In undirected hierarchies
+ * there are only 'out' arcs. A shortest path always goes up in the
+ * order and then down, so a query is a search from the source along
+ * the 'out' arcs and a search from the target backwards along the
+ * 'in' arcs; both only visit more important vertices, which is a
+ * small part of the graph.
+ *
+ * A shortcut from a to b that replaced a path through vertex m is
+ * unpacked into the arc from a to m, an 'in' arc of m, and the arc
+ * from m to b, an 'out' arc of m. */
+
+/* Limits of the witness searches: number of vertices settled when
+   estimating the importance of a vertex, and when contracting it */
+#define IGRAPH_I_CH_SIMULATE_LIMIT 50
+#define IGRAPH_I_CH_CONTRACT_LIMIT 500
+
+/* Sources or targets processed in one work item of the distance table */
+#define IGRAPH_I_CH_GRAIN 16
+
+/* ------------------------------------------------------------------ */
+/* Preprocessing                                                      */
+/* ------------------------------------------------------------------ */
+
+/* The remaining graph during the contraction. Arcs are stored once,
+   the lists of the vertices hold arc ids. In undirected mode the arc
+   is in the 'out' list of both endpoints, and 'in' is the same as
+   'out'. */
+
+typedef struct igraph_i_ch_builder_t {
+    long int no_of_nodes;
+    igraph_bool_t directed;
+    igraph_vector_int_t tail, head, via, edge;
+    igraph_vector_t weight;
+    igraph_vector_int_t *out, *in;
+    igraph_vector_int_t deleted;        /* contracted neighbours */
+    igraph_vector_int_t level;          /* depth in the hierarchy */
+    /* witness search */
+    igraph_vector_t dist;
+    igraph_vector_int_t touched;
+    igraph_vector_char_t target;
+    igraph_indheap_t heap;
+} igraph_i_ch_builder_t;
+
+static void igraph_i_ch_builder_destroy(igraph_i_ch_builder_t *b) {
+    long int i;
+    if (b->out) {
+        for (i = 0; i < b->no_of_nodes; i++) {
+            igraph_vector_int_destroy(&b->out[i]);
+        }
+        igraph_Free(b->out);
+    }
+    if (b->in) {
+        for (i = 0; i < b->no_of_nodes; i++) {
+            igraph_vector_int_destroy(&b->in[i]);
+        }
+        igraph_Free(b->in);
+    }
+    igraph_vector_int_destroy(&b->tail);
+    igraph_vector_int_destroy(&b->head);
+    igraph_vector_int_destroy(&b->via);
+    igraph_vector_int_destroy(&b->edge);
+    igraph_vector_destroy(&b->weight);
+    igraph_vector_int_destroy(&b->deleted);
+    igraph_vector_int_destroy(&b->level);
+    igraph_vector_destroy(&b->dist);
+    igraph_vector_int_destroy(&b->touched);
+    igraph_vector_char_destroy(&b->target);
+    igraph_indheap_destroy(&b->heap);
+}
+
+static igraph_vector_int_t *igraph_i_ch_lists(long int n) {
+    long int i;
+    igraph_vector_int_t *lists = igraph_Calloc(n > 0 ? n : 1, igraph_vector_int_t);
+    if (lists) {
+        for (i = 0; i < n; i++) {
+            if (igraph_vector_int_init(&lists[i], 0) != 0) {
+                while (i-- > 0) {
+                    igraph_vector_int_destroy(&lists[i]);
+                }
+                igraph_Free(lists);
+                return 0;
+            }
+        }
+    }
+    return lists;
+}
+
+/* Removes an arc from a list, the order of the list is not kept */
+
+static void igraph_i_ch_list_remove(igraph_vector_int_t *list, igraph_integer_t arc) {
+    long int i, n = igraph_vector_int_size(list);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(*list)[i] == arc) {
+            VECTOR(*list)[i] = VECTOR(*list)[n - 1];
+            igraph_vector_int_pop_back(list);
+            return;
+        }
+    }
+}
+
+static long int igraph_i_ch_other(const igraph_i_ch_builder_t *b, long int arc,
+                                  long int v) {
+    long int t = VECTOR(b->tail)[arc];
+    return t == v ? VECTOR(b->head)[arc] : t;
+}
+
+static int igraph_i_ch_builder_init(igraph_i_ch_builder_t *b,
+                                    const igraph_t *graph,
+                                    const igraph_vector_t *weights,
+                                    igraph_bool_t directed) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    long int e, v, i, n;
+    igraph_vector_int_t seen;
+    igraph_vector_char_t dead;
+
+    memset(b, 0, sizeof(*b));
+    b->no_of_nodes = no_of_nodes;
+    b->directed = directed && igraph_is_directed(graph);
+
+    IGRAPH_FINALLY(igraph_i_ch_builder_destroy, b);
+    IGRAPH_CHECK(igraph_vector_int_init(&b->tail, 0));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->head, 0));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->via, 0));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->edge, 0));
+    IGRAPH_CHECK(igraph_vector_init(&b->weight, 0));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->deleted, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->level, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_init(&b->dist, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->touched, 0));
+    IGRAPH_CHECK(igraph_vector_char_init(&b->target, no_of_nodes));
+    IGRAPH_CHECK(igraph_indheap_init(&b->heap, 0));
+    igraph_vector_fill(&b->dist, IGRAPH_INFINITY);
+
+    b->out = igraph_i_ch_lists(no_of_nodes);
+    if (!b->out) {
+        IGRAPH_ERROR("Cannot build contraction hierarchy", IGRAPH_ENOMEM);
+    }
+    if (b->directed) {
+        b->in = igraph_i_ch_lists(no_of_nodes);
+        if (!b->in) {
+            IGRAPH_ERROR("Cannot build contraction hierarchy", IGRAPH_ENOMEM);
+        }
+    }
+
+    IGRAPH_CHECK(igraph_vector_int_reserve(&b->tail, no_of_edges));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&b->head, no_of_edges));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&b->via, no_of_edges));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&b->edge, no_of_edges));
+    IGRAPH_CHECK(igraph_vector_reserve(&b->weight, no_of_edges));
+    for (e = 0; e < no_of_edges; e++) {
+        igraph_integer_t from = IGRAPH_FROM(graph, e), to = IGRAPH_TO(graph, e);
+        long int arc = igraph_vector_int_size(&b->tail);
+        if (from == to) {
+            continue;
+        }
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->tail, from));
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->head, to));
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->via, -1));
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->edge, e));
+        IGRAPH_CHECK(igraph_vector_push_back(&b->weight,
+                                             weights ? VECTOR(*weights)[e] : 1));
+        IGRAPH_CHECK(igraph_vector_int_push_back(&b->out[from], arc));
+        IGRAPH_CHECK(igraph_vector_int_push_back(b->directed ? &b->in[to] :
+                     &b->out[to], arc));
+    }
+
+    /* Keep only the lightest of parallel arcs */
+    n = igraph_vector_int_size(&b->tail);
+    IGRAPH_CHECK(igraph_vector_int_init(&seen, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &seen);
+    IGRAPH_CHECK(igraph_vector_char_init(&dead, n));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &dead);
+    igraph_vector_int_fill(&seen, -1);
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_vector_int_t *list = &b->out[v];
+        long int len = igraph_vector_int_size(list);
+        for (i = 0; i < len; i++) {
+            long int arc = VECTOR(*list)[i], u = igraph_i_ch_other(b, arc, v);
+            long int prev = VECTOR(seen)[u];
+            if (prev < 0) {
+                VECTOR(seen)[u] = arc;
+            } else if (VECTOR(b->weight)[arc] < VECTOR(b->weight)[prev]) {
+                VECTOR(dead)[prev] = 1;
+                VECTOR(seen)[u] = arc;
+            } else {
+                VECTOR(dead)[arc] = 1;
+            }
+        }
+        for (i = 0; i < len; i++) {
+            VECTOR(seen)[igraph_i_ch_other(b, VECTOR(*list)[i], v)] = -1;
+        }
+    }
+    for (v = 0; v < no_of_nodes; v++) {
+        int d;
+        for (d = 0; d < (b->directed ? 2 : 1); d++) {
+            igraph_vector_int_t *list = d == 0 ? &b->out[v] : &b->in[v];
+            long int len = igraph_vector_int_size(list), j = 0;
+            for (i = 0; i < len; i++) {
+                if (!VECTOR(dead)[VECTOR(*list)[i]]) {
+                    VECTOR(*list)[j++] = VECTOR(*list)[i];
+                }
+            }
+            IGRAPH_CHECK(igraph_vector_int_resize(list, j));
+        }
+    }
+    /* Dead arcs get an infinite weight, they are dropped at the end */
+    for (i = 0; i < n; i++) {
+        if (VECTOR(dead)[i]) {
+            VECTOR(b->weight)[i] = IGRAPH_INFINITY;
+        }
+    }
+    igraph_vector_char_destroy(&dead);
+    igraph_vector_int_destroy(&seen);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+#define IGRAPH_I_CH_IN(b, v) ((b)->directed ? &(b)->in[v] : &(b)->out[v])
+
+/* Adds a shortcut from u to w, or makes the existing arc lighter */
+
+static int igraph_i_ch_add_shortcut(igraph_i_ch_builder_t *b, long int u,
+                                    long int w, igraph_real_t weight,
+                                    long int via) {
+    igraph_vector_int_t *list = &b->out[u];
+    long int i, n = igraph_vector_int_size(list), arc;
+
+    for (i = 0; i < n; i++) {
+        arc = VECTOR(*list)[i];
+        if (VECTOR(b->tail)[arc] == u ? VECTOR(b->head)[arc] == w :
+            (!b->directed && VECTOR(b->tail)[arc] == w)) {
+            if (weight < VECTOR(b->weight)[arc]) {
+                VECTOR(b->weight)[arc] = weight;
+                VECTOR(b->via)[arc] = via;
+                VECTOR(b->edge)[arc] = -1;
+            }
+            return 0;
+        }
+    }
+
+    arc = igraph_vector_int_size(&b->tail);
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->tail, u));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->head, w));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->via, via));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->edge, -1));
+    IGRAPH_CHECK(igraph_vector_push_back(&b->weight, weight));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->out[u], arc));
+    IGRAPH_CHECK(igraph_vector_int_push_back(IGRAPH_I_CH_IN(b, w), arc));
+
+    return 0;
+}
+
+/* Bounded Dijkstra search from 'source' in the remaining graph,
+   avoiding 'avoid'. It stops after 'limit' settled vertices, beyond
+   'maxdist', or when all 'targets' marked vertices are settled. */
+
+static int igraph_i_ch_witness(igraph_i_ch_builder_t *b, long int source,
+                               long int avoid, igraph_real_t maxdist,
+                               long int limit, long int targets) {
+    long int settled = 0;
+
+    igraph_indheap_clear(&b->heap);
+    VECTOR(b->dist)[source] = 0;
+    IGRAPH_CHECK(igraph_vector_int_push_back(&b->touched, source));
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&b->heap, source, 0));
+
+    while (!igraph_indheap_empty(&b->heap) && settled < limit && targets > 0) {
+        long int v = igraph_indheap_max_index(&b->heap);
+        igraph_real_t dv = -igraph_indheap_max(&b->heap);
+        igraph_vector_int_t *list = &b->out[v];
+        long int i, n = igraph_vector_int_size(list);
+
+        igraph_indheap_delete_max(&b->heap);
+        if (dv > VECTOR(b->dist)[v]) {
+            continue;       /* outdated entry */
+        }
+        if (dv > maxdist) {
+            break;
+        }
+        settled++;
+        if (VECTOR(b->target)[v]) {
+            targets--;
+        }
+        for (i = 0; i < n; i++) {
+            long int arc = VECTOR(*list)[i];
+            long int u = b->directed ? VECTOR(b->head)[arc] : igraph_i_ch_other(b, arc, v);
+            igraph_real_t alt = dv + VECTOR(b->weight)[arc];
+            if (u == avoid || alt >= VECTOR(b->dist)[u]) {
+                continue;
+            }
+            if (VECTOR(b->dist)[u] == IGRAPH_INFINITY) {
+                IGRAPH_CHECK(igraph_vector_int_push_back(&b->touched, u));
+            }
+            VECTOR(b->dist)[u] = alt;
+            IGRAPH_CHECK(igraph_indheap_push_with_index(&b->heap, u, -alt));
+        }
+    }
+
+    return 0;
+}
+
+static void igraph_i_ch_witness_reset(igraph_i_ch_builder_t *b) {
+    long int i, n = igraph_vector_int_size(&b->touched);
+    for (i = 0; i < n; i++) {
+        VECTOR(b->dist)[VECTOR(b->touched)[i]] = IGRAPH_INFINITY;
+    }
+    igraph_vector_int_clear(&b->touched);
+}
+
+/* Contracts v, or with 'simulate' only counts the shortcuts that the
+   contraction would add. A shortcut from u to w is needed if the
+   witness search from u does not find w at most as far as the path
+   through v. */
+
+static int igraph_i_ch_contract(igraph_i_ch_builder_t *b, long int v,
+                                igraph_bool_t simulate, long int *shortcuts) {
+    igraph_vector_int_t *out = &b->out[v], *in = IGRAPH_I_CH_IN(b, v);
+    long int nout = igraph_vector_int_size(out), nin = igraph_vector_int_size(in);
+    long int i, j, targets = 0;
+    igraph_real_t maxout = 0;
+
+    *shortcuts = 0;
+    for (j = 0; j < nout; j++) {
+        long int arc = VECTOR(*out)[j];
+        long int w = igraph_i_ch_other(b, arc, v);
+        if (VECTOR(b->weight)[arc] > maxout) {
+            maxout = VECTOR(b->weight)[arc];
+        }
+        VECTOR(b->target)[w] = 1;
+        targets++;
+    }
+
+    for (i = 0; i < nin; i++) {
+        long int arc = VECTOR(*in)[i];
+        long int u = igraph_i_ch_other(b, arc, v);
+        igraph_real_t win = VECTOR(b->weight)[arc];
+        char was_target = VECTOR(b->target)[u];
+
+        /* In undirected mode a pair is only checked from its first
+           vertex, u stays unmarked after this */
+        if (was_target) {
+            VECTOR(b->target)[u] = 0;
+            targets--;
+        }
+        if (targets > 0) {
+            IGRAPH_CHECK(igraph_i_ch_witness(b, u, v, win + maxout,
+                                             simulate ? IGRAPH_I_CH_SIMULATE_LIMIT :
+                                             IGRAPH_I_CH_CONTRACT_LIMIT, targets));
+            for (j = 0; j < nout; j++) {
+                long int arc2 = VECTOR(*out)[j];
+                long int w = igraph_i_ch_other(b, arc2, v);
+                igraph_real_t through = win + VECTOR(b->weight)[arc2];
+                if (!VECTOR(b->target)[w] || VECTOR(b->dist)[w] <= through) {
+                    continue;
+                }
+                (*shortcuts)++;
+                if (!simulate) {
+                    IGRAPH_CHECK(igraph_i_ch_add_shortcut(b, u, w, through, v));
+                }
+            }
+            igraph_i_ch_witness_reset(b);
+        }
+        if (was_target && b->directed) {
+            VECTOR(b->target)[u] = 1;
+            targets++;
+        }
+    }
+
+    for (j = 0; j < nout; j++) {
+        VECTOR(b->target)[igraph_i_ch_other(b, VECTOR(*out)[j], v)] = 0;
+    }
+
+    return 0;
+}
+
+/* Importance of a vertex: the number of shortcuts its contraction
+   adds minus the number of arcs it removes, counted twice, plus the
+   number of its contracted neighbours and its depth, which spread the
+   contractions evenly over the graph */
+
+static int igraph_i_ch_priority(igraph_i_ch_builder_t *b, long int v,
+                                igraph_real_t *priority) {
+    long int shortcuts, removed = igraph_vector_int_size(&b->out[v]);
+    if (b->directed) {
+        removed += igraph_vector_int_size(&b->in[v]);
+    }
+    IGRAPH_CHECK(igraph_i_ch_contract(b, v, /* simulate= */ 1, &shortcuts));
+    *priority = 2 * (shortcuts - removed) + VECTOR(b->deleted)[v] +
+                VECTOR(b->level)[v];
+    return 0;
+}
+
+/* Removes v from the remaining graph and collects its neighbours */
+
+static int igraph_i_ch_remove(igraph_i_ch_builder_t *b, long int v,
+                              igraph_vector_int_t *neis) {
+    int d;
+
+    igraph_vector_int_clear(neis);
+    for (d = 0; d < (b->directed ? 2 : 1); d++) {
+        igraph_vector_int_t *list = d == 0 ? &b->out[v] : &b->in[v];
+        long int i, n = igraph_vector_int_size(list);
+        for (i = 0; i < n; i++) {
+            long int arc = VECTOR(*list)[i], u = igraph_i_ch_other(b, arc, v);
+            if (!b->directed) {
+                igraph_i_ch_list_remove(&b->out[u], arc);
+            } else if (d == 0) {
+                igraph_i_ch_list_remove(&b->in[u], arc);
+            } else {
+                igraph_i_ch_list_remove(&b->out[u], arc);
+            }
+            VECTOR(b->deleted)[u] += 1;
+            if (VECTOR(b->level)[u] <= VECTOR(b->level)[v]) {
+                VECTOR(b->level)[u] = VECTOR(b->level)[v] + 1;
+            }
+            IGRAPH_CHECK(igraph_vector_int_push_back(neis, u));
+        }
+        igraph_vector_int_clear(list);
+    }
+
+    return 0;
+}
+
+/* Stores the arcs in the hierarchy, at their less important endpoint */
+
+static int igraph_i_ch_store(igraph_contraction_hierarchy_t *ch,
+                             const igraph_i_ch_builder_t *b) {
+    long int no_of_nodes = b->no_of_nodes;
+    long int no_of_arcs = igraph_vector_int_size(&b->tail);
+    long int i, a, d, count[2] = { 0, 0 };
+    igraph_vector_int_t *start[2] = { &ch->out_start, &ch->in_start };
+    igraph_vector_int_t *head[2] = { &ch->out_head, &ch->in_head };
+    igraph_vector_int_t *via[2] = { &ch->out_via, &ch->in_via };
+    igraph_vector_int_t *edge[2] = { &ch->out_edge, &ch->in_edge };
+    igraph_vector_t *weight[2] = { &ch->out_weight, &ch->in_weight };
+
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->out_start, no_of_nodes + 1));
+    igraph_vector_int_null(&ch->out_start);
+    if (b->directed) {
+        IGRAPH_CHECK(igraph_vector_int_resize(&ch->in_start, no_of_nodes + 1));
+        igraph_vector_int_null(&ch->in_start);
+    }
+
+    /* Count the arcs of each vertex first, then place them */
+    for (a = 0; a < no_of_arcs; a++) {
+        long int t = VECTOR(b->tail)[a], h = VECTOR(b->head)[a];
+        if (VECTOR(b->weight)[a] == IGRAPH_INFINITY) {
+            continue;
+        }
+        if (VECTOR(ch->rank)[t] < VECTOR(ch->rank)[h]) {
+            VECTOR(ch->out_start)[t + 1] += 1;
+            count[0]++;
+        } else if (b->directed) {
+            VECTOR(ch->in_start)[h + 1] += 1;
+            count[1]++;
+        } else {
+            VECTOR(ch->out_start)[h + 1] += 1;
+            count[0]++;
+        }
+    }
+    for (d = 0; d < (b->directed ? 2 : 1); d++) {
+        for (i = 0; i < no_of_nodes; i++) {
+            VECTOR(*start[d])[i + 1] += VECTOR(*start[d])[i];
+        }
+        IGRAPH_CHECK(igraph_vector_int_resize(head[d], count[d]));
+        IGRAPH_CHECK(igraph_vector_int_resize(via[d], count[d]));
+        IGRAPH_CHECK(igraph_vector_int_resize(edge[d], count[d]));
+        IGRAPH_CHECK(igraph_vector_resize(weight[d], count[d]));
+    }
+    for (a = 0; a < no_of_arcs; a++) {
+        long int t = VECTOR(b->tail)[a], h = VECTOR(b->head)[a], owner, pos;
+        if (VECTOR(b->weight)[a] == IGRAPH_INFINITY) {
+            continue;
+        }
+        if (VECTOR(ch->rank)[t] < VECTOR(ch->rank)[h]) {
+            d = 0; owner = t;
+        } else {
+            d = b->directed ? 1 : 0; owner = h; h = t;
+        }
+        pos = VECTOR(*start[d])[owner]++;
+        VECTOR(*head[d])[pos] = h;
+        VECTOR(*via[d])[pos] = VECTOR(b->via)[a];
+        VECTOR(*edge[d])[pos] = VECTOR(b->edge)[a];
+        VECTOR(*weight[d])[pos] = VECTOR(b->weight)[a];
+    }
+    /* The starts were moved to the ends of the ranges, shift them back */
+    for (d = 0; d < (b->directed ? 2 : 1); d++) {
+        for (i = no_of_nodes; i > 0; i--) {
+            VECTOR(*start[d])[i] = VECTOR(*start[d])[i - 1];
+        }
+        VECTOR(*start[d])[0] = 0;
+    }
+
+    return 0;
+}
+
+static int igraph_i_contraction_hierarchy_alloc(igraph_contraction_hierarchy_t *ch) {
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->rank, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->rank);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->out_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->out_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->out_head, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->out_head);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->out_via, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->out_via);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->out_edge, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->out_edge);
+    IGRAPH_VECTOR_INIT_FINALLY(&ch->out_weight, 0);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->in_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->in_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->in_head, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->in_head);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->in_via, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->in_via);
+    IGRAPH_CHECK(igraph_vector_int_init(&ch->in_edge, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ch->in_edge);
+    IGRAPH_VECTOR_INIT_FINALLY(&ch->in_weight, 0);
+    IGRAPH_FINALLY_CLEAN(11);
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_init
+ * \brief Preprocesses a graph for fast shortest path queries.
+ *
+ * A contraction hierarchy adds shortcut edges to the graph in a
+ * preprocessing step, so that a shortest path query only needs to
+ * search a small number of vertices: usually a few hundred on road
+ * networks with millions of vertices, which makes a query thousands
+ * of times faster than Dijkstra's algorithm. The preprocessing works
+ * best on graphs with a natural hierarchy and a small number of
+ * edges per vertex, like road networks; on dense graphs or graphs
+ * with hubs it may add many shortcuts and take long.
+ *
+ * </para><para>
+ * The hierarchy does not refer to the graph after it was built, it
+ * can be queried with \ref igraph_contraction_hierarchy_distance(),
+ * \ref igraph_contraction_hierarchy_get_shortest_path() and \ref
+ * igraph_contraction_hierarchy_distance_matrix(), and saved with
+ * \ref igraph_contraction_hierarchy_write(). If the graph or the
+ * weights change, the hierarchy must be built again.
+ *
+ * \param ch Pointer to an uninitialized contraction hierarchy, it
+ *        must be destroyed with \ref igraph_contraction_hierarchy_destroy().
+ * \param graph The input graph.
+ * \param weights Vector of non-negative edge weights, in the order of
+ *        edge ids, or a null pointer for unit weights.
+ * \param directed Whether to consider edge directions in directed
+ *        graphs. It is ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: depends on the structure of the graph, it is
+ * usually close to linear in the number of edges for road networks.
+ *
+ * \example examples/simple/igraph_contraction_hierarchy.c
+ */
+
+int igraph_contraction_hierarchy_init(igraph_contraction_hierarchy_t *ch,
+                                      const igraph_t *graph,
+                                      const igraph_vector_t *weights,
+                                      igraph_bool_t directed) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_i_ch_builder_t builder;
+    igraph_2wheap_t queue;
+    igraph_vector_int_t neis;
+    long int v, i, rank = 0;
+
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0) {
+            igraph_real_t min = igraph_vector_min(weights);
+            if (min < 0) {
+                IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+            } else if (igraph_is_nan(min)) {
+                IGRAPH_ERROR("Weight vector must not contain NaN values", IGRAPH_EINVAL);
+            }
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_contraction_hierarchy_alloc(ch));
+    IGRAPH_FINALLY(igraph_contraction_hierarchy_destroy, ch);
+    ch->no_of_nodes = (igraph_integer_t) no_of_nodes;
+    ch->directed = directed && igraph_is_directed(graph);
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->rank, no_of_nodes));
+
+    IGRAPH_CHECK(igraph_i_ch_builder_init(&builder, graph, weights, directed));
+    IGRAPH_FINALLY(igraph_i_ch_builder_destroy, &builder);
+    IGRAPH_CHECK(igraph_2wheap_init(&queue, no_of_nodes));
+    IGRAPH_FINALLY(igraph_2wheap_destroy, &queue);
+    IGRAPH_CHECK(igraph_vector_int_init(&neis, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &neis);
+
+    /* The least important vertex is contracted first. The heap is a
+       max-heap, so it stores the negated priorities. */
+    for (v = 0; v < no_of_nodes; v++) {
+        igraph_real_t priority;
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_ch_priority(&builder, v, &priority));
+        IGRAPH_CHECK(igraph_2wheap_push_with_index(&queue, v, -priority));
+    }
+
+    while (!igraph_2wheap_empty(&queue)) {
+        igraph_real_t priority;
+        long int shortcuts;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        /* Priorities are updated lazily: the vertex is only contracted
+           if it is still the least important one after an update */
+        v = igraph_2wheap_max_index(&queue);
+        IGRAPH_CHECK(igraph_i_ch_priority(&builder, v, &priority));
+        if (-priority < igraph_2wheap_max(&queue)) {
+            IGRAPH_CHECK(igraph_2wheap_modify(&queue, v, -priority));
+            if (igraph_2wheap_max_index(&queue) != v) {
+                continue;
+            }
+        }
+
+        igraph_2wheap_delete_max(&queue);
+        VECTOR(ch->rank)[v] = rank++;
+        IGRAPH_CHECK(igraph_i_ch_contract(&builder, v, /* simulate= */ 0, &shortcuts));
+        IGRAPH_CHECK(igraph_i_ch_remove(&builder, v, &neis));
+
+        for (i = 0; i < igraph_vector_int_size(&neis); i++) {
+            long int u = VECTOR(neis)[i];
+            IGRAPH_CHECK(igraph_i_ch_priority(&builder, u, &priority));
+            IGRAPH_CHECK(igraph_2wheap_modify(&queue, u, -priority));
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_ch_store(ch, &builder));
+
+    igraph_vector_int_destroy(&neis);
+    igraph_2wheap_destroy(&queue);
+    igraph_i_ch_builder_destroy(&builder);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_destroy
+ * \brief Frees the memory of a contraction hierarchy.
+ *
+ * \param ch The contraction hierarchy.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_contraction_hierarchy_destroy(igraph_contraction_hierarchy_t *ch) {
+    igraph_vector_int_destroy(&ch->rank);
+    igraph_vector_int_destroy(&ch->out_start);
+    igraph_vector_int_destroy(&ch->out_head);
+    igraph_vector_int_destroy(&ch->out_via);
+    igraph_vector_int_destroy(&ch->out_edge);
+    igraph_vector_destroy(&ch->out_weight);
+    igraph_vector_int_destroy(&ch->in_start);
+    igraph_vector_int_destroy(&ch->in_head);
+    igraph_vector_int_destroy(&ch->in_via);
+    igraph_vector_int_destroy(&ch->in_edge);
+    igraph_vector_destroy(&ch->in_weight);
+}
+
+/* ------------------------------------------------------------------ */
+/* Queries                                                            */
+/* ------------------------------------------------------------------ */
+
+/* The arcs of one direction of the hierarchy: 0 is 'out', 1 is 'in'.
+   Undirected hierarchies use the 'out' arcs in both directions. */
+
+typedef struct igraph_i_ch_arcs_t {
+    const igraph_integer_t *start, *head, *via, *edge;
+    const igraph_real_t *weight;
+} igraph_i_ch_arcs_t;
+
+static void igraph_i_ch_arcs(const igraph_contraction_hierarchy_t *ch,
+                             igraph_i_ch_arcs_t arcs[2]) {
+    int d;
+    for (d = 0; d < 2; d++) {
+        igraph_bool_t in = d == 1 && ch->directed;
+        arcs[d].start = VECTOR(in ? ch->in_start : ch->out_start);
+        arcs[d].head = VECTOR(in ? ch->in_head : ch->out_head);
+        arcs[d].via = VECTOR(in ? ch->in_via : ch->out_via);
+        arcs[d].edge = VECTOR(in ? ch->in_edge : ch->out_edge);
+        arcs[d].weight = VECTOR(in ? ch->in_weight : ch->out_weight);
+    }
+}
+
+/* An upward search. Only the reached vertices get a slot, found with
+   an open addressing hash table, so a query does not depend on the
+   size of the graph. */
+
+typedef struct igraph_i_ch_search_t {
+    igraph_vector_int_t table;      /* slot + 1 of a vertex, or zero */
+    igraph_vector_int_t vertex;
+    igraph_vector_t dist;
+    igraph_vector_int_t pred;       /* previous vertex, or -1 */
+    igraph_vector_int_t arc;        /* arc from the previous vertex */
+    igraph_vector_char_t done;
+    igraph_vector_int_t settled;    /* slots of the unstalled settled vertices */
+    igraph_indheap_t heap;
+} igraph_i_ch_search_t;
+
+static void igraph_i_ch_search_destroy(igraph_i_ch_search_t *s) {
+    igraph_vector_int_destroy(&s->table);
+    igraph_vector_int_destroy(&s->vertex);
+    igraph_vector_destroy(&s->dist);
+    igraph_vector_int_destroy(&s->pred);
+    igraph_vector_int_destroy(&s->arc);
+    igraph_vector_char_destroy(&s->done);
+    igraph_vector_int_destroy(&s->settled);
+    igraph_indheap_destroy(&s->heap);
+}
+
+static int igraph_i_ch_search_init(igraph_i_ch_search_t *s) {
+    IGRAPH_CHECK(igraph_vector_int_init(&s->table, 64));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &s->table);
+    IGRAPH_CHECK(igraph_vector_int_init(&s->vertex, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &s->vertex);
+    IGRAPH_VECTOR_INIT_FINALLY(&s->dist, 0);
+    IGRAPH_CHECK(igraph_vector_int_init(&s->pred, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &s->pred);
+    IGRAPH_CHECK(igraph_vector_int_init(&s->arc, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &s->arc);
+    IGRAPH_CHECK(igraph_vector_char_init(&s->done, 0));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &s->done);
+    IGRAPH_CHECK(igraph_vector_int_init(&s->settled, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &s->settled);
+    IGRAPH_CHECK(igraph_indheap_init(&s->heap, 0));
+    IGRAPH_FINALLY_CLEAN(7);
+    return 0;
+}
+
+static void igraph_i_ch_search_clear(igraph_i_ch_search_t *s) {
+    igraph_vector_int_null(&s->table);
+    igraph_vector_int_clear(&s->vertex);
+    igraph_vector_clear(&s->dist);
+    igraph_vector_int_clear(&s->pred);
+    igraph_vector_int_clear(&s->arc);
+    igraph_vector_char_clear(&s->done);
+    igraph_vector_int_clear(&s->settled);
+    igraph_indheap_clear(&s->heap);
+}
+
+static long int igraph_i_ch_hash(const igraph_i_ch_search_t *s, long int vertex) {
+    unsigned long int h = (unsigned long int) vertex * 2654435761UL;
+    return (long int) (h & (unsigned long int) (igraph_vector_int_size(&s->table) - 1));
+}
+
+/* The slot of a vertex, or -1 if it was not reached */
+
+static long int igraph_i_ch_find(const igraph_i_ch_search_t *s, long int vertex) {
+    long int size = igraph_vector_int_size(&s->table);
+    long int h = igraph_i_ch_hash(s, vertex);
+    while (VECTOR(s->table)[h] != 0) {
+        long int slot = VECTOR(s->table)[h] - 1;
+        if (VECTOR(s->vertex)[slot] == vertex) {
+            return slot;
+        }
+        h = (h + 1) & (size - 1);
+    }
+    return -1;
+}
+
+static int igraph_i_ch_slot(igraph_i_ch_search_t *s, long int vertex, long int *slot) {
+    long int size = igraph_vector_int_size(&s->table);
+    long int h, n, i;
+
+    *slot = igraph_i_ch_find(s, vertex);
+    if (*slot >= 0) {
+        return 0;
+    }
+
+    *slot = n = igraph_vector_int_size(&s->vertex);
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->vertex, vertex));
+    IGRAPH_CHECK(igraph_vector_push_back(&s->dist, IGRAPH_INFINITY));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->pred, -1));
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->arc, -1));
+    IGRAPH_CHECK(igraph_vector_char_push_back(&s->done, 0));
+
+    /* Keep the table at most half full */
+    if (2 * (n + 1) > size) {
+        IGRAPH_CHECK(igraph_vector_int_resize(&s->table, 2 * size));
+        size *= 2;
+        igraph_vector_int_null(&s->table);
+        for (i = 0; i < n; i++) {
+            h = igraph_i_ch_hash(s, VECTOR(s->vertex)[i]);
+            while (VECTOR(s->table)[h] != 0) {
+                h = (h + 1) & (size - 1);
+            }
+            VECTOR(s->table)[h] = i + 1;
+        }
+    }
+    h = igraph_i_ch_hash(s, vertex);
+    while (VECTOR(s->table)[h] != 0) {
+        h = (h + 1) & (size - 1);
+    }
+    VECTOR(s->table)[h] = n + 1;
+
+    return 0;
+}
+
+static int igraph_i_ch_search_start(igraph_i_ch_search_t *s, long int source) {
+    long int slot;
+    igraph_i_ch_search_clear(s);
+    IGRAPH_CHECK(igraph_i_ch_slot(s, source, &slot));
+    VECTOR(s->dist)[slot] = 0;
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&s->heap, slot, 0));
+    return 0;
+}
+
+/* Smallest key in the heap, outdated entries are dropped first */
+
+static igraph_real_t igraph_i_ch_top(igraph_i_ch_search_t *s) {
+    while (!igraph_indheap_empty(&s->heap)) {
+        if (!VECTOR(s->done)[igraph_indheap_max_index(&s->heap)]) {
+            return -igraph_indheap_max(&s->heap);
+        }
+        igraph_indheap_delete_max(&s->heap);
+    }
+    return IGRAPH_INFINITY;
+}
+
+/* Settles the closest vertex of a search that goes along the arcs of
+   direction 'd' and returns its slot. The vertex is stalled if a more
+   important vertex already reached it on a shorter path, then its
+   arcs are not relaxed, as it cannot be on a shortest path. */
+
+static int igraph_i_ch_settle(igraph_i_ch_search_t *s,
+                              const igraph_i_ch_arcs_t arcs[2], int d,
+                              long int *settled) {
+    long int slot = igraph_indheap_max_index(&s->heap);
+    long int v = VECTOR(s->vertex)[slot], k;
+    igraph_real_t dv = VECTOR(s->dist)[slot];
+    const igraph_i_ch_arcs_t *down = &arcs[1 - d], *up = &arcs[d];
+
+    igraph_indheap_delete_max(&s->heap);
+    VECTOR(s->done)[slot] = 1;
+    *settled = slot;
+
+    for (k = down->start[v]; k < down->start[v + 1]; k++) {
+        long int u = igraph_i_ch_find(s, down->head[k]);
+        if (u >= 0 && VECTOR(s->dist)[u] + down->weight[k] < dv) {
+            return 0;
+        }
+    }
+    IGRAPH_CHECK(igraph_vector_int_push_back(&s->settled, slot));
+
+    for (k = up->start[v]; k < up->start[v + 1]; k++) {
+        igraph_real_t alt = dv + up->weight[k];
+        long int u;
+        IGRAPH_CHECK(igraph_i_ch_slot(s, up->head[k], &u));
+        if (alt < VECTOR(s->dist)[u]) {
+            VECTOR(s->dist)[u] = alt;
+            VECTOR(s->pred)[u] = v;
+            VECTOR(s->arc)[u] = k;
+            IGRAPH_CHECK(igraph_indheap_push_with_index(&s->heap, u, -alt));
+        }
+    }
+
+    return 0;
+}
+
+/* Runs a search until its heap is empty */
+
+static int igraph_i_ch_search_all(igraph_i_ch_search_t *s,
+                                  const igraph_i_ch_arcs_t arcs[2], int d) {
+    long int slot;
+    while (igraph_i_ch_top(s) != IGRAPH_INFINITY) {
+        IGRAPH_CHECK(igraph_i_ch_settle(s, arcs, d, &slot));
+    }
+    return 0;
+}
+
+/* Bidirectional query. A search is finished when its smallest key is
+   not shorter than the best path found, 'meet' is the vertex where
+   the two searches meet on the best path, -1 if there is no path. */
+
+static int igraph_i_ch_query(const igraph_contraction_hierarchy_t *ch,
+                             igraph_i_ch_search_t s[2],
+                             igraph_integer_t from, igraph_integer_t to,
+                             igraph_real_t *res, long int *meet) {
+    igraph_i_ch_arcs_t arcs[2];
+    igraph_real_t best = IGRAPH_INFINITY;
+
+    if (from < 0 || from >= ch->no_of_nodes || to < 0 || to >= ch->no_of_nodes) {
+        IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+    }
+
+    igraph_i_ch_arcs(ch, arcs);
+    IGRAPH_CHECK(igraph_i_ch_search_start(&s[0], from));
+    IGRAPH_CHECK(igraph_i_ch_search_start(&s[1], to));
+    *meet = -1;
+
+    while (1) {
+        igraph_real_t top0 = igraph_i_ch_top(&s[0]), top1 = igraph_i_ch_top(&s[1]);
+        long int slot, other;
+        int d;
+        if (top0 >= best && top1 >= best) {
+            break;
+        }
+        d = top0 < best && (top0 <= top1 || top1 >= best) ? 0 : 1;
+        IGRAPH_CHECK(igraph_i_ch_settle(&s[d], arcs, d, &slot));
+        other = igraph_i_ch_find(&s[1 - d], VECTOR(s[d].vertex)[slot]);
+        if (other >= 0 &&
+            VECTOR(s[d].dist)[slot] + VECTOR(s[1 - d].dist)[other] < best) {
+            best = VECTOR(s[d].dist)[slot] + VECTOR(s[1 - d].dist)[other];
+            *meet = VECTOR(s[d].vertex)[slot];
+        }
+    }
+
+    *res = best;
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_distance
+ * \brief Length of a shortest path, from a contraction hierarchy.
+ *
+ * \param ch The contraction hierarchy.
+ * \param res Pointer to a real number, the length of the shortest
+ *        path from \p from to \p to is stored here, or \c
+ *        IGRAPH_INFINITY if there is no path.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \return Error code.
+ *
+ * Time complexity: depends on the hierarchy, usually a few hundred
+ * vertices are searched in road networks.
+ */
+
+int igraph_contraction_hierarchy_distance(const igraph_contraction_hierarchy_t *ch,
+        igraph_real_t *res,
+        igraph_integer_t from,
+        igraph_integer_t to) {
+    igraph_i_ch_search_t s[2];
+    long int meet;
+
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s[0]));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s[0]);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s[1]));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s[1]);
+
+    IGRAPH_CHECK(igraph_i_ch_query(ch, s, from, to, res, &meet));
+
+    igraph_i_ch_search_destroy(&s[1]);
+    igraph_i_ch_search_destroy(&s[0]);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/* The position of the arc of vertex 'owner' in direction 'd' that
+   leads to 'head' */
+
+static long int igraph_i_ch_find_arc(const igraph_i_ch_arcs_t *arcs,
+                                     long int owner, long int head) {
+    long int k;
+    for (k = arcs->start[owner]; k < arcs->start[owner + 1]; k++) {
+        if (arcs->head[k] == head) {
+            return k;
+        }
+    }
+    return -1;
+}
+
+/* Appends the edges, and the vertices after 'a', of the path that the
+   arc at position 'k' in direction 'd' stands for. The arc goes from
+   'a' to 'b'. Shortcuts are replaced by their two halves on a stack
+   until only original edges are left. */
+
+static int igraph_i_ch_unpack(const igraph_i_ch_arcs_t arcs[2],
+                              igraph_vector_int_t *stack,
+                              int d, long int k, long int a, long int b,
+                              igraph_vector_t *vertices, igraph_vector_t *edges) {
+    igraph_vector_int_clear(stack);
+    IGRAPH_CHECK(igraph_vector_int_push_back(stack, d));
+    IGRAPH_CHECK(igraph_vector_int_push_back(stack, k));
+    IGRAPH_CHECK(igraph_vector_int_push_back(stack, a));
+    IGRAPH_CHECK(igraph_vector_int_push_back(stack, b));
+
+    while (!igraph_vector_int_empty(stack)) {
+        long int m, k1, k2;
+        b = igraph_vector_int_pop_back(stack);
+        a = igraph_vector_int_pop_back(stack);
+        k = igraph_vector_int_pop_back(stack);
+        d = igraph_vector_int_pop_back(stack);
+
+        if (arcs[d].edge[k] >= 0) {
+            if (edges) {
+                IGRAPH_CHECK(igraph_vector_push_back(edges, arcs[d].edge[k]));
+            }
+            if (vertices) {
+                IGRAPH_CHECK(igraph_vector_push_back(vertices, b));
+            }
+            continue;
+        }
+
+        m = arcs[d].via[k];
+        k1 = igraph_i_ch_find_arc(&arcs[1], m, a);
+        k2 = igraph_i_ch_find_arc(&arcs[0], m, b);
+        if (k1 < 0 || k2 < 0) {
+            IGRAPH_ERROR("Invalid contraction hierarchy", IGRAPH_EINVAL);
+        }
+        /* The second half goes first, so the first half is popped first */
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, 0));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, k2));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, m));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, b));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, 1));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, k1));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, a));
+        IGRAPH_CHECK(igraph_vector_int_push_back(stack, m));
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_get_shortest_path
+ * \brief A shortest path, from a contraction hierarchy.
+ *
+ * The shortcuts of the hierarchy on the path are replaced by the
+ * edges of the original graph, so the result refers to the vertex
+ * and edge ids of the graph the hierarchy was built from.
+ *
+ * \param ch The contraction hierarchy.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param res Pointer to a real number or a null pointer. If not a
+ *        null pointer, the length of the path is stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \return Error code. If there is no path, a warning is given, the
+ *        vectors are empty and the length is \c IGRAPH_INFINITY.
+ *
+ * Time complexity: the time of a distance query, plus the number of
+ * edges on the path.
+ */
+
+int igraph_contraction_hierarchy_get_shortest_path(
+    const igraph_contraction_hierarchy_t *ch,
+    igraph_vector_t *vertices,
+    igraph_vector_t *edges,
+    igraph_real_t *res,
+    igraph_integer_t from,
+    igraph_integer_t to) {
+
+    igraph_i_ch_search_t s[2];
+    igraph_i_ch_arcs_t arcs[2];
+    igraph_vector_int_t stack, up;
+    igraph_real_t dist;
+    long int meet, i, slot;
+
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s[0]));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s[0]);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s[1]));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s[1]);
+    IGRAPH_CHECK(igraph_vector_int_init(&stack, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &stack);
+    IGRAPH_CHECK(igraph_vector_int_init(&up, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &up);
+
+    IGRAPH_CHECK(igraph_i_ch_query(ch, s, from, to, &dist, &meet));
+    igraph_i_ch_arcs(ch, arcs);
+    if (res) {
+        *res = dist;
+    }
+    if (vertices) {
+        igraph_vector_clear(vertices);
+    }
+    if (edges) {
+        igraph_vector_clear(edges);
+    }
+
+    if (meet < 0) {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+    } else {
+        if (vertices) {
+            IGRAPH_CHECK(igraph_vector_push_back(vertices, from));
+        }
+
+        /* The upward part from the source is collected backwards */
+        for (slot = igraph_i_ch_find(&s[0], meet); VECTOR(s[0].pred)[slot] >= 0;
+             slot = igraph_i_ch_find(&s[0], VECTOR(s[0].pred)[slot])) {
+            IGRAPH_CHECK(igraph_vector_int_push_back(&up, slot));
+        }
+        for (i = igraph_vector_int_size(&up) - 1; i >= 0; i--) {
+            slot = VECTOR(up)[i];
+            IGRAPH_CHECK(igraph_i_ch_unpack(arcs, &stack, 0, VECTOR(s[0].arc)[slot],
+                                            VECTOR(s[0].pred)[slot],
+                                            VECTOR(s[0].vertex)[slot],
+                                            vertices, edges));
+        }
+
+        /* The downward part to the target is in order */
+        for (slot = igraph_i_ch_find(&s[1], meet); VECTOR(s[1].pred)[slot] >= 0;
+             slot = igraph_i_ch_find(&s[1], VECTOR(s[1].pred)[slot])) {
+            IGRAPH_CHECK(igraph_i_ch_unpack(arcs, &stack, 1, VECTOR(s[1].arc)[slot],
+                                            VECTOR(s[1].vertex)[slot],
+                                            VECTOR(s[1].pred)[slot],
+                                            vertices, edges));
+        }
+    }
+
+    igraph_vector_int_destroy(&up);
+    igraph_vector_int_destroy(&stack);
+    igraph_i_ch_search_destroy(&s[1]);
+    igraph_i_ch_search_destroy(&s[0]);
+    IGRAPH_FINALLY_CLEAN(4);
+
+    return 0;
+}
+
+/* Distance table. The backward search from every target leaves its
+   distance at every vertex it settles, in buckets. The forward search
+   from a source then combines its distances with the buckets of the
+   vertices it settles. */
+
+typedef struct igraph_i_ch_table_t {
+    const igraph_contraction_hierarchy_t *ch;
+    igraph_i_ch_arcs_t arcs[2];
+    const igraph_vector_t *from, *to;
+    igraph_matrix_t *res;
+    igraph_vector_int_t *reached;   /* vertices settled from each target */
+    igraph_vector_t *reached_dist;
+    long int no_of_targets;
+    igraph_vector_int_t bucket_start;
+    igraph_vector_int_t bucket_target;
+    igraph_vector_t bucket_dist;
+} igraph_i_ch_table_t;
+
+static void igraph_i_ch_table_destroy(igraph_i_ch_table_t *t) {
+    long int j;
+    if (t->reached) {
+        for (j = 0; j < t->no_of_targets; j++) {
+            igraph_vector_int_destroy(&t->reached[j]);
+            igraph_vector_destroy(&t->reached_dist[j]);
+        }
+    }
+    igraph_Free(t->reached);
+    igraph_Free(t->reached_dist);
+    igraph_vector_int_destroy(&t->bucket_start);
+    igraph_vector_int_destroy(&t->bucket_target);
+    igraph_vector_destroy(&t->bucket_dist);
+}
+
+static int igraph_i_ch_table_targets(igraph_integer_t from, igraph_integer_t to,
+                                     int thread, void *arg) {
+    igraph_i_ch_table_t *t = (igraph_i_ch_table_t *) arg;
+    igraph_i_ch_search_t s;
+    long int j, i, n;
+
+    IGRAPH_UNUSED(thread);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s);
+
+    for (j = from; j < to; j++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_ch_search_start(&s, (long int) VECTOR(*t->to)[j]));
+        IGRAPH_CHECK(igraph_i_ch_search_all(&s, t->arcs, 1));
+        n = igraph_vector_int_size(&s.settled);
+        IGRAPH_CHECK(igraph_vector_int_resize(&t->reached[j], n));
+        IGRAPH_CHECK(igraph_vector_resize(&t->reached_dist[j], n));
+        for (i = 0; i < n; i++) {
+            long int slot = VECTOR(s.settled)[i];
+            VECTOR(t->reached[j])[i] = VECTOR(s.vertex)[slot];
+            VECTOR(t->reached_dist[j])[i] = VECTOR(s.dist)[slot];
+        }
+    }
+
+    igraph_i_ch_search_destroy(&s);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static int igraph_i_ch_table_sources(igraph_integer_t from, igraph_integer_t to,
+                                     int thread, void *arg) {
+    igraph_i_ch_table_t *t = (igraph_i_ch_table_t *) arg;
+    igraph_i_ch_search_t s;
+    long int i, k, n;
+
+    IGRAPH_UNUSED(thread);
+    IGRAPH_CHECK(igraph_i_ch_search_init(&s));
+    IGRAPH_FINALLY(igraph_i_ch_search_destroy, &s);
+
+    for (i = from; i < to; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_ch_search_start(&s, (long int) VECTOR(*t->from)[i]));
+        IGRAPH_CHECK(igraph_i_ch_search_all(&s, t->arcs, 0));
+        n = igraph_vector_int_size(&s.settled);
+        for (k = 0; k < n; k++) {
+            long int slot = VECTOR(s.settled)[k];
+            long int v = VECTOR(s.vertex)[slot], b;
+            igraph_real_t dv = VECTOR(s.dist)[slot];
+            for (b = VECTOR(t->bucket_start)[v]; b < VECTOR(t->bucket_start)[v + 1]; b++) {
+                long int j = VECTOR(t->bucket_target)[b];
+                igraph_real_t alt = dv + VECTOR(t->bucket_dist)[b];
+                if (alt < MATRIX(*t->res, i, j)) {
+                    MATRIX(*t->res, i, j) = alt;
+                }
+            }
+        }
+    }
+
+    igraph_i_ch_search_destroy(&s);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static int igraph_i_ch_check_vids(const igraph_contraction_hierarchy_t *ch,
+                                  const igraph_vector_t *vids) {
+    long int i, n = igraph_vector_size(vids);
+    for (i = 0; i < n; i++) {
+        if (VECTOR(*vids)[i] < 0 || VECTOR(*vids)[i] >= ch->no_of_nodes) {
+            IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_distance_matrix
+ * \brief Shortest path lengths between many sources and targets.
+ *
+ * This function computes the table of distances from a set of source
+ * vertices to a set of target vertices with one upward search from
+ * each source and target, which is much faster than a query for each
+ * pair. The searches run on multiple threads, see \ref
+ * igraph_set_num_threads().
+ *
+ * \param ch The contraction hierarchy.
+ * \param res Pointer to an initialized matrix, it will be resized as
+ *        needed. Row i, column j will contain the length of the
+ *        shortest path from source i to target j, or \c
+ *        IGRAPH_INFINITY if there is no path.
+ * \param from Vector of the ids of the source vertices.
+ * \param to Vector of the ids of the target vertices.
+ * \return Error code.
+ *
+ * Time complexity: the time of the upward searches, plus the size of
+ * the table times the number of search spaces a vertex is in.
+ */
+
+int igraph_contraction_hierarchy_distance_matrix(
+    const igraph_contraction_hierarchy_t *ch,
+    igraph_matrix_t *res,
+    const igraph_vector_t *from,
+    const igraph_vector_t *to) {
+
+    igraph_i_ch_table_t t;
+    long int no_of_nodes = ch->no_of_nodes;
+    long int no_of_sources = igraph_vector_size(from);
+    long int no_of_targets = igraph_vector_size(to);
+    long int i, j, v, n;
+
+    IGRAPH_CHECK(igraph_i_ch_check_vids(ch, from));
+    IGRAPH_CHECK(igraph_i_ch_check_vids(ch, to));
+
+    memset(&t, 0, sizeof(t));
+    t.ch = ch;
+    t.from = from;
+    t.to = to;
+    t.res = res;
+    t.no_of_targets = 0;
+    igraph_i_ch_arcs(ch, t.arcs);
+    IGRAPH_FINALLY(igraph_i_ch_table_destroy, &t);
+    IGRAPH_CHECK(igraph_vector_int_init(&t.bucket_start, no_of_nodes + 1));
+    IGRAPH_CHECK(igraph_vector_int_init(&t.bucket_target, 0));
+    IGRAPH_CHECK(igraph_vector_init(&t.bucket_dist, 0));
+    t.reached = igraph_Calloc(no_of_targets > 0 ? no_of_targets : 1, igraph_vector_int_t);
+    t.reached_dist = igraph_Calloc(no_of_targets > 0 ? no_of_targets : 1, igraph_vector_t);
+    if (!t.reached || !t.reached_dist) {
+        IGRAPH_ERROR("Cannot compute distance table", IGRAPH_ENOMEM);
+    }
+    for (j = 0; j < no_of_targets; j++) {
+        IGRAPH_CHECK(igraph_vector_int_init(&t.reached[j], 0));
+        if (igraph_vector_init(&t.reached_dist[j], 0) != 0) {
+            igraph_vector_int_destroy(&t.reached[j]);
+            IGRAPH_ERROR("Cannot compute distance table", IGRAPH_ENOMEM);
+        }
+        t.no_of_targets = j + 1;
+    }
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_sources, no_of_targets));
+    igraph_matrix_fill(res, IGRAPH_INFINITY);
+
+    IGRAPH_CHECK(igraph_parallel_for(no_of_targets, IGRAPH_I_CH_GRAIN,
+                                     igraph_i_ch_table_targets, &t));
+
+    /* Sort the entries into buckets by vertex */
+    for (j = 0, n = 0; j < no_of_targets; j++) {
+        long int len = igraph_vector_int_size(&t.reached[j]);
+        for (i = 0; i < len; i++) {
+            VECTOR(t.bucket_start)[VECTOR(t.reached[j])[i] + 1] += 1;
+        }
+        n += len;
+    }
+    for (v = 0; v < no_of_nodes; v++) {
+        VECTOR(t.bucket_start)[v + 1] += VECTOR(t.bucket_start)[v];
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(&t.bucket_target, n));
+    IGRAPH_CHECK(igraph_vector_resize(&t.bucket_dist, n));
+    for (j = 0; j < no_of_targets; j++) {
+        long int len = igraph_vector_int_size(&t.reached[j]);
+        for (i = 0; i < len; i++) {
+            long int pos = VECTOR(t.bucket_start)[VECTOR(t.reached[j])[i]]++;
+            VECTOR(t.bucket_target)[pos] = j;
+            VECTOR(t.bucket_dist)[pos] = VECTOR(t.reached_dist[j])[i];
+        }
+        igraph_vector_int_clear(&t.reached[j]);
+        igraph_vector_clear(&t.reached_dist[j]);
+    }
+    for (v = no_of_nodes; v > 0; v--) {
+        VECTOR(t.bucket_start)[v] = VECTOR(t.bucket_start)[v - 1];
+    }
+    VECTOR(t.bucket_start)[0] = 0;
+
+    IGRAPH_CHECK(igraph_parallel_for(no_of_sources, IGRAPH_I_CH_GRAIN,
+                                     igraph_i_ch_table_sources, &t));
+
+    igraph_i_ch_table_destroy(&t);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* ------------------------------------------------------------------ */
+/* Saving and loading                                                 */
+/* ------------------------------------------------------------------ */
+
+/* The file is a header followed by the vectors of the hierarchy, in
+ * the order of the header fields: rank, then the starts, heads, vias,
+ * edges and weights of the 'out' and, for directed hierarchies, the
+ * 'in' arcs. Like igraph_write_graph_binary(), it uses the byte order
+ * and integer size of the machine. */
+
+#define IGRAPH_I_CH_MAGIC "IGRAPHCH"
+#define IGRAPH_I_CH_VERSION 1
+#define IGRAPH_I_CH_BYTEORDER 0x01020304
+
+typedef struct igraph_i_ch_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteorder;
+    uint32_t intsize;
+    uint32_t directed;
+    int64_t no_of_nodes;
+    int64_t no_of_arcs[2];
+} igraph_i_ch_header_t;
+
+static int igraph_i_ch_write(FILE *outstream, const void *data, size_t size,
+                             size_t n) {
+    if (n > 0 && fwrite(data, size, n, outstream) != n) {
+        IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+    return 0;
+}
+
+static int igraph_i_ch_read(FILE *instream, void *data, size_t size, size_t n) {
+    if (n > 0 && fread(data, size, n, instream) != n) {
+        IGRAPH_ERROR("Read error, file is truncated", IGRAPH_PARSEERROR);
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_write
+ * \brief Saves a contraction hierarchy to a file.
+ *
+ * The format is binary and not portable: it uses the byte order of
+ * the machine and the size of \type igraph_integer_t, like \ref
+ * igraph_write_graph_binary().
+ *
+ * \param ch The contraction hierarchy.
+ * \param outstream The stream to write to, it should be writable and
+ *        opened in binary mode.
+ * \return Error code:
+ *         \c IGRAPH_EFILE if there is an error writing the file.
+ *
+ * Time complexity: O(|V|+|A|), the number of vertices and arcs in the
+ * hierarchy.
+ */
+
+int igraph_contraction_hierarchy_write(const igraph_contraction_hierarchy_t *ch,
+                                       FILE *outstream) {
+    igraph_i_ch_header_t header;
+    size_t n = (size_t) ch->no_of_nodes;
+    int d;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_CH_MAGIC, sizeof(header.magic));
+    header.version = IGRAPH_I_CH_VERSION;
+    header.byteorder = IGRAPH_I_CH_BYTEORDER;
+    header.intsize = sizeof(igraph_integer_t);
+    header.directed = ch->directed ? 1 : 0;
+    header.no_of_nodes = ch->no_of_nodes;
+    header.no_of_arcs[0] = igraph_vector_int_size(&ch->out_head);
+    header.no_of_arcs[1] = igraph_vector_int_size(&ch->in_head);
+
+    IGRAPH_CHECK(igraph_i_ch_write(outstream, &header, sizeof(header), 1));
+    IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(ch->rank),
+                                   sizeof(igraph_integer_t), n));
+    for (d = 0; d < (ch->directed ? 2 : 1); d++) {
+        const igraph_contraction_hierarchy_t *c = ch;
+        size_t m = (size_t) header.no_of_arcs[d];
+        IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(d ? c->in_start : c->out_start),
+                                       sizeof(igraph_integer_t), n + 1));
+        IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(d ? c->in_head : c->out_head),
+                                       sizeof(igraph_integer_t), m));
+        IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(d ? c->in_via : c->out_via),
+                                       sizeof(igraph_integer_t), m));
+        IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(d ? c->in_edge : c->out_edge),
+                                       sizeof(igraph_integer_t), m));
+        IGRAPH_CHECK(igraph_i_ch_write(outstream, VECTOR(d ? c->in_weight : c->out_weight),
+                                       sizeof(igraph_real_t), m));
+    }
+
+    return 0;
+}
+
+/* Checks that the arcs read from a file stay within the hierarchy,
+   so that a damaged file cannot make a query read out of bounds */
+
+static int igraph_i_ch_validate(const igraph_contraction_hierarchy_t *ch) {
+    long int n = ch->no_of_nodes, v, k;
+    int d;
+
+    for (v = 0; v < n; v++) {
+        if (VECTOR(ch->rank)[v] < 0 || VECTOR(ch->rank)[v] >= n) {
+            IGRAPH_ERROR("Invalid contraction hierarchy file", IGRAPH_PARSEERROR);
+        }
+    }
+    for (d = 0; d < (ch->directed ? 2 : 1); d++) {
+        const igraph_vector_int_t *start = d ? &ch->in_start : &ch->out_start;
+        const igraph_vector_int_t *head = d ? &ch->in_head : &ch->out_head;
+        const igraph_vector_int_t *via = d ? &ch->in_via : &ch->out_via;
+        const igraph_vector_int_t *edge = d ? &ch->in_edge : &ch->out_edge;
+        long int m = igraph_vector_int_size(head);
+        if (VECTOR(*start)[0] != 0 || VECTOR(*start)[n] != m) {
+            IGRAPH_ERROR("Invalid contraction hierarchy file", IGRAPH_PARSEERROR);
+        }
+        for (v = 0; v < n; v++) {
+            if (VECTOR(*start)[v] > VECTOR(*start)[v + 1]) {
+                IGRAPH_ERROR("Invalid contraction hierarchy file", IGRAPH_PARSEERROR);
+            }
+        }
+        for (k = 0; k < m; k++) {
+            if (VECTOR(*head)[k] < 0 || VECTOR(*head)[k] >= n ||
+                VECTOR(*via)[k] < -1 || VECTOR(*via)[k] >= n ||
+                (VECTOR(*via)[k] < 0 && VECTOR(*edge)[k] < 0)) {
+                IGRAPH_ERROR("Invalid contraction hierarchy file", IGRAPH_PARSEERROR);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_contraction_hierarchy_read
+ * \brief Loads a contraction hierarchy from a file.
+ *
+ * \param ch Pointer to an uninitialized contraction hierarchy, it
+ *        must be destroyed with \ref igraph_contraction_hierarchy_destroy().
+ * \param instream The stream to read from, it should be opened in
+ *        binary mode.
+ * \return Error code:
+ *         \c IGRAPH_PARSEERROR if the file is not a contraction
+ *         hierarchy written by \ref igraph_contraction_hierarchy_write()
+ *         on a machine with the same byte order and integer size.
+ *
+ * Time complexity: O(|V|+|A|), the number of vertices and arcs in the
+ * hierarchy.
+ */
+
+int igraph_contraction_hierarchy_read(igraph_contraction_hierarchy_t *ch,
+                                      FILE *instream) {
+    igraph_i_ch_header_t header;
+    size_t n;
+    int d;
+
+    IGRAPH_CHECK(igraph_i_ch_read(instream, &header, sizeof(header), 1));
+    if (memcmp(header.magic, IGRAPH_I_CH_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != IGRAPH_I_CH_VERSION) {
+        IGRAPH_ERROR("Not a contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+    if (header.byteorder != IGRAPH_I_CH_BYTEORDER ||
+        header.intsize != sizeof(igraph_integer_t)) {
+        IGRAPH_ERROR("Contraction hierarchy file was written with a different "
+                     "byte order or integer size", IGRAPH_PARSEERROR);
+    }
+    if (header.no_of_nodes < 0 || header.no_of_nodes >= IGRAPH_INTEGER_MAX ||
+        header.no_of_arcs[0] < 0 || header.no_of_arcs[0] > IGRAPH_INTEGER_MAX ||
+        header.no_of_arcs[1] < 0 || header.no_of_arcs[1] > IGRAPH_INTEGER_MAX ||
+        (!header.directed && header.no_of_arcs[1] != 0)) {
+        IGRAPH_ERROR("Invalid contraction hierarchy file", IGRAPH_PARSEERROR);
+    }
+
+    IGRAPH_CHECK(igraph_i_contraction_hierarchy_alloc(ch));
+    IGRAPH_FINALLY(igraph_contraction_hierarchy_destroy, ch);
+    ch->no_of_nodes = (igraph_integer_t) header.no_of_nodes;
+    ch->directed = header.directed ? 1 : 0;
+    n = (size_t) header.no_of_nodes;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(&ch->rank, (long int) n));
+    IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(ch->rank),
+                                  sizeof(igraph_integer_t), n));
+    for (d = 0; d < (ch->directed ? 2 : 1); d++) {
+        igraph_vector_int_t *start = d ? &ch->in_start : &ch->out_start;
+        igraph_vector_int_t *head = d ? &ch->in_head : &ch->out_head;
+        igraph_vector_int_t *via = d ? &ch->in_via : &ch->out_via;
+        igraph_vector_int_t *edge = d ? &ch->in_edge : &ch->out_edge;
+        igraph_vector_t *weight = d ? &ch->in_weight : &ch->out_weight;
+        long int m = (long int) header.no_of_arcs[d];
+        IGRAPH_CHECK(igraph_vector_int_resize(start, (long int) n + 1));
+        IGRAPH_CHECK(igraph_vector_int_resize(head, m));
+        IGRAPH_CHECK(igraph_vector_int_resize(via, m));
+        IGRAPH_CHECK(igraph_vector_int_resize(edge, m));
+        IGRAPH_CHECK(igraph_vector_resize(weight, m));
+        IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(*start),
+                                      sizeof(igraph_integer_t), n + 1));
+        IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(*head),
+                                      sizeof(igraph_integer_t), (size_t) m));
+        IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(*via),
+                                      sizeof(igraph_integer_t), (size_t) m));
+        IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(*edge),
+                                      sizeof(igraph_integer_t), (size_t) m));
+        IGRAPH_CHECK(igraph_i_ch_read(instream, VECTOR(*weight),
+                                      sizeof(igraph_real_t), (size_t) m));
+    }
+    IGRAPH_CHECK(igraph_i_ch_validate(ch));
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
@@ -0,0 +1,613 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_interface.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_memory.h"
+#include "igraph_threading.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+#include "structural_properties_internal.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Delta-stepping, see Ulrich Meyer and Peter Sanders: Delta-stepping:
+ * a parallelizable shortest path algorithm, Journal of Algorithms 49
+ * (2003), 114-152.
+ *
+ * The tentative distances are kept in buckets of width delta, bucket
+ * i holds the vertices with distance in [i*delta, (i+1)*delta). The
+ * buckets are emptied in increasing order. Emptying a bucket takes
+ * several phases: each phase takes the vertices in the bucket and
+ * relaxes their light edges, the ones not longer than delta; these
+ * can put vertices back in the same bucket. When the bucket stays
+ * empty, the heavy edges of all vertices that were in it are relaxed
+ * once. The vertices of a phase can be processed in any order, so the
+ * phases with at least IGRAPH_I_DS_GRAIN vertices are divided among
+ * the threads. The threads only read the distances and collect the
+ * shorter ones they find in their own buffers, these are applied on
+ * the calling thread, in the order of the threads, so the result does
+ * not depend on the timing.
+ *
+ * No distance is ever more than the largest weight above the bucket
+ * being emptied, so the buckets are reused cyclically. A bucket can
+ * hold a vertex more than once, or with a distance that has
+ * decreased since it was added; these entries are skipped. */
+
+#define IGRAPH_I_DS_GRAIN 1024
+
+typedef struct igraph_i_ds_buffer_t {
+    igraph_vector_int_t vertex;
+    igraph_vector_t dist;
+} igraph_i_ds_buffer_t;
+
+typedef struct igraph_i_ds_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_neimode_t mode;
+    igraph_real_t delta;
+    long int no_of_buckets;
+    igraph_vector_int_t *buckets;
+    long int pending;            /* number of entries in the buckets */
+    igraph_vector_t dist;        /* -1 for the vertices not reached */
+    igraph_vector_int_t frontier;
+    igraph_vector_int_t settled; /* the vertices of the current bucket */
+    igraph_vector_char_t in_frontier;
+    igraph_vector_char_t in_settled;
+    igraph_vector_ptr_t buffers;
+    const igraph_vector_int_t *scan; /* vertices of the parallel step */
+    igraph_bool_t light;
+} igraph_i_ds_t;
+
+static void igraph_i_ds_destroy(igraph_i_ds_t *ds) {
+    long int i, n = igraph_vector_ptr_size(&ds->buffers);
+    if (ds->buckets) {
+        for (i = 0; i < ds->no_of_buckets; i++) {
+            igraph_vector_int_destroy(&ds->buckets[i]);
+        }
+        igraph_Free(ds->buckets);
+    }
+    for (i = 0; i < n; i++) {
+        igraph_i_ds_buffer_t *buf = VECTOR(ds->buffers)[i];
+        igraph_vector_int_destroy(&buf->vertex);
+        igraph_vector_destroy(&buf->dist);
+        igraph_Free(buf);
+    }
+    igraph_vector_ptr_destroy(&ds->buffers);
+    igraph_vector_destroy(&ds->dist);
+    igraph_vector_int_destroy(&ds->frontier);
+    igraph_vector_int_destroy(&ds->settled);
+    igraph_vector_char_destroy(&ds->in_frontier);
+    igraph_vector_char_destroy(&ds->in_settled);
+}
+
+/* Checks the weights and chooses the bucket width. A bucket width
+   that would need more than max(|V|, 1024) buckets is increased. */
+
+static int igraph_i_ds_init(igraph_i_ds_t *ds, const igraph_t *graph,
+                            const igraph_vector_t *weights,
+                            igraph_neimode_t mode, igraph_real_t delta) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    long int i, max_buckets = no_of_nodes > 1024 ? no_of_nodes : 1024;
+    igraph_real_t maxw = 0.0;
+
+    if (igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+    }
+    for (i = 0; i < no_of_edges; i++) {
+        igraph_real_t w = VECTOR(*weights)[i];
+        if (!(w >= 0)) {
+            IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+        }
+        if (w > maxw && w != IGRAPH_INFINITY) {
+            maxw = w;
+        }
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+
+    if (!(delta > 0)) {
+        /* Meyer and Sanders suggest the largest weight over the
+           average degree */
+        igraph_real_t degree = no_of_nodes > 0 ?
+                               (mode == IGRAPH_ALL ? 2.0 : 1.0) * no_of_edges / no_of_nodes : 1.0;
+        delta = maxw / (degree > 1.0 ? degree : 1.0);
+    }
+    if (maxw == 0.0) {
+        delta = 1.0;
+    } else if (maxw / delta > max_buckets - 3) {
+        delta = maxw / (max_buckets - 3);
+    }
+
+    memset(ds, 0, sizeof(*ds));
+    ds->graph = graph;
+    ds->weights = weights;
+    ds->mode = mode;
+    ds->delta = delta;
+    IGRAPH_FINALLY(igraph_i_ds_destroy, ds);
+
+    /* The distances are below the current bucket plus maxw, and one
+       more bucket is needed for rounding */
+    ds->no_of_buckets = (long int) floor(maxw / delta) + 3;
+    ds->buckets = igraph_Calloc(ds->no_of_buckets, igraph_vector_int_t);
+    if (!ds->buckets) {
+        IGRAPH_ERROR("Cannot run delta-stepping", IGRAPH_ENOMEM);
+    }
+    for (i = 0; i < ds->no_of_buckets; i++) {
+        IGRAPH_CHECK(igraph_vector_int_init(&ds->buckets[i], 0));
+    }
+    IGRAPH_CHECK(igraph_vector_ptr_init(&ds->buffers, 0));
+    IGRAPH_CHECK(igraph_vector_init(&ds->dist, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_init(&ds->frontier, 0));
+    IGRAPH_CHECK(igraph_vector_int_init(&ds->settled, 0));
+    IGRAPH_CHECK(igraph_vector_char_init(&ds->in_frontier, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_char_init(&ds->in_settled, no_of_nodes));
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+static long int igraph_i_ds_bucket(const igraph_i_ds_t *ds, igraph_real_t d) {
+    return (long int) (d / ds->delta);
+}
+
+static int igraph_i_ds_relax(igraph_i_ds_t *ds, long int v, igraph_real_t d) {
+    igraph_real_t *dist = VECTOR(ds->dist);
+    if (dist[v] < 0 || d < dist[v]) {
+        dist[v] = d;
+        IGRAPH_CHECK(igraph_vector_int_push_back(
+                         &ds->buckets[igraph_i_ds_bucket(ds, d) % ds->no_of_buckets], v));
+        ds->pending++;
+    }
+    return 0;
+}
+
+/* Relaxes the light or the heavy edges of vertex u. Without a buffer
+   the distances are updated directly, otherwise the shorter distances
+   are collected in the buffer. */
+
+static int igraph_i_ds_scan(igraph_i_ds_t *ds, long int u, igraph_bool_t light,
+                            igraph_i_ds_buffer_t *buf) {
+    const igraph_t *graph = ds->graph;
+    const igraph_real_t *weights = VECTOR(*ds->weights);
+    const igraph_real_t *dist = VECTOR(ds->dist);
+    igraph_real_t du = dist[u], delta = ds->delta;
+    int pass;
+
+    for (pass = 0; pass < 2; pass++) {
+        const igraph_integer_t *index, *other;
+        igraph_integer_t k, begin, end;
+        if (pass == 0 && (ds->mode & IGRAPH_OUT)) {
+            begin = VECTOR(graph->os)[u]; end = VECTOR(graph->os)[u + 1];
+            index = VECTOR(graph->oi); other = VECTOR(graph->to);
+        } else if (pass == 1 && (ds->mode & IGRAPH_IN)) {
+            begin = VECTOR(graph->is)[u]; end = VECTOR(graph->is)[u + 1];
+            index = VECTOR(graph->ii); other = VECTOR(graph->from);
+        } else {
+            continue;
+        }
+        for (k = begin; k < end; k++) {
+            igraph_integer_t e = index[k];
+            igraph_real_t w = weights[e], d;
+            long int v;
+            if ((w <= delta) != light || w == IGRAPH_INFINITY) {
+                continue;
+            }
+            v = other[e];
+            d = du + w;
+            if (dist[v] >= 0 && d >= dist[v]) {
+                continue;
+            }
+            if (buf) {
+                IGRAPH_CHECK(igraph_vector_int_push_back(&buf->vertex, v));
+                IGRAPH_CHECK(igraph_vector_push_back(&buf->dist, d));
+            } else {
+                IGRAPH_CHECK(igraph_i_ds_relax(ds, v, d));
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_ds_chunk(igraph_integer_t from, igraph_integer_t to,
+                             int thread, void *arg) {
+    igraph_i_ds_t *ds = arg;
+    igraph_i_ds_buffer_t *buf = VECTOR(ds->buffers)[thread];
+    igraph_integer_t i;
+
+    for (i = from; i < to; i++) {
+        IGRAPH_CHECK(igraph_i_ds_scan(ds, VECTOR(*ds->scan)[i], ds->light, buf));
+    }
+
+    return 0;
+}
+
+/* Relaxes the light or heavy edges of a set of vertices */
+
+static int igraph_i_ds_step(igraph_i_ds_t *ds, const igraph_vector_int_t *vertices,
+                            igraph_bool_t light) {
+    long int i, j, t, n = igraph_vector_int_size(vertices);
+    long int nthreads = igraph_get_num_threads();
+
+    if (nthreads < 2 || n < IGRAPH_I_DS_GRAIN) {
+        for (i = 0; i < n; i++) {
+            IGRAPH_CHECK(igraph_i_ds_scan(ds, VECTOR(*vertices)[i], light, 0));
+        }
+        return 0;
+    }
+
+    while (igraph_vector_ptr_size(&ds->buffers) < nthreads) {
+        igraph_i_ds_buffer_t *buf = igraph_Calloc(1, igraph_i_ds_buffer_t);
+        if (!buf) {
+            IGRAPH_ERROR("Cannot run delta-stepping", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, buf);
+        IGRAPH_CHECK(igraph_vector_int_init(&buf->vertex, 0));
+        IGRAPH_FINALLY(igraph_vector_int_destroy, &buf->vertex);
+        IGRAPH_CHECK(igraph_vector_init(&buf->dist, 0));
+        IGRAPH_FINALLY(igraph_vector_destroy, &buf->dist);
+        IGRAPH_CHECK(igraph_vector_ptr_push_back(&ds->buffers, buf));
+        IGRAPH_FINALLY_CLEAN(3);
+    }
+    for (t = 0; t < nthreads; t++) {
+        igraph_i_ds_buffer_t *buf = VECTOR(ds->buffers)[t];
+        igraph_vector_int_clear(&buf->vertex);
+        igraph_vector_clear(&buf->dist);
+    }
+
+    ds->scan = vertices;
+    ds->light = light;
+    IGRAPH_CHECK(igraph_parallel_for(n, IGRAPH_I_DS_GRAIN / 4,
+                                     igraph_i_ds_chunk, ds));
+
+    for (t = 0; t < nthreads; t++) {
+        igraph_i_ds_buffer_t *buf = VECTOR(ds->buffers)[t];
+        long int m = igraph_vector_int_size(&buf->vertex);
+        for (j = 0; j < m; j++) {
+            IGRAPH_CHECK(igraph_i_ds_relax(ds, VECTOR(buf->vertex)[j],
+                                           VECTOR(buf->dist)[j]));
+        }
+    }
+
+    return 0;
+}
+
+/* Distances from one source, they are left in ds->dist, -1 for the
+   vertices that cannot be reached */
+
+static int igraph_i_ds_run(igraph_i_ds_t *ds, long int source) {
+    long int i, current = 0;
+
+    igraph_vector_fill(&ds->dist, -1.0);
+    IGRAPH_CHECK(igraph_i_ds_relax(ds, source, 0.0));
+
+    while (ds->pending > 0) {
+        igraph_vector_int_t *bucket;
+
+        while (igraph_vector_int_empty(&ds->buckets[current % ds->no_of_buckets])) {
+            current++;
+        }
+        bucket = &ds->buckets[current % ds->no_of_buckets];
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        igraph_vector_int_clear(&ds->settled);
+        while (!igraph_vector_int_empty(bucket)) {
+            long int n = igraph_vector_int_size(bucket);
+            igraph_vector_int_clear(&ds->frontier);
+            for (i = 0; i < n; i++) {
+                long int v = VECTOR(*bucket)[i];
+                if (!VECTOR(ds->in_frontier)[v] &&
+                    igraph_i_ds_bucket(ds, VECTOR(ds->dist)[v]) == current) {
+                    VECTOR(ds->in_frontier)[v] = 1;
+                    IGRAPH_CHECK(igraph_vector_int_push_back(&ds->frontier, v));
+                    if (!VECTOR(ds->in_settled)[v]) {
+                        VECTOR(ds->in_settled)[v] = 1;
+                        IGRAPH_CHECK(igraph_vector_int_push_back(&ds->settled, v));
+                    }
+                }
+            }
+            ds->pending -= n;
+            igraph_vector_int_clear(bucket);
+
+            n = igraph_vector_int_size(&ds->frontier);
+            for (i = 0; i < n; i++) {
+                VECTOR(ds->in_frontier)[ VECTOR(ds->frontier)[i] ] = 0;
+            }
+            IGRAPH_CHECK(igraph_i_ds_step(ds, &ds->frontier, /* light= */ 1));
+        }
+
+        IGRAPH_CHECK(igraph_i_ds_step(ds, &ds->settled, /* light= */ 0));
+        for (i = 0; i < igraph_vector_int_size(&ds->settled); i++) {
+            VECTOR(ds->in_settled)[ VECTOR(ds->settled)[i] ] = 0;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \function igraph_shortest_paths_delta_stepping
+ * \brief Weighted shortest paths from some sources, on several threads.
+ *
+ * This function computes the same distances as \ref
+ * igraph_shortest_paths_dijkstra(), with the delta-stepping algorithm
+ * of Meyer and Sanders. Instead of taking the vertices one by one in
+ * the order of their distance, it takes all vertices whose distance
+ * is in the same range of width \p delta at once, and relaxes their
+ * edges on several threads, see \ref igraph_set_num_threads(). On a
+ * single thread it is a bucket-based version of Dijkstra's algorithm.
+ *
+ * </para><para>
+ * The sources are processed one after the other, each of them uses
+ * all threads, so this is the function to use for a few sources in a
+ * large graph. For many sources in a smaller graph, it is usually
+ * faster to give the sources to different threads.
+ *
+ * </para><para>
+ * Reference: Ulrich Meyer and Peter Sanders: Delta-stepping: a
+ * parallelizable shortest path algorithm. Journal of Algorithms 49
+ * (2003), 114-152.
+ *
+ * \param graph The input graph, can be directed.
+ * \param res The result, a matrix. A pointer to an initialized matrix
+ *    should be passed here. The matrix will be resized as needed.
+ *    Each row contains the distances from a single source, to the
+ *    vertices given in the \c to argument. Unreachable vertices have
+ *    distance \c IGRAPH_INFINITY.
+ * \param from The source vertices.
+ * \param to The target vertices. It is not allowed to include a
+ *    vertex twice or more.
+ * \param weights The edge weights, they must be non-negative. Edges
+ *    with infinite weight are ignored. If this is a null pointer,
+ *    then the unweighted version, \ref igraph_shortest_paths() is
+ *    called.
+ * \param mode For directed graphs; whether to follow paths along edge
+ *    directions (\c IGRAPH_OUT), or the opposite (\c IGRAPH_IN), or
+ *    ignore edge directions completely (\c IGRAPH_ALL). It is ignored
+ *    for undirected graphs.
+ * \param delta The width of the distance ranges. Smaller values do
+ *    less work but have fewer vertices to process in parallel; with
+ *    a very small value this is Dijkstra's algorithm, with a value
+ *    above the largest distance it is the Bellman-Ford algorithm.
+ *    Zero or a negative value selects the largest weight divided by
+ *    the average degree. Values that would need more than
+ *    max(|V|, 1024) ranges for the largest weight are increased.
+ * \return Error code.
+ *
+ * Time complexity: O(s*(|V|+|E|+L/delta)) for s sources, where L is
+ * the largest distance, if the weights are random; in the worst case
+ * a vertex may be processed many times.
+ *
+ * \sa \ref igraph_get_shortest_paths_delta_stepping() to get the
+ * paths themselves.
+ *
+ * \example examples/simple/igraph_shortest_paths_delta_stepping.c
+ */
+
+int igraph_shortest_paths_delta_stepping(const igraph_t *graph,
+        igraph_matrix_t *res,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_real_t delta) {
+    igraph_i_ds_t ds;
+    igraph_vit_t fromvit, tovit;
+    long int i, j, no_of_from, no_of_to;
+
+    if (!weights) {
+        return igraph_shortest_paths(graph, res, from, to, mode);
+    }
+
+    IGRAPH_CHECK(igraph_i_ds_init(&ds, graph, weights, mode, delta));
+    IGRAPH_FINALLY(igraph_i_ds_destroy, &ds);
+
+    IGRAPH_CHECK(igraph_vit_create(graph, from, &fromvit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
+    no_of_from = IGRAPH_VIT_SIZE(fromvit);
+    IGRAPH_CHECK(igraph_vit_create(graph, to, &tovit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &tovit);
+    no_of_to = IGRAPH_VIT_SIZE(tovit);
+
+    /* Duplicate targets are not allowed, as in the other functions;
+       'in_frontier' is not in use yet, so it marks the targets */
+    for (IGRAPH_VIT_RESET(tovit); !IGRAPH_VIT_END(tovit); IGRAPH_VIT_NEXT(tovit)) {
+        long int v = IGRAPH_VIT_GET(tovit);
+        if (VECTOR(ds.in_frontier)[v]) {
+            IGRAPH_ERROR("Duplicate vertices in `to', this is not allowed",
+                         IGRAPH_EINVAL);
+        }
+        VECTOR(ds.in_frontier)[v] = 1;
+    }
+    igraph_vector_char_null(&ds.in_frontier);
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
+
+    for (IGRAPH_VIT_RESET(fromvit), i = 0; !IGRAPH_VIT_END(fromvit);
+         IGRAPH_VIT_NEXT(fromvit), i++) {
+        IGRAPH_CHECK(igraph_i_ds_run(&ds, IGRAPH_VIT_GET(fromvit)));
+        for (IGRAPH_VIT_RESET(tovit), j = 0; !IGRAPH_VIT_END(tovit);
+             IGRAPH_VIT_NEXT(tovit), j++) {
+            igraph_real_t d = VECTOR(ds.dist)[ (long int) IGRAPH_VIT_GET(tovit) ];
+            MATRIX(*res, i, j) = d < 0 ? IGRAPH_INFINITY : d;
+        }
+    }
+
+    igraph_vit_destroy(&tovit);
+    igraph_vit_destroy(&fromvit);
+    igraph_i_ds_destroy(&ds);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_paths_delta_stepping
+ * \brief Weighted shortest paths from a vertex, on several threads.
+ *
+ * This function finds the same kind of paths as \ref
+ * igraph_get_shortest_paths_dijkstra() and takes the same arguments,
+ * but it computes the distances with the delta-stepping algorithm,
+ * on several threads, see \ref igraph_shortest_paths_delta_stepping().
+ * The shortest path tree is then formed from the edges whose weight
+ * is the difference of the distances of their endpoints. If there
+ * are several shortest paths, the one returned may be different from
+ * the one \ref igraph_get_shortest_paths_dijkstra() returns.
+ *
+ * \param graph The graph object.
+ * \param vertices The result, the ids of the vertices along the
+ *        paths, a pointer vector of initialized vectors, or a null
+ *        pointer.
+ * \param edges The result, the ids of the edges along the paths, a
+ *        pointer vector of initialized vectors, or a null pointer.
+ * \param from The id of the source vertex.
+ * \param to Vertex sequence with the ids of the target vertices. A
+ *        vertex might be given multiple times.
+ * \param weights The edge weights, they must be non-negative. Edges
+ *        with infinite weight are ignored. If this is a null pointer,
+ *        \ref igraph_get_shortest_paths() is called.
+ * \param mode The type of shortest paths to be use for the
+ *        calculation in directed graphs, \c IGRAPH_OUT, \c IGRAPH_IN
+ *        or \c IGRAPH_ALL.
+ * \param delta The width of the distance ranges, see \ref
+ *        igraph_shortest_paths_delta_stepping(). Zero or a negative
+ *        value chooses it automatically.
+ * \param predecessors A pointer to an initialized igraph vector or
+ *        null. If not null, the predecessor of each vertex in the
+ *        shortest path tree is stored here, the source itself for the
+ *        source and -1 for the vertices that cannot be reached.
+ * \param inbound_edges A pointer to an initialized igraph vector or
+ *        null. If not null, the edge via which each vertex is reached
+ *        in the tree is stored here, -1 for the source and the
+ *        vertices that cannot be reached.
+ * \return Error code.
+ *
+ * Time complexity: that of \ref igraph_shortest_paths_delta_stepping()
+ * for one source, plus O(|V|+|E|) for the tree.
+ */
+
+int igraph_get_shortest_paths_delta_stepping(const igraph_t *graph,
+        igraph_vector_ptr_t *vertices,
+        igraph_vector_ptr_t *edges,
+        igraph_integer_t from,
+        igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        igraph_real_t delta,
+        igraph_vector_long_t *predecessors,
+        igraph_vector_long_t *inbound_edges) {
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_i_ds_t ds;
+    igraph_vit_t vit;
+    igraph_vector_int_t *queue;
+    long int *parents;
+    long int head;
+
+    if (!weights) {
+        return igraph_get_shortest_paths(graph, vertices, edges, from, to, mode,
+                                         predecessors, inbound_edges);
+    }
+    if (from < 0 || from >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid source vertex", IGRAPH_EINVVID);
+    }
+
+    IGRAPH_CHECK(igraph_i_ds_init(&ds, graph, weights, mode, delta));
+    IGRAPH_FINALLY(igraph_i_ds_destroy, &ds);
+
+    IGRAPH_CHECK(igraph_vit_create(graph, to, &vit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    if (vertices && IGRAPH_VIT_SIZE(vit) != igraph_vector_ptr_size(vertices)) {
+        IGRAPH_ERROR("Size of `vertices' and `to' should match", IGRAPH_EINVAL);
+    }
+    if (edges && IGRAPH_VIT_SIZE(vit) != igraph_vector_ptr_size(edges)) {
+        IGRAPH_ERROR("Size of `edges' and `to' should match", IGRAPH_EINVAL);
+    }
+
+    parents = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, long int);
+    if (!parents) {
+        IGRAPH_ERROR("Can't calculate shortest paths", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, parents);
+
+    IGRAPH_CHECK(igraph_i_ds_run(&ds, from));
+
+    /* The tree is found by a search on the edges that are on shortest
+       paths. The distance of every vertex was set from a neighbor
+       with its final distance, so all reached vertices are found, and
+       the search gives a tree even if there are zero weights. */
+    queue = &ds.frontier;
+    igraph_vector_int_clear(queue);
+    IGRAPH_CHECK(igraph_vector_int_push_back(queue, from));
+    VECTOR(ds.in_frontier)[(long int) from] = 1;
+    for (head = 0; head < igraph_vector_int_size(queue); head++) {
+        long int u = VECTOR(*queue)[head];
+        igraph_real_t du = VECTOR(ds.dist)[u];
+        int pass;
+        for (pass = 0; pass < 2; pass++) {
+            igraph_integer_t k, begin, end;
+            if (pass == 0 && (ds.mode & IGRAPH_OUT)) {
+                begin = VECTOR(graph->os)[u]; end = VECTOR(graph->os)[u + 1];
+            } else if (pass == 1 && (ds.mode & IGRAPH_IN)) {
+                begin = VECTOR(graph->is)[u]; end = VECTOR(graph->is)[u + 1];
+            } else {
+                continue;
+            }
+            for (k = begin; k < end; k++) {
+                long int e = pass == 0 ? VECTOR(graph->oi)[k] : VECTOR(graph->ii)[k];
+                long int v = pass == 0 ? VECTOR(graph->to)[e] : VECTOR(graph->from)[e];
+                if (!VECTOR(ds.in_frontier)[v] &&
+                    du + VECTOR(*weights)[e] == VECTOR(ds.dist)[v]) {
+                    VECTOR(ds.in_frontier)[v] = 1;
+                    parents[v] = e + 1;
+                    IGRAPH_CHECK(igraph_vector_int_push_back(queue, v));
+                }
+            }
+        }
+    }
+
+    for (IGRAPH_VIT_RESET(vit); !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit)) {
+        if (!VECTOR(ds.in_frontier)[ (long int) IGRAPH_VIT_GET(vit) ]) {
+            IGRAPH_WARNING("Couldn't reach some vertices");
+            break;
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_shortest_path_tree_result(graph, vertices, edges, from,
+                 &vit, parents, predecessors,
+                 inbound_edges));
+
+    igraph_Free(parents);
+    igraph_vit_destroy(&vit);
+    igraph_i_ds_destroy(&ds);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
@@ -23,100 +23,74 @@
 */
 
 #include "igraph_datatype.h"
-#include "igraph_dqueue.h"
 #include "igraph_iterators.h"
 #include "igraph_interrupt_internal.h"
 #include "igraph_vector.h"
 #include "igraph_interface.h"
-#include "igraph_adjlist.h"
+#include "igraph_bfs_internal.h"
+#include "igraph_memory.h"
+#include "igraph_random.h"
+#include "igraph_threading.h"
+#include "igraph_components.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+#include "structural_properties_internal.h"
+
+#include <math.h>
+#include <string.h>
 
 int igraph_i_eccentricity(const igraph_t *graph,
                           igraph_vector_t *res,
                           igraph_vs_t vids,
-                          igraph_neimode_t mode,
-                          const igraph_adjlist_t *adjlist) {
+                          igraph_neimode_t mode) {
 
-    int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_long_t q;
+    igraph_integer_t sources[IGRAPH_I_MSBFS_WIDTH];
+    igraph_i_msbfs_t msbfs;
     igraph_vit_t vit;
-    igraph_vector_int_t counted;
-    int i, mark = 1;
-    igraph_vector_t vneis;
-    igraph_vector_int_t *neis;
+    long int i, k, batch, no_of_vids;
 
-    IGRAPH_CHECK(igraph_dqueue_long_init(&q, 100));
-    IGRAPH_FINALLY(igraph_dqueue_long_destroy, &q);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, graph, mode));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
+    no_of_vids = IGRAPH_VIT_SIZE(vit);
 
-    IGRAPH_CHECK(igraph_vector_int_init(&counted, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_int_destroy, &counted);
-
-    if (!adjlist) {
-        IGRAPH_VECTOR_INIT_FINALLY(&vneis, 0);
-    }
-
-    IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
-    igraph_vector_fill(res, -1);
+    IGRAPH_CHECK(igraph_vector_resize(res, no_of_vids));
+    igraph_vector_null(res);
 
-    for (i = 0, IGRAPH_VIT_RESET(vit);
-         !IGRAPH_VIT_END(vit);
-         IGRAPH_VIT_NEXT(vit), mark++, i++) {
+    /* The vertices are searched from in batches, the eccentricity is
+       the last level in which the search of a vertex reached anything */
+    for (i = 0, IGRAPH_VIT_RESET(vit); i < no_of_vids; i += batch) {
+        igraph_bool_t found;
+        uint64_t mask;
 
-        long int source;
-        source = IGRAPH_VIT_GET(vit);
-        IGRAPH_CHECK(igraph_dqueue_long_push(&q, source));
-        IGRAPH_CHECK(igraph_dqueue_long_push(&q, 0));
-        VECTOR(counted)[source] = mark;
+        batch = no_of_vids - i < IGRAPH_I_MSBFS_WIDTH ?
+                no_of_vids - i : IGRAPH_I_MSBFS_WIDTH;
+        for (k = 0; k < batch; k++, IGRAPH_VIT_NEXT(vit)) {
+            sources[k] = IGRAPH_VIT_GET(vit);
+        }
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_long_empty(&q)) {
-            long int act = igraph_dqueue_long_pop(&q);
-            long int dist = igraph_dqueue_long_pop(&q);
-            int j, n;
-
-            if (dist > VECTOR(*res)[i]) {
-                VECTOR(*res)[i] = dist;
+        IGRAPH_CHECK(igraph_i_msbfs_start(&msbfs, sources, (int) batch));
+        while (1) {
+            IGRAPH_CHECK(igraph_i_msbfs_next_level(&msbfs, &found));
+            if (!found) {
+                break;
             }
-
-            if (adjlist) {
-                neis = igraph_adjlist_get(adjlist, act);
-                n = (int) igraph_vector_int_size(neis);
-                for (j = 0; j < n; j++) {
-                    int nei = (int) VECTOR(*neis)[j];
-                    if (VECTOR(counted)[nei] != mark) {
-                        VECTOR(counted)[nei] = mark;
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist + 1));
-                    }
-                }
-            } else {
-                IGRAPH_CHECK(igraph_neighbors(graph, &vneis,
-                                              (igraph_integer_t) act, mode));
-                n = (int) igraph_vector_size(&vneis);
-                for (j = 0; j < n; j++) {
-                    int nei = (int) VECTOR(vneis)[j];
-                    if (VECTOR(counted)[nei] != mark) {
-                        VECTOR(counted)[nei] = mark;
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_long_push(&q, dist + 1));
-                    }
+            igraph_i_msbfs_level_stats(&msbfs, 0, &mask, 0);
+            for (k = 0; mask; k++, mask >>= 1) {
+                if (mask & 1) {
+                    VECTOR(*res)[i + k] = msbfs.level;
                 }
             }
-        } /* while !igraph_dqueue_long_empty(dqueue) */
-
-    } /* for IGRAPH_VIT_NEXT(vit) */
-
-    if (!adjlist) {
-        igraph_vector_destroy(&vneis);
-        IGRAPH_FINALLY_CLEAN(1);
+        }
     }
-    igraph_vector_int_destroy(&counted);
+
     igraph_vit_destroy(&vit);
-    igraph_dqueue_long_destroy(&q);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_i_msbfs_destroy(&msbfs);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -158,7 +132,356 @@ int igraph_eccentricity(const igraph_t *graph,
                         igraph_vs_t vids,
                         igraph_neimode_t mode) {
 
-    return igraph_i_eccentricity(graph, res, vids, mode, /*adjlist=*/ 0);
+    return igraph_i_eccentricity(graph, res, vids, mode);
+}
+
+/* One search of the bounding algorithm, the distances from (or to)
+   'source' are stored in 'dist', IGRAPH_INFINITY for the unreached
+   vertices, and the largest finite distance in 'ecc'. Unweighted
+   graphs use the breadth-first search of 'bfs', weighted graphs
+   Dijkstra's algorithm on the edge index. */
+
+static int igraph_i_bounding_search(const igraph_t *graph,
+                                    const igraph_vector_t *weights,
+                                    igraph_i_bfs_t *bfs,
+                                    igraph_i_spqueue_t *heap,
+                                    igraph_neimode_t mode,
+                                    igraph_integer_t source,
+                                    igraph_vector_t *dist,
+                                    igraph_real_t *ecc) {
+
+    igraph_vector_fill(dist, IGRAPH_INFINITY);
+    *ecc = 0;
+
+    if (!weights) {
+        igraph_bool_t found = 1;
+        long int j;
+        IGRAPH_CHECK(igraph_i_bfs_start(bfs, source));
+        while (found) {
+            for (j = bfs->level_begin; j < bfs->level_end; j++) {
+                VECTOR(*dist)[ VECTOR(bfs->order)[j] ] = bfs->level;
+            }
+            *ecc = bfs->level;
+            IGRAPH_CHECK(igraph_i_bfs_next_level(bfs, &found));
+        }
+        return 0;
+    }
+
+    igraph_i_spqueue_clear(heap);
+    IGRAPH_CHECK(igraph_i_spqueue_push(heap, source, 0.0));
+    while (!igraph_i_spqueue_empty(heap)) {
+        long int v, k, e, u;
+        igraph_real_t d = igraph_i_spqueue_deactivate_min(heap, &v);
+        int pass;
+
+        VECTOR(*dist)[v] = d;
+        *ecc = d;
+        for (pass = 0; pass < 2; pass++) {
+            igraph_integer_t begin, end;
+            if (pass == 0 && (mode & IGRAPH_OUT)) {
+                begin = VECTOR(graph->os)[v]; end = VECTOR(graph->os)[v + 1];
+            } else if (pass == 1 && (mode & IGRAPH_IN)) {
+                begin = VECTOR(graph->is)[v]; end = VECTOR(graph->is)[v + 1];
+            } else {
+                continue;
+            }
+            for (k = begin; k < end; k++) {
+                igraph_real_t alt;
+                if (pass == 0) {
+                    e = VECTOR(graph->oi)[k]; u = VECTOR(graph->to)[e];
+                } else {
+                    e = VECTOR(graph->ii)[k]; u = VECTOR(graph->from)[e];
+                }
+                alt = d + VECTOR(*weights)[e];
+                if (!igraph_i_spqueue_has_elem(heap, u)) {
+                    IGRAPH_CHECK(igraph_i_spqueue_push(heap, u, alt));
+                } else if (igraph_i_spqueue_has_active(heap, u) &&
+                           alt < igraph_i_spqueue_get(heap, u)) {
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(heap, u, alt));
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Exact diameter and radius with the bounding algorithm of Frank W.
+ * Takes and Walter A. Kosters: Computing the Eccentricity Distribution
+ * of Large Graphs, Algorithms 6 (2013). Every vertex has a lower and
+ * an upper bound for its eccentricity. After the searches from and to
+ * a vertex w, with forward distances f and backward distances b, the
+ * triangle inequality gives for every vertex v
+ *
+ *     max(b(v), ecc(w) - f(v)) <= ecc(v) <= b(v) + ecc(w).
+ *
+ * A vertex is dropped when its bounds show that it cannot change the
+ * diameter or the radius any more. The next vertex is alternately the
+ * one with the largest upper bound and the one with the smallest lower
+ * bound, ties are broken by degree. In undirected graphs f = b, and a
+ * single search is needed per vertex.
+ *
+ * The bounds only hold if every vertex reaches every vertex that w
+ * reaches, so directed graphs that are not strongly connected fall
+ * back to a search from every vertex. Undirected graphs need no such
+ * care, the searches never reach the other components. */
+
+int igraph_i_diameter_radius(const igraph_t *graph,
+                             const igraph_vector_t *weights,
+                             igraph_real_t *diameter,
+                             igraph_real_t *radius,
+                             igraph_neimode_t mode,
+                             igraph_bool_t unconn,
+                             igraph_integer_t *searches) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_bool_t directed = igraph_is_directed(graph) && mode != IGRAPH_ALL;
+    igraph_neimode_t backward = mode == IGRAPH_OUT ? IGRAPH_IN : IGRAPH_OUT;
+    igraph_bool_t want_diameter = diameter != 0, want_radius = radius != 0;
+    igraph_bool_t connected, all_sources, pick_upper = 1;
+    igraph_real_t dia_lower = 0, rad_upper = IGRAPH_INFINITY;
+    igraph_vector_t lower, upper, fdist, bdist, degree;
+    igraph_vector_int_t cand;
+    igraph_i_bfs_t bfs_forward, bfs_backward;
+    igraph_i_spqueue_t heap;
+    igraph_integer_t no_of_searches = 0;
+    long int i, v;
+
+    if (!directed) {
+        mode = IGRAPH_ALL;
+    }
+
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Invalid weight vector length", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0) {
+            igraph_real_t min = igraph_vector_min(weights);
+            if (min < 0) {
+                IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+            } else if (igraph_is_nan(min)) {
+                IGRAPH_ERROR("Weight vector must not contain NaN values", IGRAPH_EINVAL);
+            }
+        }
+    }
+
+    if (no_of_nodes == 0) {
+        if (diameter) {
+            *diameter = IGRAPH_NAN;
+        }
+        if (radius) {
+            *radius = IGRAPH_NAN;
+        }
+        if (searches) {
+            *searches = 0;
+        }
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_is_connected(graph, &connected,
+                                     directed ? IGRAPH_STRONG : IGRAPH_WEAK));
+    if (!connected && !unconn && diameter) {
+        *diameter = IGRAPH_INFINITY;
+        want_diameter = 0;
+    }
+    all_sources = directed && !connected;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&lower, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&upper, no_of_nodes);
+    igraph_vector_fill(&upper, IGRAPH_INFINITY);
+    IGRAPH_VECTOR_INIT_FINALLY(&fdist, no_of_nodes);
+    IGRAPH_VECTOR_INIT_FINALLY(&bdist, directed ? no_of_nodes : 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&degree, no_of_nodes);
+    IGRAPH_CHECK(igraph_degree(graph, &degree, igraph_vss_all(), mode, IGRAPH_LOOPS));
+    IGRAPH_CHECK(igraph_vector_int_init_seq(&cand, 0, no_of_nodes - 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &cand);
+
+    if (weights) {
+        IGRAPH_CHECK(igraph_i_spqueue_init(&heap, no_of_nodes, weights));
+        IGRAPH_FINALLY(igraph_i_spqueue_destroy, &heap);
+    } else {
+        IGRAPH_CHECK(igraph_i_bfs_init(&bfs_forward, graph, mode));
+        IGRAPH_FINALLY(igraph_i_bfs_destroy, &bfs_forward);
+        if (directed) {
+            IGRAPH_CHECK(igraph_i_bfs_init(&bfs_backward, graph, backward));
+            IGRAPH_FINALLY(igraph_i_bfs_destroy, &bfs_backward);
+        }
+    }
+
+    while ((want_diameter || want_radius) && igraph_vector_int_size(&cand) > 0) {
+        long int n = igraph_vector_int_size(&cand), best = 0;
+        igraph_vector_t *back = directed ? &bdist : &fdist;
+        igraph_real_t ecc, ecc2;
+        igraph_integer_t w;
+
+        IGRAPH_ALLOW_INTERRUPTION();
+
+        if (!all_sources) {
+            for (i = 1; i < n; i++) {
+                long int a = VECTOR(cand)[i], b = VECTOR(cand)[best];
+                igraph_real_t x = pick_upper ? VECTOR(upper)[a] : -VECTOR(lower)[a];
+                igraph_real_t y = pick_upper ? VECTOR(upper)[b] : -VECTOR(lower)[b];
+                if (x > y || (x == y && VECTOR(degree)[a] > VECTOR(degree)[b])) {
+                    best = i;
+                }
+            }
+            pick_upper = !pick_upper;
+        }
+        w = VECTOR(cand)[best];
+
+        IGRAPH_CHECK(igraph_i_bounding_search(graph, weights, &bfs_forward, &heap,
+                                              mode, w, &fdist, &ecc));
+        no_of_searches++;
+        if (directed && !all_sources) {
+            IGRAPH_CHECK(igraph_i_bounding_search(graph, weights, &bfs_backward,
+                                                  &heap, backward, w, &bdist,
+                                                  &ecc2));
+            no_of_searches++;
+        }
+
+        if (all_sources) {
+            VECTOR(lower)[w] = VECTOR(upper)[w] = ecc;
+        } else {
+            for (v = 0; v < no_of_nodes; v++) {
+                igraph_real_t f = VECTOR(fdist)[v], b = VECTOR(*back)[v];
+                if (b < IGRAPH_INFINITY) {
+                    if (b > VECTOR(lower)[v]) {
+                        VECTOR(lower)[v] = b;
+                    }
+                    if (b + ecc < VECTOR(upper)[v]) {
+                        VECTOR(upper)[v] = b + ecc;
+                    }
+                }
+                if (f < IGRAPH_INFINITY && ecc - f > VECTOR(lower)[v]) {
+                    VECTOR(lower)[v] = ecc - f;
+                }
+            }
+            /* Exact, even if rounding spoils the bounds of weighted graphs */
+            VECTOR(lower)[w] = VECTOR(upper)[w] = ecc;
+        }
+
+        for (v = 0; v < no_of_nodes; v++) {
+            if (VECTOR(lower)[v] > dia_lower) {
+                dia_lower = VECTOR(lower)[v];
+            }
+            if (VECTOR(upper)[v] < rad_upper) {
+                rad_upper = VECTOR(upper)[v];
+            }
+        }
+
+        /* Drop the vertices that cannot change the results */
+        for (i = 0; i < igraph_vector_int_size(&cand); ) {
+            v = VECTOR(cand)[i];
+            if (v == w ||
+                ((!want_diameter || VECTOR(upper)[v] <= dia_lower) &&
+                 (!want_radius || VECTOR(lower)[v] >= rad_upper))) {
+                VECTOR(cand)[i] = igraph_vector_int_tail(&cand);
+                igraph_vector_int_pop_back(&cand);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    if (want_diameter) {
+        *diameter = dia_lower;
+    }
+    if (want_radius) {
+        *radius = rad_upper;
+    }
+    if (searches) {
+        *searches = no_of_searches;
+    }
+
+    if (weights) {
+        igraph_i_spqueue_destroy(&heap);
+        IGRAPH_FINALLY_CLEAN(1);
+    } else {
+        if (directed) {
+            igraph_i_bfs_destroy(&bfs_backward);
+            IGRAPH_FINALLY_CLEAN(1);
+        }
+        igraph_i_bfs_destroy(&bfs_forward);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+    igraph_vector_int_destroy(&cand);
+    igraph_vector_destroy(&degree);
+    igraph_vector_destroy(&bdist);
+    igraph_vector_destroy(&fdist);
+    igraph_vector_destroy(&upper);
+    igraph_vector_destroy(&lower);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
+/**
+ * \function igraph_diameter_radius
+ * Exact diameter and radius with eccentricity bounds
+ *
+ * The diameter of a graph is the largest eccentricity of its vertices,
+ * the radius is the smallest one, see \ref igraph_eccentricity().
+ * Instead of a search from every vertex, this function keeps a lower
+ * and an upper bound for the eccentricity of each vertex, and tightens
+ * them with the triangle inequality after every search. Vertices whose
+ * bounds show that they cannot change the results are skipped. On
+ * most real networks only a handful of searches are needed, although
+ * in the worst case, e.g. in a ring, every vertex is searched. See
+ * Frank W. Takes and Walter A. Kosters: Computing the Eccentricity
+ * Distribution of Large Graphs, Algorithms 6 (2013).
+ *
+ * </para><para>
+ * In directed graphs every vertex needs a search along and one against
+ * the edge directions. The bounds only hold in strongly connected
+ * directed graphs; for other directed graphs this function searches
+ * from every vertex.
+ *
+ * </para><para>
+ * As in \ref igraph_eccentricity(), vertex pairs in different
+ * components are ignored for the radius, so isolated vertices make it
+ * zero.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param weights Pointer to a vector of non-negative edge weights, or
+ *    a null pointer for unweighted graphs.
+ * \param diameter Pointer to a real number or a null pointer. If not
+ *    null, the diameter is stored here. If the graph is not
+ *    (strongly) connected and \p unconn is false, it is \c
+ *    IGRAPH_INFINITY.
+ * \param radius Pointer to a real number or a null pointer. If not
+ *    null, the radius is stored here.
+ * \param directed Whether to consider directed paths in directed
+ *    graphs. It is ignored for undirected graphs.
+ * \param unconn What to do if the graph is not connected. If true,
+ *    the diameter is the largest one within the components.
+ * \param searches Pointer to an integer or a null pointer. If not
+ *    null, the number of breadth-first searches (or runs of
+ *    Dijkstra's algorithm, for weighted graphs) is stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(s (|V|+|E|)) for unweighted and O(s |E| log|V|)
+ * for weighted graphs, where s is the number of searches, at most
+ * |V| in undirected and 2|V| in directed graphs.
+ *
+ * \sa \ref igraph_diameter(), \ref igraph_diameter_dijkstra() and
+ * \ref igraph_radius(), which use this function when they are only
+ * asked for the length.
+ *
+ * \example examples/simple/igraph_diameter_radius.c
+ */
+
+int igraph_diameter_radius(const igraph_t *graph,
+                           const igraph_vector_t *weights,
+                           igraph_real_t *diameter,
+                           igraph_real_t *radius,
+                           igraph_bool_t directed,
+                           igraph_bool_t unconn,
+                           igraph_integer_t *searches) {
+
+    return igraph_i_diameter_radius(graph, weights, diameter, radius,
+                                    directed ? IGRAPH_OUT : IGRAPH_ALL,
+                                    unconn, searches);
 }
 
 /**
@@ -178,8 +501,12 @@ int igraph_eccentricity(const igraph_t *graph,
  *    is ignored for undirected graphs.
  * \return Error code.
  *
+ * </para><para>
+ * The eccentricities are bounded as in \ref igraph_diameter_radius(),
+ * so usually only a few vertices need a search.
+ *
  * Time complexity: O(|V|(|V|+|E|)), where |V| is the number of
- * vertices and |E| is the number of edges.
+ * vertices and |E| is the number of edges, in the worst case.
  *
  * \sa \ref igraph_eccentricity().
  *
@@ -189,23 +516,327 @@ int igraph_eccentricity(const igraph_t *graph,
 int igraph_radius(const igraph_t *graph, igraph_real_t *radius,
                   igraph_neimode_t mode) {
 
-    int no_of_nodes = igraph_vcount(graph);
+    return igraph_i_diameter_radius(graph, /* weights= */ 0, /* diameter= */ 0,
+                                    radius, mode, /* unconn= */ 1,
+                                    /* searches= */ 0);
+}
 
-    if (no_of_nodes == 0) {
-        *radius = IGRAPH_NAN;
-    } else {
-        igraph_adjlist_t adjlist;
-        igraph_vector_t ecc;
-        IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-        IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-        IGRAPH_VECTOR_INIT_FINALLY(&ecc, igraph_vcount(graph));
-        IGRAPH_CHECK(igraph_i_eccentricity(graph, &ecc, igraph_vss_all(),
-                                           mode, &adjlist));
-        *radius = igraph_vector_min(&ecc);
-        igraph_vector_destroy(&ecc);
-        igraph_adjlist_destroy(&adjlist);
-        IGRAPH_FINALLY_CLEAN(2);
+/* HyperLogLog counters of the approximate neighborhood function.
+ * Every vertex has 2^log2m byte registers, 'cur' holds the counters of
+ * the balls of radius t and 'next' receives the balls of radius t+1.
+ * A vertex is only recomputed if one of its neighbors changed in the
+ * previous iteration, the others already contain the union. Vertices
+ * are split into chunks of IGRAPH_I_ANF_GRAIN, and every chunk only
+ * writes the counters and flags of its own vertices. */
+
+#define IGRAPH_I_ANF_GRAIN 256
+
+typedef struct igraph_i_anf_t {
+    const igraph_t *graph;
+    igraph_neimode_t mode;
+    igraph_integer_t m;
+    igraph_real_t alpha;
+    unsigned char *cur, *next;
+    unsigned char *modified, *next_modified;
+    igraph_real_t *estimate;
+} igraph_i_anf_t;
+
+static igraph_real_t igraph_i_anf_estimate(const igraph_i_anf_t *anf,
+        const unsigned char *reg) {
+    igraph_integer_t j, zeros = 0;
+    igraph_real_t sum = 0.0, e, m = anf->m;
+
+    for (j = 0; j < anf->m; j++) {
+        sum += ldexp(1.0, -reg[j]);
+        if (reg[j] == 0) {
+            zeros++;
+        }
+    }
+    e = anf->alpha * m * m / sum;
+    /* Linear counting for small cardinalities */
+    if (e <= 2.5 * m && zeros > 0) {
+        e = m * log(m / zeros);
+    }
+    return e;
+}
+
+/* The mixing function of SplitMix64 */
+
+static uint64_t igraph_i_anf_hash(uint64_t x) {
+    x += UINT64_C(0x9e3779b97f4a7c15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xbf58476d1ce4e5b9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94d049bb133111eb);
+    return x ^ (x >> 31);
+}
+
+static int igraph_i_anf_union(const igraph_i_anf_t *anf, unsigned char *dst,
+                              igraph_integer_t u) {
+    const unsigned char *src = anf->cur + u * anf->m;
+    igraph_integer_t j;
+    int changed = 0;
+
+    if (!anf->modified[u]) {
+        return 0;
+    }
+    for (j = 0; j < anf->m; j++) {
+        if (src[j] > dst[j]) {
+            dst[j] = src[j];
+            changed = 1;
+        }
     }
+    return changed;
+}
+
+static int igraph_i_anf_chunk(igraph_integer_t from, igraph_integer_t to,
+                              int thread, igraph_real_t *result, void *arg) {
+    igraph_i_anf_t *anf = arg;
+    const igraph_t *graph = anf->graph;
+    igraph_integer_t v, k, m = anf->m, changed = 0;
+
+    IGRAPH_UNUSED(thread);
+
+    for (v = from; v < to; v++) {
+        unsigned char *dst = anf->next + v * m;
+        int upd = 0;
+        /* 'next' is one iteration behind unless v changed last time */
+        if (anf->modified[v]) {
+            memcpy(dst, anf->cur + v * m, (size_t) m);
+        }
+        if (anf->mode & IGRAPH_OUT) {
+            for (k = VECTOR(graph->os)[v]; k < VECTOR(graph->os)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->to)[ VECTOR(graph->oi)[k] ];
+                upd |= igraph_i_anf_union(anf, dst, u);
+            }
+        }
+        if (anf->mode & IGRAPH_IN) {
+            for (k = VECTOR(graph->is)[v]; k < VECTOR(graph->is)[v + 1]; k++) {
+                igraph_integer_t u = VECTOR(graph->from)[ VECTOR(graph->ii)[k] ];
+                upd |= igraph_i_anf_union(anf, dst, u);
+            }
+        }
+        anf->next_modified[v] = (unsigned char) upd;
+        if (upd) {
+            anf->estimate[v] = igraph_i_anf_estimate(anf, dst);
+            changed++;
+        }
+    }
+
+    *result = changed;
+    return 0;
+}
+
+/**
+ * \function igraph_neighborhood_function_approx
+ * Approximate neighborhood function and path length statistics
+ *
+ * The neighborhood function N(t) of a graph is the number of ordered
+ * vertex pairs (x, y) for which y is reachable from x in at most t
+ * steps, N(0) being the number of vertices. From it follow the
+ * distribution of the shortest path lengths, the average path length
+ * and the effective diameter, the (interpolated) path length within
+ * which 90% of the connected vertex pairs are.
+ *
+ * </para><para>
+ * This function estimates all of these from a single run of the
+ * HyperANF algorithm, see Paolo Boldi, Marco Rosa and Sebastiano
+ * Vigna: HyperANF: Approximating the Neighbourhood Function of Very
+ * Large Graphs on a Budget, WWW 2011. Every vertex has a HyperLogLog
+ * counter of 2^\p log2m one byte registers that estimates the size of
+ * its ball of radius t. In every iteration the counters are replaced
+ * by their union with the counters of the neighbors, until no counter
+ * changes. The relative standard error of a single counter is about
+ * 1.04/sqrt(2^\p log2m), the error of N(t) is usually smaller. The
+ * memory use is O(|V| 2^\p log2m), instead of the O(|V|^2) time of
+ * the exact \ref igraph_path_length_hist().
+ *
+ * </para><para>
+ * The vertices are hashed with a random salt taken from igraph's
+ * random number generator. The iterations are divided between the
+ * threads of \ref igraph_set_num_threads(), the result does not
+ * depend on the number of threads.
+ *
+ * \param graph The input graph.
+ * \param nf Pointer to an initialized vector or a null pointer. If
+ *    not null, the estimated N(t) is stored here, for t from zero to
+ *    the number of iterations, i.e. the estimated diameter.
+ * \param hist Pointer to an initialized vector or a null pointer. If
+ *    not null, the estimated number of paths of length one, two, etc.
+ *    is stored here, as in \ref igraph_path_length_hist(). In
+ *    undirected graphs, and if \p directed is false, each vertex
+ *    pair is counted once.
+ * \param average_path_length Pointer to a real number or a null
+ *    pointer. If not null, the estimated average path length of the
+ *    connected vertex pairs is stored here, or NaN if there are none.
+ * \param effective_diameter Pointer to a real number or a null
+ *    pointer. If not null, the estimated effective diameter is
+ *    stored here, or NaN if there are no connected vertex pairs.
+ * \param directed Whether to consider directed paths in directed
+ *    graphs. It is ignored for undirected graphs.
+ * \param log2m The base two logarithm of the number of registers
+ *    per vertex, between 4 and 16.
+ * \return Error code.
+ *
+ * Time complexity: O(d (|V|+|E|) 2^log2m), where d is the diameter
+ * of the graph, |V| the number of vertices and |E| the number of
+ * edges.
+ *
+ * \sa \ref igraph_path_length_hist() and \ref
+ * igraph_average_path_length() for the exact values.
+ *
+ * \example examples/simple/igraph_neighborhood_function_approx.c
+ */
+
+int igraph_neighborhood_function_approx(const igraph_t *graph,
+                                        igraph_vector_t *nf,
+                                        igraph_vector_t *hist,
+                                        igraph_real_t *average_path_length,
+                                        igraph_real_t *effective_diameter,
+                                        igraph_bool_t directed,
+                                        igraph_integer_t log2m) {
+
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t v, t, m;
+    igraph_vector_t n_t;
+    igraph_i_anf_t anf;
+    igraph_real_t changed, total, sum;
+    uint64_t salt;
+    unsigned char *tmp;
+    size_t size;
+
+    if (log2m < 4 || log2m > 16) {
+        IGRAPH_ERROR("The number of registers must be between 2^4 and 2^16",
+                     IGRAPH_EINVAL);
+    }
+    m = 1 << log2m;
+    if ((size_t) no_of_nodes > ((size_t) -1) / 2 / (size_t) m) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    size = (size_t) no_of_nodes * (size_t) m;
+
+    anf.graph = graph;
+    anf.mode = directed && igraph_is_directed(graph) ? IGRAPH_OUT : IGRAPH_ALL;
+    anf.m = m;
+    switch (m) {
+    case 16: anf.alpha = 0.673; break;
+    case 32: anf.alpha = 0.697; break;
+    case 64: anf.alpha = 0.709; break;
+    default: anf.alpha = 0.7213 / (1 + 1.079 / m); break;
+    }
+
+    anf.cur = igraph_Calloc(size > 0 ? size : 1, unsigned char);
+    if (!anf.cur) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, anf.cur);
+    anf.next = igraph_Calloc(size > 0 ? size : 1, unsigned char);
+    if (!anf.next) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, anf.next);
+    anf.modified = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, unsigned char);
+    if (!anf.modified) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, anf.modified);
+    anf.next_modified = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, unsigned char);
+    if (!anf.next_modified) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, anf.next_modified);
+    anf.estimate = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, igraph_real_t);
+    if (!anf.estimate) {
+        IGRAPH_ERROR("Cannot approximate neighborhood function", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, anf.estimate);
+    IGRAPH_VECTOR_INIT_FINALLY(&n_t, 0);
+
+    /* Every counter starts with its own vertex */
+    RNG_BEGIN();
+    salt = (uint64_t) RNG_INTEGER(0, 0x7fffffff) << 32;
+    salt |= (uint64_t) RNG_INTEGER(0, 0x7fffffff);
+    RNG_END();
+    sum = 0.0;
+    for (v = 0; v < no_of_nodes; v++) {
+        uint64_t h = igraph_i_anf_hash(salt ^ (uint64_t) v);
+        uint64_t w = h << log2m;
+        int rank = 1;
+        while (rank <= 64 - log2m && !(w >> 63)) {
+            w <<= 1;
+            rank++;
+        }
+        anf.cur[v * m + (igraph_integer_t) (h >> (64 - log2m))] = (unsigned char) rank;
+        memcpy(anf.next + v * m, anf.cur + v * m, (size_t) m);
+        anf.modified[v] = 1;
+        anf.estimate[v] = igraph_i_anf_estimate(&anf, anf.cur + v * m);
+        sum += anf.estimate[v];
+    }
+    IGRAPH_CHECK(igraph_vector_push_back(&n_t, sum));
+
+    while (no_of_nodes > 0) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_parallel_reduce(no_of_nodes, IGRAPH_I_ANF_GRAIN,
+                                            igraph_i_anf_chunk, &anf,
+                                            &changed));
+        if (changed == 0) {
+            break;
+        }
+        tmp = anf.cur; anf.cur = anf.next; anf.next = tmp;
+        tmp = anf.modified; anf.modified = anf.next_modified; anf.next_modified = tmp;
+        sum = 0.0;
+        for (v = 0; v < no_of_nodes; v++) {
+            sum += anf.estimate[v];
+        }
+        IGRAPH_CHECK(igraph_vector_push_back(&n_t, sum));
+    }
+
+    if (hist) {
+        igraph_real_t div = anf.mode == IGRAPH_OUT ? 1 : 2;
+        IGRAPH_CHECK(igraph_vector_resize(hist, igraph_vector_size(&n_t) - 1));
+        for (t = 1; t < igraph_vector_size(&n_t); t++) {
+            igraph_real_t d = VECTOR(n_t)[t] - VECTOR(n_t)[t - 1];
+            VECTOR(*hist)[t - 1] = d > 0 ? d / div : 0;
+        }
+    }
+
+    total = VECTOR(n_t)[igraph_vector_size(&n_t) - 1] - VECTOR(n_t)[0];
+    if (average_path_length) {
+        if (total > 0) {
+            sum = 0.0;
+            for (t = 1; t < igraph_vector_size(&n_t); t++) {
+                sum += t * (VECTOR(n_t)[t] - VECTOR(n_t)[t - 1]);
+            }
+            *average_path_length = sum / total;
+        } else {
+            *average_path_length = IGRAPH_NAN;
+        }
+    }
+    if (effective_diameter) {
+        if (total > 0) {
+            igraph_real_t target = 0.9 * total, prev = 0.0, cur = 0.0;
+            for (t = 1; t < igraph_vector_size(&n_t); t++) {
+                cur = VECTOR(n_t)[t] - VECTOR(n_t)[0];
+                if (cur >= target) {
+                    break;
+                }
+                prev = cur;
+            }
+            *effective_diameter = t - 1 + (target - prev) / (cur - prev);
+        } else {
+            *effective_diameter = IGRAPH_NAN;
+        }
+    }
+
+    if (nf) {
+        IGRAPH_CHECK(igraph_vector_update(nf, &n_t));
+    }
+
+    igraph_vector_destroy(&n_t);
+    igraph_free(anf.estimate);
+    igraph_free(anf.next_modified);
+    igraph_free(anf.modified);
+    igraph_free(anf.next);
+    igraph_free(anf.cur);
+    IGRAPH_FINALLY_CLEAN(6);
 
     return 0;
 }
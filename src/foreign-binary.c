@@ -0,0 +1,595 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_foreign.h"
+#include "config.h"
+#include "igraph_attributes.h"
+#include "igraph_interface.h"
+#include "igraph_memory.h"
+#include "igraph_types_internal.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(HAVE_SYS_MMAN_H) && defined(HAVE_MMAP)
+    #define IGRAPH_I_BINARY_MMAP 1
+    #include <sys/types.h>
+    #include <sys/stat.h>
+    #include <sys/mman.h>
+#endif
+
+/* The binary format is the in-memory representation of the graph:
+ *
+ *   header (igraph_i_binary_header_t, 64 bytes)
+ *   from, to, oi, ii     |E| integers each
+ *   os, is               |V|+1 integers each
+ *   padding to 8 bytes
+ *   numeric attributes, graph, vertex and edge attributes, in this
+ *   order. Every attribute is an int64_t giving the length of the
+ *   name, the zero padded name itself (its length is a multiple of 8)
+ *   and then 1, |V| or |E| doubles.
+ *
+ * Integers have the size of igraph_integer_t, and all numbers are
+ * stored in the byte order of the machine that wrote the file. */
+
+#define IGRAPH_I_BINARY_MAGIC "IGRAPHBG"
+#define IGRAPH_I_BINARY_VERSION 1
+#define IGRAPH_I_BINARY_BYTEORDER 0x01020304
+
+typedef struct igraph_i_binary_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteorder;
+    uint32_t intsize;
+    uint32_t directed;
+    int64_t no_of_nodes;
+    int64_t no_of_edges;
+    int64_t no_of_attrs[3];
+} igraph_i_binary_header_t;
+
+typedef struct igraph_i_binary_mapping_t {
+    void *addr;
+    size_t length;
+    igraph_bool_t mapped;
+} igraph_i_binary_mapping_t;
+
+void igraph_i_binary_release(void *mapping) {
+    igraph_i_binary_mapping_t *m = (igraph_i_binary_mapping_t *) mapping;
+#ifdef IGRAPH_I_BINARY_MMAP
+    if (m->mapped) {
+        munmap(m->addr, m->length);
+    } else {
+        igraph_Free(m->addr);
+    }
+#else
+    igraph_Free(m->addr);
+#endif
+    igraph_Free(m);
+}
+
+static size_t igraph_i_binary_padding(size_t bytes) {
+    return (8 - bytes % 8) % 8;
+}
+
+static int igraph_i_binary_write(FILE *outstream, const void *data,
+                                 size_t size, size_t n) {
+    static const char zeros[8] = { 0 };
+    if (n > 0 && fwrite(data ? data : zeros, size, n, outstream) != n) {
+        IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+    return 0;
+}
+
+static int igraph_i_binary_write_attrs(const igraph_t *graph, FILE *outstream,
+                                       igraph_attribute_elemtype_t elemtype,
+                                       const igraph_strvector_t *names,
+                                       const igraph_vector_t *types) {
+    igraph_vector_t values;
+    long int i, n = igraph_strvector_size(names);
+
+    IGRAPH_VECTOR_INIT_FINALLY(&values, 0);
+    for (i = 0; i < n; i++) {
+        char *name;
+        int64_t namelen;
+        size_t len;
+        if (VECTOR(*types)[i] != IGRAPH_ATTRIBUTE_NUMERIC) {
+            continue;
+        }
+        igraph_strvector_get(names, i, &name);
+        switch (elemtype) {
+        case IGRAPH_ATTRIBUTE_GRAPH:
+            IGRAPH_CHECK(igraph_i_attribute_get_numeric_graph_attr(graph, name,
+                         &values));
+            break;
+        case IGRAPH_ATTRIBUTE_VERTEX:
+            IGRAPH_CHECK(igraph_i_attribute_get_numeric_vertex_attr(graph, name,
+                         igraph_vss_all(), &values));
+            break;
+        default:
+            IGRAPH_CHECK(igraph_i_attribute_get_numeric_edge_attr(graph, name,
+                         igraph_ess_all(IGRAPH_EDGEORDER_ID), &values));
+            break;
+        }
+        len = strlen(name);
+        namelen = (int64_t) (len + 1 + igraph_i_binary_padding(len + 1));
+        IGRAPH_CHECK(igraph_i_binary_write(outstream, &namelen, sizeof(int64_t), 1));
+        IGRAPH_CHECK(igraph_i_binary_write(outstream, name, 1, len));
+        IGRAPH_CHECK(igraph_i_binary_write(outstream, 0, 1, (size_t) namelen - len));
+        IGRAPH_CHECK(igraph_i_binary_write(outstream, VECTOR(values),
+                                           sizeof(igraph_real_t),
+                                           (size_t) igraph_vector_size(&values)));
+    }
+    igraph_vector_destroy(&values);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static long int igraph_i_binary_count_numeric(const igraph_vector_t *types) {
+    long int i, n = igraph_vector_size(types), res = 0;
+    for (i = 0; i < n; i++) {
+        if (VECTOR(*types)[i] == IGRAPH_ATTRIBUTE_NUMERIC) {
+            res++;
+        }
+    }
+    return res;
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_write_graph_binary
+ * \brief Writes a graph to a file in igraph's native binary format.
+ *
+ * </para><para>
+ * The file contains the edge list and the already built indices of
+ * the graph, exactly as they are stored in memory, so
+ * \ref igraph_read_graph_binary() can use them without any parsing
+ * or sorting. Numeric graph, vertex and edge attributes are saved as
+ * well, attributes of other types are ignored.
+ *
+ * </para><para>
+ * The format is not portable: integers and real numbers are written
+ * in the byte order of the machine, and integers have the size of
+ * \type igraph_integer_t, see \ref IGRAPH_INTEGER_SIZE. The file can
+ * only be read by an igraph library built with the same integer
+ * size, on a machine with the same byte order.
+ *
+ * \param graph The graph to write.
+ * \param outstream The stream to write to, it should be writable and
+ *        opened in binary mode.
+ * \return Error code:
+ *         \c IGRAPH_EFILE if there is an error writing the file.
+ *
+ * Time complexity: O(|V|+|E|) for a graph with |V| vertices and |E|
+ * edges, plus the time needed to query the attributes.
+ *
+ * \example examples/simple/igraph_read_graph_binary.c
+ */
+
+int igraph_write_graph_binary(const igraph_t *graph, FILE *outstream) {
+    igraph_i_binary_header_t header;
+    igraph_strvector_t gnames, vnames, enames;
+    igraph_vector_t gtypes, vtypes, etypes;
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    size_t bytes;
+
+    IGRAPH_CHECK(igraph_strvector_init(&gnames, 0));
+    IGRAPH_FINALLY(igraph_strvector_destroy, &gnames);
+    IGRAPH_CHECK(igraph_strvector_init(&vnames, 0));
+    IGRAPH_FINALLY(igraph_strvector_destroy, &vnames);
+    IGRAPH_CHECK(igraph_strvector_init(&enames, 0));
+    IGRAPH_FINALLY(igraph_strvector_destroy, &enames);
+    IGRAPH_VECTOR_INIT_FINALLY(&gtypes, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&vtypes, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&etypes, 0);
+    IGRAPH_CHECK(igraph_i_attribute_get_info(graph, &gnames, &gtypes,
+                 &vnames, &vtypes, &enames, &etypes));
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_BINARY_MAGIC, sizeof(header.magic));
+    header.version = IGRAPH_I_BINARY_VERSION;
+    header.byteorder = IGRAPH_I_BINARY_BYTEORDER;
+    header.intsize = sizeof(igraph_integer_t);
+    header.directed = igraph_is_directed(graph) ? 1 : 0;
+    header.no_of_nodes = no_of_nodes;
+    header.no_of_edges = no_of_edges;
+    header.no_of_attrs[0] = igraph_i_binary_count_numeric(&gtypes);
+    header.no_of_attrs[1] = igraph_i_binary_count_numeric(&vtypes);
+    header.no_of_attrs[2] = igraph_i_binary_count_numeric(&etypes);
+
+    IGRAPH_CHECK(igraph_i_binary_write(outstream, &header, sizeof(header), 1));
+
+#define WRITE(v, n) \
+    IGRAPH_CHECK(igraph_i_binary_write(outstream, VECTOR(graph->v), \
+                                       sizeof(igraph_integer_t), (size_t) (n)))
+    WRITE(from, no_of_edges);
+    WRITE(to, no_of_edges);
+    WRITE(oi, no_of_edges);
+    WRITE(ii, no_of_edges);
+    WRITE(os, no_of_nodes + 1);
+    WRITE(is, no_of_nodes + 1);
+#undef WRITE
+
+    bytes = sizeof(igraph_integer_t) * (size_t) (4 * no_of_edges + 2 * no_of_nodes + 2);
+    IGRAPH_CHECK(igraph_i_binary_write(outstream, 0, 1,
+                                       igraph_i_binary_padding(bytes)));
+
+    IGRAPH_CHECK(igraph_i_binary_write_attrs(graph, outstream,
+                 IGRAPH_ATTRIBUTE_GRAPH, &gnames, &gtypes));
+    IGRAPH_CHECK(igraph_i_binary_write_attrs(graph, outstream,
+                 IGRAPH_ATTRIBUTE_VERTEX, &vnames, &vtypes));
+    IGRAPH_CHECK(igraph_i_binary_write_attrs(graph, outstream,
+                 IGRAPH_ATTRIBUTE_EDGE, &enames, &etypes));
+
+    igraph_vector_destroy(&etypes);
+    igraph_vector_destroy(&vtypes);
+    igraph_vector_destroy(&gtypes);
+    igraph_strvector_destroy(&enames);
+    igraph_strvector_destroy(&vnames);
+    igraph_strvector_destroy(&gnames);
+    IGRAPH_FINALLY_CLEAN(6);
+
+    return 0;
+}
+
+/* Makes the rest of the stream, starting at its current position,
+   available in memory. The file is mapped if possible, otherwise it
+   is read into a buffer. */
+
+static int igraph_i_binary_map(FILE *instream, igraph_i_binary_mapping_t *m,
+                               const char **data, size_t *size) {
+    long int pos = ftell(instream);
+    long int end;
+
+    if (pos < 0) {
+        IGRAPH_ERROR("Binary graph files must be seekable", IGRAPH_EFILE);
+    }
+
+#ifdef IGRAPH_I_BINARY_MMAP
+    /* The mapping must start at a page boundary, so we map the whole
+       file. The data is only used in place if it is suitably aligned. */
+    if (pos % 8 == 0) {
+        struct stat st;
+        int fd = fileno(instream);
+        if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+            st.st_size > pos) {
+            void *addr = mmap(0, (size_t) st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr != MAP_FAILED) {
+                m->addr = addr;
+                m->length = (size_t) st.st_size;
+                m->mapped = 1;
+                *data = (const char *) addr + pos;
+                *size = (size_t) (st.st_size - pos);
+                return 0;
+            }
+        }
+    }
+#endif
+
+    if (fseek(instream, 0, SEEK_END) != 0 || (end = ftell(instream)) < pos ||
+        fseek(instream, pos, SEEK_SET) != 0) {
+        IGRAPH_ERROR("Binary graph files must be seekable", IGRAPH_EFILE);
+    }
+    m->length = (size_t) (end - pos);
+    m->addr = igraph_Calloc(m->length > 0 ? m->length : 1, char);
+    if (!m->addr) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_ENOMEM);
+    }
+    m->mapped = 0;
+    if (fread(m->addr, 1, m->length, instream) != m->length) {
+        igraph_Free(m->addr);
+        IGRAPH_ERROR("Read error", IGRAPH_EFILE);
+    }
+    *data = (const char *) m->addr;
+    *size = m->length;
+
+    return 0;
+}
+
+typedef struct igraph_i_binary_cursor_t {
+    const char *data;
+    size_t pos, size;
+} igraph_i_binary_cursor_t;
+
+/* Returns the next 'n' elements of size 'size', or a null pointer if
+   the file is too short */
+
+static const void *igraph_i_binary_take(igraph_i_binary_cursor_t *c,
+                                        size_t size, int64_t n) {
+    const char *res = c->data + c->pos;
+    if (n < 0 || (uint64_t) n > (c->size - c->pos) / size) {
+        return 0;
+    }
+    c->pos += size * (size_t) n;
+    return res;
+}
+
+static int igraph_i_binary_read_attrs(igraph_i_binary_cursor_t *c,
+                                      int64_t no_of_attrs, int64_t length,
+                                      igraph_attribute_record_t *records,
+                                      igraph_vector_t *values,
+                                      igraph_vector_ptr_t *ptrs) {
+    int64_t i;
+
+    IGRAPH_CHECK(igraph_vector_ptr_resize(ptrs, (long int) no_of_attrs));
+    for (i = 0; i < no_of_attrs; i++) {
+        const int64_t *namelen = igraph_i_binary_take(c, sizeof(int64_t), 1);
+        const char *name = namelen ? igraph_i_binary_take(c, 1, *namelen) : 0;
+        const igraph_real_t *v = name ? igraph_i_binary_take(c, sizeof(igraph_real_t),
+                                 length) : 0;
+        if (!v || *namelen % 8 != 0 || *namelen == 0 || name[*namelen - 1] != 0) {
+            IGRAPH_ERROR("Invalid attribute in binary graph file", IGRAPH_PARSEERROR);
+        }
+        igraph_vector_view(&values[i], v, (long int) length);
+        records[i].name = name;
+        records[i].type = IGRAPH_ATTRIBUTE_NUMERIC;
+        records[i].value = &values[i];
+        VECTOR(*ptrs)[i] = &records[i];
+    }
+
+    return 0;
+}
+
+static int igraph_i_binary_add_attrs(igraph_t *graph, igraph_i_binary_cursor_t *c,
+                                     const igraph_i_binary_header_t *header) {
+    igraph_attribute_record_t *records;
+    igraph_vector_t *values, edges;
+    igraph_vector_ptr_t attrs[3];
+    int64_t lengths[3];
+    int64_t no_of_attrs = header->no_of_attrs[0] + header->no_of_attrs[1] +
+                          header->no_of_attrs[2];
+    long int i, no_of_edges = (long int) header->no_of_edges;
+    int k;
+
+    lengths[0] = 1;
+    lengths[1] = header->no_of_nodes;
+    lengths[2] = header->no_of_edges;
+
+    records = igraph_Calloc(no_of_attrs > 0 ? no_of_attrs : 1,
+                            igraph_attribute_record_t);
+    if (!records) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, records);
+    values = igraph_Calloc(no_of_attrs > 0 ? no_of_attrs : 1, igraph_vector_t);
+    if (!values) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, values);
+
+    for (k = 0, no_of_attrs = 0; k < 3; k++) {
+        IGRAPH_CHECK(igraph_vector_ptr_init(&attrs[k], 0));
+        IGRAPH_FINALLY(igraph_vector_ptr_destroy, &attrs[k]);
+        IGRAPH_CHECK(igraph_i_binary_read_attrs(c, header->no_of_attrs[k], lengths[k],
+                                                records + no_of_attrs,
+                                                values + no_of_attrs, &attrs[k]));
+        no_of_attrs += header->no_of_attrs[k];
+    }
+
+    /* The attribute handler copies the values */
+    IGRAPH_CHECK(igraph_i_attribute_init(graph, &attrs[0]));
+    if (graph->attr) {
+        IGRAPH_CHECK(igraph_i_attribute_add_vertices(graph, graph->n, &attrs[1]));
+        IGRAPH_VECTOR_INIT_FINALLY(&edges, 2 * no_of_edges);
+        for (i = 0; i < no_of_edges; i++) {
+            VECTOR(edges)[2 * i] = VECTOR(graph->from)[i];
+            VECTOR(edges)[2 * i + 1] = VECTOR(graph->to)[i];
+        }
+        IGRAPH_CHECK(igraph_i_attribute_add_edges(graph, &edges, &attrs[2]));
+        igraph_vector_destroy(&edges);
+        IGRAPH_FINALLY_CLEAN(1);
+    }
+
+    igraph_vector_ptr_destroy(&attrs[2]);
+    igraph_vector_ptr_destroy(&attrs[1]);
+    igraph_vector_ptr_destroy(&attrs[0]);
+    igraph_Free(values);
+    igraph_Free(records);
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return 0;
+}
+
+/* Checks that the edge list and the indices read from a file form a
+   valid graph, so that a corrupt or crafted file cannot make the
+   algorithms index out of bounds: every endpoint is a vertex, oi and
+   ii are permutations of the edge ids, and the index of each vertex
+   lists exactly the edges that start (os, oi) or end (is, ii)
+   there. */
+
+static int igraph_i_binary_check_graph(const igraph_integer_t **arrays,
+                                       int64_t n, int64_t m) {
+    const igraph_integer_t *from = arrays[0], *to = arrays[1];
+    const igraph_integer_t *oi = arrays[2], *ii = arrays[3];
+    const igraph_integer_t *os = arrays[4], *is = arrays[5];
+    char *seen;
+    int64_t v, k;
+
+    if (os[0] != 0 || os[n] != m || is[0] != 0 || is[n] != m) {
+        IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+    }
+    for (k = 0; k < m; k++) {
+        if (from[k] < 0 || from[k] >= n || to[k] < 0 || to[k] >= n ||
+            oi[k] < 0 || oi[k] >= m || ii[k] < 0 || ii[k] >= m) {
+            IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+        }
+    }
+
+    /* m ids in [0,m) without repetition are a permutation; bit 1 marks
+       the ids seen in oi, bit 2 the ones seen in ii */
+    seen = igraph_Calloc(m > 0 ? m : 1, char);
+    if (!seen) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_ENOMEM);
+    }
+    for (k = 0; k < m; k++) {
+        if ((seen[oi[k]] & 1) || (seen[ii[k]] & 2)) {
+            igraph_Free(seen);
+            IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+        }
+        seen[oi[k]] |= 1;
+        seen[ii[k]] |= 2;
+    }
+    igraph_Free(seen);
+
+    for (v = 0; v < n; v++) {
+        if (os[v] > os[v + 1] || is[v] > is[v + 1]) {
+            IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+        }
+        for (k = os[v]; k < os[v + 1]; k++) {
+            if (from[oi[k]] != v) {
+                IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+            }
+        }
+        for (k = is[v]; k < is[v + 1]; k++) {
+            if (to[ii[k]] != v) {
+                IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * \ingroup loadsave
+ * \function igraph_read_graph_binary
+ * \brief Reads a graph written by \ref igraph_write_graph_binary().
+ *
+ * </para><para>
+ * The file is mapped into memory, and the edge list and indices of
+ * the new graph are used directly from the mapping: nothing is parsed
+ * or sorted, they are only checked for consistency in linear time,
+ * using one byte of temporary memory per edge, so that a corrupt file
+ * is rejected instead of crashing later
+ * computations. Several processes reading the same file share a
+ * single copy of it in the page cache. On systems without \c mmap(), or if the
+ * graph does not start at an offset divisible by eight, the file is
+ * read into memory instead.
+ *
+ * </para><para>
+ * The resulting graph is read-only: \ref igraph_add_edges(),
+ * \ref igraph_add_vertices() and \ref igraph_delete_edges() fail with
+ * \c IGRAPH_EINVAL on it. Use \ref igraph_copy() to create a
+ * modifiable copy. \ref igraph_destroy() unmaps the file. The stream
+ * itself can be closed right after this function returns.
+ *
+ * </para><para>
+ * Numeric attributes stored in the file are copied to the attribute
+ * handler, if one is installed.
+ *
+ * \param graph Pointer to an uninitialized graph object.
+ * \param instream The stream to read from. It must be a seekable
+ *        stream, opened in binary mode, positioned at the beginning
+ *        of the graph. After the call it is positioned after the
+ *        graph.
+ * \return Error code:
+ *         \c IGRAPH_PARSEERROR if the file is not a binary graph
+ *         file, it is corrupt, or it was written by an igraph library
+ *         with a different integer size or byte order;
+ *         \c IGRAPH_EFILE if the stream is not seekable or cannot be
+ *         read.
+ *
+ * Time complexity: O(|V|+|E|), the time of checking the graph and of
+ * copying the attributes to the attribute handler.
+ *
+ * \example examples/simple/igraph_read_graph_binary.c
+ */
+
+int igraph_read_graph_binary(igraph_t *graph, FILE *instream) {
+    igraph_i_binary_mapping_t *mapping;
+    igraph_i_binary_header_t header;
+    igraph_i_binary_cursor_t c;
+    const igraph_integer_t *arrays[6];
+    long int start = ftell(instream);
+    int64_t n, m;
+    size_t bytes;
+
+    mapping = igraph_Calloc(1, igraph_i_binary_mapping_t);
+    if (!mapping) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, mapping);
+    IGRAPH_CHECK(igraph_i_binary_map(instream, mapping, &c.data, &c.size));
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_i_binary_release, mapping);
+    c.pos = 0;
+
+    if (c.size < sizeof(header)) {
+        IGRAPH_ERROR("Not a binary graph file", IGRAPH_PARSEERROR);
+    }
+    memcpy(&header, igraph_i_binary_take(&c, sizeof(header), 1), sizeof(header));
+    if (memcmp(header.magic, IGRAPH_I_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != IGRAPH_I_BINARY_VERSION) {
+        IGRAPH_ERROR("Not a binary graph file", IGRAPH_PARSEERROR);
+    }
+    if (header.byteorder != IGRAPH_I_BINARY_BYTEORDER ||
+        header.intsize != sizeof(igraph_integer_t)) {
+        IGRAPH_ERROR("Binary graph file was written with a different byte order "
+                     "or integer size", IGRAPH_PARSEERROR);
+    }
+    n = header.no_of_nodes;
+    m = header.no_of_edges;
+    if (n < 0 || m < 0 || n >= IGRAPH_INTEGER_MAX || m > IGRAPH_INTEGER_MAX ||
+        header.no_of_attrs[0] < 0 || header.no_of_attrs[1] < 0 ||
+        header.no_of_attrs[2] < 0) {
+        IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+    }
+
+    arrays[0] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), m);
+    arrays[1] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), m);
+    arrays[2] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), m);
+    arrays[3] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), m);
+    arrays[4] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), n + 1);
+    arrays[5] = igraph_i_binary_take(&c, sizeof(igraph_integer_t), n + 1);
+    bytes = igraph_i_binary_padding(c.pos);
+    /* A failed take leaves the cursor in place, so the later arrays
+       may be there even if an earlier one is not */
+    if (!arrays[0] || !arrays[1] || !arrays[2] || !arrays[3] ||
+        !arrays[4] || !arrays[5] ||
+        !igraph_i_binary_take(&c, 1, (int64_t) bytes)) {
+        IGRAPH_ERROR("Invalid binary graph file", IGRAPH_PARSEERROR);
+    }
+    IGRAPH_CHECK(igraph_i_binary_check_graph(arrays, n, m));
+
+    graph->n = (igraph_integer_t) n;
+    graph->directed = header.directed ? 1 : 0;
+    igraph_vector_int_view(&graph->from, arrays[0], (long int) m);
+    igraph_vector_int_view(&graph->to, arrays[1], (long int) m);
+    igraph_vector_int_view(&graph->oi, arrays[2], (long int) m);
+    igraph_vector_int_view(&graph->ii, arrays[3], (long int) m);
+    igraph_vector_int_view(&graph->os, arrays[4], (long int) n + 1);
+    igraph_vector_int_view(&graph->is, arrays[5], (long int) n + 1);
+    graph->attr = 0;
+    graph->mapping = mapping;
+    IGRAPH_FINALLY_CLEAN(1);
+    IGRAPH_FINALLY(igraph_destroy, graph);
+
+    IGRAPH_CHECK(igraph_i_binary_add_attrs(graph, &c, &header));
+
+    if (fseek(instream, start + (long int) c.pos, SEEK_SET) != 0) {
+        IGRAPH_ERROR("Cannot read binary graph", IGRAPH_EFILE);
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
@@ -32,12 +32,14 @@
 #include "igraph_nongraph.h"
 #include "igraph_conversion.h"
 #include "igraph_psumtree.h"
+#include "igraph_random_internal.h"
 #include "igraph_dqueue.h"
 #include "igraph_adjlist.h"
 #include "igraph_iterators.h"
 #include "igraph_progress.h"
 #include "igraph_topology.h"
 #include "igraph_types_internal.h"
+#include "igraph_threading.h"
 #include "config.h"
 
 #include <math.h>
@@ -97,6 +99,7 @@ int igraph_i_barabasi_game_bag(igraph_t *graph, igraph_integer_t n,
     igraph_vector_t edges = IGRAPH_VECTOR_NULL;
     long int resp;
     long int i, j, k;
+    igraph_i_rng_buffer_t rng;
     long int bagsize, start_nodes, start_edges, new_edges, no_of_edges;
 
     if (!directed) {
@@ -155,6 +158,7 @@ int igraph_i_barabasi_game_bag(igraph_t *graph, igraph_integer_t n,
     }
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&rng, igraph_rng_default());
 
     /* and the others */
 
@@ -165,7 +169,7 @@ int igraph_i_barabasi_game_bag(igraph_t *graph, igraph_integer_t n,
             no_of_neighbors = (long int) VECTOR(*outseq)[k];
         }
         for (j = 0; j < no_of_neighbors; j++) {
-            long int to = bag[RNG_INTEGER(0, bagp - 1)];
+            long int to = bag[IGRAPH_I_RNG_INTEGER(&rng, 0, bagp - 1)];
             VECTOR(edges)[resp++] = i;
             VECTOR(edges)[resp++] = to;
         }
@@ -207,6 +211,7 @@ int igraph_i_barabasi_game_psumtree_multiple(igraph_t *graph,
     igraph_psumtree_t sumtree;
     long int edgeptr = 0;
     igraph_vector_t degree;
+    igraph_i_rng_buffer_t rng;
     long int start_nodes, start_edges, new_edges, no_of_edges;
 
     if (!directed) {
@@ -253,6 +258,7 @@ int igraph_i_barabasi_game_psumtree_multiple(igraph_t *graph,
     }
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&rng, igraph_rng_default());
 
     /* and the rest */
     for (i = (start_from ? start_nodes : 1), k = (start_from ? 0 : 1);
@@ -263,7 +269,7 @@ int igraph_i_barabasi_game_psumtree_multiple(igraph_t *graph,
             no_of_neighbors = (long int) VECTOR(*outseq)[k];
         }
         for (j = 0; j < no_of_neighbors; j++) {
-            igraph_psumtree_search(&sumtree, &to, RNG_UNIF(0, sum));
+            igraph_psumtree_search(&sumtree, &to, IGRAPH_I_RNG_UNIF(&rng, 0, sum));
             VECTOR(degree)[to]++;
             VECTOR(edges)[edgeptr++] = i;
             VECTOR(edges)[edgeptr++] = to;
@@ -313,6 +319,7 @@ int igraph_i_barabasi_game_psumtree(igraph_t *graph,
     igraph_psumtree_t sumtree;
     long int edgeptr = 0;
     igraph_vector_t degree;
+    igraph_i_rng_buffer_t rng;
     long int start_nodes, start_edges, new_edges, no_of_edges;
 
     if (!directed) {
@@ -340,6 +347,7 @@ int igraph_i_barabasi_game_psumtree(igraph_t *graph,
     IGRAPH_VECTOR_INIT_FINALLY(&degree, no_of_nodes);
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&rng, igraph_rng_default());
 
     /* first node(s) */
     if (start_from) {
@@ -380,7 +388,7 @@ int igraph_i_barabasi_game_psumtree(igraph_t *graph,
         } else {
             for (j = 0; j < no_of_neighbors; j++) {
                 sum = igraph_psumtree_sum(&sumtree);
-                igraph_psumtree_search(&sumtree, &to, RNG_UNIF(0, sum));
+                igraph_psumtree_search(&sumtree, &to, IGRAPH_I_RNG_UNIF(&rng, 0, sum));
                 VECTOR(degree)[to]++;
                 igraph_vector_push_back(&edges, i);
                 igraph_vector_push_back(&edges, to);
@@ -578,6 +586,111 @@ int igraph_barabasi_game(igraph_t *graph, igraph_integer_t n,
     return 0;
 }
 
+/* The parallel G(n,p) generator cuts the candidate edges into blocks
+ * of about IGRAPH_I_GNP_BLOCK expected edges. Each block has its own
+ * random stream, so the graph depends only on the seed drawn from the
+ * default RNG, and not on the number of threads. */
+
+#define IGRAPH_I_GNP_BLOCK 65536.0
+
+typedef struct igraph_i_gnp_parallel_t {
+    igraph_real_t maxedges, p;
+    igraph_integer_t nblocks;
+    unsigned long int seed;
+    igraph_vector_t *blocks;
+    igraph_integer_t ninit;     /* the number of initialized blocks */
+} igraph_i_gnp_parallel_t;
+
+static void igraph_i_gnp_parallel_destroy(igraph_i_gnp_parallel_t *data) {
+    igraph_integer_t i;
+    for (i = 0; i < data->ninit; i++) {
+        igraph_vector_destroy(&data->blocks[i]);
+    }
+    igraph_Free(data->blocks);
+}
+
+static int igraph_i_gnp_parallel_block(igraph_integer_t from,
+                                       igraph_integer_t to,
+                                       int thread, void *arg) {
+    igraph_i_gnp_parallel_t *data = (igraph_i_gnp_parallel_t *) arg;
+    igraph_rng_t rng;
+    igraph_i_rng_buffer_t buffer;
+    igraph_integer_t b;
+
+    IGRAPH_UNUSED(thread);
+
+    IGRAPH_CHECK(igraph_rng_init(&rng, &igraph_rngtype_philox4x32));
+    IGRAPH_FINALLY(igraph_rng_destroy, &rng);
+
+    for (b = from; b < to; b++) {
+        igraph_vector_t *s = &data->blocks[b];
+        igraph_real_t lo = floor(data->maxedges * b / data->nblocks);
+        igraph_real_t hi = b + 1 == data->nblocks ? data->maxedges :
+                           floor(data->maxedges * (b + 1) / data->nblocks);
+        igraph_real_t last;
+
+        IGRAPH_CHECK(igraph_rng_seed_stream(&rng, data->seed, b));
+        IGRAPH_CHECK(igraph_vector_reserve(s, (long int) ((hi - lo) * data->p * 1.1)));
+        igraph_i_rng_buffer_init(&buffer, &rng);
+
+        last = lo + IGRAPH_I_RNG_GEOM(&buffer, data->p);
+        while (last < hi) {
+            IGRAPH_CHECK(igraph_vector_push_back(s, last));
+            last += IGRAPH_I_RNG_GEOM(&buffer, data->p);
+            last += 1;
+        }
+    }
+
+    igraph_rng_destroy(&rng);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* Stores the indices of the selected candidate edges in 's', like the
+   serial loop of igraph_erdos_renyi_game_gnp() */
+
+static int igraph_i_erdos_renyi_game_gnp_parallel(igraph_vector_t *s,
+        igraph_real_t maxedges,
+        igraph_real_t p) {
+    igraph_i_gnp_parallel_t data;
+    igraph_real_t nblocks = ceil(maxedges * p / IGRAPH_I_GNP_BLOCK);
+    igraph_integer_t i;
+
+    data.maxedges = maxedges;
+    data.p = p;
+    data.nblocks = nblocks < 1 ? 1 : (igraph_integer_t) nblocks;
+
+    RNG_BEGIN();
+    data.seed = RNG_INT31();
+    data.seed = (data.seed << 16 << 15) ^ RNG_INT31();
+    RNG_END();
+
+    data.blocks = igraph_Calloc(data.nblocks, igraph_vector_t);
+    if (!data.blocks) {
+        IGRAPH_ERROR("Cannot generate random graph", IGRAPH_ENOMEM);
+    }
+    data.ninit = 0;
+    IGRAPH_FINALLY(igraph_i_gnp_parallel_destroy, &data);
+    for (i = 0; i < data.nblocks; i++) {
+        IGRAPH_CHECK(igraph_vector_init(&data.blocks[i], 0));
+        data.ninit++;
+    }
+
+    IGRAPH_CHECK(igraph_parallel_for(data.nblocks, 1,
+                                     igraph_i_gnp_parallel_block, &data));
+
+    igraph_vector_clear(s);
+    for (i = 0; i < data.nblocks; i++) {
+        IGRAPH_CHECK(igraph_vector_append(s, &data.blocks[i]));
+    }
+
+    igraph_i_gnp_parallel_destroy(&data);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
 /**
  * \ingroup internal
  */
@@ -616,18 +729,26 @@ int igraph_erdos_renyi_game_gnp(igraph_t *graph, igraph_integer_t n, igraph_real
         }
 
         IGRAPH_VECTOR_INIT_FINALLY(&s, 0);
-        IGRAPH_CHECK(igraph_vector_reserve(&s, (long int) (maxedges * p * 1.1)));
 
-        RNG_BEGIN();
+        if (igraph_get_num_threads() > 1) {
+            IGRAPH_CHECK(igraph_i_erdos_renyi_game_gnp_parallel(&s, maxedges, p));
+        } else {
+            igraph_i_rng_buffer_t rng;
 
-        last = RNG_GEOM(p);
-        while (last < maxedges) {
-            IGRAPH_CHECK(igraph_vector_push_back(&s, last));
-            last += RNG_GEOM(p);
-            last += 1;
-        }
+            IGRAPH_CHECK(igraph_vector_reserve(&s, (long int) (maxedges * p * 1.1)));
 
-        RNG_END();
+            RNG_BEGIN();
+            igraph_i_rng_buffer_init(&rng, igraph_rng_default());
+
+            last = IGRAPH_I_RNG_GEOM(&rng, p);
+            while (last < maxedges) {
+                IGRAPH_CHECK(igraph_vector_push_back(&s, last));
+                last += IGRAPH_I_RNG_GEOM(&rng, p);
+                last += 1;
+            }
+
+            RNG_END();
+        }
 
         IGRAPH_VECTOR_INIT_FINALLY(&edges, 0);
         IGRAPH_CHECK(igraph_vector_reserve(&edges, igraph_vector_size(&s) * 2));
@@ -787,6 +908,11 @@ int igraph_erdos_renyi_game_gnm(igraph_t *graph, igraph_integer_t n, igraph_real
  *          every possible edge is included in the graph with
  *          probability p.
  *        \endclist
+ *        G(n,p) graphs are generated on several threads if \ref
+ *        igraph_set_num_threads() was called with more than one.
+ *        The result then does not depend on the number of threads,
+ *        only on the state of the default random number generator,
+ *        but it differs from the single-threaded result.
  * \param n The number of vertices in the graph.
  * \param p_or_m This is the p parameter for
  *        G(n,p) graphs and the
@@ -403,8 +403,8 @@ typedef struct {
 
 int igraph_i_graphlets_filter_cmp(void *data, const void *a, const void *b) {
     igraph_i_graphlets_filter_t *ddata = (igraph_i_graphlets_filter_t *) data;
-    int *aa = (int*) a;
-    int *bb = (int*) b;
+    igraph_integer_t *aa = (igraph_integer_t*) a;
+    igraph_integer_t *bb = (igraph_integer_t*) b;
     igraph_real_t t_a = VECTOR(*ddata->thresholds)[*aa];
     igraph_real_t t_b = VECTOR(*ddata->thresholds)[*bb];
     igraph_vector_t *v_a, *v_b;
@@ -451,7 +451,7 @@ int igraph_i_graphlets_filter(igraph_vector_ptr_t *cliques,
         VECTOR(order)[i] = i;
     }
 
-    igraph_qsort_r(VECTOR(order), nocliques, sizeof(int), &sortdata,
+    igraph_qsort_r(VECTOR(order), nocliques, sizeof(igraph_integer_t), &sortdata,
                    igraph_i_graphlets_filter_cmp);
 
     for (i = 0; i < nocliques - 1; i++) {
@@ -796,8 +796,8 @@ typedef struct igraph_i_graphlets_order_t {
 
 int igraph_i_graphlets_order_cmp(void *data, const void *a, const void *b) {
     igraph_i_graphlets_order_t *ddata = (igraph_i_graphlets_order_t*) data;
-    int *aa = (int*) a;
-    int *bb = (int*) b;
+    igraph_integer_t *aa = (igraph_integer_t*) a;
+    igraph_integer_t *bb = (igraph_integer_t*) b;
     igraph_real_t Mu_a = VECTOR(*ddata->Mu)[*aa];
     igraph_real_t Mu_b = VECTOR(*ddata->Mu)[*bb];
 
@@ -857,7 +857,7 @@ int igraph_graphlets(const igraph_t *graph,
     for (i = 0; i < nocliques; i++) {
         VECTOR(order)[i] = i;
     }
-    igraph_qsort_r(VECTOR(order), nocliques, sizeof(int), &sortdata,
+    igraph_qsort_r(VECTOR(order), nocliques, sizeof(igraph_integer_t), &sortdata,
                    igraph_i_graphlets_order_cmp);
 
     igraph_vector_ptr_index_int(cliques, &order);
@@ -1081,3 +1081,462 @@ int igraph_2wheap_check(igraph_2wheap_t *h) {
 
     return 0;
 }
+
+/* -------------------------------------------------- */
+/* Indexed d-ary heap                                 */
+/* -------------------------------------------------- */
+
+#define IGRAPH_I_DHEAP_PARENT(x)  (((x) - 1) / IGRAPH_DHEAP_ARITY)
+#define IGRAPH_I_DHEAP_CHILD(x)   ((x) * IGRAPH_DHEAP_ARITY + 1)
+
+/* Both sifts move a hole instead of swapping, and write the element
+   only where it stops */
+
+static void igraph_i_dheap_shift_up(igraph_dheap_t *h, long int i,
+                                    igraph_i_dheap_elem_t elem) {
+    igraph_i_dheap_elem_t *data = h->data;
+    while (i > 0) {
+        long int parent = IGRAPH_I_DHEAP_PARENT(i);
+        if (data[parent].key <= elem.key) {
+            break;
+        }
+        data[i] = data[parent];
+        h->pos[ data[i].idx ] = i + 2;
+        i = parent;
+    }
+    data[i] = elem;
+    h->pos[elem.idx] = i + 2;
+}
+
+static void igraph_i_dheap_sink(igraph_dheap_t *h, long int i,
+                                igraph_i_dheap_elem_t elem) {
+    igraph_i_dheap_elem_t *data = h->data;
+    long int size = h->size;
+    while (1) {
+        long int child = IGRAPH_I_DHEAP_CHILD(i), end, min, j;
+        if (child >= size) {
+            break;
+        }
+        end = child + IGRAPH_DHEAP_ARITY < size ? child + IGRAPH_DHEAP_ARITY : size;
+        for (min = child, j = child + 1; j < end; j++) {
+            if (data[j].key < data[min].key) {
+                min = j;
+            }
+        }
+        if (elem.key <= data[min].key) {
+            break;
+        }
+        data[i] = data[min];
+        h->pos[ data[i].idx ] = i + 2;
+        i = min;
+    }
+    data[i] = elem;
+    h->pos[elem.idx] = i + 2;
+}
+
+int igraph_dheap_init(igraph_dheap_t *h, long int size) {
+    h->size = 0;
+    h->capacity = size;
+    h->data = igraph_Calloc(size > 0 ? size : 1, igraph_i_dheap_elem_t);
+    h->pos = igraph_Calloc(size > 0 ? size : 1, long int);
+    if (h->data == 0 || h->pos == 0) {
+        igraph_dheap_destroy(h);
+        IGRAPH_ERROR("Cannot initialize d-ary heap", IGRAPH_ENOMEM);
+    }
+    return 0;
+}
+
+void igraph_dheap_destroy(igraph_dheap_t *h) {
+    if (h->data != 0) {
+        igraph_Free(h->data);
+    }
+    if (h->pos != 0) {
+        igraph_Free(h->pos);
+    }
+}
+
+int igraph_dheap_clear(igraph_dheap_t *h) {
+    h->size = 0;
+    memset(h->pos, 0, sizeof(long int) * (size_t) h->capacity);
+    return 0;
+}
+
+igraph_bool_t igraph_dheap_empty(const igraph_dheap_t *h) {
+    return h->size == 0;
+}
+
+long int igraph_dheap_size(const igraph_dheap_t *h) {
+    return h->size;
+}
+
+int igraph_dheap_push_with_index(igraph_dheap_t *h,
+                                 long int idx, igraph_real_t key) {
+    igraph_i_dheap_elem_t elem;
+    elem.key = key;
+    elem.idx = idx;
+    h->size++;
+    igraph_i_dheap_shift_up(h, h->size - 1, elem);
+    return 0;
+}
+
+igraph_real_t igraph_dheap_min(const igraph_dheap_t *h) {
+    return h->data[0].key;
+}
+
+long int igraph_dheap_min_index(const igraph_dheap_t *h) {
+    return h->data[0].idx;
+}
+
+igraph_bool_t igraph_dheap_has_elem(const igraph_dheap_t *h, long int idx) {
+    return h->pos[idx] != 0;
+}
+
+igraph_bool_t igraph_dheap_has_active(const igraph_dheap_t *h, long int idx) {
+    return h->pos[idx] > 1;
+}
+
+igraph_real_t igraph_dheap_get(const igraph_dheap_t *h, long int idx) {
+    return h->data[ h->pos[idx] - 2 ].key;
+}
+
+/* Removes the minimum, and marks it as removed if 'deactivate' is
+   true, or as never pushed otherwise */
+
+static igraph_real_t igraph_i_dheap_pop(igraph_dheap_t *h, long int *idx,
+                                        igraph_bool_t deactivate) {
+    igraph_i_dheap_elem_t min = h->data[0];
+    h->size--;
+    if (h->size > 0) {
+        igraph_i_dheap_sink(h, 0, h->data[h->size]);
+    }
+    h->pos[min.idx] = deactivate ? 1 : 0;
+    if (idx) {
+        *idx = min.idx;
+    }
+    return min.key;
+}
+
+igraph_real_t igraph_dheap_delete_min(igraph_dheap_t *h, long int *idx) {
+    return igraph_i_dheap_pop(h, idx, /* deactivate= */ 0);
+}
+
+igraph_real_t igraph_dheap_deactivate_min(igraph_dheap_t *h, long int *idx) {
+    return igraph_i_dheap_pop(h, idx, /* deactivate= */ 1);
+}
+
+int igraph_dheap_modify(igraph_dheap_t *h, long int idx, igraph_real_t key) {
+    long int i = h->pos[idx] - 2;
+    igraph_i_dheap_elem_t elem;
+    elem.key = key;
+    elem.idx = idx;
+    if (key < h->data[i].key) {
+        igraph_i_dheap_shift_up(h, i, elem);
+    } else {
+        igraph_i_dheap_sink(h, i, elem);
+    }
+    return 0;
+}
+
+int igraph_dheap_check(const igraph_dheap_t *h) {
+    long int i;
+    for (i = 0; i < h->size; i++) {
+        if ((i > 0 && h->data[IGRAPH_I_DHEAP_PARENT(i)].key > h->data[i].key) ||
+            h->pos[ h->data[i].idx ] != i + 2) {
+            IGRAPH_ERROR("Inconsistent heap", IGRAPH_EINTERNAL);
+        }
+    }
+    return 0;
+}
+
+/* -------------------------------------------------- */
+/* Bucket queue                                       */
+/* -------------------------------------------------- */
+
+static int igraph_i_bucketqueue_lowest_bit(uint64_t x) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(x);
+#else
+    int b = 0;
+    while (!(x & 1)) {
+        x >>= 1; b++;
+    }
+    return b;
+#endif
+}
+
+static long int igraph_i_bucketqueue_bucket(const igraph_bucketqueue_t *q,
+        igraph_real_t key) {
+    return (long int) ((uint64_t) key % (uint64_t) q->no_of_buckets);
+}
+
+static void igraph_i_bucketqueue_insert(igraph_bucketqueue_t *q, long int idx) {
+    igraph_i_bucketqueue_node_t *node = q->nodes + idx;
+    long int b = igraph_i_bucketqueue_bucket(q, node->key);
+    long int first = q->head[b];
+    node->state = 2;
+    node->prev = -1;
+    node->next = first;
+    if (first >= 0) {
+        q->nodes[first].prev = idx;
+    } else {
+        q->used[b >> 6] |= (uint64_t) 1 << (b & 63);
+    }
+    q->head[b] = idx;
+}
+
+static void igraph_i_bucketqueue_remove(igraph_bucketqueue_t *q, long int idx) {
+    igraph_i_bucketqueue_node_t *node = q->nodes + idx;
+    if (node->prev >= 0) {
+        q->nodes[node->prev].next = node->next;
+    } else {
+        long int b = igraph_i_bucketqueue_bucket(q, node->key);
+        q->head[b] = node->next;
+        if (node->next < 0) {
+            q->used[b >> 6] &= ~((uint64_t) 1 << (b & 63));
+        }
+    }
+    if (node->next >= 0) {
+        q->nodes[node->next].prev = node->prev;
+    }
+}
+
+int igraph_bucketqueue_init(igraph_bucketqueue_t *q, long int size,
+                            long int no_of_buckets) {
+    long int i;
+
+    q->size = 0;
+    q->capacity = size;
+    q->no_of_buckets = no_of_buckets;
+    q->cur = 0;
+    q->last = 0;
+    q->nodes = igraph_Calloc(size > 0 ? size : 1, igraph_i_bucketqueue_node_t);
+    q->head = igraph_Calloc(no_of_buckets, long int);
+    q->used = igraph_Calloc((no_of_buckets + 63) / 64, uint64_t);
+    if (q->nodes == 0 || q->head == 0 || q->used == 0) {
+        igraph_bucketqueue_destroy(q);
+        IGRAPH_ERROR("Cannot initialize bucket queue", IGRAPH_ENOMEM);
+    }
+    for (i = 0; i < no_of_buckets; i++) {
+        q->head[i] = -1;
+    }
+
+    return 0;
+}
+
+void igraph_bucketqueue_destroy(igraph_bucketqueue_t *q) {
+    if (q->nodes != 0) {
+        igraph_Free(q->nodes);
+    }
+    if (q->head != 0) {
+        igraph_Free(q->head);
+    }
+    if (q->used != 0) {
+        igraph_Free(q->used);
+    }
+}
+
+int igraph_bucketqueue_clear(igraph_bucketqueue_t *q) {
+    long int i;
+    if (q->size > 0) {
+        /* Only the non-empty buckets need resetting */
+        long int nwords = (q->no_of_buckets + 63) / 64;
+        for (i = 0; i < nwords; i++) {
+            while (q->used[i]) {
+                long int b = i * 64 + igraph_i_bucketqueue_lowest_bit(q->used[i]);
+                q->head[b] = -1;
+                q->used[i] &= q->used[i] - 1;
+            }
+        }
+        q->size = 0;
+    }
+    for (i = 0; i < q->capacity; i++) {
+        q->nodes[i].state = 0;
+    }
+    return 0;
+}
+
+igraph_bool_t igraph_bucketqueue_empty(const igraph_bucketqueue_t *q) {
+    return q->size == 0;
+}
+
+long int igraph_bucketqueue_size(const igraph_bucketqueue_t *q) {
+    return q->size;
+}
+
+int igraph_bucketqueue_push_with_index(igraph_bucketqueue_t *q,
+                                       long int idx, igraph_real_t key) {
+    q->nodes[idx].key = key;
+    if (q->size == 0 || key < q->last) {
+        /* A new search can start from any key, and before the first
+           removal the keys may come in any order */
+        q->last = key;
+        q->cur = igraph_i_bucketqueue_bucket(q, key);
+    }
+    igraph_i_bucketqueue_insert(q, idx);
+    q->size++;
+    return 0;
+}
+
+igraph_bool_t igraph_bucketqueue_has_elem(const igraph_bucketqueue_t *q, long int idx) {
+    return q->nodes[idx].state != 0;
+}
+
+igraph_bool_t igraph_bucketqueue_has_active(const igraph_bucketqueue_t *q, long int idx) {
+    return q->nodes[idx].state == 2;
+}
+
+igraph_real_t igraph_bucketqueue_get(const igraph_bucketqueue_t *q, long int idx) {
+    return q->nodes[idx].key;
+}
+
+/* Removes the minimum, and marks it as removed if 'deactivate' is
+   true, or as never pushed otherwise */
+
+static igraph_real_t igraph_i_bucketqueue_pop(igraph_bucketqueue_t *q, long int *idx,
+        igraph_bool_t deactivate) {
+    long int min;
+
+    if (q->head[q->cur] < 0) {
+        /* The keys are within no_of_buckets of the last one removed,
+           so the next non-empty bucket in cyclic order holds the
+           smallest keys */
+        long int nwords = (q->no_of_buckets + 63) / 64;
+        long int w = q->cur >> 6;
+        uint64_t bits = q->used[w] & (~(uint64_t) 0 << (q->cur & 63));
+        while (!bits) {
+            w = w + 1 < nwords ? w + 1 : 0;
+            bits = q->used[w];
+        }
+        q->cur = w * 64 + igraph_i_bucketqueue_lowest_bit(bits);
+    }
+
+    min = q->head[q->cur];
+    q->last = q->nodes[min].key;
+    igraph_i_bucketqueue_remove(q, min);
+    q->nodes[min].state = deactivate ? 1 : 0;
+    q->size--;
+    if (idx) {
+        *idx = min;
+    }
+
+    return q->nodes[min].key;
+}
+
+igraph_real_t igraph_bucketqueue_delete_min(igraph_bucketqueue_t *q, long int *idx) {
+    return igraph_i_bucketqueue_pop(q, idx, /* deactivate= */ 0);
+}
+
+igraph_real_t igraph_bucketqueue_deactivate_min(igraph_bucketqueue_t *q, long int *idx) {
+    return igraph_i_bucketqueue_pop(q, idx, /* deactivate= */ 1);
+}
+
+int igraph_bucketqueue_modify(igraph_bucketqueue_t *q, long int idx, igraph_real_t key) {
+    igraph_i_bucketqueue_remove(q, idx);
+    q->nodes[idx].key = key;
+    if (key < q->last) {
+        q->last = key;
+        q->cur = igraph_i_bucketqueue_bucket(q, key);
+    }
+    igraph_i_bucketqueue_insert(q, idx);
+    return 0;
+}
+
+/* -------------------------------------------------- */
+/* Queue of the weighted shortest path algorithms     */
+/* -------------------------------------------------- */
+
+/* The number of buckets for a bucket queue, one more than the largest
+   weight, if all weights are integers, and there are not more buckets
+   than vertices, or IGRAPH_I_SPQUEUE_MAX_BUCKETS. Otherwise zero, and
+   a d-ary heap should be used. Then finding the next non-empty
+   bucket is cheap compared to the work done on the vertices. The
+   distances stay exact: they are below 2^53 for any realistic number
+   of vertices. */
+
+long int igraph_i_spqueue_no_of_buckets(const igraph_vector_t *weights,
+                                        long int no_of_nodes) {
+    long int i, n = igraph_vector_size(weights);
+    long int limit = no_of_nodes < 1024 ? 1024 : no_of_nodes;
+    igraph_real_t maxw = 0.0;
+
+    if (limit > IGRAPH_I_SPQUEUE_MAX_BUCKETS) {
+        limit = IGRAPH_I_SPQUEUE_MAX_BUCKETS;
+    }
+    for (i = 0; i < n; i++) {
+        igraph_real_t w = VECTOR(*weights)[i];
+        if (!(w >= 0 && w < limit && w == floor(w))) {
+            return 0;
+        }
+        if (w > maxw) {
+            maxw = w;
+        }
+    }
+
+    return (long int) maxw + 1;
+}
+
+int igraph_i_spqueue_init(igraph_i_spqueue_t *q, long int size,
+                          const igraph_vector_t *weights) {
+    long int no_of_buckets = weights ?
+                             igraph_i_spqueue_no_of_buckets(weights, size) : 0;
+    q->integer = no_of_buckets > 0;
+    if (q->integer) {
+        IGRAPH_CHECK(igraph_bucketqueue_init(&q->buckets, size, no_of_buckets));
+    } else {
+        IGRAPH_CHECK(igraph_dheap_init(&q->heap, size));
+    }
+    return 0;
+}
+
+void igraph_i_spqueue_destroy(igraph_i_spqueue_t *q) {
+    if (q->integer) {
+        igraph_bucketqueue_destroy(&q->buckets);
+    } else {
+        igraph_dheap_destroy(&q->heap);
+    }
+}
+
+int igraph_i_spqueue_clear(igraph_i_spqueue_t *q) {
+    return q->integer ? igraph_bucketqueue_clear(&q->buckets) :
+           igraph_dheap_clear(&q->heap);
+}
+
+igraph_bool_t igraph_i_spqueue_empty(const igraph_i_spqueue_t *q) {
+    return q->integer ? igraph_bucketqueue_empty(&q->buckets) :
+           igraph_dheap_empty(&q->heap);
+}
+
+int igraph_i_spqueue_push(igraph_i_spqueue_t *q, long int idx, igraph_real_t dist) {
+    return q->integer ? igraph_bucketqueue_push_with_index(&q->buckets, idx, dist) :
+           igraph_dheap_push_with_index(&q->heap, idx, dist);
+}
+
+int igraph_i_spqueue_modify(igraph_i_spqueue_t *q, long int idx, igraph_real_t dist) {
+    return q->integer ? igraph_bucketqueue_modify(&q->buckets, idx, dist) :
+           igraph_dheap_modify(&q->heap, idx, dist);
+}
+
+igraph_bool_t igraph_i_spqueue_has_elem(const igraph_i_spqueue_t *q, long int idx) {
+    return q->integer ? igraph_bucketqueue_has_elem(&q->buckets, idx) :
+           igraph_dheap_has_elem(&q->heap, idx);
+}
+
+igraph_bool_t igraph_i_spqueue_has_active(const igraph_i_spqueue_t *q, long int idx) {
+    return q->integer ? igraph_bucketqueue_has_active(&q->buckets, idx) :
+           igraph_dheap_has_active(&q->heap, idx);
+}
+
+igraph_real_t igraph_i_spqueue_get(const igraph_i_spqueue_t *q, long int idx) {
+    return q->integer ? igraph_bucketqueue_get(&q->buckets, idx) :
+           igraph_dheap_get(&q->heap, idx);
+}
+
+igraph_real_t igraph_i_spqueue_delete_min(igraph_i_spqueue_t *q, long int *idx) {
+    return q->integer ? igraph_bucketqueue_delete_min(&q->buckets, idx) :
+           igraph_dheap_delete_min(&q->heap, idx);
+}
+
+igraph_real_t igraph_i_spqueue_deactivate_min(igraph_i_spqueue_t *q, long int *idx) {
+    return q->integer ? igraph_bucketqueue_deactivate_min(&q->buckets, idx) :
+           igraph_dheap_deactivate_min(&q->heap, idx);
+}
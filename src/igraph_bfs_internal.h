@@ -0,0 +1,112 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_BFS_INTERNAL_H
+#define IGRAPH_BFS_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_constants.h"
+#include "igraph_datatype.h"
+#include "igraph_types.h"
+#include "igraph_vector.h"
+#include "igraph_vector_ptr.h"
+
+#include <stdint.h>
+
+__BEGIN_DECLS
+
+/* Breadth-first search for the unweighted distance functions. It
+   reads the edge index of the graph directly, and it switches between
+   top-down steps, which expand the frontier, and bottom-up steps, in
+   which every unreached vertex looks for a neighbor in the frontier.
+   The large steps run on igraph_get_num_threads() threads.
+
+   igraph_i_bfs_start() reaches the root, and each call to
+   igraph_i_bfs_next_level() reaches the next level. The vertices of
+   the current level are order[level_begin] to order[level_end-1],
+   their distance from the root is 'level'. The order of the vertices
+   within a level is not specified. dist[v] is the distance of v, or
+   -1 if it was not reached yet. The same object can be used for many
+   searches, a new search only resets the vertices reached by the
+   previous one. */
+
+typedef struct igraph_i_bfs_t {
+    const igraph_t *graph;
+    igraph_neimode_t mode;
+    igraph_integer_t no_of_nodes;
+    igraph_vector_int_t dist;
+    igraph_vector_int_t order;
+    igraph_integer_t level;
+    igraph_integer_t level_begin, level_end;
+    uint64_t *frontier;         /* bitmaps for the bottom-up steps */
+    uint64_t *next;
+    igraph_bool_t bottom_up;
+    igraph_real_t unexplored;   /* edges of the unreached vertices */
+    igraph_vector_ptr_t buffers;    /* per thread, for the top-down steps */
+} igraph_i_bfs_t;
+
+int igraph_i_bfs_init(igraph_i_bfs_t *bfs, const igraph_t *graph,
+                      igraph_neimode_t mode);
+void igraph_i_bfs_destroy(igraph_i_bfs_t *bfs);
+int igraph_i_bfs_start(igraph_i_bfs_t *bfs, igraph_integer_t root);
+int igraph_i_bfs_next_level(igraph_i_bfs_t *bfs, igraph_bool_t *found);
+
+/* Multi-source breadth-first search, it runs the searches of up to 64
+   sources at once. Every vertex has a 64 bit word in 'seen', bit k is
+   set if the search from the k-th source has reached it. 'visit' has
+   the bits of the searches that reached the vertex in the current
+   level. The searches share the scans of the edges, so this is much
+   faster than separate searches when many sources are needed.
+
+   Levels with many vertices are computed bottom-up on several threads,
+   the others top-down from the list of the vertices in the frontier.
+   igraph_i_msbfs_level_stats() summarizes the current level. */
+
+#define IGRAPH_I_MSBFS_WIDTH 64
+
+typedef struct igraph_i_msbfs_t {
+    const igraph_t *graph;
+    igraph_neimode_t mode;
+    igraph_integer_t no_of_nodes;
+    igraph_integer_t level;
+    igraph_integer_t active;      /* vertices in the current level */
+    uint64_t *seen;
+    uint64_t *visit;
+    uint64_t *next;
+    igraph_bool_t listed;         /* whether 'frontier' is valid */
+    igraph_vector_int_t frontier;
+    igraph_vector_int_t touched;
+} igraph_i_msbfs_t;
+
+int igraph_i_msbfs_init(igraph_i_msbfs_t *msbfs, const igraph_t *graph,
+                        igraph_neimode_t mode);
+void igraph_i_msbfs_destroy(igraph_i_msbfs_t *msbfs);
+int igraph_i_msbfs_start(igraph_i_msbfs_t *msbfs,
+                         const igraph_integer_t *sources, int no_of_sources);
+int igraph_i_msbfs_next_level(igraph_i_msbfs_t *msbfs, igraph_bool_t *found);
+void igraph_i_msbfs_level_stats(const igraph_i_msbfs_t *msbfs,
+                                igraph_real_t *pairs, uint64_t *mask,
+                                igraph_real_t *counts);
+
+__END_DECLS
+
+#endif
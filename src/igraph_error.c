@@ -24,6 +24,7 @@
 #include "config.h"
 #include "igraph_error.h"
 #include "igraph_types.h"
+#include "igraph_threading_internal.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -114,6 +115,13 @@ const char* igraph_strerror(const int igraph_errno) {
 int igraph_error(const char *reason, const char *file, int line,
                  int igraph_errno) {
 
+    igraph_i_parallel_context_t *ctx = igraph_i_parallel_context();
+    if (ctx) {
+        /* Raised again on the calling thread, after the region */
+        IGRAPH_FINALLY_FREE();
+        return igraph_i_parallel_error(ctx, reason, file, line, igraph_errno);
+    }
+
     if (igraph_i_error_handler) {
         igraph_i_error_handler(reason, file, line, igraph_errno);
 #ifndef USING_R
@@ -177,40 +185,47 @@ igraph_set_error_handler (igraph_error_handler_t * new_handler) {
 
 IGRAPH_THREAD_LOCAL struct igraph_i_protectedPtr igraph_i_finally_stack[100];
 
+/* Threads taking part in a parallel region use their own stack */
+
+static struct igraph_i_protectedPtr *igraph_i_finally_stack_current(void) {
+    igraph_i_parallel_context_t *ctx = igraph_i_parallel_context();
+    return ctx ? igraph_i_parallel_finally_stack(ctx) : igraph_i_finally_stack;
+}
+
 /*
  * Adds another element to the free list
  */
 
 void IGRAPH_FINALLY_REAL(void (*func)(void*), void* ptr) {
-    int no = igraph_i_finally_stack[0].all;
+    struct igraph_i_protectedPtr *stack = igraph_i_finally_stack_current();
+    int no = stack[0].all;
     assert (no < 100);
     assert (no >= 0);
-    igraph_i_finally_stack[no].ptr = ptr;
-    igraph_i_finally_stack[no].func = func;
-    igraph_i_finally_stack[0].all ++;
-    /* printf("--> Finally stack contains now %d elements\n", igraph_i_finally_stack[0].all); */
+    stack[no].ptr = ptr;
+    stack[no].func = func;
+    stack[0].all ++;
 }
 
 void IGRAPH_FINALLY_CLEAN(int minus) {
-    igraph_i_finally_stack[0].all -= minus;
-    if (igraph_i_finally_stack[0].all < 0) {
-        /* fprintf(stderr, "corrupt finally stack, popping %d elements when only %d left\n", minus, igraph_i_finally_stack[0].all+minus); */
-        igraph_i_finally_stack[0].all = 0;
+    struct igraph_i_protectedPtr *stack = igraph_i_finally_stack_current();
+    stack[0].all -= minus;
+    if (stack[0].all < 0) {
+        /* fprintf(stderr, "corrupt finally stack, popping %d elements when only %d left\n", minus, stack[0].all+minus); */
+        stack[0].all = 0;
     }
-    /* printf("<-- Finally stack contains now %d elements\n", igraph_i_finally_stack[0].all); */
 }
 
 void IGRAPH_FINALLY_FREE(void) {
+    struct igraph_i_protectedPtr *stack = igraph_i_finally_stack_current();
     int p;
-    /*   printf("[X] Finally stack will be cleaned (contained %d elements)\n", igraph_i_finally_stack[0].all);  */
-    for (p = igraph_i_finally_stack[0].all - 1; p >= 0; p--) {
-        igraph_i_finally_stack[p].func(igraph_i_finally_stack[p].ptr);
+    for (p = stack[0].all - 1; p >= 0; p--) {
+        stack[p].func(stack[p].ptr);
     }
-    igraph_i_finally_stack[0].all = 0;
+    stack[0].all = 0;
 }
 
 int IGRAPH_FINALLY_STACK_SIZE(void) {
-    return igraph_i_finally_stack[0].all;
+    return igraph_i_finally_stack_current()[0].all;
 }
 
 static IGRAPH_THREAD_LOCAL igraph_warning_handler_t *igraph_i_warning_handler = 0;
@@ -262,6 +277,13 @@ void igraph_warning_handler_print (const char *reason, const char *file,
 int igraph_warning(const char *reason, const char *file, int line,
                    int igraph_errno) {
 
+    igraph_i_parallel_context_t *ctx = igraph_i_parallel_context();
+    if (ctx && !igraph_i_parallel_is_caller(ctx)) {
+        /* Reported on the calling thread, after the region */
+        igraph_i_parallel_warning(ctx, reason, file, line, igraph_errno);
+        return igraph_errno;
+    }
+
     if (igraph_i_warning_handler) {
         igraph_i_warning_handler(reason, file, line, igraph_errno);
 #ifndef USING_R
@@ -0,0 +1,63 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_RANDOM_INTERNAL_H
+#define IGRAPH_RANDOM_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_random.h"
+#include "igraph_types.h"
+
+__BEGIN_DECLS
+
+#define IGRAPH_I_RNG_BUFFER_SIZE 256
+
+/* A buffer of uniform random numbers, for loops that draw many of
+   them. Generators with a fill_real hook refill the whole buffer at
+   once; all other generators are read one number at a time, so that
+   they produce the same sequence as igraph_rng_get_unif01() calls.
+   Note that a buffered generator is read ahead: numbers left in the
+   buffer when it goes out of scope are lost. */
+
+typedef struct {
+    igraph_rng_t *rng;
+    int next, size;
+    igraph_real_t data[IGRAPH_I_RNG_BUFFER_SIZE];
+} igraph_i_rng_buffer_t;
+
+void igraph_i_rng_buffer_init(igraph_i_rng_buffer_t *buffer, igraph_rng_t *rng);
+igraph_real_t igraph_i_rng_buffer_refill(igraph_i_rng_buffer_t *buffer);
+igraph_real_t igraph_i_rng_buffer_geom(igraph_i_rng_buffer_t *buffer,
+                                       igraph_real_t p);
+
+#define IGRAPH_I_RNG_UNIF01(buffer) \
+    ((buffer)->next < (buffer)->size ? (buffer)->data[(buffer)->next++] : \
+     igraph_i_rng_buffer_refill(buffer))
+#define IGRAPH_I_RNG_UNIF(buffer, l, h) \
+    (IGRAPH_I_RNG_UNIF01(buffer) * ((h) - (l)) + (l))
+#define IGRAPH_I_RNG_INTEGER(buffer, l, h) \
+    ((long int) (IGRAPH_I_RNG_UNIF01(buffer) * ((h) - (l) + 1) + (l)))
+#define IGRAPH_I_RNG_GEOM(buffer, p) igraph_i_rng_buffer_geom((buffer), (p))
+
+__END_DECLS
+
+#endif
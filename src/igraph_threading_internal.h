@@ -0,0 +1,64 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#ifndef IGRAPH_THREADING_INTERNAL_H
+#define IGRAPH_THREADING_INTERNAL_H
+
+#include "igraph_decls.h"
+#include "igraph_threading.h"
+#include "igraph_types.h"
+
+__BEGIN_DECLS
+
+typedef int igraph_i_parallel_func_t(void *arg, int thread);
+
+int igraph_i_parallel_run(igraph_i_parallel_func_t *func, void *arg,
+                          int nthreads);
+
+/* The state of a thread while it takes part in a parallel region.
+   igraph_error.c, interrupt.c and progress.c use these to keep the
+   finally stack, the error handler and the interruption handler of
+   the calling thread away from the worker threads. All of them are
+   no-ops when the thread is not in a parallel region, i.e. when
+   igraph_i_parallel_context() returns a null pointer. */
+
+typedef struct igraph_i_parallel_context_t igraph_i_parallel_context_t;
+struct igraph_i_protectedPtr;
+
+igraph_i_parallel_context_t *igraph_i_parallel_context(void);
+struct igraph_i_protectedPtr *igraph_i_parallel_finally_stack(
+    igraph_i_parallel_context_t *ctx);
+igraph_bool_t igraph_i_parallel_is_caller(igraph_i_parallel_context_t *ctx);
+int igraph_i_parallel_error(igraph_i_parallel_context_t *ctx,
+                            const char *reason, const char *file,
+                            int line, int igraph_errno);
+void igraph_i_parallel_warning(igraph_i_parallel_context_t *ctx,
+                               const char *reason, const char *file,
+                               int line, int igraph_errno);
+int igraph_i_parallel_allow_interruption(igraph_i_parallel_context_t *ctx,
+        void *data);
+void igraph_i_parallel_interrupt(igraph_i_parallel_context_t *ctx);
+igraph_bool_t igraph_i_parallel_cancelled(igraph_i_parallel_context_t *ctx);
+
+__END_DECLS
+
+#endif
@@ -41,6 +41,8 @@
 #include "igraph_vector.h"
 #include "igraph_vector_ptr.h"
 
+#include <stdint.h>
+
 __BEGIN_DECLS
 
 /* -------------------------------------------------- */
@@ -158,6 +160,124 @@ igraph_real_t igraph_2wheap_delete_max_index(igraph_2wheap_t *h, long int *idx);
 int igraph_2wheap_modify(igraph_2wheap_t *h, long int idx, igraph_real_t elem);
 int igraph_2wheap_check(igraph_2wheap_t *h);
 
+/* -------------------------------------------------- */
+/* Indexed d-ary heap                                 */
+/* -------------------------------------------------- */
+
+/* An indexed minimum heap with the operations of the two-way heap,
+   for keys that are used as they are, not negated. Each node has
+   IGRAPH_DHEAP_ARITY children, so the heap is shallower than a binary
+   one, and the children of a node are next to each other in memory.
+   A key is stored together with its index, so sifting an element
+   touches one array and the positions of the indices, instead of
+   three arrays. */
+
+#define IGRAPH_DHEAP_ARITY 4
+
+typedef struct igraph_i_dheap_elem_t {
+    igraph_real_t key;
+    long int idx;
+} igraph_i_dheap_elem_t;
+
+typedef struct igraph_dheap_t {
+    long int size, capacity;
+    igraph_i_dheap_elem_t *data;
+    long int *pos;              /* 0: never pushed, 1: removed, i+2: at data[i] */
+} igraph_dheap_t;
+
+int igraph_dheap_init(igraph_dheap_t *h, long int size);
+void igraph_dheap_destroy(igraph_dheap_t *h);
+int igraph_dheap_clear(igraph_dheap_t *h);
+int igraph_dheap_push_with_index(igraph_dheap_t *h,
+                                 long int idx, igraph_real_t key);
+igraph_bool_t igraph_dheap_empty(const igraph_dheap_t *h);
+long int igraph_dheap_size(const igraph_dheap_t *h);
+igraph_real_t igraph_dheap_min(const igraph_dheap_t *h);
+long int igraph_dheap_min_index(const igraph_dheap_t *h);
+igraph_bool_t igraph_dheap_has_elem(const igraph_dheap_t *h, long int idx);
+igraph_bool_t igraph_dheap_has_active(const igraph_dheap_t *h, long int idx);
+igraph_real_t igraph_dheap_get(const igraph_dheap_t *h, long int idx);
+igraph_real_t igraph_dheap_delete_min(igraph_dheap_t *h, long int *idx);
+igraph_real_t igraph_dheap_deactivate_min(igraph_dheap_t *h, long int *idx);
+int igraph_dheap_modify(igraph_dheap_t *h, long int idx, igraph_real_t key);
+int igraph_dheap_check(const igraph_dheap_t *h);
+
+/* -------------------------------------------------- */
+/* Bucket queue                                       */
+/* -------------------------------------------------- */
+
+/* Dial's bucket queue: an indexed minimum heap for non-negative
+   integer keys, where a key is never smaller than the last key
+   removed, and all keys are smaller than the minimum plus
+   no_of_buckets, as in
+   Dijkstra's algorithm with integer weights smaller than
+   no_of_buckets. Key k goes to bucket k mod no_of_buckets, the
+   buckets are doubly linked lists through the elements, so adding,
+   modifying and removing an element take constant time. Finding the
+   next non-empty bucket uses a bit set of them. The interface follows
+   the two-way heap, but the keys are not negated and the smallest one
+   comes first. */
+
+typedef struct igraph_i_bucketqueue_node_t {
+    igraph_real_t key;
+    long int next, prev;
+    int state;                  /* 0: never pushed, 1: removed, 2: in a bucket */
+} igraph_i_bucketqueue_node_t;
+
+typedef struct igraph_bucketqueue_t {
+    long int size, capacity;
+    long int no_of_buckets, cur;   /* 'cur' is the bucket of 'last' */
+    igraph_real_t last;
+    igraph_i_bucketqueue_node_t *nodes;
+    long int *head;
+    uint64_t *used;             /* bit set of the non-empty buckets */
+} igraph_bucketqueue_t;
+
+int igraph_bucketqueue_init(igraph_bucketqueue_t *q, long int size,
+                            long int no_of_buckets);
+void igraph_bucketqueue_destroy(igraph_bucketqueue_t *q);
+int igraph_bucketqueue_clear(igraph_bucketqueue_t *q);
+int igraph_bucketqueue_push_with_index(igraph_bucketqueue_t *q,
+                                       long int idx, igraph_real_t key);
+igraph_bool_t igraph_bucketqueue_empty(const igraph_bucketqueue_t *q);
+long int igraph_bucketqueue_size(const igraph_bucketqueue_t *q);
+igraph_bool_t igraph_bucketqueue_has_elem(const igraph_bucketqueue_t *q, long int idx);
+igraph_bool_t igraph_bucketqueue_has_active(const igraph_bucketqueue_t *q, long int idx);
+igraph_real_t igraph_bucketqueue_get(const igraph_bucketqueue_t *q, long int idx);
+igraph_real_t igraph_bucketqueue_delete_min(igraph_bucketqueue_t *q, long int *idx);
+igraph_real_t igraph_bucketqueue_deactivate_min(igraph_bucketqueue_t *q, long int *idx);
+int igraph_bucketqueue_modify(igraph_bucketqueue_t *q, long int idx, igraph_real_t key);
+
+/* -------------------------------------------------- */
+/* Queue of the weighted shortest path algorithms     */
+/* -------------------------------------------------- */
+
+/* A minimum heap of distances, indexed by vertex: a bucket queue if
+   all weights are small integers, a d-ary heap otherwise. */
+
+#define IGRAPH_I_SPQUEUE_MAX_BUCKETS 65536
+
+typedef struct igraph_i_spqueue_t {
+    igraph_bool_t integer;
+    igraph_dheap_t heap;
+    igraph_bucketqueue_t buckets;
+} igraph_i_spqueue_t;
+
+long int igraph_i_spqueue_no_of_buckets(const igraph_vector_t *weights,
+                                        long int no_of_nodes);
+int igraph_i_spqueue_init(igraph_i_spqueue_t *q, long int size,
+                          const igraph_vector_t *weights);
+void igraph_i_spqueue_destroy(igraph_i_spqueue_t *q);
+int igraph_i_spqueue_clear(igraph_i_spqueue_t *q);
+igraph_bool_t igraph_i_spqueue_empty(const igraph_i_spqueue_t *q);
+int igraph_i_spqueue_push(igraph_i_spqueue_t *q, long int idx, igraph_real_t dist);
+int igraph_i_spqueue_modify(igraph_i_spqueue_t *q, long int idx, igraph_real_t dist);
+igraph_bool_t igraph_i_spqueue_has_elem(const igraph_i_spqueue_t *q, long int idx);
+igraph_bool_t igraph_i_spqueue_has_active(const igraph_i_spqueue_t *q, long int idx);
+igraph_real_t igraph_i_spqueue_get(const igraph_i_spqueue_t *q, long int idx);
+igraph_real_t igraph_i_spqueue_delete_min(igraph_i_spqueue_t *q, long int *idx);
+igraph_real_t igraph_i_spqueue_deactivate_min(igraph_i_spqueue_t *q, long int *idx);
+
 /**
  * Trie data type
  * \ingroup internal
@@ -390,6 +510,12 @@ int igraph_fixed_vectorlist_convert(igraph_fixed_vectorlist_t *l,
                                     const igraph_vector_t *from,
                                     long int size);
 
+/* -------------------------------------------------- */
+/* Memory mapped binary graphs, see foreign-binary.c  */
+/* -------------------------------------------------- */
+
+void igraph_i_binary_release(void *mapping);
+
 __END_DECLS
 
 #endif
@@ -22,6 +22,7 @@
 */
 
 #include "igraph_interrupt.h"
+#include "igraph_threading_internal.h"
 #include "config.h"
 
 #include <stdio.h>
@@ -32,6 +33,10 @@ IGRAPH_THREAD_LOCAL igraph_interruption_handler_t
 *igraph_i_interruption_handler = 0;
 
 int igraph_allow_interruption(void* data) {
+    igraph_i_parallel_context_t *ctx = igraph_i_parallel_context();
+    if (ctx) {
+        return igraph_i_parallel_allow_interruption(ctx, data);
+    }
     if (igraph_i_interruption_handler) {
         return igraph_i_interruption_handler(data);
     }
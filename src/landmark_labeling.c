@@ -0,0 +1,615 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_paths.h"
+#include "igraph_interface.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_memory.h"
+#include "igraph_types_internal.h"
+#include "config.h"
+
+#include <string.h>
+#include <stdint.h>
+
+/* Pruned landmark labeling gives every vertex a label: a list of
+ * (hub, distance) pairs, such that for any two vertices the shortest
+ * path between them goes through a hub that is in both labels. The
+ * distance is then the minimum of the sums of the two distances over
+ * the common hubs, which is a merge of the two labels, as they are
+ * sorted by hub.
+ *
+ * The labels are built with a breadth-first search from every vertex,
+ * in the order of decreasing degree. The search from hub r adds r to
+ * the label of every vertex it reaches, unless the labels built so far
+ * already give the right distance; then the search does not continue
+ * from that vertex. As high degree vertices cover most shortest paths
+ * of social and web graphs, the later searches stop quickly and the
+ * labels stay short.
+ *
+ * Directed graphs need two labels: the 'out' label of v holds the
+ * distances from v to its hubs, the 'in' label the distances from the
+ * hubs to v. A hub is stored by its position in the order, so that
+ * the labels are sorted. */
+
+/* Labels of one direction during the build, (hub, distance) pairs of
+   each vertex stored one after the other */
+
+typedef struct igraph_i_pll_builder_t {
+    long int no_of_nodes;
+    igraph_vector_int_t *labels[2];
+    igraph_vector_int_t cache;      /* distances from the hub by rank */
+    igraph_vector_int_t dist;       /* distances of the search */
+    igraph_vector_int_t queue;
+} igraph_i_pll_builder_t;
+
+static void igraph_i_pll_builder_destroy(igraph_i_pll_builder_t *b) {
+    long int i;
+    int d;
+    for (d = 0; d < 2; d++) {
+        if (b->labels[d]) {
+            for (i = 0; i < b->no_of_nodes; i++) {
+                igraph_vector_int_destroy(&b->labels[d][i]);
+            }
+            igraph_Free(b->labels[d]);
+        }
+    }
+    igraph_vector_int_destroy(&b->cache);
+    igraph_vector_int_destroy(&b->dist);
+    igraph_vector_int_destroy(&b->queue);
+}
+
+static int igraph_i_pll_builder_init(igraph_i_pll_builder_t *b, long int no_of_nodes,
+                                     igraph_bool_t directed) {
+    long int i;
+    int d;
+
+    memset(b, 0, sizeof(*b));
+    b->no_of_nodes = no_of_nodes;
+    IGRAPH_FINALLY(igraph_i_pll_builder_destroy, b);
+
+    for (d = 0; d < (directed ? 2 : 1); d++) {
+        b->labels[d] = igraph_Calloc(no_of_nodes > 0 ? no_of_nodes : 1, igraph_vector_int_t);
+        if (!b->labels[d]) {
+            IGRAPH_ERROR("Cannot build landmark labeling", IGRAPH_ENOMEM);
+        }
+        for (i = 0; i < no_of_nodes; i++) {
+            IGRAPH_CHECK(igraph_vector_int_init(&b->labels[d][i], 0));
+        }
+    }
+    IGRAPH_CHECK(igraph_vector_int_init(&b->cache, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->dist, no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_init(&b->queue, no_of_nodes));
+    igraph_vector_int_fill(&b->cache, -1);
+    igraph_vector_int_fill(&b->dist, -1);
+
+    IGRAPH_FINALLY_CLEAN(1);
+    return 0;
+}
+
+/* Pruned breadth-first search from the hub at position 'rank' of the
+   order, vertex 'root'. 'hub_label' is the label of the root in the
+   other direction, 'labels' get the new entries. */
+
+static int igraph_i_pll_search(igraph_i_pll_builder_t *b, const igraph_t *graph,
+                               igraph_neimode_t mode, long int root, long int rank,
+                               igraph_vector_int_t *hub_label,
+                               igraph_vector_int_t *labels) {
+    long int i, n = igraph_vector_int_size(hub_label), head = 0, tail = 0;
+
+    /* The label of the root, indexed by hub, for the pruning test */
+    for (i = 0; i < n; i += 2) {
+        VECTOR(b->cache)[VECTOR(*hub_label)[i]] = VECTOR(*hub_label)[i + 1];
+    }
+
+    VECTOR(b->dist)[root] = 0;
+    VECTOR(b->queue)[tail++] = root;
+    while (head < tail) {
+        long int v = VECTOR(b->queue)[head++];
+        igraph_integer_t dv = VECTOR(b->dist)[v];
+        igraph_vector_int_t *label = &labels[v];
+        long int len = igraph_vector_int_size(label);
+        int pass;
+
+        /* Prune if an earlier hub gives a path that is not longer */
+        for (i = 0; i < len; i += 2) {
+            igraph_integer_t c = VECTOR(b->cache)[VECTOR(*label)[i]];
+            if (c >= 0 && c + VECTOR(*label)[i + 1] <= dv) {
+                break;
+            }
+        }
+        if (i < len) {
+            continue;
+        }
+
+        IGRAPH_CHECK(igraph_vector_int_push_back(label, rank));
+        IGRAPH_CHECK(igraph_vector_int_push_back(label, dv));
+
+        for (pass = 0; pass < 2; pass++) {
+            igraph_integer_t begin, end, k;
+            if (pass == 0 && (mode & IGRAPH_OUT)) {
+                begin = VECTOR(graph->os)[v]; end = VECTOR(graph->os)[v + 1];
+            } else if (pass == 1 && (mode & IGRAPH_IN)) {
+                begin = VECTOR(graph->is)[v]; end = VECTOR(graph->is)[v + 1];
+            } else {
+                continue;
+            }
+            for (k = begin; k < end; k++) {
+                long int u = pass == 0 ? VECTOR(graph->to)[VECTOR(graph->oi)[k]] :
+                             VECTOR(graph->from)[VECTOR(graph->ii)[k]];
+                if (VECTOR(b->dist)[u] < 0) {
+                    VECTOR(b->dist)[u] = dv + 1;
+                    VECTOR(b->queue)[tail++] = u;
+                }
+            }
+        }
+    }
+
+    for (i = 0; i < tail; i++) {
+        VECTOR(b->dist)[VECTOR(b->queue)[i]] = -1;
+    }
+    for (i = 0; i < n; i += 2) {
+        VECTOR(b->cache)[VECTOR(*hub_label)[i]] = -1;
+    }
+
+    return 0;
+}
+
+/* Moves the labels of the builder into the compact arrays */
+
+static int igraph_i_pll_store(igraph_vector_int_t *labels, long int no_of_nodes,
+                              igraph_vector_int_t *start, igraph_vector_int_t *hub,
+                              igraph_vector_int_t *dist) {
+    long int v, i, pos = 0;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(start, no_of_nodes + 1));
+    VECTOR(*start)[0] = 0;
+    for (v = 0; v < no_of_nodes; v++) {
+        VECTOR(*start)[v + 1] = VECTOR(*start)[v] +
+                                igraph_vector_int_size(&labels[v]) / 2;
+    }
+    IGRAPH_CHECK(igraph_vector_int_resize(hub, VECTOR(*start)[no_of_nodes]));
+    IGRAPH_CHECK(igraph_vector_int_resize(dist, VECTOR(*start)[no_of_nodes]));
+    for (v = 0; v < no_of_nodes; v++) {
+        long int len = igraph_vector_int_size(&labels[v]);
+        for (i = 0; i < len; i += 2, pos++) {
+            VECTOR(*hub)[pos] = VECTOR(labels[v])[i];
+            VECTOR(*dist)[pos] = VECTOR(labels[v])[i + 1];
+        }
+        igraph_vector_int_destroy(&labels[v]);
+        IGRAPH_CHECK(igraph_vector_int_init(&labels[v], 0));
+    }
+
+    return 0;
+}
+
+static int igraph_i_landmark_labeling_alloc(igraph_landmark_labeling_t *ll) {
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->order, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->order);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->out_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->out_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->out_hub, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->out_hub);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->out_dist, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->out_dist);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->in_start, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->in_start);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->in_hub, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ll->in_hub);
+    IGRAPH_CHECK(igraph_vector_int_init(&ll->in_dist, 0));
+    IGRAPH_FINALLY_CLEAN(6);
+    return 0;
+}
+
+/**
+ * \function igraph_landmark_labeling_init
+ * \brief Builds a distance labeling for exact distance queries.
+ *
+ * This function computes a pruned landmark labeling of an unweighted
+ * graph: for every vertex, a list of hub vertices and its distance
+ * to them, such that the distance of any two vertices is the smallest
+ * sum of distances over the hubs the two have in common. After it is
+ * built, \ref igraph_landmark_labeling_distance() answers a distance
+ * query by merging two short sorted lists, without searching the
+ * graph.
+ *
+ * </para><para>
+ * The hubs are chosen in the order of decreasing degree, which keeps
+ * the labels short on graphs where high degree vertices lie on many
+ * shortest paths, like social networks and web graphs: the labels of
+ * such graphs usually have a few hundred entries per vertex, even
+ * with millions of vertices. On graphs without such vertices, e.g.
+ * road networks or lattices, the labels can be much larger. Use
+ * \ref igraph_landmark_labeling_size() to check the memory used.
+ *
+ * </para><para>
+ * The labeling does not refer to the graph after it was built and
+ * can be saved with \ref igraph_landmark_labeling_write().
+ *
+ * </para><para>
+ * Reference: Takuya Akiba, Yoichi Iwata and Yuichi Yoshida: Fast
+ * exact shortest-path distance queries on large networks by pruned
+ * landmark labeling. SIGMOD 2013, pp. 349-360.
+ *
+ * \param ll Pointer to an uninitialized labeling, it must be
+ *        destroyed with \ref igraph_landmark_labeling_destroy().
+ * \param graph The input graph.
+ * \param directed Whether to consider edge directions in directed
+ *        graphs. Directed labelings store two labels for every
+ *        vertex. It is ignored for undirected graphs.
+ * \return Error code.
+ *
+ * Time complexity: O(|V| L (L+d)) in the worst case, where L is the
+ * size of the largest label and d the average degree, much less in
+ * practice.
+ *
+ * \example examples/simple/igraph_landmark_labeling.c
+ */
+
+int igraph_landmark_labeling_init(igraph_landmark_labeling_t *ll,
+                                  const igraph_t *graph,
+                                  igraph_bool_t directed) {
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_i_pll_builder_t builder;
+    igraph_vector_int_t count;
+    long int v, r, maxdeg = 0;
+
+    IGRAPH_CHECK(igraph_i_landmark_labeling_alloc(ll));
+    IGRAPH_FINALLY(igraph_landmark_labeling_destroy, ll);
+    ll->no_of_nodes = (igraph_integer_t) no_of_nodes;
+    ll->directed = directed && igraph_is_directed(graph);
+
+    /* Order by decreasing total degree, ties by vertex id, with a
+       counting sort */
+    IGRAPH_CHECK(igraph_vector_int_resize(&ll->order, no_of_nodes));
+    for (v = 0; v < no_of_nodes; v++) {
+        long int deg = VECTOR(graph->os)[v + 1] - VECTOR(graph->os)[v] +
+                       VECTOR(graph->is)[v + 1] - VECTOR(graph->is)[v];
+        if (deg > maxdeg) {
+            maxdeg = deg;
+        }
+    }
+    IGRAPH_CHECK(igraph_vector_int_init(&count, maxdeg + 2));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &count);
+    for (v = 0; v < no_of_nodes; v++) {
+        long int deg = VECTOR(graph->os)[v + 1] - VECTOR(graph->os)[v] +
+                       VECTOR(graph->is)[v + 1] - VECTOR(graph->is)[v];
+        VECTOR(count)[maxdeg - deg + 1] += 1;
+    }
+    for (r = 0; r <= maxdeg; r++) {
+        VECTOR(count)[r + 1] += VECTOR(count)[r];
+    }
+    for (v = 0; v < no_of_nodes; v++) {
+        long int deg = VECTOR(graph->os)[v + 1] - VECTOR(graph->os)[v] +
+                       VECTOR(graph->is)[v + 1] - VECTOR(graph->is)[v];
+        VECTOR(ll->order)[VECTOR(count)[maxdeg - deg]++] = v;
+    }
+    igraph_vector_int_destroy(&count);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    IGRAPH_CHECK(igraph_i_pll_builder_init(&builder, no_of_nodes, ll->directed));
+    IGRAPH_FINALLY(igraph_i_pll_builder_destroy, &builder);
+
+    for (r = 0; r < no_of_nodes; r++) {
+        long int root = VECTOR(ll->order)[r];
+        IGRAPH_ALLOW_INTERRUPTION();
+        if (ll->directed) {
+            /* Forward search fills the 'in' labels, it is pruned with
+               the 'out' label of the root, and the other way around */
+            IGRAPH_CHECK(igraph_i_pll_search(&builder, graph, IGRAPH_OUT, root, r,
+                                             &builder.labels[0][root],
+                                             builder.labels[1]));
+            IGRAPH_CHECK(igraph_i_pll_search(&builder, graph, IGRAPH_IN, root, r,
+                                             &builder.labels[1][root],
+                                             builder.labels[0]));
+        } else {
+            IGRAPH_CHECK(igraph_i_pll_search(&builder, graph, IGRAPH_ALL, root, r,
+                                             &builder.labels[0][root],
+                                             builder.labels[0]));
+        }
+    }
+
+    IGRAPH_CHECK(igraph_i_pll_store(builder.labels[0], no_of_nodes, &ll->out_start,
+                                    &ll->out_hub, &ll->out_dist));
+    if (ll->directed) {
+        IGRAPH_CHECK(igraph_i_pll_store(builder.labels[1], no_of_nodes, &ll->in_start,
+                                        &ll->in_hub, &ll->in_dist));
+    }
+
+    igraph_i_pll_builder_destroy(&builder);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
+/**
+ * \function igraph_landmark_labeling_destroy
+ * \brief Frees the memory of a landmark labeling.
+ *
+ * \param ll The labeling.
+ *
+ * Time complexity: O(1).
+ */
+
+void igraph_landmark_labeling_destroy(igraph_landmark_labeling_t *ll) {
+    igraph_vector_int_destroy(&ll->order);
+    igraph_vector_int_destroy(&ll->out_start);
+    igraph_vector_int_destroy(&ll->out_hub);
+    igraph_vector_int_destroy(&ll->out_dist);
+    igraph_vector_int_destroy(&ll->in_start);
+    igraph_vector_int_destroy(&ll->in_hub);
+    igraph_vector_int_destroy(&ll->in_dist);
+}
+
+/**
+ * \function igraph_landmark_labeling_distance
+ * \brief Distance of two vertices, from their labels.
+ *
+ * \param ll The labeling.
+ * \param res Pointer to a real number, the length of the shortest
+ *        path from \p from to \p to is stored here, or \c
+ *        IGRAPH_INFINITY if there is no path.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \return Error code.
+ *
+ * Time complexity: O(L), the size of the two labels.
+ */
+
+int igraph_landmark_labeling_distance(const igraph_landmark_labeling_t *ll,
+                                      igraph_real_t *res,
+                                      igraph_integer_t from,
+                                      igraph_integer_t to) {
+    const igraph_vector_int_t *in_start = ll->directed ? &ll->in_start : &ll->out_start;
+    const igraph_integer_t *hub1, *hub2, *dist1, *dist2, *end1, *end2;
+    igraph_integer_t best = -1;
+
+    if (from < 0 || from >= ll->no_of_nodes || to < 0 || to >= ll->no_of_nodes) {
+        IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+    }
+
+    hub1 = VECTOR(ll->out_hub) + VECTOR(ll->out_start)[from];
+    end1 = VECTOR(ll->out_hub) + VECTOR(ll->out_start)[from + 1];
+    dist1 = VECTOR(ll->out_dist) + VECTOR(ll->out_start)[from];
+    hub2 = VECTOR(ll->directed ? ll->in_hub : ll->out_hub) + VECTOR(*in_start)[to];
+    end2 = VECTOR(ll->directed ? ll->in_hub : ll->out_hub) + VECTOR(*in_start)[to + 1];
+    dist2 = VECTOR(ll->directed ? ll->in_dist : ll->out_dist) + VECTOR(*in_start)[to];
+
+    while (hub1 < end1 && hub2 < end2) {
+        if (*hub1 < *hub2) {
+            hub1++; dist1++;
+        } else if (*hub1 > *hub2) {
+            hub2++; dist2++;
+        } else {
+            if (best < 0 || *dist1 + *dist2 < best) {
+                best = *dist1 + *dist2;
+            }
+            hub1++; dist1++;
+            hub2++; dist2++;
+        }
+    }
+
+    *res = best < 0 ? IGRAPH_INFINITY : best;
+    return 0;
+}
+
+/**
+ * \function igraph_landmark_labeling_size
+ * \brief The size of a landmark labeling.
+ *
+ * \param ll The labeling.
+ * \param entries Pointer to a real number or a null pointer. If not
+ *        a null pointer, the total number of (hub, distance) entries
+ *        in the labels is stored here. Divide it by the number of
+ *        vertices for the average label size.
+ * \param bytes Pointer to a real number or a null pointer. If not a
+ *        null pointer, the number of bytes used by the labeling is
+ *        stored here.
+ * \return Error code.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_landmark_labeling_size(const igraph_landmark_labeling_t *ll,
+                                  igraph_real_t *entries,
+                                  igraph_real_t *bytes) {
+    igraph_real_t n = igraph_vector_int_size(&ll->out_hub) +
+                      igraph_vector_int_size(&ll->in_hub);
+    if (entries) {
+        *entries = n;
+    }
+    if (bytes) {
+        *bytes = sizeof(*ll) + sizeof(igraph_integer_t) *
+                 (2 * n + igraph_vector_int_size(&ll->order) +
+                  igraph_vector_int_size(&ll->out_start) +
+                  igraph_vector_int_size(&ll->in_start));
+    }
+    return 0;
+}
+
+/* The file is a header followed by the order, then the starts, hubs
+ * and distances of the 'out' and, for directed labelings, the 'in'
+ * labels. Like igraph_write_graph_binary(), it uses the byte order
+ * and integer size of the machine. */
+
+#define IGRAPH_I_PLL_MAGIC "IGRAPHLL"
+#define IGRAPH_I_PLL_VERSION 1
+#define IGRAPH_I_PLL_BYTEORDER 0x01020304
+
+typedef struct igraph_i_pll_header_t {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteorder;
+    uint32_t intsize;
+    uint32_t directed;
+    int64_t no_of_nodes;
+    int64_t no_of_entries[2];
+} igraph_i_pll_header_t;
+
+static int igraph_i_pll_write(FILE *outstream, const igraph_vector_int_t *v) {
+    size_t n = (size_t) igraph_vector_int_size(v);
+    if (n > 0 && fwrite(VECTOR(*v), sizeof(igraph_integer_t), n, outstream) != n) {
+        IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+    return 0;
+}
+
+static int igraph_i_pll_read(FILE *instream, igraph_vector_int_t *v, long int n) {
+    IGRAPH_CHECK(igraph_vector_int_resize(v, n));
+    if (n > 0 && fread(VECTOR(*v), sizeof(igraph_integer_t), (size_t) n, instream) !=
+        (size_t) n) {
+        IGRAPH_ERROR("Read error, file is truncated", IGRAPH_PARSEERROR);
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_landmark_labeling_write
+ * \brief Saves a landmark labeling to a file.
+ *
+ * The format is binary and not portable: it uses the byte order of
+ * the machine and the size of \type igraph_integer_t, like \ref
+ * igraph_write_graph_binary().
+ *
+ * \param ll The labeling.
+ * \param outstream The stream to write to, it should be writable and
+ *        opened in binary mode.
+ * \return Error code:
+ *         \c IGRAPH_EFILE if there is an error writing the file.
+ *
+ * Time complexity: O(|V|+|L|), the number of vertices and label
+ * entries.
+ */
+
+int igraph_landmark_labeling_write(const igraph_landmark_labeling_t *ll,
+                                   FILE *outstream) {
+    igraph_i_pll_header_t header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, IGRAPH_I_PLL_MAGIC, sizeof(header.magic));
+    header.version = IGRAPH_I_PLL_VERSION;
+    header.byteorder = IGRAPH_I_PLL_BYTEORDER;
+    header.intsize = sizeof(igraph_integer_t);
+    header.directed = ll->directed ? 1 : 0;
+    header.no_of_nodes = ll->no_of_nodes;
+    header.no_of_entries[0] = igraph_vector_int_size(&ll->out_hub);
+    header.no_of_entries[1] = igraph_vector_int_size(&ll->in_hub);
+
+    if (fwrite(&header, sizeof(header), 1, outstream) != 1) {
+        IGRAPH_ERROR("Write error", IGRAPH_EFILE);
+    }
+    IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->order));
+    IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->out_start));
+    IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->out_hub));
+    IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->out_dist));
+    if (ll->directed) {
+        IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->in_start));
+        IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->in_hub));
+        IGRAPH_CHECK(igraph_i_pll_write(outstream, &ll->in_dist));
+    }
+
+    return 0;
+}
+
+/* Checks the labels read from a file, a damaged file must not make a
+   query read out of bounds */
+
+static int igraph_i_pll_validate(const igraph_vector_int_t *start,
+                                 const igraph_vector_int_t *hub,
+                                 long int no_of_nodes) {
+    long int v, i, m = igraph_vector_int_size(hub);
+    if (VECTOR(*start)[0] != 0 || VECTOR(*start)[no_of_nodes] != m) {
+        IGRAPH_ERROR("Invalid landmark labeling file", IGRAPH_PARSEERROR);
+    }
+    for (v = 0; v < no_of_nodes; v++) {
+        if (VECTOR(*start)[v] > VECTOR(*start)[v + 1]) {
+            IGRAPH_ERROR("Invalid landmark labeling file", IGRAPH_PARSEERROR);
+        }
+        for (i = VECTOR(*start)[v] + 1; i < VECTOR(*start)[v + 1]; i++) {
+            if (VECTOR(*hub)[i - 1] >= VECTOR(*hub)[i]) {
+                IGRAPH_ERROR("Invalid landmark labeling file", IGRAPH_PARSEERROR);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_landmark_labeling_read
+ * \brief Loads a landmark labeling from a file.
+ *
+ * \param ll Pointer to an uninitialized labeling, it must be
+ *        destroyed with \ref igraph_landmark_labeling_destroy().
+ * \param instream The stream to read from, it should be opened in
+ *        binary mode.
+ * \return Error code:
+ *         \c IGRAPH_PARSEERROR if the file is not a labeling written
+ *         by \ref igraph_landmark_labeling_write() on a machine with
+ *         the same byte order and integer size.
+ *
+ * Time complexity: O(|V|+|L|), the number of vertices and label
+ * entries.
+ */
+
+int igraph_landmark_labeling_read(igraph_landmark_labeling_t *ll,
+                                  FILE *instream) {
+    igraph_i_pll_header_t header;
+    long int n;
+
+    if (fread(&header, sizeof(header), 1, instream) != 1 ||
+        memcmp(header.magic, IGRAPH_I_PLL_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != IGRAPH_I_PLL_VERSION) {
+        IGRAPH_ERROR("Not a landmark labeling file", IGRAPH_PARSEERROR);
+    }
+    if (header.byteorder != IGRAPH_I_PLL_BYTEORDER ||
+        header.intsize != sizeof(igraph_integer_t)) {
+        IGRAPH_ERROR("Landmark labeling file was written with a different "
+                     "byte order or integer size", IGRAPH_PARSEERROR);
+    }
+    if (header.no_of_nodes < 0 || header.no_of_nodes >= IGRAPH_INTEGER_MAX ||
+        header.no_of_entries[0] < 0 || header.no_of_entries[0] > IGRAPH_INTEGER_MAX ||
+        header.no_of_entries[1] < 0 || header.no_of_entries[1] > IGRAPH_INTEGER_MAX ||
+        (!header.directed && header.no_of_entries[1] != 0)) {
+        IGRAPH_ERROR("Invalid landmark labeling file", IGRAPH_PARSEERROR);
+    }
+
+    IGRAPH_CHECK(igraph_i_landmark_labeling_alloc(ll));
+    IGRAPH_FINALLY(igraph_landmark_labeling_destroy, ll);
+    ll->no_of_nodes = (igraph_integer_t) header.no_of_nodes;
+    ll->directed = header.directed ? 1 : 0;
+    n = (long int) header.no_of_nodes;
+
+    IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->order, n));
+    IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->out_start, n + 1));
+    IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->out_hub, (long int) header.no_of_entries[0]));
+    IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->out_dist, (long int) header.no_of_entries[0]));
+    IGRAPH_CHECK(igraph_i_pll_validate(&ll->out_start, &ll->out_hub, n));
+    if (ll->directed) {
+        IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->in_start, n + 1));
+        IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->in_hub, (long int) header.no_of_entries[1]));
+        IGRAPH_CHECK(igraph_i_pll_read(instream, &ll->in_dist, (long int) header.no_of_entries[1]));
+        IGRAPH_CHECK(igraph_i_pll_validate(&ll->in_start, &ll->in_hub, n));
+    }
+
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
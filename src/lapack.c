@@ -23,6 +23,42 @@
 
 #include "igraph_lapack.h"
 #include "igraph_lapack_internal.h"
+#include "igraph_memory.h"
+
+/* LAPACK works with 'int' integers. If igraph_integer_t is wider than
+   that, then integer vectors are passed to LAPACK via a temporary
+   copy, otherwise they are passed directly. Call
+   igraph_i_lapack_int_end() right after the LAPACK call, it copies
+   the values back and frees the temporary array. */
+
+static int igraph_i_lapack_int_begin(igraph_vector_int_t *v, int **ptr) {
+#if IGRAPH_INTEGER_SIZE == 64
+    long int i, n = igraph_vector_int_size(v);
+    *ptr = igraph_Calloc(n > 0 ? n : 1, int);
+    if (!*ptr) {
+        IGRAPH_ERROR("Cannot call LAPACK", IGRAPH_ENOMEM);
+    }
+    for (i = 0; i < n; i++) {
+        (*ptr)[i] = (int) VECTOR(*v)[i];
+    }
+#else
+    *ptr = VECTOR(*v);
+#endif
+    return 0;
+}
+
+static void igraph_i_lapack_int_end(igraph_vector_int_t *v, int *ptr) {
+#if IGRAPH_INTEGER_SIZE == 64
+    long int i, n = igraph_vector_int_size(v);
+    for (i = 0; i < n; i++) {
+        VECTOR(*v)[i] = ptr[i];
+    }
+    igraph_Free(ptr);
+#else
+    IGRAPH_UNUSED(v);
+    IGRAPH_UNUSED(ptr);
+#endif
+}
 
 /**
  * \function igraph_lapack_dgetrf
@@ -57,6 +93,7 @@ int igraph_lapack_dgetrf(igraph_matrix_t *a, igraph_vector_int_t *ipiv,
     int n = (int) igraph_matrix_ncol(a);
     int lda = m > 0 ? m : 1;
     igraph_vector_int_t *myipiv = ipiv, vipiv;
+    int *ipiv_int;
 
     if (!ipiv) {
         IGRAPH_CHECK(igraph_vector_int_init(&vipiv, m < n ? m : n));
@@ -64,7 +101,9 @@ int igraph_lapack_dgetrf(igraph_matrix_t *a, igraph_vector_int_t *ipiv,
         myipiv = &vipiv;
     }
 
-    igraphdgetrf_(&m, &n, VECTOR(a->data), &lda, VECTOR(*myipiv), info);
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(myipiv, &ipiv_int));
+    igraphdgetrf_(&m, &n, VECTOR(a->data), &lda, ipiv_int, info);
+    igraph_i_lapack_int_end(myipiv, ipiv_int);
 
     if (*info > 0) {
         IGRAPH_WARNING("LU: factor is exactly singular");
@@ -130,6 +169,7 @@ int igraph_lapack_dgetrs(igraph_bool_t transpose, const igraph_matrix_t *a,
     int lda = n > 0 ? n : 1;
     int ldb = n > 0 ? n : 1;
     int info;
+    int *ipiv_int;
 
     if (n != igraph_matrix_ncol(a)) {
         IGRAPH_ERROR("Cannot LU solve matrix", IGRAPH_NONSQUARE);
@@ -138,8 +178,10 @@ int igraph_lapack_dgetrs(igraph_bool_t transpose, const igraph_matrix_t *a,
         IGRAPH_ERROR("Cannot LU solve matrix, RHS of wrong size", IGRAPH_EINVAL);
     }
 
-    igraphdgetrs_(&trans, &n, &nrhs, VECTOR(a->data), &lda, VECTOR(*ipiv),
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(ipiv, &ipiv_int));
+    igraphdgetrs_(&trans, &n, &nrhs, VECTOR(a->data), &lda, ipiv_int,
                   VECTOR(b->data), &ldb, &info);
+    igraph_i_lapack_int_end(ipiv, ipiv_int);
 
     if (info < 0) {
         switch (info) {
@@ -222,6 +264,7 @@ int igraph_lapack_dgesv(igraph_matrix_t *a, igraph_vector_int_t *ipiv,
     int lda = n > 0 ? n : 1;
     int ldb = n > 0 ? n : 1;
     igraph_vector_int_t *myipiv = ipiv, vipiv;
+    int *ipiv_int;
 
     if (n != igraph_matrix_ncol(a)) {
         IGRAPH_ERROR("Cannot LU solve matrix", IGRAPH_NONSQUARE);
@@ -236,8 +279,10 @@ int igraph_lapack_dgesv(igraph_matrix_t *a, igraph_vector_int_t *ipiv,
         myipiv = &vipiv;
     }
 
-    igraphdgesv_(&n, &nrhs, VECTOR(a->data), &lda, VECTOR(*myipiv),
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(myipiv, &ipiv_int));
+    igraphdgesv_(&n, &nrhs, VECTOR(a->data), &lda, ipiv_int,
                  VECTOR(b->data), &ldb, info);
+    igraph_i_lapack_int_end(myipiv, ipiv_int);
 
     if (*info > 0) {
         IGRAPH_WARNING("LU: factor is exactly singular");
@@ -357,6 +402,7 @@ int igraph_lapack_dsyevr(const igraph_matrix_t *A,
     igraph_vector_t work;
     igraph_vector_int_t iwork;
     int lwork = -1, liwork = -1;
+    int *support_int, *iwork_int;
 
     if (n != igraph_matrix_ncol(A)) {
         IGRAPH_ERROR("Cannot find eigenvalues/vectors", IGRAPH_NONSQUARE);
@@ -413,10 +459,20 @@ int igraph_lapack_dsyevr(const igraph_matrix_t *A,
         break;
     }
 
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(mysupport, &support_int));
+#if IGRAPH_INTEGER_SIZE == 64
+    IGRAPH_FINALLY(igraph_free, support_int);
+#endif
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(&iwork, &iwork_int));
+#if IGRAPH_INTEGER_SIZE == 64
+    IGRAPH_FINALLY_CLEAN(1);
+#endif
     igraphdsyevr_(&jobz, &range, &uplo, &n, &MATRIX(Acopy, 0, 0), &lda,
                   &vl, &vu, &il, &iu, &abstol, &m, VECTOR(*myvalues),
-                  vectors ? &MATRIX(*vectors, 0, 0) : 0, &ldz, VECTOR(*mysupport),
-                  VECTOR(work), &lwork, VECTOR(iwork), &liwork, &info);
+                  vectors ? &MATRIX(*vectors, 0, 0) : 0, &ldz, support_int,
+                  VECTOR(work), &lwork, iwork_int, &liwork, &info);
+    igraph_i_lapack_int_end(&iwork, iwork_int);
+    igraph_i_lapack_int_end(mysupport, support_int);
 
     if (info != 0) {
         IGRAPH_ERROR("Invalid argument to dsyevr in workspace query", IGRAPH_EINVAL);
@@ -427,10 +483,20 @@ int igraph_lapack_dsyevr(const igraph_matrix_t *A,
     IGRAPH_CHECK(igraph_vector_resize(&work, lwork));
     IGRAPH_CHECK(igraph_vector_int_resize(&iwork, liwork));
 
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(mysupport, &support_int));
+#if IGRAPH_INTEGER_SIZE == 64
+    IGRAPH_FINALLY(igraph_free, support_int);
+#endif
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(&iwork, &iwork_int));
+#if IGRAPH_INTEGER_SIZE == 64
+    IGRAPH_FINALLY_CLEAN(1);
+#endif
     igraphdsyevr_(&jobz, &range, &uplo, &n, &MATRIX(Acopy, 0, 0), &lda,
                   &vl, &vu, &il, &iu, &abstol, &m, VECTOR(*myvalues),
-                  vectors ? &MATRIX(*vectors, 0, 0) : 0, &ldz, VECTOR(*mysupport),
-                  VECTOR(work), &lwork, VECTOR(iwork), &liwork, &info);
+                  vectors ? &MATRIX(*vectors, 0, 0) : 0, &ldz, support_int,
+                  VECTOR(work), &lwork, iwork_int, &liwork, &info);
+    igraph_i_lapack_int_end(&iwork, iwork_int);
+    igraph_i_lapack_int_end(mysupport, support_int);
 
     if (info != 0) {
         IGRAPH_ERROR("Invalid argument to dsyevr in calculation", IGRAPH_EINVAL);
@@ -744,6 +810,7 @@ int igraph_lapack_dgeevx(igraph_lapack_dgeevx_balance_t balance,
     int lda = n, ldvl = n, ldvr = n, lwork = -1;
     igraph_vector_t work;
     igraph_vector_int_t iwork;
+    int *iwork_int;
     igraph_matrix_t Acopy;
     int error = *info;
     igraph_vector_t *myreal = valuesreal, *myimag = valuesimag, vreal, vimag;
@@ -813,6 +880,7 @@ int igraph_lapack_dgeevx(igraph_lapack_dgeevx_balance_t balance,
         IGRAPH_CHECK(igraph_matrix_resize(vectorsright, n, n));
     }
 
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(&iwork, &iwork_int));
     igraphdgeevx_(&balanc, &jobvl, &jobvr, &sense, &n, &MATRIX(Acopy, 0, 0),
                   &lda, VECTOR(*myreal), VECTOR(*myimag),
                   vectorsleft  ? &MATRIX(*vectorsleft, 0, 0) : 0, &ldvl,
@@ -820,11 +888,13 @@ int igraph_lapack_dgeevx(igraph_lapack_dgeevx_balance_t balance,
                   ilo, ihi, VECTOR(*myscale), abnrm,
                   rconde ? VECTOR(*rconde) : 0,
                   rcondv ? VECTOR(*rcondv) : 0,
-                  VECTOR(work), &lwork, VECTOR(iwork), info);
+                  VECTOR(work), &lwork, iwork_int, info);
+    igraph_i_lapack_int_end(&iwork, iwork_int);
 
     lwork = (int) VECTOR(work)[0];
     IGRAPH_CHECK(igraph_vector_resize(&work, lwork));
 
+    IGRAPH_CHECK(igraph_i_lapack_int_begin(&iwork, &iwork_int));
     igraphdgeevx_(&balanc, &jobvl, &jobvr, &sense, &n, &MATRIX(Acopy, 0, 0),
                   &lda, VECTOR(*myreal), VECTOR(*myimag),
                   vectorsleft  ? &MATRIX(*vectorsleft, 0, 0) : 0, &ldvl,
@@ -832,7 +902,8 @@ int igraph_lapack_dgeevx(igraph_lapack_dgeevx_balance_t balance,
                   ilo, ihi, VECTOR(*myscale), abnrm,
                   rconde ? VECTOR(*rconde) : 0,
                   rcondv ? VECTOR(*rcondv) : 0,
-                  VECTOR(work), &lwork, VECTOR(iwork), info);
+                  VECTOR(work), &lwork, iwork_int, info);
+    igraph_i_lapack_int_end(&iwork, iwork_int);
 
     if (*info < 0) {
         IGRAPH_ERROR("Cannot calculate eigenvalues (dgeev)", IGRAPH_ELAPACK);
@@ -45,7 +45,7 @@ AP     *ap_create_problem_from_matrix(double **t, int n);
 AP     *ap_read_problem(char *file);
 void    ap_free(AP *p);
 
-int     ap_assignment(AP *p, int *res);
+int     ap_assignment(AP *p, igraph_integer_t *res);
 int     ap_costmatrix(AP *p, double **m);
 int     ap_datamatrix(AP *p, double **m);
 int     ap_iterations(AP *p);
@@ -134,7 +134,7 @@ int ap_hungarian(AP *p) {
 }
 
 /* abbreviated interface */
-int ap_assignment(AP *p, int *res) {
+int ap_assignment(AP *p, igraph_integer_t *res) {
     int i;
 
     if (p->s == NULL) {
@@ -27,6 +27,12 @@
 #include "igraph_iterators.h"
 #include "igraph_adjlist.h"
 #include "igraph_stack.h"
+#include "igraph_paths.h"
+#include "igraph_types_internal.h"
+#include "igraph_math.h"
+#include "structural_properties_internal.h"
+
+#include <math.h>
 
 /**
  * \function igraph_get_all_simple_paths
@@ -116,7 +122,7 @@ int igraph_get_all_simple_paths(const igraph_t *graph,
         int curdist = igraph_vector_int_tail(&dist);
         igraph_vector_t *neis = igraph_lazy_adjlist_get(&adjlist, act);
         int n = igraph_vector_size(neis);
-        int *ptr = igraph_vector_int_e_ptr(&nptr, act);
+        igraph_integer_t *ptr = igraph_vector_int_e_ptr(&nptr, act);
         igraph_bool_t any;
         igraph_bool_t within_dist;
         int nei;
@@ -173,3 +179,512 @@ int igraph_get_all_simple_paths(const igraph_t *graph,
 
     return 0;
 }
+
+/* State of the point-to-point searches. Only the vertices that the
+ * search reaches get a slot, the slot of a vertex is found through an
+ * open addressing hash table, so a query costs time and memory in
+ * proportion to the explored region, not to the size of the graph.
+ * Direction 0 is the search from the source, direction 1 the search
+ * from the target of bidirectional Dijkstra. The heaps are max-heaps
+ * of the negated keys with lazy deletion: an outdated entry of a
+ * vertex is skipped when it is popped. */
+
+typedef struct igraph_i_p2p_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_vector_int_t table;      /* slot + 1 of a vertex, or zero */
+    igraph_vector_int_t vertex;     /* vertex of a slot */
+    igraph_vector_t dist[2];
+    igraph_vector_int_t pred[2];    /* edge to the predecessor, or -1 */
+    igraph_vector_char_t done[2];
+    igraph_vector_t potential;      /* A* heuristic of a slot */
+    igraph_indheap_t heap[2];
+} igraph_i_p2p_t;
+
+static void igraph_i_p2p_destroy(igraph_i_p2p_t *state) {
+    int d;
+    igraph_vector_int_destroy(&state->table);
+    igraph_vector_int_destroy(&state->vertex);
+    for (d = 0; d < 2; d++) {
+        igraph_vector_destroy(&state->dist[d]);
+        igraph_vector_int_destroy(&state->pred[d]);
+        igraph_vector_char_destroy(&state->done[d]);
+        igraph_indheap_destroy(&state->heap[d]);
+    }
+    igraph_vector_destroy(&state->potential);
+}
+
+static int igraph_i_p2p_init(igraph_i_p2p_t *state, const igraph_t *graph,
+                             const igraph_vector_t *weights) {
+    int d;
+
+    state->graph = graph;
+    state->weights = weights;
+    IGRAPH_CHECK(igraph_vector_int_init(&state->table, 64));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &state->table);
+    IGRAPH_CHECK(igraph_vector_int_init(&state->vertex, 0));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &state->vertex);
+    IGRAPH_VECTOR_INIT_FINALLY(&state->potential, 0);
+    for (d = 0; d < 2; d++) {
+        IGRAPH_VECTOR_INIT_FINALLY(&state->dist[d], 0);
+        IGRAPH_CHECK(igraph_vector_int_init(&state->pred[d], 0));
+        IGRAPH_FINALLY(igraph_vector_int_destroy, &state->pred[d]);
+        IGRAPH_CHECK(igraph_vector_char_init(&state->done[d], 0));
+        IGRAPH_FINALLY(igraph_vector_char_destroy, &state->done[d]);
+        IGRAPH_CHECK(igraph_indheap_init(&state->heap[d], 0));
+        IGRAPH_FINALLY(igraph_indheap_destroy, &state->heap[d]);
+    }
+    IGRAPH_FINALLY_CLEAN(11);
+
+    return 0;
+}
+
+static long int igraph_i_p2p_hash(const igraph_i_p2p_t *state, long int vertex) {
+    unsigned long int h = (unsigned long int) vertex * 2654435761UL;
+    return (long int) (h & (unsigned long int) (igraph_vector_int_size(&state->table) - 1));
+}
+
+/* The slot of 'vertex', a new one with infinite distances if it was not
+   reached yet */
+
+static int igraph_i_p2p_slot(igraph_i_p2p_t *state, long int vertex,
+                             long int *slot) {
+    long int size = igraph_vector_int_size(&state->table);
+    long int h = igraph_i_p2p_hash(state, vertex), n, i;
+    int d;
+
+    while (VECTOR(state->table)[h] != 0) {
+        *slot = VECTOR(state->table)[h] - 1;
+        if (VECTOR(state->vertex)[*slot] == vertex) {
+            return 0;
+        }
+        h = (h + 1) & (size - 1);
+    }
+
+    *slot = n = igraph_vector_int_size(&state->vertex);
+    IGRAPH_CHECK(igraph_vector_int_push_back(&state->vertex, vertex));
+    for (d = 0; d < 2; d++) {
+        IGRAPH_CHECK(igraph_vector_push_back(&state->dist[d], IGRAPH_INFINITY));
+        IGRAPH_CHECK(igraph_vector_int_push_back(&state->pred[d], -1));
+        IGRAPH_CHECK(igraph_vector_char_push_back(&state->done[d], 0));
+    }
+    VECTOR(state->table)[h] = n + 1;
+
+    /* Keep the table at most half full */
+    if (2 * (n + 1) > size) {
+        IGRAPH_CHECK(igraph_vector_int_resize(&state->table, 2 * size));
+        igraph_vector_int_null(&state->table);
+        for (i = 0; i <= n; i++) {
+            h = igraph_i_p2p_hash(state, VECTOR(state->vertex)[i]);
+            while (VECTOR(state->table)[h] != 0) {
+                h = (h + 1) & (2 * size - 1);
+            }
+            VECTOR(state->table)[h] = i + 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Pops the closest vertex of a direction that is not done yet, -1 if
+   there is none */
+
+static long int igraph_i_p2p_pop(igraph_i_p2p_t *state, int d) {
+    while (!igraph_indheap_empty(&state->heap[d])) {
+        long int slot = igraph_indheap_max_index(&state->heap[d]);
+        igraph_indheap_delete_max(&state->heap[d]);
+        if (!VECTOR(state->done[d])[slot]) {
+            VECTOR(state->done[d])[slot] = 1;
+            return slot;
+        }
+    }
+    return -1;
+}
+
+/* Smallest key in the heap of a direction, outdated entries are
+   dropped first */
+
+static igraph_real_t igraph_i_p2p_top(igraph_i_p2p_t *state, int d) {
+    while (!igraph_indheap_empty(&state->heap[d])) {
+        long int slot = igraph_indheap_max_index(&state->heap[d]);
+        if (!VECTOR(state->done[d])[slot]) {
+            return -igraph_indheap_max(&state->heap[d]);
+        }
+        igraph_indheap_delete_max(&state->heap[d]);
+    }
+    return IGRAPH_INFINITY;
+}
+
+/* Writes the path through the slot 'meet': the predecessors of the
+   forward search lead back to the source, the ones of the backward
+   search on to the target */
+
+static int igraph_i_p2p_path(igraph_i_p2p_t *state, long int meet,
+                             igraph_vector_t *vertices, igraph_vector_t *edges) {
+    const igraph_t *graph = state->graph;
+    long int slot, v, e, i, n;
+
+    if (vertices) {
+        igraph_vector_clear(vertices);
+    }
+    if (edges) {
+        igraph_vector_clear(edges);
+    }
+
+    /* From the meeting vertex back to the source, reversed below */
+    for (slot = meet; ; ) {
+        v = VECTOR(state->vertex)[slot];
+        e = VECTOR(state->pred[0])[slot];
+        if (vertices) {
+            IGRAPH_CHECK(igraph_vector_push_back(vertices, v));
+        }
+        if (e < 0) {
+            break;
+        }
+        if (edges) {
+            IGRAPH_CHECK(igraph_vector_push_back(edges, e));
+        }
+        IGRAPH_CHECK(igraph_i_p2p_slot(state, IGRAPH_OTHER(graph, e, v), &slot));
+    }
+    if (vertices) {
+        n = igraph_vector_size(vertices);
+        for (i = 0; i < n / 2; i++) {
+            igraph_real_t tmp = VECTOR(*vertices)[i];
+            VECTOR(*vertices)[i] = VECTOR(*vertices)[n - 1 - i];
+            VECTOR(*vertices)[n - 1 - i] = tmp;
+        }
+    }
+    if (edges) {
+        n = igraph_vector_size(edges);
+        for (i = 0; i < n / 2; i++) {
+            igraph_real_t tmp = VECTOR(*edges)[i];
+            VECTOR(*edges)[i] = VECTOR(*edges)[n - 1 - i];
+            VECTOR(*edges)[n - 1 - i] = tmp;
+        }
+    }
+
+    /* From the meeting vertex on to the target */
+    for (slot = meet; ; ) {
+        v = VECTOR(state->vertex)[slot];
+        e = VECTOR(state->pred[1])[slot];
+        if (e < 0) {
+            break;
+        }
+        if (edges) {
+            IGRAPH_CHECK(igraph_vector_push_back(edges, e));
+        }
+        v = IGRAPH_OTHER(graph, e, v);
+        if (vertices) {
+            IGRAPH_CHECK(igraph_vector_push_back(vertices, v));
+        }
+        IGRAPH_CHECK(igraph_i_p2p_slot(state, v, &slot));
+    }
+
+    return 0;
+}
+
+static int igraph_i_p2p_check(const igraph_t *graph, igraph_integer_t from,
+                              igraph_integer_t to,
+                              const igraph_vector_t *weights,
+                              igraph_neimode_t mode) {
+    igraph_integer_t no_of_nodes = igraph_vcount(graph);
+    igraph_integer_t no_of_edges = igraph_ecount(graph);
+
+    if (from < 0 || from >= no_of_nodes || to < 0 || to >= no_of_nodes) {
+        IGRAPH_ERROR("Invalid vertex id", IGRAPH_EINVVID);
+    }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
+    if (weights) {
+        if (igraph_vector_size(weights) != no_of_edges) {
+            IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
+        }
+        if (no_of_edges > 0) {
+            igraph_real_t min = igraph_vector_min(weights);
+            if (min < 0) {
+                IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
+            } else if (igraph_is_nan(min)) {
+                IGRAPH_ERROR("Weight vector must not contain NaN values", IGRAPH_EINVAL);
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Relaxes the edges of 'slot' in direction 'd', following 'mode'. For
+   A* the keys include the potential of the vertices. */
+
+static int igraph_i_p2p_relax(igraph_i_p2p_t *state, int d, long int slot,
+                              igraph_neimode_t mode,
+                              igraph_astar_heuristic_func_t *heuristic,
+                              igraph_integer_t to, void *extra,
+                              igraph_real_t *best, long int *meet) {
+    const igraph_t *graph = state->graph;
+    long int v = VECTOR(state->vertex)[slot];
+    igraph_real_t dv = VECTOR(state->dist[d])[slot];
+    int pass;
+
+    for (pass = 0; pass < 2; pass++) {
+        igraph_integer_t begin, end, k;
+        if (pass == 0 && (mode & IGRAPH_OUT)) {
+            begin = VECTOR(graph->os)[v]; end = VECTOR(graph->os)[v + 1];
+        } else if (pass == 1 && (mode & IGRAPH_IN)) {
+            begin = VECTOR(graph->is)[v]; end = VECTOR(graph->is)[v + 1];
+        } else {
+            continue;
+        }
+        for (k = begin; k < end; k++) {
+            long int e = pass == 0 ? VECTOR(graph->oi)[k] : VECTOR(graph->ii)[k];
+            long int u = pass == 0 ? VECTOR(graph->to)[e] : VECTOR(graph->from)[e];
+            igraph_real_t alt = dv + (state->weights ? VECTOR(*state->weights)[e] : 1);
+            long int us, n = igraph_vector_int_size(&state->vertex);
+
+            IGRAPH_CHECK(igraph_i_p2p_slot(state, u, &us));
+            if (heuristic && us == n) {
+                igraph_real_t h;
+                IGRAPH_CHECK(heuristic(&h, (igraph_integer_t) u, to, extra));
+                IGRAPH_CHECK(igraph_vector_push_back(&state->potential, h));
+            }
+            if (alt < VECTOR(state->dist[d])[us]) {
+                igraph_real_t key = alt;
+                VECTOR(state->dist[d])[us] = alt;
+                VECTOR(state->pred[d])[us] = e;
+                /* A* reopens vertices if the heuristic is not consistent */
+                VECTOR(state->done[d])[us] = 0;
+                if (heuristic) {
+                    key += VECTOR(state->potential)[us];
+                }
+                IGRAPH_CHECK(igraph_indheap_push_with_index(&state->heap[d], us, -key));
+            }
+            if (!heuristic && VECTOR(state->dist[d])[us] + VECTOR(state->dist[1 - d])[us] < *best) {
+                *best = VECTOR(state->dist[d])[us] + VECTOR(state->dist[1 - d])[us];
+                *meet = us;
+            }
+        }
+    }
+
+    return 0;
+}
+
+/* Bidirectional Dijkstra. The searches take turns by the smaller key,
+ * and stop when the two smallest keys together are at least as long as
+ * the best path found so far, no path through the unfinished vertices
+ * can be shorter then. */
+
+int igraph_i_get_shortest_path_bidijkstra(const igraph_t *graph,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode) {
+
+    igraph_i_p2p_t state;
+    igraph_neimode_t modes[2];
+    igraph_real_t best = IGRAPH_INFINITY;
+    long int meet = -1, slot;
+
+    IGRAPH_CHECK(igraph_i_p2p_check(graph, from, to, weights, mode));
+    if (!igraph_is_directed(graph)) {
+        mode = IGRAPH_ALL;
+    }
+    modes[0] = mode;
+    modes[1] = mode == IGRAPH_OUT ? IGRAPH_IN : (mode == IGRAPH_IN ? IGRAPH_OUT : IGRAPH_ALL);
+
+    IGRAPH_CHECK(igraph_i_p2p_init(&state, graph, weights));
+    IGRAPH_FINALLY(igraph_i_p2p_destroy, &state);
+
+    IGRAPH_CHECK(igraph_i_p2p_slot(&state, from, &slot));
+    VECTOR(state.dist[0])[slot] = 0;
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&state.heap[0], slot, 0));
+    IGRAPH_CHECK(igraph_i_p2p_slot(&state, to, &slot));
+    VECTOR(state.dist[1])[slot] = 0;
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&state.heap[1], slot, 0));
+    if (from == to) {
+        best = 0;
+        meet = slot;
+    }
+
+    while (1) {
+        igraph_real_t top0 = igraph_i_p2p_top(&state, 0);
+        igraph_real_t top1 = igraph_i_p2p_top(&state, 1);
+        int d = top0 <= top1 ? 0 : 1;
+        if (top0 == IGRAPH_INFINITY || top1 == IGRAPH_INFINITY ||
+            top0 + top1 >= best) {
+            break;
+        }
+        IGRAPH_ALLOW_INTERRUPTION();
+        slot = igraph_i_p2p_pop(&state, d);
+        IGRAPH_CHECK(igraph_i_p2p_relax(&state, d, slot, modes[d], 0, to, 0,
+                                        &best, &meet));
+    }
+
+    if (meet < 0) {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        if (vertices) {
+            igraph_vector_clear(vertices);
+        }
+        if (edges) {
+            igraph_vector_clear(edges);
+        }
+    } else {
+        IGRAPH_CHECK(igraph_i_p2p_path(&state, meet, vertices, edges));
+    }
+
+    igraph_i_p2p_destroy(&state);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_get_shortest_path_astar
+ * A* search for a shortest path from one vertex to another one.
+ *
+ * A* is Dijkstra's algorithm that visits the vertices in the order of
+ * their distance from the source plus a heuristic estimate of their
+ * distance to the target, so it moves towards the target and usually
+ * explores a much smaller part of the graph. The result is a shortest
+ * path if the heuristic is admissible, i.e. it never overestimates
+ * the distance to the target. If the heuristic is also consistent,
+ * i.e. it does not decrease by more than the weight of an edge along
+ * the edge, then every vertex is visited at most once. A heuristic
+ * that is always zero gives Dijkstra's algorithm.
+ *
+ * </para><para>
+ * The search only allocates memory for the vertices that it reaches,
+ * so many queries on a large graph are cheap.
+ *
+ * \param graph The input graph, it can be directed or undirected.
+ * \param vertices Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the vertex ids along
+ *        the path are stored here, including the source and target
+ *        vertices.
+ * \param edges Pointer to an initialized vector or a null
+ *        pointer. If not a null pointer, then the edge ids along the
+ *        path are stored here.
+ * \param from The id of the source vertex.
+ * \param to The id of the target vertex.
+ * \param weights Vector of non-negative edge weights, in the order
+ *        of edge ids, or a null pointer for unit weights.
+ * \param mode A constant specifying how edge directions are
+ *        considered in directed graphs. \c IGRAPH_OUT follows edge
+ *        directions, \c IGRAPH_IN follows the opposite directions,
+ *        and \c IGRAPH_ALL ignores edge directions. This argument is
+ *        ignored for undirected graphs.
+ * \param heuristic The heuristic function, see \ref
+ *        igraph_astar_heuristic_func_t. It is called once for every
+ *        reached vertex. \ref igraph_astar_heuristic_euclidean() uses
+ *        the coordinates of the vertices.
+ * \param extra Extra argument passed to \p heuristic.
+ * \return Error code. If the target cannot be reached, a warning is
+ *        given and the vectors are empty.
+ *
+ * Time complexity: O(|E|log|E|+|V|) in the worst case, |V| is the
+ * number of vertices, |E| is the number of edges in the graph,
+ * usually much less.
+ *
+ * \sa \ref igraph_get_shortest_path_dijkstra(), which runs a
+ * bidirectional search without a heuristic.
+ *
+ * \example examples/simple/igraph_get_shortest_path_astar.c
+ */
+
+int igraph_get_shortest_path_astar(const igraph_t *graph,
+                                   igraph_vector_t *vertices,
+                                   igraph_vector_t *edges,
+                                   igraph_integer_t from,
+                                   igraph_integer_t to,
+                                   const igraph_vector_t *weights,
+                                   igraph_neimode_t mode,
+                                   igraph_astar_heuristic_func_t *heuristic,
+                                   void *extra) {
+
+    igraph_i_p2p_t state;
+    igraph_real_t best = IGRAPH_INFINITY, h;
+    long int meet = -1, slot;
+
+    IGRAPH_CHECK(igraph_i_p2p_check(graph, from, to, weights, mode));
+    if (!heuristic) {
+        IGRAPH_ERROR("A heuristic function is needed", IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_i_p2p_init(&state, graph, weights));
+    IGRAPH_FINALLY(igraph_i_p2p_destroy, &state);
+
+    IGRAPH_CHECK(igraph_i_p2p_slot(&state, from, &slot));
+    IGRAPH_CHECK(heuristic(&h, from, to, extra));
+    IGRAPH_CHECK(igraph_vector_push_back(&state.potential, h));
+    VECTOR(state.dist[0])[slot] = 0;
+    IGRAPH_CHECK(igraph_indheap_push_with_index(&state.heap[0], slot, -h));
+
+    while ((slot = igraph_i_p2p_pop(&state, 0)) >= 0) {
+        if (VECTOR(state.vertex)[slot] == to) {
+            meet = slot;
+            break;
+        }
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_p2p_relax(&state, 0, slot,
+                                        igraph_is_directed(graph) ? mode : IGRAPH_ALL,
+                                        heuristic, to, extra, &best, &meet));
+    }
+
+    if (meet < 0) {
+        IGRAPH_WARNING("Couldn't reach some vertices");
+        if (vertices) {
+            igraph_vector_clear(vertices);
+        }
+        if (edges) {
+            igraph_vector_clear(edges);
+        }
+    } else {
+        IGRAPH_CHECK(igraph_i_p2p_path(&state, meet, vertices, edges));
+    }
+
+    igraph_i_p2p_destroy(&state);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/**
+ * \function igraph_astar_heuristic_euclidean
+ * A* heuristic from vertex coordinates.
+ *
+ * This function can be passed to \ref igraph_get_shortest_path_astar()
+ * as the heuristic. It is the Euclidean distance of the vertices,
+ * which is admissible and consistent if no edge is lighter than the
+ * distance of its endpoints, e.g. if the weights are road lengths and
+ * the coordinates are planar positions in the same unit.
+ *
+ * \param result The heuristic is stored here.
+ * \param from The vertex whose distance is estimated.
+ * \param to The target vertex.
+ * \param extra Pointer to an \type igraph_matrix_t, row i holds the
+ *        coordinates of vertex i, in any number of dimensions.
+ * \return Error code.
+ *
+ * Time complexity: O(d), the number of dimensions.
+ */
+
+int igraph_astar_heuristic_euclidean(igraph_real_t *result,
+                                     igraph_integer_t from,
+                                     igraph_integer_t to,
+                                     void *extra) {
+    const igraph_matrix_t *coords = (const igraph_matrix_t *) extra;
+    long int j, dim = igraph_matrix_ncol(coords);
+    igraph_real_t sum = 0;
+
+    if (from >= igraph_matrix_nrow(coords) || to >= igraph_matrix_nrow(coords)) {
+        IGRAPH_ERROR("Missing vertex coordinates", IGRAPH_EINVAL);
+    }
+    for (j = 0; j < dim; j++) {
+        igraph_real_t d = MATRIX(*coords, from, j) - MATRIX(*coords, to, j);
+        sum += d * d;
+    }
+    *result = sqrt(sum);
+
+    return 0;
+}
@@ -22,6 +22,7 @@
 */
 
 #include "igraph_progress.h"
+#include "igraph_threading_internal.h"
 #include "config.h"
 
 static IGRAPH_THREAD_LOCAL igraph_progress_handler_t *igraph_i_progress_handler = 0;
@@ -52,8 +53,16 @@ static IGRAPH_THREAD_LOCAL char igraph_i_progressmsg_buffer[1000];
  */
 
 int igraph_progress(const char *message, igraph_real_t percent, void *data) {
+    igraph_i_parallel_context_t *ctx = igraph_i_parallel_context();
+    if (ctx && !igraph_i_parallel_is_caller(ctx)) {
+        /* Only the calling thread of a parallel region reports progress */
+        return igraph_i_parallel_cancelled(ctx) ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+    }
     if (igraph_i_progress_handler) {
         if (igraph_i_progress_handler(message, percent, data) != IGRAPH_SUCCESS) {
+            if (ctx) {
+                igraph_i_parallel_interrupt(ctx);
+            }
             return IGRAPH_INTERRUPTED;
         }
     }
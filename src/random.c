@@ -28,10 +28,12 @@
 #include <math.h>
 #include <limits.h>
 #include <string.h>
+#include <stdint.h>
 #include "igraph_math.h"
 #include "igraph_types.h"
 #include "igraph_vector.h"
 #include "igraph_memory.h"
+#include "igraph_random_internal.h"
 #include "igraph_matrix.h"
 
 /**
@@ -241,7 +243,9 @@ const igraph_rng_type_t igraph_rngtype_glibc2 = {
     /* get_geom= */  0,
     /* get_binom= */ 0,
     /* get_exp= */   0,
-    /* get_gamma= */ 0
+    /* get_gamma= */ 0,
+    /* seed_stream= */ 0,
+    /* fill_real= */ 0
 };
 
 /* ------------------------------------ */
@@ -318,7 +322,9 @@ const igraph_rng_type_t igraph_rngtype_rand = {
     /* get_geom= */  0,
     /* get_binom= */ 0,
     /* get_exp= */   0,
-    /* get_gamma= */ 0
+    /* get_gamma= */ 0,
+    /* seed_stream= */ 0,
+    /* fill_real= */ 0
 };
 
 /* ------------------------------------ */
@@ -472,7 +478,9 @@ const igraph_rng_type_t igraph_rngtype_mt19937 = {
     /* get_geom= */  0,
     /* get_binom= */ 0,
     /* get_exp= */   0,
-    /* get_gamma= */ 0
+    /* get_gamma= */ 0,
+    /* seed_stream= */ 0,
+    /* fill_real= */ 0
 };
 
 #undef N
@@ -480,6 +488,317 @@ const igraph_rng_type_t igraph_rngtype_mt19937 = {
 
 /* ------------------------------------ */
 
+#define PHILOX_M0 0xD2511F53UL
+#define PHILOX_M1 0xCD9E8D57UL
+#define PHILOX_W0 0x9E3779B9UL
+#define PHILOX_W1 0xBB67AE85UL
+
+typedef struct {
+    uint32_t key[2];
+    uint32_t counter[4];    /* block number, then the stream */
+    uint32_t output[4];
+    int next;               /* the next unused element of 'output' */
+} igraph_i_rng_philox_state_t;
+
+static void igraph_i_rng_philox_block(igraph_i_rng_philox_state_t *state) {
+    uint32_t c0 = state->counter[0], c1 = state->counter[1];
+    uint32_t c2 = state->counter[2], c3 = state->counter[3];
+    uint32_t k0 = state->key[0], k1 = state->key[1];
+    int round;
+
+    for (round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t) PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t) PHILOX_M1 * c2;
+        c0 = (uint32_t) (p1 >> 32) ^ c1 ^ k0;
+        c1 = (uint32_t) p1;
+        c2 = (uint32_t) (p0 >> 32) ^ c3 ^ k1;
+        c3 = (uint32_t) p0;
+        k0 += (uint32_t) PHILOX_W0;
+        k1 += (uint32_t) PHILOX_W1;
+    }
+
+    state->output[0] = c0;
+    state->output[1] = c1;
+    state->output[2] = c2;
+    state->output[3] = c3;
+    state->next = 0;
+
+    if (++state->counter[0] == 0) {
+        state->counter[1]++;
+    }
+}
+
+unsigned long int igraph_rng_philox4x32_get(void *vstate) {
+    igraph_i_rng_philox_state_t *state = vstate;
+    if (state->next == 4) {
+        igraph_i_rng_philox_block(state);
+    }
+    return state->output[state->next++];
+}
+
+igraph_real_t igraph_rng_philox4x32_get_real(void *vstate) {
+    /* 53 random bits */
+    unsigned long int a = igraph_rng_philox4x32_get(vstate) >> 5;
+    unsigned long int b = igraph_rng_philox4x32_get(vstate) >> 6;
+    return (a * 67108864.0 + b) / 9007199254740992.0;
+}
+
+void igraph_rng_philox4x32_fill_real(void *vstate, igraph_real_t *res,
+                                     long int n) {
+    long int i;
+    for (i = 0; i < n; i++) {
+        res[i] = igraph_rng_philox4x32_get_real(vstate);
+    }
+}
+
+/* Inversion, this does not need the state of the R samplers, so it
+   can be used on several threads at the same time */
+
+igraph_real_t igraph_rng_philox4x32_get_geom(void *vstate, igraph_real_t p) {
+    if (p == 1.0) {
+        return 0.0;
+    }
+    return floor(log(1.0 - igraph_rng_philox4x32_get_real(vstate)) / log1p(-p));
+}
+
+igraph_real_t igraph_rng_philox4x32_get_exp(void *vstate, igraph_real_t rate) {
+    return -log(1.0 - igraph_rng_philox4x32_get_real(vstate)) / rate;
+}
+
+int igraph_rng_philox4x32_seed_stream(void *vstate, unsigned long int seed,
+                                      igraph_integer_t stream) {
+    igraph_i_rng_philox_state_t *state = vstate;
+    uint64_t s = seed, t = (uint64_t) stream;
+    state->key[0] = (uint32_t) s;
+    state->key[1] = (uint32_t) (s >> 32);
+    state->counter[0] = 0;
+    state->counter[1] = 0;
+    state->counter[2] = (uint32_t) t;
+    state->counter[3] = (uint32_t) (t >> 32);
+    state->next = 4;
+    return 0;
+}
+
+int igraph_rng_philox4x32_seed(void *vstate, unsigned long int seed) {
+    return igraph_rng_philox4x32_seed_stream(vstate, seed, 0);
+}
+
+int igraph_rng_philox4x32_init(void **state) {
+    igraph_i_rng_philox_state_t *st;
+
+    st = igraph_Calloc(1, igraph_i_rng_philox_state_t);
+    if (!st) {
+        IGRAPH_ERROR("Cannot initialize RNG", IGRAPH_ENOMEM);
+    }
+    (*state) = st;
+
+    igraph_rng_philox4x32_seed(st, 0);
+
+    return 0;
+}
+
+void igraph_rng_philox4x32_destroy(void *vstate) {
+    igraph_i_rng_philox_state_t *state =
+        (igraph_i_rng_philox_state_t*) vstate;
+    igraph_Free(state);
+}
+
+/**
+ * \var igraph_rngtype_philox4x32
+ * \brief The Philox4x32-10 counter-based random number generator
+ *
+ * Philox is a counter-based generator of Salmon, Moraes, Dror and
+ * Shaw: the n-th block of four 32 bit outputs is a ten-round bijective
+ * function of n, keyed by the seed. There is no state to advance
+ * sequentially, so it is cheap to start any number of independent
+ * streams: \ref igraph_rng_seed_stream() stores the stream number in
+ * the upper half of the 128 bit counter. Each stream has a period of
+ * 2^66 numbers, and different streams or seeds never overlap.
+ *
+ * </para><para>
+ * This makes it the generator of choice for parallel code: a work
+ * item can seed its own generator with the same seed and its own
+ * index, and the numbers it gets do not depend on which thread
+ * runs it or when.
+ *
+ * </para><para>
+ * The uniform reals from this generator have 53 random bits.
+ * Geometric and exponential random numbers are generated by
+ * inversion.
+ *
+ * </para><para>
+ * For more information see,
+ * John K. Salmon, Mark A. Moraes, Ron O. Dror and David E. Shaw:
+ * Parallel random numbers: as easy as 1, 2, 3. Proceedings of the
+ * International Conference for High Performance Computing,
+ * Networking, Storage and Analysis (SC11), 2011.
+ */
+
+const igraph_rng_type_t igraph_rngtype_philox4x32 = {
+    /* name= */      "PHILOX4X32",
+    /* min=  */      0,
+    /* max=  */      0xffffffffUL,
+    /* init= */      igraph_rng_philox4x32_init,
+    /* destroy= */   igraph_rng_philox4x32_destroy,
+    /* seed= */      igraph_rng_philox4x32_seed,
+    /* get= */       igraph_rng_philox4x32_get,
+    /* get_real= */  igraph_rng_philox4x32_get_real,
+    /* get_norm= */  0,
+    /* get_geom= */  igraph_rng_philox4x32_get_geom,
+    /* get_binom= */ 0,
+    /* get_exp= */   igraph_rng_philox4x32_get_exp,
+    /* get_gamma= */ 0,
+    /* seed_stream= */ igraph_rng_philox4x32_seed_stream,
+    /* fill_real= */ igraph_rng_philox4x32_fill_real
+};
+
+#undef PHILOX_M0
+#undef PHILOX_M1
+#undef PHILOX_W0
+#undef PHILOX_W1
+
+/* ------------------------------------ */
+
+typedef struct {
+    uint64_t s[4];
+} igraph_i_rng_xoshiro256ss_state_t;
+
+#define ROTL(x, k) (((x) << (k)) | ((x) >> (64 - (k))))
+
+static uint64_t igraph_i_rng_xoshiro256ss_next(
+    igraph_i_rng_xoshiro256ss_state_t *state) {
+    uint64_t *s = state->s;
+    uint64_t result = ROTL(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ROTL(s[3], 45);
+
+    return result;
+}
+
+#undef ROTL
+
+unsigned long int igraph_rng_xoshiro256ss_get(void *vstate) {
+    return (unsigned long int) (igraph_i_rng_xoshiro256ss_next(vstate) >> 32);
+}
+
+igraph_real_t igraph_rng_xoshiro256ss_get_real(void *vstate) {
+    return (igraph_i_rng_xoshiro256ss_next(vstate) >> 11) *
+           (1.0 / 9007199254740992.0);
+}
+
+void igraph_rng_xoshiro256ss_fill_real(void *vstate, igraph_real_t *res,
+                                       long int n) {
+    igraph_i_rng_xoshiro256ss_state_t *state = vstate;
+    long int i;
+    for (i = 0; i < n; i++) {
+        res[i] = (igraph_i_rng_xoshiro256ss_next(state) >> 11) *
+                 (1.0 / 9007199254740992.0);
+    }
+}
+
+igraph_real_t igraph_rng_xoshiro256ss_get_geom(void *vstate, igraph_real_t p) {
+    if (p == 1.0) {
+        return 0.0;
+    }
+    return floor(log(1.0 - igraph_rng_xoshiro256ss_get_real(vstate)) / log1p(-p));
+}
+
+igraph_real_t igraph_rng_xoshiro256ss_get_exp(void *vstate, igraph_real_t rate) {
+    return -log(1.0 - igraph_rng_xoshiro256ss_get_real(vstate)) / rate;
+}
+
+int igraph_rng_xoshiro256ss_seed(void *vstate, unsigned long int seed) {
+    igraph_i_rng_xoshiro256ss_state_t *state = vstate;
+    uint64_t z = seed;
+    int i;
+
+    /* The state is filled by SplitMix64, as recommended by the
+       authors; it is never all zero. */
+    for (i = 0; i < 4; i++) {
+        uint64_t x;
+        z += 0x9E3779B97F4A7C15ULL;
+        x = z;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        state->s[i] = x ^ (x >> 31);
+    }
+
+    return 0;
+}
+
+int igraph_rng_xoshiro256ss_init(void **state) {
+    igraph_i_rng_xoshiro256ss_state_t *st;
+
+    st = igraph_Calloc(1, igraph_i_rng_xoshiro256ss_state_t);
+    if (!st) {
+        IGRAPH_ERROR("Cannot initialize RNG", IGRAPH_ENOMEM);
+    }
+    (*state) = st;
+
+    igraph_rng_xoshiro256ss_seed(st, 0);
+
+    return 0;
+}
+
+void igraph_rng_xoshiro256ss_destroy(void *vstate) {
+    igraph_i_rng_xoshiro256ss_state_t *state =
+        (igraph_i_rng_xoshiro256ss_state_t*) vstate;
+    igraph_Free(state);
+}
+
+/**
+ * \var igraph_rngtype_xoshiro256ss
+ * \brief The xoshiro256** random number generator
+ *
+ * xoshiro256** is a fast, small-state generator of David Blackman and
+ * Sebastiano Vigna, based on shifts, rotations and exclusive or
+ * operations on a 256 bit state. It has a period of 2^256 - 1, passes
+ * all known statistical tests, and produces 64 random bits per step,
+ * so a uniform real number with 53 random bits takes a single step.
+ * The state is initialized from the seed with the SplitMix64
+ * generator.
+ *
+ * </para><para>
+ * This generator supports filling vectors in bulk, see e.g. \ref
+ * igraph_rng_get_unif01_vector(); the random graph generators use
+ * this to reduce the overhead per random number, and they then read
+ * the generator in blocks, i.e. they may draw more numbers than
+ * they use. Geometric and exponential random numbers are generated
+ * by inversion.
+ *
+ * </para><para>
+ * For more information see,
+ * David Blackman and Sebastiano Vigna: Scrambled linear pseudorandom
+ * number generators. ACM Transactions on Mathematical Software 47(4),
+ * 2021.
+ */
+
+const igraph_rng_type_t igraph_rngtype_xoshiro256ss = {
+    /* name= */      "XOSHIRO256**",
+    /* min=  */      0,
+    /* max=  */      0xffffffffUL,
+    /* init= */      igraph_rng_xoshiro256ss_init,
+    /* destroy= */   igraph_rng_xoshiro256ss_destroy,
+    /* seed= */      igraph_rng_xoshiro256ss_seed,
+    /* get= */       igraph_rng_xoshiro256ss_get,
+    /* get_real= */  igraph_rng_xoshiro256ss_get_real,
+    /* get_norm= */  0,
+    /* get_geom= */  igraph_rng_xoshiro256ss_get_geom,
+    /* get_binom= */ 0,
+    /* get_exp= */   igraph_rng_xoshiro256ss_get_exp,
+    /* get_gamma= */ 0,
+    /* seed_stream= */ 0,
+    /* fill_real= */ igraph_rng_xoshiro256ss_fill_real
+};
+
+/* ------------------------------------ */
+
 #ifndef USING_R
 
 igraph_i_rng_mt19937_state_t igraph_i_rng_default_state;
@@ -692,6 +1011,53 @@ int igraph_rng_seed(igraph_rng_t *rng, unsigned long int seed) {
     return 0;
 }
 
+/**
+ * \function igraph_rng_seed_stream
+ * Seed one of several independent streams of a generator
+ *
+ * </para><para>
+ * Parallel code that needs random numbers should not share one
+ * generator between threads: the numbers a thread gets would depend
+ * on the timing of the others. Instead, split the work into items
+ * that do not depend on the number of threads, and give each item
+ * its own generator, seeded with this function, using the same seed
+ * and the index of the item as the stream. The result is then
+ * reproducible for a given seed.
+ *
+ * </para><para>
+ * With \ref igraph_rngtype_philox4x32 the streams are guaranteed not
+ * to overlap. Other generators are seeded with a hash of \p seed and
+ * \p stream, which gives practically, but not provably independent
+ * streams.
+ *
+ * \param rng The RNG.
+ * \param seed The seed, shared by all streams.
+ * \param stream The index of the stream.
+ * \return Error code.
+ *
+ * \sa \ref igraph_rng_seed().
+ *
+ * Time complexity: usually O(1), but may depend on the type of the
+ * RNG.
+ */
+
+int igraph_rng_seed_stream(igraph_rng_t *rng, unsigned long int seed,
+                           igraph_integer_t stream) {
+    const igraph_rng_type_t *type = rng->type;
+    rng->def = 0;
+    if (type->seed_stream) {
+        IGRAPH_CHECK(type->seed_stream(rng->state, seed, stream));
+    } else {
+        /* The SplitMix64 finalizer */
+        uint64_t z = (uint64_t) seed + 0x9E3779B97F4A7C15ULL * ((uint64_t) stream + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z = z ^ (z >> 31);
+        IGRAPH_CHECK(type->seed(rng->state, (unsigned long int) z));
+    }
+    return 0;
+}
+
 /**
  * \function igraph_rng_max
  * Query the maximum possible integer for a random number generator
@@ -931,6 +1297,162 @@ igraph_real_t igraph_rng_get_exp(igraph_rng_t *rng, igraph_real_t rate) {
 }
 
 
+/**
+ * \function igraph_rng_get_unif01_vector
+ * Generate a vector of uniform random numbers from the unit interval
+ *
+ * The result is the same as with \p n calls to \ref
+ * igraph_rng_get_unif01(), but generators that support it, e.g.
+ * \ref igraph_rngtype_xoshiro256ss, fill the vector in a single
+ * call, without the overhead of a function call per number.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, it is resized to \p n and the
+ *        numbers are stored here.
+ * \param n The number of random numbers to generate.
+ * \return Error code.
+ *
+ * Time complexity: O(n).
+ */
+
+int igraph_rng_get_unif01_vector(igraph_rng_t *rng, igraph_vector_t *res,
+                                 igraph_integer_t n) {
+    const igraph_rng_type_t *type = rng->type;
+    long int i;
+
+    IGRAPH_CHECK(igraph_vector_resize(res, n));
+    if (type->fill_real) {
+        type->fill_real(rng->state, VECTOR(*res), n);
+    } else {
+        for (i = 0; i < n; i++) {
+            VECTOR(*res)[i] = igraph_rng_get_unif01(rng);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_rng_get_integer_vector
+ * Generate a vector of random integers from an interval
+ *
+ * The result is the same as with \p n calls to \ref
+ * igraph_rng_get_integer(), see \ref igraph_rng_get_unif01_vector()
+ * for the advantage of generating them together.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized integer vector, it is resized to \p n and
+ *        the numbers are stored here.
+ * \param n The number of random numbers to generate.
+ * \param l Lower limit, inclusive, it can be negative as well.
+ * \param h Upper limit, inclusive, it can be negative as well, but it
+ *        should be at least <code>l</code>.
+ * \return Error code.
+ *
+ * Time complexity: O(n).
+ */
+
+int igraph_rng_get_integer_vector(igraph_rng_t *rng, igraph_vector_int_t *res,
+                                  igraph_integer_t n, long int l, long int h) {
+    const igraph_rng_type_t *type = rng->type;
+    igraph_real_t buffer[IGRAPH_I_RNG_BUFFER_SIZE];
+    long int i, j;
+
+    IGRAPH_CHECK(igraph_vector_int_resize(res, n));
+    if (!type->fill_real) {
+        for (i = 0; i < n; i++) {
+            VECTOR(*res)[i] = (igraph_integer_t) igraph_rng_get_integer(rng, l, h);
+        }
+        return 0;
+    }
+
+    for (i = 0; i < n; i += IGRAPH_I_RNG_BUFFER_SIZE) {
+        long int size = n - i < IGRAPH_I_RNG_BUFFER_SIZE ? n - i : IGRAPH_I_RNG_BUFFER_SIZE;
+        type->fill_real(rng->state, buffer, size);
+        for (j = 0; j < size; j++) {
+            VECTOR(*res)[i + j] = (igraph_integer_t) (buffer[j] * (h - l + 1) + l);
+        }
+    }
+    return 0;
+}
+
+/**
+ * \function igraph_rng_get_geom_vector
+ * Generate a vector of geometrically distributed random numbers
+ *
+ * The result is the same as with \p n calls to \ref
+ * igraph_rng_get_geom(). For generators that support filling vectors
+ * in bulk, the geometric random numbers are computed by inversion from
+ * a vector of uniform ones.
+ *
+ * \param rng Pointer to the RNG to use. Use \ref igraph_rng_default()
+ *        here to use the default igraph RNG.
+ * \param res An initialized vector, it is resized to \p n and the
+ *        numbers are stored here.
+ * \param n The number of random numbers to generate.
+ * \param p The probability of success in each trial. Must be larger
+ *        than zero and smaller or equal to 1.
+ * \return Error code.
+ *
+ * Time complexity: O(n).
+ */
+
+int igraph_rng_get_geom_vector(igraph_rng_t *rng, igraph_vector_t *res,
+                               igraph_integer_t n, igraph_real_t p) {
+    const igraph_rng_type_t *type = rng->type;
+    long int i;
+
+    if (!type->fill_real) {
+        IGRAPH_CHECK(igraph_vector_resize(res, n));
+        for (i = 0; i < n; i++) {
+            VECTOR(*res)[i] = igraph_rng_get_geom(rng, p);
+        }
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_rng_get_unif01_vector(rng, res, n));
+    if (p == 1.0) {
+        igraph_vector_null(res);
+    } else {
+        igraph_real_t logq = log1p(-p);
+        for (i = 0; i < n; i++) {
+            VECTOR(*res)[i] = floor(log(1.0 - VECTOR(*res)[i]) / logq);
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------ */
+
+void igraph_i_rng_buffer_init(igraph_i_rng_buffer_t *buffer, igraph_rng_t *rng) {
+    buffer->rng = rng;
+    buffer->next = buffer->size = 0;
+}
+
+igraph_real_t igraph_i_rng_buffer_refill(igraph_i_rng_buffer_t *buffer) {
+    const igraph_rng_type_t *type = buffer->rng->type;
+    if (!type->fill_real) {
+        return igraph_rng_get_unif01(buffer->rng);
+    }
+    type->fill_real(buffer->rng->state, buffer->data, IGRAPH_I_RNG_BUFFER_SIZE);
+    buffer->size = IGRAPH_I_RNG_BUFFER_SIZE;
+    buffer->next = 1;
+    return buffer->data[0];
+}
+
+igraph_real_t igraph_i_rng_buffer_geom(igraph_i_rng_buffer_t *buffer,
+                                       igraph_real_t p) {
+    if (!buffer->rng->type->fill_real) {
+        return igraph_rng_get_geom(buffer->rng, p);
+    }
+    if (p == 1.0) {
+        return 0.0;
+    }
+    return floor(log(1.0 - IGRAPH_I_RNG_UNIF01(buffer)) / log1p(-p));
+}
+
+
 #ifndef HAVE_EXPM1
 #ifndef USING_R         /* R provides a replacement */
 /* expm1 replacement */
@@ -978,7 +1500,7 @@ float rintf (float x) {
  */
 
 int igraph_i_random_sample_alga(igraph_vector_t *res, igraph_integer_t l, igraph_integer_t h,
-                                igraph_integer_t length) {
+                                igraph_integer_t length, igraph_i_rng_buffer_t *rng) {
     igraph_real_t N = h - l + 1;
     igraph_real_t n = length;
 
@@ -990,7 +1512,7 @@ int igraph_i_random_sample_alga(igraph_vector_t *res, igraph_integer_t l, igraph
     l = l - 1;
 
     while (n >= 2) {
-        V = RNG_UNIF01();
+        V = IGRAPH_I_RNG_UNIF01(rng);
         S = 1;
         quot = top / Nreal;
         while (quot > V) {
@@ -1004,7 +1526,7 @@ int igraph_i_random_sample_alga(igraph_vector_t *res, igraph_integer_t l, igraph
         Nreal = -1.0 + Nreal; n = -1 + n;
     }
 
-    S = floor(round(Nreal) * RNG_UNIF01());
+    S = floor(round(Nreal) * IGRAPH_I_RNG_UNIF01(rng));
     l += S + 1;
     igraph_vector_push_back(res, l);  /* allocated */
 
@@ -1074,6 +1596,7 @@ int igraph_random_sample(igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
     igraph_real_t negalphainv = -13;
     igraph_real_t threshold = -negalphainv * n;
     igraph_real_t S;
+    igraph_i_rng_buffer_t rng;
 
     /* getting back some sense of sanity */
     if (l > h) {
@@ -1107,8 +1630,9 @@ int igraph_random_sample(igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
     IGRAPH_CHECK(igraph_vector_reserve(res, length));
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&rng, igraph_rng_default());
 
-    Vprime = exp(log(RNG_UNIF01()) * ninv);
+    Vprime = exp(log(IGRAPH_I_RNG_UNIF01(&rng)) * ninv);
     l = l - 1;
 
     while (n > 1 && threshold < N) {
@@ -1124,9 +1648,9 @@ int igraph_random_sample(igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
                 if (S < qu1) {
                     break;
                 }
-                Vprime = exp(log(RNG_UNIF01()) * ninv);
+                Vprime = exp(log(IGRAPH_I_RNG_UNIF01(&rng)) * ninv);
             }
-            U = RNG_UNIF01();
+            U = IGRAPH_I_RNG_UNIF01(&rng);
             negSreal = -S;
 
             y1 = exp(log(U * Nreal / qu1real) * nmin1inv);
@@ -1150,10 +1674,10 @@ int igraph_random_sample(igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
                 bottom = -1.0 + bottom;
             }
             if (Nreal / (-X + Nreal) >= y1 * exp(log(y2)*nmin1inv)) {
-                Vprime = exp(log(RNG_UNIF01()) * nmin1inv);
+                Vprime = exp(log(IGRAPH_I_RNG_UNIF01(&rng)) * nmin1inv);
                 break;
             }
-            Vprime = exp(log(RNG_UNIF01()) * ninv);
+            Vprime = exp(log(IGRAPH_I_RNG_UNIF01(&rng)) * ninv);
         }
 
         l += S + 1;
@@ -1167,7 +1691,7 @@ int igraph_random_sample(igraph_vector_t *res, igraph_real_t l, igraph_real_t h,
     if (n > 1) {
         retval = igraph_i_random_sample_alga(res, (igraph_integer_t) l + 1,
                                              (igraph_integer_t) h,
-                                             (igraph_integer_t) n);
+                                             (igraph_integer_t) n, &rng);
     } else {
         retval = 0;
         S = floor(N * Vprime);
@@ -70,7 +70,7 @@
 #include "igraph_memory.h"
 #include "igraph_vector.h"
 
-int igraph_i_intervals_plus_kmeans(const igraph_vector_t *v, int *gr,
+int igraph_i_intervals_plus_kmeans(const igraph_vector_t *v, igraph_integer_t *gr,
                                    int n, int n_interv,
                                    int maxiter) {
     int i;
@@ -93,7 +93,7 @@ int igraph_i_intervals_plus_kmeans(const igraph_vector_t *v, int *gr,
     return 0;
 }
 
-int igraph_i_intervals_method(const igraph_vector_t *v, int *gr, int n,
+int igraph_i_intervals_method(const igraph_vector_t *v, igraph_integer_t *gr, int n,
                               int n_interv) {
     int i, lo, hi, new;
     const int lft = 1;
@@ -71,7 +71,7 @@ int igraph_i_compare_ind_val(const void *a, const void *b);
 typedef struct groups {
     int ind;
     int n;
-    int* gr;
+    igraph_integer_t* gr;
 } igraph_i_scg_groups_t;
 
 /*-------------------------------------------------
@@ -81,10 +81,10 @@ typedef struct groups {
 int igraph_i_breaks_computation(const igraph_vector_t *v,
                                 igraph_vector_t *breaks, int nb,
                                 int method);
-int igraph_i_intervals_plus_kmeans(const igraph_vector_t *v, int *gr,
+int igraph_i_intervals_plus_kmeans(const igraph_vector_t *v, igraph_integer_t *gr,
                                    int n, int n_interv,
                                    int maxiter);
-int igraph_i_intervals_method(const igraph_vector_t *v, int *gr,
+int igraph_i_intervals_method(const igraph_vector_t *v, igraph_integer_t *gr,
                               int n, int n_interv);
 
 /*-------------------------------------------------
@@ -93,7 +93,7 @@ int igraph_i_intervals_method(const igraph_vector_t *v, int *gr,
 
 int igraph_i_cost_matrix(igraph_real_t *Cv, const igraph_i_scg_indval_t *vs,
                          int n, int matrix, const igraph_vector_t *ps);
-int igraph_i_optimal_partition(const igraph_real_t *v, int *gr, int n, int nt,
+int igraph_i_optimal_partition(const igraph_real_t *v, igraph_integer_t *gr, int n, int nt,
                                int matrix, const igraph_real_t *p,
                                igraph_real_t *value);
 
@@ -103,13 +103,13 @@ int igraph_i_optimal_partition(const igraph_real_t *v, int *gr, int n, int nt,
 
 int igraph_i_kmeans_Lloyd(const igraph_vector_t *x, int n,
                           int p, igraph_vector_t *centers,
-                          int k, int *cl, int maxiter);
+                          int k, igraph_integer_t *cl, int maxiter);
 
 /*-------------------------------------------------
 ------------DEFINED IN scg_exact_scg.c-------------
 ---------------------------------------------------*/
 
-int igraph_i_exact_coarse_graining(const igraph_real_t *v, int *gr,
+int igraph_i_exact_coarse_graining(const igraph_real_t *v, igraph_integer_t *gr,
                                    int n);
 
 /*-------------------------------------------------
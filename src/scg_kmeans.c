@@ -36,7 +36,7 @@
 #include "scg_headers.h"
 
 int igraph_i_kmeans_Lloyd(const igraph_vector_t *x, int n, int p,
-                          igraph_vector_t *cen, int k, int *cl, int maxiter) {
+                          igraph_vector_t *cen, int k, igraph_integer_t *cl, int maxiter) {
 
     int iter, i, j, c, it, inew = 0;
     igraph_real_t best, dd, tmp;
@@ -292,7 +292,7 @@ int igraph_sparsemat_permute(const igraph_sparsemat_t *A,
                              igraph_sparsemat_t *res) {
 
     long int nrow = A->cs->m, ncol = A->cs->n;
-    igraph_vector_int_t pinv;
+    int *pinv, *qint;
     long int i;
 
     if (nrow != igraph_vector_int_size(p)) {
@@ -302,20 +302,33 @@ int igraph_sparsemat_permute(const igraph_sparsemat_t *A,
         IGRAPH_ERROR("Invalid column permutation length", IGRAPH_FAILURE);
     }
 
-    /* We invert the permutation by hand */
-    IGRAPH_CHECK(igraph_vector_int_init(&pinv, nrow));
-    IGRAPH_FINALLY(igraph_vector_int_destroy, &pinv);
+    /* We invert the permutation by hand, CSparse needs 'int' arrays,
+       so we copy the column permutation as well */
+    pinv = igraph_Calloc(nrow > 0 ? nrow : 1, int);
+    if (!pinv) {
+        IGRAPH_ERROR("Cannot permute sparse matrix", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, pinv);
+    qint = igraph_Calloc(ncol > 0 ? ncol : 1, int);
+    if (!qint) {
+        IGRAPH_ERROR("Cannot permute sparse matrix", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, qint);
     for (i = 0; i < nrow; i++) {
-        VECTOR(pinv)[ VECTOR(*p)[i] ] = (int) i;
+        pinv[ VECTOR(*p)[i] ] = (int) i;
+    }
+    for (i = 0; i < ncol; i++) {
+        qint[i] = (int) VECTOR(*q)[i];
     }
 
     /* And call the permutation routine */
-    if (! (res->cs = cs_permute(A->cs, VECTOR(pinv), VECTOR(*q), /*values=*/ 1))) {
+    if (! (res->cs = cs_permute(A->cs, pinv, qint, /*values=*/ 1))) {
         IGRAPH_ERROR("Cannot index sparse matrix", IGRAPH_FAILURE);
     }
 
-    igraph_vector_int_destroy(&pinv);
-    IGRAPH_FINALLY_CLEAN(1);
+    igraph_Free(qint);
+    igraph_Free(pinv);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -2576,7 +2589,7 @@ int igraph_i_sparsemat_which_min_cols_cc(igraph_sparsemat_t *A,
     int n, j, p;
     double *px;
     double *pr;
-    int *ppos;
+    igraph_integer_t *ppos;
     double inf = IGRAPH_INFINITY;
 
     IGRAPH_CHECK(igraph_sparsemat_dupl(A));
@@ -2789,6 +2802,20 @@ int igraph_sparsemat_nonzero_storage(const igraph_sparsemat_t *A) {
     }
 }
 
+/* CSparse indices are 'int', igraph_integer_t may be wider */
+
+static void igraph_i_sparsemat_copy_int(igraph_integer_t *to, const int *from,
+                                        int n) {
+#if IGRAPH_INTEGER_SIZE == 64
+    int k;
+    for (k = 0; k < n; k++) {
+        to[k] = from[k];
+    }
+#else
+    memcpy(to, from, (size_t) n * sizeof(int));
+#endif
+}
+
 int igraph_sparsemat_getelements(const igraph_sparsemat_t *A,
                                  igraph_vector_int_t *i,
                                  igraph_vector_int_t *j,
@@ -2799,15 +2826,15 @@ int igraph_sparsemat_getelements(const igraph_sparsemat_t *A,
         IGRAPH_CHECK(igraph_vector_int_resize(i, nz));
         IGRAPH_CHECK(igraph_vector_int_resize(j, A->cs->n + 1));
         IGRAPH_CHECK(igraph_vector_resize(x, nz));
-        memcpy(VECTOR(*i), A->cs->i, (size_t) nz * sizeof(int));
-        memcpy(VECTOR(*j), A->cs->p, (size_t) (A->cs->n + 1) * sizeof(int));
+        igraph_i_sparsemat_copy_int(VECTOR(*i), A->cs->i, nz);
+        igraph_i_sparsemat_copy_int(VECTOR(*j), A->cs->p, A->cs->n + 1);
         memcpy(VECTOR(*x), A->cs->x, (size_t) nz * sizeof(igraph_real_t));
     } else {
         IGRAPH_CHECK(igraph_vector_int_resize(i, nz));
         IGRAPH_CHECK(igraph_vector_int_resize(j, nz));
         IGRAPH_CHECK(igraph_vector_resize(x, nz));
-        memcpy(VECTOR(*i), A->cs->i, (size_t) nz * sizeof(int));
-        memcpy(VECTOR(*j), A->cs->p, (size_t) nz * sizeof(int));
+        igraph_i_sparsemat_copy_int(VECTOR(*i), A->cs->i, nz);
+        igraph_i_sparsemat_copy_int(VECTOR(*j), A->cs->p, nz);
         memcpy(VECTOR(*x), A->cs->x, (size_t) nz * sizeof(igraph_real_t));
     }
     return 0;
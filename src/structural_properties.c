@@ -28,6 +28,8 @@
 #include "igraph_math.h"
 #include "igraph_memory.h"
 #include "igraph_random.h"
+#include "igraph_random_internal.h"
+#include "igraph_bfs_internal.h"
 #include "igraph_adjlist.h"
 #include "igraph_interface.h"
 #include "igraph_progress.h"
@@ -42,6 +44,7 @@
 #include "igraph_neighborhood.h"
 #include "igraph_topology.h"
 #include "igraph_qsort.h"
+#include "igraph_threading.h"
 #include "config.h"
 #include "structural_properties_internal.h"
 
@@ -83,6 +86,11 @@
  *         \c IGRAPH_ENOMEM, not enough memory for
  *         temporary data.
  *
+ * </para><para>
+ * If only \p pres is requested, the diameter is computed by \ref
+ * igraph_diameter_radius(), which usually needs much fewer
+ * searches.
+ *
  * Time complexity: O(|V||E|), the
  * number of vertices times the number of edges.
  *
@@ -111,6 +119,20 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
     } else {
         dirmode = IGRAPH_ALL;
     }
+
+    /* Only the length is needed, bound the eccentricities */
+    if (no_of_nodes > 0 && !pfrom && !pto && !path) {
+        igraph_real_t diameter;
+        IGRAPH_CHECK(igraph_i_diameter_radius(graph, /* weights= */ 0, &diameter,
+                                              /* radius= */ 0, dirmode, unconn,
+                                              /* searches= */ 0));
+        if (pres) {
+            *pres = igraph_finite(diameter) ? (igraph_integer_t) diameter :
+                    (igraph_integer_t) no_of_nodes;
+        }
+        return 0;
+    }
+
     already_added = igraph_Calloc(no_of_nodes, long int);
     if (already_added == 0) {
         IGRAPH_ERROR("diameter failed", IGRAPH_ENOMEM);
@@ -229,64 +251,45 @@ int igraph_diameter(const igraph_t *graph, igraph_integer_t *pres,
 int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
                                igraph_bool_t directed, igraph_bool_t unconn) {
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    long int *already_added;
-    long int nodes_reached = 0;
+    long int i, k, batch;
     igraph_real_t normfact = 0.0;
-
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
-    igraph_neimode_t dirmode;
-    igraph_adjlist_t allneis;
+    igraph_integer_t sources[IGRAPH_I_MSBFS_WIDTH];
+    igraph_i_msbfs_t msbfs;
 
     *res = 0;
-    if (directed) {
-        dirmode = IGRAPH_OUT;
-    } else {
-        dirmode = IGRAPH_ALL;
-    }
-    already_added = igraph_Calloc(no_of_nodes, long int);
-    if (already_added == 0) {
-        IGRAPH_ERROR("average path length failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_added); /* TODO: hack */
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, graph,
+                                     directed ? IGRAPH_OUT : IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
-    igraph_adjlist_init(graph, &allneis, dirmode);
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+    for (i = 0; i < no_of_nodes; i += batch) {
+        igraph_real_t pairs, nodes_reached = 0;
+        igraph_bool_t found;
 
-    for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_added[i] = i + 1;
+        batch = no_of_nodes - i < IGRAPH_I_MSBFS_WIDTH ?
+                no_of_nodes - i : IGRAPH_I_MSBFS_WIDTH;
+        for (k = 0; k < batch; k++) {
+            sources[k] = i + k;
+        }
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_added[neighbor] == i + 1) {
-                    continue;
-                }
-                already_added[neighbor] = i + 1;
-                nodes_reached++;
-                *res += actdist + 1;
-                normfact += 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+        IGRAPH_CHECK(igraph_i_msbfs_start(&msbfs, sources, (int) batch));
+        while (1) {
+            IGRAPH_CHECK(igraph_i_msbfs_next_level(&msbfs, &found));
+            if (!found) {
+                break;
             }
-        } /* while !igraph_dqueue_empty */
+            igraph_i_msbfs_level_stats(&msbfs, &pairs, 0, 0);
+            nodes_reached += pairs;
+            *res += msbfs.level * pairs;
+            normfact += pairs;
+        }
 
         /* not connected, return largest possible */
         if (!unconn) {
-            *res += (no_of_nodes * (no_of_nodes - 1 - nodes_reached));
-            normfact += no_of_nodes - 1 - nodes_reached;
+            igraph_real_t unreached = batch * (no_of_nodes - 1.0) - nodes_reached;
+            *res += no_of_nodes * unreached;
+            normfact += unreached;
         }
     } /* for i<no_of_nodes */
 
@@ -298,10 +301,8 @@ int igraph_average_path_length(const igraph_t *graph, igraph_real_t *res,
     }
 
     /* clean */
-    igraph_Free(already_added);
-    igraph_dqueue_destroy(&q);
-    igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_i_msbfs_destroy(&msbfs);
+    IGRAPH_FINALLY_CLEAN(1);
 
     return 0;
 }
@@ -337,69 +338,51 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
                             igraph_real_t *unconnected, igraph_bool_t directed) {
 
     long int no_of_nodes = igraph_vcount(graph);
-    long int i, j, n;
-    igraph_vector_long_t already_added;
-    long int nodes_reached;
-
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
-    igraph_neimode_t dirmode;
-    igraph_adjlist_t allneis;
+    long int i, k, batch;
+    igraph_integer_t sources[IGRAPH_I_MSBFS_WIDTH];
+    igraph_i_msbfs_t msbfs;
     igraph_real_t unconn = 0;
     long int ressize;
 
-    if (directed) {
-        dirmode = IGRAPH_OUT;
-    } else {
-        dirmode = IGRAPH_ALL;
-    }
-
-    IGRAPH_CHECK(igraph_vector_long_init(&already_added, no_of_nodes));
-    IGRAPH_FINALLY(igraph_vector_long_destroy, &already_added);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &allneis, dirmode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &allneis);
+    IGRAPH_CHECK(igraph_i_msbfs_init(&msbfs, graph,
+                                     directed ? IGRAPH_OUT : IGRAPH_ALL));
+    IGRAPH_FINALLY(igraph_i_msbfs_destroy, &msbfs);
 
     IGRAPH_CHECK(igraph_vector_resize(res, 0));
     ressize = 0;
 
-    for (i = 0; i < no_of_nodes; i++) {
-        nodes_reached = 1;      /* itself */
-        IGRAPH_CHECK(igraph_dqueue_push(&q, i));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        VECTOR(already_added)[i] = i + 1;
+    for (i = 0; i < no_of_nodes; i += batch) {
+        igraph_real_t pairs, nodes_reached = 0;
+        igraph_bool_t found;
+
+        batch = no_of_nodes - i < IGRAPH_I_MSBFS_WIDTH ?
+                no_of_nodes - i : IGRAPH_I_MSBFS_WIDTH;
+        for (k = 0; k < batch; k++) {
+            sources[k] = i + k;
+        }
 
         IGRAPH_PROGRESS("Path-hist: ", 100.0 * i / no_of_nodes, NULL);
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-
-            neis = igraph_adjlist_get(&allneis, actnode);
-            n = igraph_vector_int_size(neis);
-            for (j = 0; j < n; j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (VECTOR(already_added)[neighbor] == i + 1) {
-                    continue;
-                }
-                VECTOR(already_added)[neighbor] = i + 1;
-                nodes_reached++;
-                if (actdist + 1 > ressize) {
-                    IGRAPH_CHECK(igraph_vector_resize(res, actdist + 1));
-                    for (; ressize < actdist + 1; ressize++) {
-                        VECTOR(*res)[ressize] = 0;
-                    }
+        IGRAPH_CHECK(igraph_i_msbfs_start(&msbfs, sources, (int) batch));
+        while (1) {
+            IGRAPH_CHECK(igraph_i_msbfs_next_level(&msbfs, &found));
+            if (!found) {
+                break;
+            }
+            if (msbfs.level > ressize) {
+                IGRAPH_CHECK(igraph_vector_resize(res, msbfs.level));
+                for (; ressize < msbfs.level; ressize++) {
+                    VECTOR(*res)[ressize] = 0;
                 }
-                VECTOR(*res)[actdist] += 1;
-
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
             }
-        } /* while !igraph_dqueue_empty */
+            igraph_i_msbfs_level_stats(&msbfs, &pairs, 0, 0);
+            VECTOR(*res)[msbfs.level - 1] += pairs;
+            nodes_reached += pairs;
+        }
 
-        unconn += (no_of_nodes - nodes_reached);
+        unconn += batch * (no_of_nodes - 1.0) - nodes_reached;
 
     } /* for i<no_of_nodes */
 
@@ -413,10 +396,8 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
         unconn /= 2;
     }
 
-    igraph_vector_long_destroy(&already_added);
-    igraph_dqueue_destroy(&q);
-    igraph_adjlist_destroy(&allneis);
-    IGRAPH_FINALLY_CLEAN(3);
+    igraph_i_msbfs_destroy(&msbfs);
+    IGRAPH_FINALLY_CLEAN(1);
 
     if (unconnected) {
         *unconnected = unconn;
@@ -430,6 +411,13 @@ int igraph_path_length_hist(const igraph_t *graph, igraph_vector_t *res,
  * \function igraph_shortest_paths
  * \brief The length of the shortest paths between vertices.
  *
+ * The breadth-first searches read the edge index of the graph
+ * directly. When the frontier of a search gets large, the search
+ * switches to bottom-up steps, in which every unreached vertex looks
+ * for a neighbor in the frontier, and back when it gets small again.
+ * The steps with large frontiers run on \ref igraph_get_num_threads()
+ * threads.
+ *
  * \param graph The graph object.
  * \param res The result of the calculation, a matrix. A pointer to an
  *        initialized matrix, to be more precise. The matrix will be
@@ -482,10 +470,7 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
 
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_from, no_of_to;
-    long int *already_counted;
-    igraph_adjlist_t adjlist;
-    igraph_dqueue_t q = IGRAPH_DQUEUE_NULL;
-    igraph_vector_int_t *neis;
+    igraph_i_bfs_t bfs;
     igraph_bool_t all_to;
 
     long int i, j;
@@ -502,15 +487,8 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_CHECK(igraph_adjlist_init(graph, &adjlist, mode));
-    IGRAPH_FINALLY(igraph_adjlist_destroy, &adjlist);
-
-    already_counted = igraph_Calloc(no_of_nodes, long int);
-    if (already_counted == 0) {
-        IGRAPH_ERROR("shortest paths failed", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(free, already_counted);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+    IGRAPH_CHECK(igraph_i_bfs_init(&bfs, graph, mode));
+    IGRAPH_FINALLY(igraph_i_bfs_destroy, &bfs);
 
     if ( (all_to = igraph_vs_is_all(&to)) ) {
         no_of_to = no_of_nodes;
@@ -536,39 +514,25 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
          !IGRAPH_VIT_END(fromvit);
          IGRAPH_VIT_NEXT(fromvit), i++) {
         long int reached = 0;
-        IGRAPH_CHECK(igraph_dqueue_push(&q, IGRAPH_VIT_GET(fromvit)));
-        IGRAPH_CHECK(igraph_dqueue_push(&q, 0));
-        already_counted[ (long int) IGRAPH_VIT_GET(fromvit) ] = i + 1;
+        igraph_bool_t found = 1;
 
         IGRAPH_ALLOW_INTERRUPTION();
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int act = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-
-            if (all_to) {
-                MATRIX(*res, i, act) = actdist;
-            } else {
-                if (VECTOR(indexv)[act]) {
-                    MATRIX(*res, i, (long int)(VECTOR(indexv)[act] - 1)) = actdist;
+        IGRAPH_CHECK(igraph_i_bfs_start(&bfs, IGRAPH_VIT_GET(fromvit)));
+        while (found) {
+            for (j = bfs.level_begin; j < bfs.level_end; j++) {
+                long int act = VECTOR(bfs.order)[j];
+                if (all_to) {
+                    MATRIX(*res, i, act) = bfs.level;
+                } else if (VECTOR(indexv)[act]) {
+                    MATRIX(*res, i, (long int)(VECTOR(indexv)[act] - 1)) = bfs.level;
                     reached++;
-                    if (reached == no_of_to) {
-                        igraph_dqueue_clear(&q);
-                        break;
-                    }
                 }
             }
-
-            neis = igraph_adjlist_get(&adjlist, act);
-            for (j = 0; j < igraph_vector_int_size(neis); j++) {
-                long int neighbor = (long int) VECTOR(*neis)[j];
-                if (already_counted[neighbor] == i + 1) {
-                    continue;
-                }
-                already_counted[neighbor] = i + 1;
-                IGRAPH_CHECK(igraph_dqueue_push(&q, neighbor));
-                IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
+            if (!all_to && reached == no_of_to) {
+                break;
             }
+            IGRAPH_CHECK(igraph_i_bfs_next_level(&bfs, &found));
         }
     }
 
@@ -579,11 +543,9 @@ int igraph_shortest_paths(const igraph_t *graph, igraph_matrix_t *res,
         IGRAPH_FINALLY_CLEAN(2);
     }
 
-    igraph_Free(already_counted);
-    igraph_dqueue_destroy(&q);
+    igraph_i_bfs_destroy(&bfs);
     igraph_vit_destroy(&fromvit);
-    igraph_adjlist_destroy(&adjlist);
-    IGRAPH_FINALLY_CLEAN(4);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -1563,6 +1525,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
     igraph_bool_t directed, loops, ok;
     igraph_es_t es;
     igraph_adjlist_t al;
+    igraph_i_rng_buffer_t rng;
 
     if (no_of_nodes < 4) {
         IGRAPH_ERROR("graph unsuitable for rewiring", IGRAPH_EINVAL);
@@ -1572,6 +1535,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
     loops = (mode & IGRAPH_REWIRING_SIMPLE_LOOPS);
 
     RNG_BEGIN();
+    igraph_i_rng_buffer_init(&rng, igraph_rng_default());
 
     IGRAPH_VECTOR_INIT_FINALLY(&eids, 2);
 
@@ -1612,9 +1576,9 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
             ok = 1;
 
             /* Choose two edges randomly */
-            VECTOR(eids)[0] = RNG_INTEGER(0, no_of_edges - 1);
+            VECTOR(eids)[0] = IGRAPH_I_RNG_INTEGER(&rng, 0, no_of_edges - 1);
             do {
-                VECTOR(eids)[1] = RNG_INTEGER(0, no_of_edges - 1);
+                VECTOR(eids)[1] = IGRAPH_I_RNG_INTEGER(&rng, 0, no_of_edges - 1);
             } while (VECTOR(eids)[0] == VECTOR(eids)[1]);
 
             /* Get the endpoints */
@@ -1633,7 +1597,7 @@ int igraph_rewire_core(igraph_t *graph, igraph_integer_t n, igraph_rewiring_t mo
             /* For an undirected graph, we have two "variants" of each edge, i.e.
              * a -- b and b -- a. Since some rewirings can be performed only when we
              * "swap" the endpoints, we do it now with probability 0.5 */
-            if (!directed && RNG_UNIF01() < 0.5) {
+            if (!directed && IGRAPH_I_RNG_UNIF01(&rng) < 0.5) {
                 dummy = c; c = d; d = dummy;
                 if (use_adjlist) {
                     /* Flip the edge in the unordered edge-list, so the update later on
@@ -2985,12 +2949,9 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
                              igraph_neimode_t mode,
                              igraph_integer_t mindist) {
 
-    long int no_of_nodes = igraph_vcount(graph);
-    igraph_dqueue_t q;
+    igraph_i_bfs_t bfs;
     igraph_vit_t vit;
-    long int i, j;
-    long int *added;
-    igraph_vector_t neis;
+    long int i;
 
     if (order < 0) {
         IGRAPH_ERROR("Negative order in neighborhood size", IGRAPH_EINVAL);
@@ -3001,70 +2962,35 @@ int igraph_neighborhood_size(const igraph_t *graph, igraph_vector_t *res,
                      IGRAPH_EINVAL);
     }
 
-    added = igraph_Calloc(no_of_nodes, long int);
-    if (added == 0) {
-        IGRAPH_ERROR("Cannot calculate neighborhood size", IGRAPH_ENOMEM);
-    }
-    IGRAPH_FINALLY(igraph_free, added);
-    IGRAPH_DQUEUE_INIT_FINALLY(&q, 100);
+    IGRAPH_CHECK(igraph_i_bfs_init(&bfs, graph, mode));
+    IGRAPH_FINALLY(igraph_i_bfs_destroy, &bfs);
     IGRAPH_CHECK(igraph_vit_create(graph, vids, &vit));
     IGRAPH_FINALLY(igraph_vit_destroy, &vit);
-    IGRAPH_VECTOR_INIT_FINALLY(&neis, 0);
     IGRAPH_CHECK(igraph_vector_resize(res, IGRAPH_VIT_SIZE(vit)));
 
     for (i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
-        long int node = IGRAPH_VIT_GET(vit);
-        long int size = mindist == 0 ? 1 : 0;
-        added[node] = i + 1;
-        igraph_dqueue_clear(&q);
-        if (order > 0) {
-            igraph_dqueue_push(&q, node);
-            igraph_dqueue_push(&q, 0);
-        }
+        long int size = 0;
+        igraph_bool_t found = 1;
 
-        while (!igraph_dqueue_empty(&q)) {
-            long int actnode = (long int) igraph_dqueue_pop(&q);
-            long int actdist = (long int) igraph_dqueue_pop(&q);
-            long int n;
-            igraph_neighbors(graph, &neis, (igraph_integer_t) actnode, mode);
-            n = igraph_vector_size(&neis);
+        IGRAPH_ALLOW_INTERRUPTION();
 
-            if (actdist < order - 1) {
-                /* we add them to the q */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
-                        added[nei] = i + 1;
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, nei));
-                        IGRAPH_CHECK(igraph_dqueue_push(&q, actdist + 1));
-                        if (actdist + 1 >= mindist) {
-                            size++;
-                        }
-                    }
-                }
-            } else {
-                /* we just count them, but don't add them */
-                for (j = 0; j < n; j++) {
-                    long int nei = (long int) VECTOR(neis)[j];
-                    if (added[nei] != i + 1) {
-                        added[nei] = i + 1;
-                        if (actdist + 1 >= mindist) {
-                            size++;
-                        }
-                    }
-                }
+        IGRAPH_CHECK(igraph_i_bfs_start(&bfs, IGRAPH_VIT_GET(vit)));
+        while (found) {
+            if (bfs.level >= mindist) {
+                size += bfs.level_end - bfs.level_begin;
             }
-
-        } /* while q not empty */
+            if (bfs.level == order) {
+                break;
+            }
+            IGRAPH_CHECK(igraph_i_bfs_next_level(&bfs, &found));
+        }
 
         VECTOR(*res)[i] = size;
     } /* for VIT, i */
 
-    igraph_vector_destroy(&neis);
     igraph_vit_destroy(&vit);
-    igraph_dqueue_destroy(&q);
-    igraph_Free(added);
-    IGRAPH_FINALLY_CLEAN(4);
+    igraph_i_bfs_destroy(&bfs);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -4334,6 +4260,253 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
     return 0;
 }
 
+/* Dijkstra's algorithm from many sources, used by
+   igraph_shortest_paths_dijkstra() and Johnson's algorithm. The
+   searches from the sources are independent, so they run on several
+   threads, each with its own queue. The neighbors are read from the
+   edge index of the graph directly, because a lazy incidence list
+   cannot be shared between threads.
+
+   The distance from source 'first'+i to target j is stored at
+   res[i*row_stride + j*col_stride], so both a column-major matrix and
+   a buffer of rows can be filled. Entries of unreachable targets are
+   not touched. If 'potential' is not NULL, then the weights were
+   reweighted as in Johnson's algorithm, and the distances are
+   corrected with it. */
+
+typedef struct igraph_i_dijkstra_rows_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_neimode_t mode;
+    const igraph_vector_t *sources;
+    const igraph_vector_t *potential;
+    const igraph_vector_t *indexv; /* target index plus one, or NULL for all */
+    long int no_of_to;
+    long int first;
+    igraph_real_t *res;
+    long int row_stride, col_stride;
+    igraph_vector_ptr_t queues;    /* igraph_i_spqueue_t for each thread */
+} igraph_i_dijkstra_rows_t;
+
+static void igraph_i_dijkstra_rows_destroy(igraph_i_dijkstra_rows_t *d) {
+    long int t, n = igraph_vector_ptr_size(&d->queues);
+    for (t = 0; t < n; t++) {
+        igraph_i_spqueue_t *Q = VECTOR(d->queues)[t];
+        igraph_i_spqueue_destroy(Q);
+        igraph_Free(Q);
+    }
+    igraph_vector_ptr_destroy(&d->queues);
+}
+
+static int igraph_i_dijkstra_rows_init(igraph_i_dijkstra_rows_t *d,
+                                       const igraph_t *graph,
+                                       const igraph_vector_t *weights,
+                                       igraph_neimode_t mode,
+                                       const igraph_vector_t *sources,
+                                       const igraph_vector_t *potential,
+                                       const igraph_vector_t *indexv,
+                                       long int no_of_to) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int t, nthreads = igraph_get_num_threads();
+
+    if (nthreads < 2 || igraph_vector_size(sources) < 2) {
+        nthreads = 1;
+    }
+
+    d->graph = graph;
+    d->weights = weights;
+    d->mode = igraph_is_directed(graph) ? mode : IGRAPH_ALL;
+    d->sources = sources;
+    d->potential = potential;
+    d->indexv = indexv;
+    d->no_of_to = no_of_to;
+    d->first = 0;
+    d->res = 0;
+    d->row_stride = d->col_stride = 0;
+
+    IGRAPH_CHECK(igraph_vector_ptr_init(&d->queues, 0));
+    IGRAPH_FINALLY(igraph_i_dijkstra_rows_destroy, d);
+    for (t = 0; t < nthreads; t++) {
+        igraph_i_spqueue_t *Q = igraph_Calloc(1, igraph_i_spqueue_t);
+        if (!Q) {
+            IGRAPH_ERROR("Cannot run Dijkstra's algorithm", IGRAPH_ENOMEM);
+        }
+        IGRAPH_FINALLY(igraph_free, Q);
+        IGRAPH_CHECK(igraph_i_spqueue_init(Q, no_of_nodes, weights));
+        IGRAPH_FINALLY(igraph_i_spqueue_destroy, Q);
+        IGRAPH_CHECK(igraph_vector_ptr_push_back(&d->queues, Q));
+        IGRAPH_FINALLY_CLEAN(2);
+    }
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+static int igraph_i_dijkstra_rows_run(igraph_i_dijkstra_rows_t *d,
+                                      igraph_i_spqueue_t *Q, long int row) {
+    const igraph_t *graph = d->graph;
+    const igraph_real_t *weights = VECTOR(*d->weights);
+    long int source = (long int) VECTOR(*d->sources)[d->first + row];
+    igraph_real_t *res = d->res + row * d->row_stride;
+    long int reached = 0;
+
+    /* Distances are stored plus one in the queue, as elsewhere */
+    igraph_i_spqueue_clear(Q);
+    IGRAPH_CHECK(igraph_i_spqueue_push(Q, source, 1.0));
+
+    while (!igraph_i_spqueue_empty(Q)) {
+        long int minnei, col;
+        igraph_real_t mindist = igraph_i_spqueue_deactivate_min(Q, &minnei);
+        int pass;
+
+        col = d->indexv ? (long int) VECTOR(*d->indexv)[minnei] - 1 : minnei;
+        if (col >= 0) {
+            igraph_real_t dist = mindist - 1.0;
+            if (d->potential) {
+                dist -= VECTOR(*d->potential)[source] -
+                        VECTOR(*d->potential)[minnei];
+            }
+            res[col * d->col_stride] = dist;
+            if (d->indexv && ++reached == d->no_of_to) {
+                break;
+            }
+        }
+
+        /* Now check all neighbors of 'minnei' for a shorter path */
+        for (pass = 0; pass < 2; pass++) {
+            const igraph_integer_t *index, *other;
+            igraph_integer_t k, begin, end;
+            if (pass == 0 && (d->mode & IGRAPH_OUT)) {
+                begin = VECTOR(graph->os)[minnei]; end = VECTOR(graph->os)[minnei + 1];
+                index = VECTOR(graph->oi); other = VECTOR(graph->to);
+            } else if (pass == 1 && (d->mode & IGRAPH_IN)) {
+                begin = VECTOR(graph->is)[minnei]; end = VECTOR(graph->is)[minnei + 1];
+                index = VECTOR(graph->ii); other = VECTOR(graph->from);
+            } else {
+                continue;
+            }
+            for (k = begin; k < end; k++) {
+                igraph_integer_t edge = index[k];
+                long int tto = other[edge];
+                igraph_real_t altdist = mindist + weights[edge];
+                if (!igraph_i_spqueue_has_elem(Q, tto)) {
+                    /* This is the first non-infinite distance */
+                    IGRAPH_CHECK(igraph_i_spqueue_push(Q, tto, altdist));
+                } else if (igraph_i_spqueue_has_active(Q, tto) &&
+                           altdist < igraph_i_spqueue_get(Q, tto)) {
+                    /* This is a shorter path */
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(Q, tto, altdist));
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int igraph_i_dijkstra_rows_chunk(igraph_integer_t from,
+                                        igraph_integer_t to,
+                                        int thread, void *arg) {
+    igraph_i_dijkstra_rows_t *d = arg;
+    igraph_i_spqueue_t *Q = VECTOR(d->queues)[thread];
+    igraph_integer_t i;
+
+    for (i = from; i < to; i++) {
+        IGRAPH_ALLOW_INTERRUPTION();
+        IGRAPH_CHECK(igraph_i_dijkstra_rows_run(d, Q, i));
+    }
+
+    return 0;
+}
+
+/* Fills 'n' rows, for the sources starting at 'first' */
+
+static int igraph_i_dijkstra_rows(igraph_i_dijkstra_rows_t *d,
+                                  long int first, long int n) {
+    d->first = first;
+    if (igraph_vector_ptr_size(&d->queues) < 2) {
+        return igraph_i_dijkstra_rows_chunk(0, (igraph_integer_t) n, 0, d);
+    }
+    return igraph_parallel_for((igraph_integer_t) n, 1,
+                               igraph_i_dijkstra_rows_chunk, d);
+}
+
+/* The column of each vertex in 'to' plus one, zero for the other
+   vertices. 'indexv' is left empty if all vertices are targets. */
+
+static int igraph_i_dijkstra_targets(const igraph_t *graph, igraph_vs_t to,
+                                     igraph_vector_t *indexv,
+                                     long int *no_of_to) {
+    long int no_of_nodes = igraph_vcount(graph);
+    igraph_vit_t tovit;
+    long int i;
+
+    if (igraph_vs_is_all(&to)) {
+        igraph_vector_clear(indexv);
+        *no_of_to = no_of_nodes;
+        return 0;
+    }
+
+    IGRAPH_CHECK(igraph_vector_resize(indexv, no_of_nodes));
+    igraph_vector_null(indexv);
+    IGRAPH_CHECK(igraph_vit_create(graph, to, &tovit));
+    IGRAPH_FINALLY(igraph_vit_destroy, &tovit);
+    *no_of_to = IGRAPH_VIT_SIZE(tovit);
+    for (i = 0; !IGRAPH_VIT_END(tovit); IGRAPH_VIT_NEXT(tovit)) {
+        long int v = IGRAPH_VIT_GET(tovit);
+        if (VECTOR(*indexv)[v]) {
+            IGRAPH_ERROR("Duplicate vertices in `to', this is not allowed",
+                         IGRAPH_EINVAL);
+        }
+        VECTOR(*indexv)[v] = ++i;
+    }
+    igraph_vit_destroy(&tovit);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
+
+/* igraph_shortest_paths_dijkstra() without checking the weights, and
+   optionally with the potentials of Johnson's algorithm */
+
+static int igraph_i_shortest_paths_dijkstra(const igraph_t *graph,
+        igraph_matrix_t *res,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode,
+        const igraph_vector_t *potential) {
+
+    igraph_i_dijkstra_rows_t d;
+    igraph_vector_t sources, indexv;
+    long int no_of_from, no_of_to;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+    IGRAPH_CHECK(igraph_vs_as_vector(graph, from, &sources));
+    no_of_from = igraph_vector_size(&sources);
+    IGRAPH_VECTOR_INIT_FINALLY(&indexv, 0);
+    IGRAPH_CHECK(igraph_i_dijkstra_targets(graph, to, &indexv, &no_of_to));
+
+    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
+    igraph_matrix_fill(res, IGRAPH_INFINITY);
+
+    IGRAPH_CHECK(igraph_i_dijkstra_rows_init(&d, graph, weights, mode,
+                 &sources, potential,
+                 igraph_vs_is_all(&to) ? 0 : &indexv, no_of_to));
+    IGRAPH_FINALLY(igraph_i_dijkstra_rows_destroy, &d);
+    d.res = VECTOR(res->data);
+    d.row_stride = 1;
+    d.col_stride = no_of_from;
+    IGRAPH_CHECK(igraph_i_dijkstra_rows(&d, 0, no_of_from));
+
+    igraph_i_dijkstra_rows_destroy(&d);
+    igraph_vector_destroy(&indexv);
+    igraph_vector_destroy(&sources);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
 /**
  * \function igraph_shortest_paths_dijkstra
  * Weighted shortest paths from some sources.
@@ -4341,7 +4514,8 @@ int igraph_convergence_degree(const igraph_t *graph, igraph_vector_t *result,
  * This function is Dijkstra's algorithm to find the weighted
  * shortest paths to all vertices from a single source. (It is run
  * independently for the given sources.) It uses a binary heap for
- * efficient implementation.
+ * efficient implementation. The searches from the sources run on
+ * multiple threads, see \ref igraph_set_num_threads().
  *
  * \param graph The input graph, can be directed.
  * \param res The result, a matrix. A pointer to an initialized matrix
@@ -4383,30 +4557,13 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
                                    igraph_neimode_t mode) {
 
     /* Implementation details. This is the basic Dijkstra algorithm,
-       with a binary heap. The heap is indexed, i.e. it stores not only
-       the distances, but also which vertex they belong to.
+       with a 4-ary heap. The heap is indexed, i.e. it stores not only
+       the distances, but also which vertex they belong to. With small
+       integer weights it is a bucket queue instead, see
+       igraph_i_spqueue_t. The sources are processed in parallel, see
+       igraph_i_dijkstra_rows_t. */
 
-       From now on we use a 2-way heap, so the distances can be queried
-       directly from the heap.
-
-       Dirty tricks:
-       - the opposite of the distance is stored in the heap, as it is a
-         maximum heap and we need a minimum heap.
-       - we don't use IGRAPH_INFINITY in the res matrix during the
-         computation, as IGRAPH_FINITE() might involve a function call
-         and we want to spare that. -1 will denote infinity instead.
-    */
-
-    long int no_of_nodes = igraph_vcount(graph);
-    long int no_of_edges = igraph_ecount(graph);
-    igraph_2wheap_t Q;
-    igraph_vit_t fromvit, tovit;
-    long int no_of_from, no_of_to;
-    igraph_lazy_inclist_t inclist;
-    long int i, j;
-    igraph_real_t my_infinity = IGRAPH_INFINITY;
-    igraph_bool_t all_to;
-    igraph_vector_t indexv;
+    long int no_of_edges = igraph_ecount(graph);
 
     if (!weights) {
         return igraph_shortest_paths(graph, res, from, to, mode);
@@ -4418,98 +4575,109 @@ int igraph_shortest_paths_dijkstra(const igraph_t *graph,
     if (igraph_vector_min(weights) < 0) {
         IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
     }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
 
-    IGRAPH_CHECK(igraph_vit_create(graph, from, &fromvit));
-    IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
-    no_of_from = IGRAPH_VIT_SIZE(fromvit);
+    return igraph_i_shortest_paths_dijkstra(graph, res, from, to, weights,
+                                            mode, /* potential= */ 0);
+}
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+/* Writes the results of the single source shortest path functions
+   from the shortest path tree: 'parents' holds the inbound edge of
+   every vertex plus one, zero for the source and for the vertices that
+   were not reached. 'vit' gives the targets. */
 
-    if ( (all_to = igraph_vs_is_all(&to)) ) {
-        no_of_to = no_of_nodes;
-    } else {
-        IGRAPH_VECTOR_INIT_FINALLY(&indexv, no_of_nodes);
-        IGRAPH_CHECK(igraph_vit_create(graph, to, &tovit));
-        IGRAPH_FINALLY(igraph_vit_destroy, &tovit);
-        no_of_to = IGRAPH_VIT_SIZE(tovit);
-        for (i = 0; !IGRAPH_VIT_END(tovit); IGRAPH_VIT_NEXT(tovit)) {
-            long int v = IGRAPH_VIT_GET(tovit);
-            if (VECTOR(indexv)[v]) {
-                IGRAPH_ERROR("Duplicate vertices in `to', this is not allowed",
-                             IGRAPH_EINVAL);
+int igraph_i_shortest_path_tree_result(const igraph_t *graph,
+                                       igraph_vector_ptr_t *vertices,
+                                       igraph_vector_ptr_t *edges,
+                                       igraph_integer_t from,
+                                       igraph_vit_t *vit,
+                                       const long int *parents,
+                                       igraph_vector_long_t *predecessors,
+                                       igraph_vector_long_t *inbound_edges) {
+    long int no_of_nodes = igraph_vcount(graph);
+    long int i;
+
+    /* Create `predecessors' if needed */
+    if (predecessors) {
+        IGRAPH_CHECK(igraph_vector_long_resize(predecessors, no_of_nodes));
+
+        for (i = 0; i < no_of_nodes; i++) {
+            if (i == from) {
+                /* i is the start vertex */
+                VECTOR(*predecessors)[i] = i;
+            } else if (parents[i] <= 0) {
+                /* i was not reached */
+                VECTOR(*predecessors)[i] = -1;
+            } else {
+                /* i was reached via the edge with ID = parents[i] - 1 */
+                VECTOR(*predecessors)[i] = IGRAPH_OTHER(graph, parents[i] - 1, i);
             }
-            VECTOR(indexv)[v] = ++i;
         }
     }
 
-    IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
-    igraph_matrix_fill(res, my_infinity);
-
-    for (IGRAPH_VIT_RESET(fromvit), i = 0;
-         !IGRAPH_VIT_END(fromvit);
-         IGRAPH_VIT_NEXT(fromvit), i++) {
-
-        long int reached = 0;
-        long int source = IGRAPH_VIT_GET(fromvit);
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
-
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
-            igraph_vector_t *neis;
-            long int nlen;
+    /* Create `inbound_edges' if needed */
+    if (inbound_edges) {
+        IGRAPH_CHECK(igraph_vector_long_resize(inbound_edges, no_of_nodes));
 
-            if (all_to) {
-                MATRIX(*res, i, minnei) = mindist - 1.0;
+        for (i = 0; i < no_of_nodes; i++) {
+            if (parents[i] <= 0) {
+                /* i was not reached */
+                VECTOR(*inbound_edges)[i] = -1;
             } else {
-                if (VECTOR(indexv)[minnei]) {
-                    MATRIX(*res, i, (long int)(VECTOR(indexv)[minnei] - 1)) = mindist - 1.0;
-                    reached++;
-                    if (reached == no_of_to) {
-                        igraph_2wheap_clear(&Q);
-                        break;
-                    }
-                }
+                /* i was reached via the edge with ID = parents[i] - 1 */
+                VECTOR(*inbound_edges)[i] = parents[i] - 1;
             }
+        }
+    }
 
-            /* Now check all neighbors of 'minnei' for a shorter path */
-            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) minnei);
-            nlen = igraph_vector_size(neis);
-            for (j = 0; j < nlen; j++) {
-                long int edge = (long int) VECTOR(*neis)[j];
-                long int tto = IGRAPH_OTHER(graph, edge, minnei);
-                igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
-                if (!has) {
-                    /* This is the first non-infinite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
-                } else if (altdist < curdist) {
-                    /* This is a shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
-                }
+    /* Reconstruct the shortest paths based on vertex and/or edge IDs */
+    if (vertices || edges) {
+        for (IGRAPH_VIT_RESET(*vit), i = 0; !IGRAPH_VIT_END(*vit); IGRAPH_VIT_NEXT(*vit), i++) {
+            long int node = IGRAPH_VIT_GET(*vit);
+            long int size, act, edge;
+            igraph_vector_t *vvec = 0, *evec = 0;
+            if (vertices) {
+                vvec = VECTOR(*vertices)[i];
+                igraph_vector_clear(vvec);
+            }
+            if (edges) {
+                evec = VECTOR(*edges)[i];
+                igraph_vector_clear(evec);
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
-
-    } /* !IGRAPH_VIT_END(fromvit) */
+            IGRAPH_ALLOW_INTERRUPTION();
 
-    if (!all_to) {
-        igraph_vit_destroy(&tovit);
-        igraph_vector_destroy(&indexv);
-        IGRAPH_FINALLY_CLEAN(2);
+            size = 0;
+            act = node;
+            while (parents[act]) {
+                size++;
+                edge = parents[act] - 1;
+                act = IGRAPH_OTHER(graph, edge, act);
+            }
+            if (vvec) {
+                IGRAPH_CHECK(igraph_vector_resize(vvec, size + 1));
+                VECTOR(*vvec)[size] = node;
+            }
+            if (evec) {
+                IGRAPH_CHECK(igraph_vector_resize(evec, size));
+            }
+            act = node;
+            while (parents[act]) {
+                edge = parents[act] - 1;
+                act = IGRAPH_OTHER(graph, edge, act);
+                size--;
+                if (vvec) {
+                    VECTOR(*vvec)[size] = act;
+                }
+                if (evec) {
+                    VECTOR(*evec)[size] = edge;
+                }
+            }
+        }
     }
 
-    igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
-    igraph_vit_destroy(&fromvit);
-    IGRAPH_FINALLY_CLEAN(3);
-
     return 0;
 }
 
@@ -4605,15 +4773,16 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
                                        igraph_vector_long_t *predecessors,
                                        igraph_vector_long_t *inbound_edges) {
     /* Implementation details. This is the basic Dijkstra algorithm,
-       with a binary heap. The heap is indexed, i.e. it stores not only
+       with a 4-ary heap. The heap is indexed, i.e. it stores not only
        the distances, but also which vertex they belong to. The other
        mapping, i.e. getting the distance for a vertex is not in the
        heap (that would by the double-indexed heap), but in the result
        matrix.
 
+       With small integer weights the heap is a bucket queue, see
+       igraph_i_spqueue_t.
+
        Dirty tricks:
-       - the opposite of the distance is stored in the heap, as it is a
-         maximum heap and we need a minimum heap.
        - we don't use IGRAPH_INFINITY in the distance vector during the
          computation, as IGRAPH_FINITE() might involve a function call
          and we want to spare that. So we store distance+1.0 instead of
@@ -4626,7 +4795,7 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
     igraph_vit_t vit;
-    igraph_2wheap_t Q;
+    igraph_i_spqueue_t Q;
     igraph_lazy_inclist_t inclist;
     igraph_vector_t dists;
     long int *parents;
@@ -4655,8 +4824,8 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
         IGRAPH_ERROR("Size of `edges' and `to' should match", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+    IGRAPH_CHECK(igraph_i_spqueue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_spqueue_destroy, &Q);
     IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
     IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
 
@@ -4686,11 +4855,11 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
 
     VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
     parents[(long int)from] = 0;
-    igraph_2wheap_push_with_index(&Q, from, 0);
+    IGRAPH_CHECK(igraph_i_spqueue_push(&Q, from, 0));
 
-    while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-        long int nlen, minnei = igraph_2wheap_max_index(&Q);
-        igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
+    while (!igraph_i_spqueue_empty(&Q) && to_reach > 0) {
+        long int nlen, minnei;
+        igraph_real_t mindist = igraph_i_spqueue_delete_min(&Q, &minnei);
         igraph_vector_t *neis;
 
         IGRAPH_ALLOW_INTERRUPTION();
@@ -4712,101 +4881,26 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
                 /* This is the first finite distance */
                 VECTOR(dists)[tto] = altdist;
                 parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                IGRAPH_CHECK(igraph_i_spqueue_push(&Q, tto, altdist));
             } else if (altdist < curdist) {
                 /* This is a shorter path */
                 VECTOR(dists)[tto] = altdist;
                 parents[tto] = edge + 1;
-                IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                IGRAPH_CHECK(igraph_i_spqueue_modify(&Q, tto, altdist));
             }
         }
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_spqueue_empty(&Q) */
 
     if (to_reach > 0) {
         IGRAPH_WARNING("Couldn't reach some vertices");
     }
 
-    /* Create `predecessors' if needed */
-    if (predecessors) {
-        IGRAPH_CHECK(igraph_vector_long_resize(predecessors, no_of_nodes));
-
-        for (i = 0; i < no_of_nodes; i++) {
-            if (i == from) {
-                /* i is the start vertex */
-                VECTOR(*predecessors)[i] = i;
-            } else if (parents[i] <= 0) {
-                /* i was not reached */
-                VECTOR(*predecessors)[i] = -1;
-            } else {
-                /* i was reached via the edge with ID = parents[i] - 1 */
-                VECTOR(*predecessors)[i] = IGRAPH_OTHER(graph, parents[i] - 1, i);
-            }
-        }
-    }
-
-    /* Create `inbound_edges' if needed */
-    if (inbound_edges) {
-        IGRAPH_CHECK(igraph_vector_long_resize(inbound_edges, no_of_nodes));
-
-        for (i = 0; i < no_of_nodes; i++) {
-            if (parents[i] <= 0) {
-                /* i was not reached */
-                VECTOR(*inbound_edges)[i] = -1;
-            } else {
-                /* i was reached via the edge with ID = parents[i] - 1 */
-                VECTOR(*inbound_edges)[i] = parents[i] - 1;
-            }
-        }
-    }
-
-    /* Reconstruct the shortest paths based on vertex and/or edge IDs */
-    if (vertices || edges) {
-        for (IGRAPH_VIT_RESET(vit), i = 0; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit), i++) {
-            long int node = IGRAPH_VIT_GET(vit);
-            long int size, act, edge;
-            igraph_vector_t *vvec = 0, *evec = 0;
-            if (vertices) {
-                vvec = VECTOR(*vertices)[i];
-                igraph_vector_clear(vvec);
-            }
-            if (edges) {
-                evec = VECTOR(*edges)[i];
-                igraph_vector_clear(evec);
-            }
-
-            IGRAPH_ALLOW_INTERRUPTION();
-
-            size = 0;
-            act = node;
-            while (parents[act]) {
-                size++;
-                edge = parents[act] - 1;
-                act = IGRAPH_OTHER(graph, edge, act);
-            }
-            if (vvec) {
-                IGRAPH_CHECK(igraph_vector_resize(vvec, size + 1));
-                VECTOR(*vvec)[size] = node;
-            }
-            if (evec) {
-                IGRAPH_CHECK(igraph_vector_resize(evec, size));
-            }
-            act = node;
-            while (parents[act]) {
-                edge = parents[act] - 1;
-                act = IGRAPH_OTHER(graph, edge, act);
-                size--;
-                if (vvec) {
-                    VECTOR(*vvec)[size] = act;
-                }
-                if (evec) {
-                    VECTOR(*evec)[size] = edge;
-                }
-            }
-        }
-    }
+    IGRAPH_CHECK(igraph_i_shortest_path_tree_result(graph, vertices, edges, from,
+                 &vit, parents, predecessors,
+                 inbound_edges));
 
     igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_spqueue_destroy(&Q);
     igraph_vector_destroy(&dists);
     igraph_Free(is_target);
     igraph_Free(parents);
@@ -4823,7 +4917,12 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
  * Calculates a single (positively) weighted shortest path from
  * a single vertex to another one, using Dijkstra's algorithm.
  *
- * </para><para>This function is a special case (and a wrapper) to
+ * </para><para>With weights, this function runs a bidirectional
+ * search: Dijkstra's algorithm from the source and from the target
+ * at the same time, until the two searches are known to have found
+ * the shortest path. It usually visits only a small part of a large
+ * graph, and it only allocates memory for the vertices that it
+ * visits. Without weights it is a special case (and a wrapper) to
  * \ref igraph_get_shortest_paths_dijkstra().
  *
  * \param graph The input graph, it can be directed or undirected.
@@ -4850,7 +4949,8 @@ int igraph_get_shortest_paths_dijkstra(const igraph_t *graph,
  * |E| is the number of edges in the graph.
  *
  * \sa \ref igraph_get_shortest_paths_dijkstra() for the version with
- * more target vertices.
+ * more target vertices, \ref igraph_get_shortest_path_astar() for a
+ * search guided by a heuristic.
  */
 
 int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
@@ -4864,6 +4964,11 @@ int igraph_get_shortest_path_dijkstra(const igraph_t *graph,
     igraph_vector_ptr_t vertices2, *vp = &vertices2;
     igraph_vector_ptr_t edges2, *ep = &edges2;
 
+    if (weights) {
+        return igraph_i_get_shortest_path_bidijkstra(graph, vertices, edges,
+                from, to, weights, mode);
+    }
+
     if (vertices) {
         IGRAPH_CHECK(igraph_vector_ptr_init(&vertices2, 1));
         IGRAPH_FINALLY(igraph_vector_ptr_destroy, &vertices2);
@@ -4976,7 +5081,7 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
     igraph_vit_t vit;
-    igraph_2wheap_t Q;
+    igraph_i_spqueue_t Q;
     igraph_lazy_inclist_t inclist;
     igraph_vector_t dists, order;
     igraph_vector_ptr_t parents;
@@ -5028,9 +5133,9 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
     }
     IGRAPH_FINALLY(igraph_free, is_target);
 
-    /* two-way heap storing vertices and distances */
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+    /* heap storing vertices and distances */
+    IGRAPH_CHECK(igraph_i_spqueue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_spqueue_destroy, &Q);
 
     /* lazy adjacency edge list to query neighbours efficiently */
     IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
@@ -5051,11 +5156,11 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
     IGRAPH_FINALLY_CLEAN(1);
 
     VECTOR(dists)[(long int)from] = 0.0;  /* zero distance */
-    igraph_2wheap_push_with_index(&Q, from, 0);
+    IGRAPH_CHECK(igraph_i_spqueue_push(&Q, from, 0));
 
-    while (!igraph_2wheap_empty(&Q) && to_reach > 0) {
-        long int nlen, minnei = igraph_2wheap_max_index(&Q);
-        igraph_real_t mindist = -igraph_2wheap_delete_max(&Q);
+    while (!igraph_i_spqueue_empty(&Q) && to_reach > 0) {
+        long int nlen, minnei;
+        igraph_real_t mindist = igraph_i_spqueue_delete_min(&Q, &minnei);
         igraph_vector_t *neis;
 
         IGRAPH_ALLOW_INTERRUPTION();
@@ -5088,7 +5193,7 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
                 VECTOR(dists)[tto] = altdist;
                 parent_vec = (igraph_vector_t*)VECTOR(parents)[tto];
                 IGRAPH_CHECK(igraph_vector_push_back(parent_vec, minnei));
-                IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                IGRAPH_CHECK(igraph_i_spqueue_push(&Q, tto, altdist));
             } else if (altdist == curdist && VECTOR(*weights)[edge] > 0) {
                 /* This is an alternative path with exactly the same length.
                      * Note that we consider this case only if the edge via which we
@@ -5103,10 +5208,10 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
                 parent_vec = (igraph_vector_t*)VECTOR(parents)[tto];
                 igraph_vector_clear(parent_vec);
                 IGRAPH_CHECK(igraph_vector_push_back(parent_vec, minnei));
-                IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                IGRAPH_CHECK(igraph_i_spqueue_modify(&Q, tto, altdist));
             }
         }
-    } /* !igraph_2wheap_empty(&Q) */
+    } /* !igraph_i_spqueue_empty(&Q) */
 
     if (to_reach > 0) {
         IGRAPH_WARNING("Couldn't reach some vertices");
@@ -5114,7 +5219,7 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
 
     /* we don't need these anymore */
     igraph_lazy_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_spqueue_destroy(&Q);
     IGRAPH_FINALLY_CLEAN(2);
 
     /*
@@ -5337,6 +5442,179 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
     return 0;
 }
 
+/* Label-correcting shortest paths from a set of sources, for
+   igraph_shortest_paths_bellman_ford() and Johnson's algorithm. This
+   is the Bellman-Ford algorithm with a FIFO queue of the vertices
+   whose distance decreased, and Tarjan's subtree disassembly.
+
+   The tree of the current shortest paths is kept as a circular list
+   of its vertices in preorder, starting at a virtual root with index
+   no_of_nodes, whose children are the sources, and the depth of each
+   vertex in the tree; vertices not in the tree have depth -1. When
+   the distance of a vertex v decreases, the distances in its subtree
+   are too large, so the subtree is removed from the tree and v is
+   attached to its new parent u. The removed vertices are not scanned
+   until they are reached again, with a smaller or, because of
+   rounding, the same distance; this often saves most of the
+   relaxations. If u itself is in the removed subtree, then the
+   parents lead around a cycle of negative length, which is reported
+   right away, instead of after |V| rounds. */
+
+typedef struct igraph_i_bellman_ford_t {
+    const igraph_t *graph;
+    const igraph_vector_t *weights;
+    igraph_neimode_t mode;
+    igraph_vector_t dist;
+    igraph_vector_int_t next, prev, depth;
+    igraph_vector_char_t queued;
+    igraph_dqueue_int_t Q;
+} igraph_i_bellman_ford_t;
+
+static void igraph_i_bellman_ford_destroy(igraph_i_bellman_ford_t *bf) {
+    igraph_dqueue_int_destroy(&bf->Q);
+    igraph_vector_char_destroy(&bf->queued);
+    igraph_vector_int_destroy(&bf->depth);
+    igraph_vector_int_destroy(&bf->prev);
+    igraph_vector_int_destroy(&bf->next);
+    igraph_vector_destroy(&bf->dist);
+}
+
+static int igraph_i_bellman_ford_init(igraph_i_bellman_ford_t *bf,
+                                      const igraph_t *graph,
+                                      const igraph_vector_t *weights,
+                                      igraph_neimode_t mode) {
+    long int no_of_nodes = igraph_vcount(graph);
+
+    bf->graph = graph;
+    bf->weights = weights;
+    bf->mode = igraph_is_directed(graph) ? mode : IGRAPH_ALL;
+
+    IGRAPH_VECTOR_INIT_FINALLY(&bf->dist, no_of_nodes);
+    IGRAPH_CHECK(igraph_vector_int_init(&bf->next, no_of_nodes + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bf->next);
+    IGRAPH_CHECK(igraph_vector_int_init(&bf->prev, no_of_nodes + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bf->prev);
+    IGRAPH_CHECK(igraph_vector_int_init(&bf->depth, no_of_nodes + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &bf->depth);
+    IGRAPH_CHECK(igraph_vector_char_init(&bf->queued, no_of_nodes));
+    IGRAPH_FINALLY(igraph_vector_char_destroy, &bf->queued);
+    IGRAPH_CHECK(igraph_dqueue_int_init(&bf->Q, no_of_nodes + 1));
+    IGRAPH_FINALLY_CLEAN(5);
+
+    return 0;
+}
+
+/* Makes v the first child of u in the tree */
+
+static void igraph_i_bellman_ford_attach(igraph_i_bellman_ford_t *bf,
+        long int u, long int v) {
+    igraph_integer_t *next = VECTOR(bf->next), *prev = VECTOR(bf->prev);
+    next[v] = next[u];
+    prev[next[u]] = (igraph_integer_t) v;
+    next[u] = (igraph_integer_t) v;
+    prev[v] = (igraph_integer_t) u;
+    VECTOR(bf->depth)[v] = VECTOR(bf->depth)[u] + 1;
+}
+
+/* Distances from the nearest vertex of 'sources', they are left in
+   bf->dist, IGRAPH_INFINITY for the vertices that cannot be reached */
+
+static int igraph_i_bellman_ford_run(igraph_i_bellman_ford_t *bf,
+                                     const igraph_vector_t *sources) {
+    const igraph_t *graph = bf->graph;
+    long int no_of_nodes = igraph_vcount(graph);
+    long int root = no_of_nodes;
+    long int i, n = igraph_vector_size(sources), scanned = 0;
+    igraph_real_t *dist = VECTOR(bf->dist);
+    igraph_integer_t *next = VECTOR(bf->next), *prev = VECTOR(bf->prev);
+    igraph_integer_t *depth = VECTOR(bf->depth);
+    const igraph_real_t *weights = VECTOR(*bf->weights);
+
+    igraph_vector_fill(&bf->dist, IGRAPH_INFINITY);
+    igraph_vector_int_fill(&bf->depth, -1);
+    igraph_vector_char_null(&bf->queued);
+    igraph_dqueue_int_clear(&bf->Q);
+    next[root] = prev[root] = (igraph_integer_t) root;
+    depth[root] = 0;
+
+    for (i = 0; i < n; i++) {
+        long int s = (long int) VECTOR(*sources)[i];
+        if (depth[s] < 0) {
+            dist[s] = 0.0;
+            igraph_i_bellman_ford_attach(bf, root, s);
+            VECTOR(bf->queued)[s] = 1;
+            IGRAPH_CHECK(igraph_dqueue_int_push(&bf->Q, (igraph_integer_t) s));
+        }
+    }
+
+    while (!igraph_dqueue_int_empty(&bf->Q)) {
+        long int u = igraph_dqueue_int_pop(&bf->Q);
+        int pass;
+
+        VECTOR(bf->queued)[u] = 0;
+        /* Removed from the tree since it was queued: it will be
+           reached again with a smaller distance */
+        if (depth[u] < 0) {
+            continue;
+        }
+        if (++scanned % no_of_nodes == 0) {
+            IGRAPH_ALLOW_INTERRUPTION();
+        }
+
+        for (pass = 0; pass < 2; pass++) {
+            const igraph_integer_t *index, *other;
+            igraph_integer_t k, begin, end;
+            if (pass == 0 && (bf->mode & IGRAPH_OUT)) {
+                begin = VECTOR(graph->os)[u]; end = VECTOR(graph->os)[u + 1];
+                index = VECTOR(graph->oi); other = VECTOR(graph->to);
+            } else if (pass == 1 && (bf->mode & IGRAPH_IN)) {
+                begin = VECTOR(graph->is)[u]; end = VECTOR(graph->is)[u + 1];
+                index = VECTOR(graph->ii); other = VECTOR(graph->from);
+            } else {
+                continue;
+            }
+            for (k = begin; k < end; k++) {
+                igraph_integer_t edge = index[k];
+                long int v = other[edge];
+                igraph_real_t altdist = dist[u] + weights[edge];
+                if (!(altdist < dist[v])) {
+                    /* A removed vertex is also attached again if its
+                       distance did not change: the decrease of an
+                       ancestor may be lost to rounding on the way
+                       down, then it would never be scanned again */
+                    if (depth[v] >= 0 || altdist != dist[v] ||
+                        altdist == IGRAPH_INFINITY) {
+                        continue;
+                    }
+                } else if (depth[v] >= 0) {
+                    /* Disassemble the subtree of v: it is v and the
+                       vertices after it in preorder that are deeper */
+                    igraph_integer_t d = depth[v], before = prev[v];
+                    long int x = v;
+                    do {
+                        if (x == u) {
+                            IGRAPH_ERROR("cannot run Bellman-Ford algorithm",
+                                         IGRAPH_ENEGLOOP);
+                        }
+                        depth[x] = -1;
+                        x = next[x];
+                    } while (depth[x] > d);
+                    next[before] = (igraph_integer_t) x;
+                    prev[x] = before;
+                }
+                dist[v] = altdist;
+                igraph_i_bellman_ford_attach(bf, u, v);
+                if (!VECTOR(bf->queued)[v]) {
+                    VECTOR(bf->queued)[v] = 1;
+                    IGRAPH_CHECK(igraph_dqueue_int_push(&bf->Q, (igraph_integer_t) v));
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
 /**
  * \function igraph_shortest_paths_bellman_ford
  * Weighted shortest paths from some sources allowing negative weights.
@@ -5346,6 +5624,15 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
  * independently for the given sources.). If there are no negative
  * weights, you are better off with \ref igraph_shortest_paths_dijkstra() .
  *
+ * </para><para>
+ * Only the vertices whose distance decreased are scanned again, in
+ * first-in first-out order, and when the distance of a vertex
+ * decreases, the vertices whose shortest paths go through it are not
+ * scanned until they are reached again (Tarjan's subtree
+ * disassembly). This usually needs far fewer relaxations than |V|
+ * rounds, and a negative cycle is found as soon as the tree of
+ * shortest paths closes it.
+ *
  * \param graph The input graph, can be directed.
  * \param res The result, a matrix. A pointer to an initialized matrix
  *    should be passed here, the matrix will be resized if needed.
@@ -5364,8 +5651,9 @@ int igraph_get_all_shortest_paths_dijkstra(const igraph_t *graph,
  *    for undirected graphs.
  * \return Error code.
  *
- * Time complexity: O(s*|E|*|V|), where |V| is the number of
- * vertices, |E| the number of edges and s the number of sources.
+ * Time complexity: O(s*|E|*|V|) in the worst case, where |V| is the
+ * number of vertices, |E| the number of edges and s the number of
+ * sources.
  *
  * \sa \ref igraph_shortest_paths() for a faster unweighted version
  * or \ref igraph_shortest_paths_dijkstra() if you do not have negative
@@ -5380,27 +5668,14 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
                                        const igraph_vs_t to,
                                        const igraph_vector_t *weights,
                                        igraph_neimode_t mode) {
-    long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_lazy_inclist_t inclist;
-    long int i, j, k;
+    igraph_i_bellman_ford_t bf;
+    igraph_vector_t source;
+    long int i, j;
     long int no_of_from, no_of_to;
-    igraph_dqueue_t Q;
-    igraph_vector_t clean_vertices;
-    igraph_vector_t num_queued;
     igraph_vit_t fromvit, tovit;
-    igraph_real_t my_infinity = IGRAPH_INFINITY;
     igraph_bool_t all_to;
-    igraph_vector_t dist;
 
-    /*
-       - speedup: a vertex is marked clean if its distance from the source
-         did not change during the last phase. Neighbors of a clean vertex
-         are not relaxed again, since it would mean no change in the
-         shortest path values. Dirty vertices are queued. Negative loops can
-         be detected by checking whether a vertex has been queued at least
-         n times.
-    */
     if (!weights) {
         return igraph_shortest_paths(graph, res, from, to, mode);
     }
@@ -5408,103 +5683,104 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
     if (igraph_vector_size(weights) != no_of_edges) {
         IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
     }
+    if (mode != IGRAPH_OUT && mode != IGRAPH_IN && mode != IGRAPH_ALL) {
+        IGRAPH_ERROR("Invalid mode argument", IGRAPH_EINVMODE);
+    }
 
     IGRAPH_CHECK(igraph_vit_create(graph, from, &fromvit));
     IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
     no_of_from = IGRAPH_VIT_SIZE(fromvit);
 
-    IGRAPH_DQUEUE_INIT_FINALLY(&Q, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&clean_vertices, no_of_nodes);
-    IGRAPH_VECTOR_INIT_FINALLY(&num_queued, no_of_nodes);
-    IGRAPH_CHECK(igraph_lazy_inclist_init(graph, &inclist, mode));
-    IGRAPH_FINALLY(igraph_lazy_inclist_destroy, &inclist);
+    IGRAPH_CHECK(igraph_i_bellman_ford_init(&bf, graph, weights, mode));
+    IGRAPH_FINALLY(igraph_i_bellman_ford_destroy, &bf);
+    IGRAPH_VECTOR_INIT_FINALLY(&source, 1);
 
     if ( (all_to = igraph_vs_is_all(&to)) ) {
-        no_of_to = no_of_nodes;
+        no_of_to = igraph_vcount(graph);
     } else {
         IGRAPH_CHECK(igraph_vit_create(graph, to, &tovit));
         IGRAPH_FINALLY(igraph_vit_destroy, &tovit);
         no_of_to = IGRAPH_VIT_SIZE(tovit);
     }
 
-    IGRAPH_VECTOR_INIT_FINALLY(&dist, no_of_nodes);
     IGRAPH_CHECK(igraph_matrix_resize(res, no_of_from, no_of_to));
 
     for (IGRAPH_VIT_RESET(fromvit), i = 0;
          !IGRAPH_VIT_END(fromvit);
          IGRAPH_VIT_NEXT(fromvit), i++) {
-        long int source = IGRAPH_VIT_GET(fromvit);
 
-        igraph_vector_fill(&dist, my_infinity);
-        VECTOR(dist)[source] = 0;
-        igraph_vector_null(&clean_vertices);
-        igraph_vector_null(&num_queued);
-
-        /* Fill the queue with vertices to be checked */
-        for (j = 0; j < no_of_nodes; j++) {
-            IGRAPH_CHECK(igraph_dqueue_push(&Q, j));
-        }
-
-        while (!igraph_dqueue_empty(&Q)) {
-            igraph_vector_t *neis;
-            long int nlen;
-
-            j = (long int) igraph_dqueue_pop(&Q);
-            VECTOR(clean_vertices)[j] = 1;
-            VECTOR(num_queued)[j] += 1;
-            if (VECTOR(num_queued)[j] > no_of_nodes) {
-                IGRAPH_ERROR("cannot run Bellman-Ford algorithm", IGRAPH_ENEGLOOP);
-            }
-
-            /* If we cannot get to j in finite time yet, there is no need to relax
-             * its edges */
-            if (!IGRAPH_FINITE(VECTOR(dist)[j])) {
-                continue;
-            }
-
-            neis = igraph_lazy_inclist_get(&inclist, (igraph_integer_t) j);
-            nlen = igraph_vector_size(neis);
-
-            for (k = 0; k < nlen; k++) {
-                long int nei = (long int) VECTOR(*neis)[k];
-                long int target = IGRAPH_OTHER(graph, nei, j);
-                if (VECTOR(dist)[target] > VECTOR(dist)[j] + VECTOR(*weights)[nei]) {
-                    /* relax the edge */
-                    VECTOR(dist)[target] = VECTOR(dist)[j] + VECTOR(*weights)[nei];
-                    if (VECTOR(clean_vertices)[target]) {
-                        VECTOR(clean_vertices)[target] = 0;
-                        IGRAPH_CHECK(igraph_dqueue_push(&Q, target));
-                    }
-                }
-            }
-        }
+        VECTOR(source)[0] = IGRAPH_VIT_GET(fromvit);
+        IGRAPH_CHECK(igraph_i_bellman_ford_run(&bf, &source));
 
         /* Copy it to the result */
         if (all_to) {
-            igraph_matrix_set_row(res, &dist, i);
+            igraph_matrix_set_row(res, &bf.dist, i);
         } else {
             for (IGRAPH_VIT_RESET(tovit), j = 0; !IGRAPH_VIT_END(tovit);
                  IGRAPH_VIT_NEXT(tovit), j++) {
                 long int v = IGRAPH_VIT_GET(tovit);
-                MATRIX(*res, i, j) = VECTOR(dist)[v];
+                MATRIX(*res, i, j) = VECTOR(bf.dist)[v];
             }
         }
     }
 
-    igraph_vector_destroy(&dist);
-    IGRAPH_FINALLY_CLEAN(1);
-
     if (!all_to) {
         igraph_vit_destroy(&tovit);
         IGRAPH_FINALLY_CLEAN(1);
     }
 
+    igraph_vector_destroy(&source);
+    igraph_i_bellman_ford_destroy(&bf);
     igraph_vit_destroy(&fromvit);
-    igraph_dqueue_destroy(&Q);
-    igraph_vector_destroy(&clean_vertices);
-    igraph_vector_destroy(&num_queued);
-    igraph_lazy_inclist_destroy(&inclist);
-    IGRAPH_FINALLY_CLEAN(5);
+    IGRAPH_FINALLY_CLEAN(3);
+
+    return 0;
+}
+
+/* The potentials of Johnson's algorithm: the distances from a new
+   vertex that has a zero weight edge to every vertex, i.e. the
+   distances from the nearest of all vertices, computed with the
+   Bellman-Ford algorithm. 'newweights' gets the reweighted edge
+   weights w(u,v) + h(u) - h(v), these are non-negative. */
+
+static int igraph_i_johnson_reweight(const igraph_t *graph,
+                                     const igraph_vector_t *weights,
+                                     igraph_vector_t *newweights,
+                                     igraph_vector_t *potential) {
+
+    long int no_of_nodes = igraph_vcount(graph);
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_i_bellman_ford_t bf;
+    igraph_vector_t sources;
+    long int i;
+
+    if (!igraph_is_directed(graph)) {
+        IGRAPH_ERROR("Johnson's shortest path: undirected graph and negative weight",
+                     IGRAPH_EINVAL);
+    }
+
+    IGRAPH_CHECK(igraph_vector_init_seq(&sources, 0, no_of_nodes - 1));
+    IGRAPH_FINALLY(igraph_vector_destroy, &sources);
+    IGRAPH_CHECK(igraph_i_bellman_ford_init(&bf, graph, weights, IGRAPH_OUT));
+    IGRAPH_FINALLY(igraph_i_bellman_ford_destroy, &bf);
+
+    IGRAPH_CHECK(igraph_i_bellman_ford_run(&bf, &sources));
+
+    /* Now the edges of the original graph are reweighted, using the
+       values from the BF algorithm. Instead of w(u,v) we will have
+       w(u,v) + h(u) - h(v) */
+
+    IGRAPH_CHECK(igraph_vector_update(newweights, weights));
+    for (i = 0; i < no_of_edges; i++) {
+        long int ffrom = IGRAPH_FROM(graph, i);
+        long int tto = IGRAPH_TO(graph, i);
+        VECTOR(*newweights)[i] += VECTOR(bf.dist)[ffrom] - VECTOR(bf.dist)[tto];
+    }
+    IGRAPH_CHECK(igraph_vector_update(potential, &bf.dist));
+
+    igraph_i_bellman_ford_destroy(&bf);
+    igraph_vector_destroy(&sources);
+    IGRAPH_FINALLY_CLEAN(2);
 
     return 0;
 }
@@ -5525,6 +5801,11 @@ int igraph_shortest_paths_bellman_ford(const igraph_t *graph,
  * then Dijkstra's algorithm is used by calling
  * \ref igraph_shortest_paths_dijkstra().
  *
+ * </para><para> The searches from the sources run on multiple
+ * threads, see \ref igraph_set_num_threads(). For many sources, \ref
+ * igraph_shortest_paths_johnson_callback() and \ref
+ * igraph_shortest_paths_johnson_float() need less memory.
+ *
  * \param graph The input graph, typically it is directed.
  * \param res Pointer to an initialized matrix, the result will be
  *   stored here, one line for each source vertex, one column for each
@@ -5552,14 +5833,8 @@ int igraph_shortest_paths_johnson(const igraph_t *graph,
                                   const igraph_vs_t to,
                                   const igraph_vector_t *weights) {
 
-    long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
-    igraph_t newgraph;
-    igraph_vector_t edges, newweights;
-    igraph_matrix_t bfres;
-    long int i, ptr;
-    long int nr, nc;
-    igraph_vit_t fromvit;
+    igraph_vector_t newweights, potential;
 
     /* If no weights, then we can just run the unweighted version */
     if (!weights) {
@@ -5576,104 +5851,210 @@ int igraph_shortest_paths_johnson(const igraph_t *graph,
                                               weights, IGRAPH_OUT);
     }
 
-    if (!igraph_is_directed(graph)) {
-        IGRAPH_ERROR("Johnson's shortest path: undirected graph and negative weight",
-                     IGRAPH_EINVAL);
-    }
-
     /* ------------------------------------------------------------ */
     /* -------------------- Otherwise proceed --------------------- */
 
-    IGRAPH_MATRIX_INIT_FINALLY(&bfres, 0, 0);
     IGRAPH_VECTOR_INIT_FINALLY(&newweights, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&potential, 0);
+    IGRAPH_CHECK(igraph_i_johnson_reweight(graph, weights, &newweights,
+                                           &potential));
 
-    IGRAPH_CHECK(igraph_empty(&newgraph, (igraph_integer_t) no_of_nodes + 1,
-                              igraph_is_directed(graph)));
-    IGRAPH_FINALLY(igraph_destroy, &newgraph);
+    /* Run Dijkstra's algorithm on the new weights, the distances are
+       corrected with the potentials as they are found */
+    IGRAPH_CHECK(igraph_i_shortest_paths_dijkstra(graph, res, from, to,
+                 &newweights, IGRAPH_OUT,
+                 &potential));
 
-    /* Add a new node to the graph, plus edges from it to all the others. */
-    IGRAPH_VECTOR_INIT_FINALLY(&edges, no_of_edges * 2 + no_of_nodes * 2);
-    igraph_get_edgelist(graph, &edges, /*bycol=*/ 0);
-    igraph_vector_resize(&edges, no_of_edges * 2 + no_of_nodes * 2);
-    for (i = 0, ptr = no_of_edges * 2; i < no_of_nodes; i++) {
-        VECTOR(edges)[ptr++] = no_of_nodes;
-        VECTOR(edges)[ptr++] = i;
-    }
-    IGRAPH_CHECK(igraph_add_edges(&newgraph, &edges, 0));
-    igraph_vector_destroy(&edges);
-    IGRAPH_FINALLY_CLEAN(1);
+    igraph_vector_destroy(&potential);
+    igraph_vector_destroy(&newweights);
+    IGRAPH_FINALLY_CLEAN(2);
 
-    IGRAPH_CHECK(igraph_vector_reserve(&newweights, no_of_edges + no_of_nodes));
-    igraph_vector_update(&newweights, weights);
-    igraph_vector_resize(&newweights, no_of_edges + no_of_nodes);
-    for (i = no_of_edges; i < no_of_edges + no_of_nodes; i++) {
-        VECTOR(newweights)[i] = 0;
+    return 0;
+}
+
+/**
+ * \function igraph_shortest_paths_johnson_callback
+ * \brief Shortest path lengths from many sources, passed to a callback row by row.
+ *
+ * Computes the same distances as \ref igraph_shortest_paths_johnson(),
+ * but instead of storing the whole matrix, it calls \p handler with
+ * the distances from each source, in the order of the sources. Only
+ * a few rows are kept in memory at a time, so this works for more
+ * sources than what would fit into a matrix; the handler can write
+ * the rows to a file, or keep them in a more compact form, e.g. as
+ * single precision or quantized numbers.
+ *
+ * </para><para>
+ * The searches from the sources run on multiple threads, see \ref
+ * igraph_set_num_threads(), but \p handler is always called from the
+ * calling thread.
+ *
+ * \param graph The input graph, typically it is directed.
+ * \param from The source vertices.
+ * \param to The target vertices. It is not allowed to include a
+ *   vertex twice or more.
+ * \param weights Optional edge weights. If it is a null-pointer, then
+ *   every edge has length one. Negative weights are allowed in
+ *   directed graphs, as long as there is no negative cycle.
+ * \param handler The function to call with each row, see \ref
+ *   igraph_shortest_paths_row_handler_t. If it returns false, then
+ *   no more rows are computed.
+ * \param arg Extra argument to pass to \p handler.
+ * \return Error code.
+ *
+ * Time complexity: O(s|E|log|V|+|V||E|), |V| and |E| are the number
+ * of vertices and edges, s is the number of source vertices, plus the
+ * time of the calls to \p handler. The additional memory is
+ * O(t|V|) for t threads.
+ *
+ * \sa \ref igraph_shortest_paths_johnson_float().
+ */
+
+int igraph_shortest_paths_johnson_callback(const igraph_t *graph,
+        const igraph_vs_t from,
+        const igraph_vs_t to,
+        const igraph_vector_t *weights,
+        igraph_shortest_paths_row_handler_t *handler,
+        void *arg) {
+
+    long int no_of_edges = igraph_ecount(graph);
+    igraph_i_dijkstra_rows_t d;
+    igraph_vector_t newweights, potential, sources, indexv, rows, row;
+    igraph_bool_t negative, cont = 1;
+    long int no_of_from, no_of_to, block, first, i;
+
+    if (weights && igraph_vector_size(weights) != no_of_edges) {
+        IGRAPH_ERROR("Weight vector length does not match", IGRAPH_EINVAL);
     }
+    negative = weights && no_of_edges > 0 && igraph_vector_min(weights) < 0;
 
-    /* Run Bellmann-Ford algorithm on the new graph, starting from the
-       new vertex.  */
+    IGRAPH_VECTOR_INIT_FINALLY(&newweights, 0);
+    IGRAPH_VECTOR_INIT_FINALLY(&potential, 0);
+    if (negative) {
+        IGRAPH_CHECK(igraph_i_johnson_reweight(graph, weights, &newweights,
+                                               &potential));
+    } else if (weights) {
+        IGRAPH_CHECK(igraph_vector_update(&newweights, weights));
+    } else {
+        IGRAPH_CHECK(igraph_vector_resize(&newweights, no_of_edges));
+        igraph_vector_fill(&newweights, 1.0);
+    }
+
+    IGRAPH_VECTOR_INIT_FINALLY(&sources, 0);
+    IGRAPH_CHECK(igraph_vs_as_vector(graph, from, &sources));
+    no_of_from = igraph_vector_size(&sources);
+    IGRAPH_VECTOR_INIT_FINALLY(&indexv, 0);
+    IGRAPH_CHECK(igraph_i_dijkstra_targets(graph, to, &indexv, &no_of_to));
+
+    IGRAPH_CHECK(igraph_i_dijkstra_rows_init(&d, graph, &newweights,
+                 IGRAPH_OUT, &sources,
+                 negative ? &potential : 0,
+                 igraph_vs_is_all(&to) ? 0 : &indexv, no_of_to));
+    IGRAPH_FINALLY(igraph_i_dijkstra_rows_destroy, &d);
+
+    /* Two rows for each thread are computed at a time */
+    block = 2 * igraph_vector_ptr_size(&d.queues);
+    if (block > no_of_from) {
+        block = no_of_from;
+    }
+    IGRAPH_VECTOR_INIT_FINALLY(&rows, block * no_of_to);
+    d.res = VECTOR(rows);
+    d.row_stride = no_of_to;
+    d.col_stride = 1;
+
+    for (first = 0; cont && first < no_of_from; first += block) {
+        long int n = no_of_from - first < block ? no_of_from - first : block;
+        igraph_vector_fill(&rows, IGRAPH_INFINITY);
+        IGRAPH_CHECK(igraph_i_dijkstra_rows(&d, first, n));
+        for (i = 0; cont && i < n; i++) {
+            igraph_vector_view(&row, VECTOR(rows) + i * no_of_to, no_of_to);
+            cont = handler((igraph_integer_t) VECTOR(sources)[first + i],
+                           &row, arg);
+        }
+    }
+
+    igraph_vector_destroy(&rows);
+    igraph_i_dijkstra_rows_destroy(&d);
+    igraph_vector_destroy(&indexv);
+    igraph_vector_destroy(&sources);
+    igraph_vector_destroy(&potential);
+    igraph_vector_destroy(&newweights);
+    IGRAPH_FINALLY_CLEAN(6);
 
-    IGRAPH_CHECK(igraph_shortest_paths_bellman_ford(&newgraph, &bfres,
-                 igraph_vss_1((igraph_integer_t) no_of_nodes),
-                 igraph_vss_all(), &newweights, IGRAPH_OUT));
+    return 0;
+}
 
-    igraph_destroy(&newgraph);
-    IGRAPH_FINALLY_CLEAN(1);
+typedef struct igraph_i_johnson_float_t {
+    float *res;
+    long int row, no_of_to;
+} igraph_i_johnson_float_t;
 
-    /* Now the edges of the original graph are reweighted, using the
-       values from the BF algorithm. Instead of w(u,v) we will have
-       w(u,v) + h(u) - h(v) */
+static igraph_bool_t igraph_i_johnson_float_handler(igraph_integer_t source,
+        const igraph_vector_t *distances,
+        void *arg) {
+    igraph_i_johnson_float_t *data = arg;
+    float *res = data->res + data->row * data->no_of_to;
+    long int j;
 
-    igraph_vector_resize(&newweights, no_of_edges);
-    for (i = 0; i < no_of_edges; i++) {
-        long int ffrom = IGRAPH_FROM(graph, i);
-        long int tto = IGRAPH_TO(graph, i);
-        VECTOR(newweights)[i] += MATRIX(bfres, 0, ffrom) - MATRIX(bfres, 0, tto);
+    IGRAPH_UNUSED(source);
+    for (j = 0; j < data->no_of_to; j++) {
+        res[j] = (float) VECTOR(*distances)[j];
     }
+    data->row++;
 
-    /* Run Dijkstra's algorithm on the new weights */
-    IGRAPH_CHECK(igraph_shortest_paths_dijkstra(graph, res, from,
-                 to, &newweights,
-                 IGRAPH_OUT));
-
-    igraph_vector_destroy(&newweights);
-    IGRAPH_FINALLY_CLEAN(1);
+    return 1;
+}
 
-    /* Reweight the shortest paths */
-    nr = igraph_matrix_nrow(res);
-    nc = igraph_matrix_ncol(res);
+/**
+ * \function igraph_shortest_paths_johnson_float
+ * \brief Shortest path lengths from many sources, in single precision.
+ *
+ * Computes the same distances as \ref igraph_shortest_paths_johnson(),
+ * but stores them as \c float numbers, in half the memory of a
+ * matrix. Unreachable vertices have infinite distance.
+ *
+ * </para><para>
+ * The searches from the sources run on multiple threads, see \ref
+ * igraph_set_num_threads().
+ *
+ * \param graph The input graph, typically it is directed.
+ * \param res Pointer to an array with room for at least as many
+ *   numbers as the number of sources times the number of targets.
+ *   Unlike in an \ref igraph_matrix_t, the distances are stored row by
+ *   row: the distance from the i-th source to the j-th target is
+ *   <code>res[i * nt + j]</code>, where \c nt is the number of targets.
+ * \param from The source vertices.
+ * \param to The target vertices. It is not allowed to include a
+ *   vertex twice or more.
+ * \param weights Optional edge weights. If it is a null-pointer, then
+ *   every edge has length one. Negative weights are allowed in
+ *   directed graphs, as long as there is no negative cycle.
+ * \return Error code.
+ *
+ * Time complexity: the same as for \ref
+ * igraph_shortest_paths_johnson_callback().
+ */
 
-    IGRAPH_CHECK(igraph_vit_create(graph, from, &fromvit));
-    IGRAPH_FINALLY(igraph_vit_destroy, &fromvit);
+int igraph_shortest_paths_johnson_float(const igraph_t *graph,
+                                        float *res,
+                                        const igraph_vs_t from,
+                                        const igraph_vs_t to,
+                                        const igraph_vector_t *weights) {
+    igraph_i_johnson_float_t data;
+    igraph_integer_t no_of_to;
 
-    for (i = 0; i < nr; i++, IGRAPH_VIT_NEXT(fromvit)) {
-        long int v1 = IGRAPH_VIT_GET(fromvit);
-        if (igraph_vs_is_all(&to)) {
-            long int v2;
-            for (v2 = 0; v2 < nc; v2++) {
-                igraph_real_t sub = MATRIX(bfres, 0, v1) - MATRIX(bfres, 0, v2);
-                MATRIX(*res, i, v2) -= sub;
-            }
-        } else {
-            long int j;
-            igraph_vit_t tovit;
-            IGRAPH_CHECK(igraph_vit_create(graph, to, &tovit));
-            IGRAPH_FINALLY(igraph_vit_destroy, &tovit);
-            for (j = 0, IGRAPH_VIT_RESET(tovit); j < nc; j++, IGRAPH_VIT_NEXT(tovit)) {
-                long int v2 = IGRAPH_VIT_GET(tovit);
-                igraph_real_t sub = MATRIX(bfres, 0, v1) - MATRIX(bfres, 0, v2);
-                MATRIX(*res, i, v2) -= sub;
-            }
-            igraph_vit_destroy(&tovit);
-            IGRAPH_FINALLY_CLEAN(1);
-        }
+    if (igraph_vs_is_all(&to)) {
+        no_of_to = igraph_vcount(graph);
+    } else {
+        IGRAPH_CHECK(igraph_vs_size(graph, &to, &no_of_to));
     }
 
-    igraph_vit_destroy(&fromvit);
-    igraph_matrix_destroy(&bfres);
-    IGRAPH_FINALLY_CLEAN(2);
+    data.res = res;
+    data.row = 0;
+    data.no_of_to = no_of_to;
 
-    return 0;
+    return igraph_shortest_paths_johnson_callback(graph, from, to, weights,
+            igraph_i_johnson_float_handler, &data);
 }
 
 /**
@@ -6253,6 +6634,10 @@ int igraph_strength(const igraph_t *graph, igraph_vector_t *res,
  *        returned.
  * \return Error code.
  *
+ * If only \p pres is requested, the diameter is computed by \ref
+ * igraph_diameter_radius(), which usually needs much fewer
+ * searches.
+ *
  * Time complexity: O(|V||E|*log|E|), |V| is the number of vertices,
  * |E| is the number of edges.
  */
@@ -6267,15 +6652,15 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
                              igraph_bool_t unconn) {
 
     /* Implementation details. This is the basic Dijkstra algorithm,
-       with a binary heap. The heap is indexed, i.e. it stores not only
+       with a 4-ary heap. The heap is indexed, i.e. it stores not only
        the distances, but also which vertex they belong to.
 
-       From now on we use a 2-way heap, so the distances can be queried
-       directly from the heap.
+       From now on we use a 4-ary heap with two-way indexing, so the
+       distances can be queried directly from the heap. With small
+       integer weights it is a bucket queue instead, see
+       igraph_i_spqueue_t.
 
        Dirty tricks:
-       - the opposite of the distance is stored in the heap, as it is a
-         maximum heap and we need a minimum heap.
        - we don't use IGRAPH_INFINITY during the computation, as IGRAPH_FINITE()
          might involve a function call and we want to spare that. -1 will denote
          infinity instead.
@@ -6284,7 +6669,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     long int no_of_nodes = igraph_vcount(graph);
     long int no_of_edges = igraph_ecount(graph);
 
-    igraph_2wheap_t Q;
+    igraph_i_spqueue_t Q;
     igraph_inclist_t inclist;
     long int source, j;
     igraph_neimode_t dirmode = directed ? IGRAPH_OUT : IGRAPH_ALL;
@@ -6310,8 +6695,14 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
         IGRAPH_ERROR("Weight vector must be non-negative", IGRAPH_EINVAL);
     }
 
-    IGRAPH_CHECK(igraph_2wheap_init(&Q, no_of_nodes));
-    IGRAPH_FINALLY(igraph_2wheap_destroy, &Q);
+    /* Only the length is needed, bound the eccentricities */
+    if (no_of_nodes > 0 && !pfrom && !pto && !path) {
+        return igraph_i_diameter_radius(graph, weights, pres, /* radius= */ 0,
+                                        dirmode, unconn, /* searches= */ 0);
+    }
+
+    IGRAPH_CHECK(igraph_i_spqueue_init(&Q, no_of_nodes, weights));
+    IGRAPH_FINALLY(igraph_i_spqueue_destroy, &Q);
     IGRAPH_CHECK(igraph_inclist_init(graph, &inclist, dirmode));
     IGRAPH_FINALLY(igraph_inclist_destroy, &inclist);
 
@@ -6320,14 +6711,14 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
         IGRAPH_PROGRESS("Weighted diameter: ", source * 100.0 / no_of_nodes, NULL);
         IGRAPH_ALLOW_INTERRUPTION();
 
-        igraph_2wheap_clear(&Q);
-        igraph_2wheap_push_with_index(&Q, source, -1.0);
+        igraph_i_spqueue_clear(&Q);
+        IGRAPH_CHECK(igraph_i_spqueue_push(&Q, source, 1.0));
 
         nodes_reached = 0.0;
 
-        while (!igraph_2wheap_empty(&Q)) {
-            long int minnei = igraph_2wheap_max_index(&Q);
-            igraph_real_t mindist = -igraph_2wheap_deactivate_max(&Q);
+        while (!igraph_i_spqueue_empty(&Q)) {
+            long int minnei;
+            igraph_real_t mindist = igraph_i_spqueue_deactivate_min(&Q, &minnei);
             igraph_vector_int_t *neis;
             long int nlen;
 
@@ -6343,20 +6734,20 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
                 long int edge = (long int) VECTOR(*neis)[j];
                 long int tto = IGRAPH_OTHER(graph, edge, minnei);
                 igraph_real_t altdist = mindist + VECTOR(*weights)[edge];
-                igraph_bool_t active = igraph_2wheap_has_active(&Q, tto);
-                igraph_bool_t has = igraph_2wheap_has_elem(&Q, tto);
-                igraph_real_t curdist = active ? -igraph_2wheap_get(&Q, tto) : 0.0;
+                igraph_bool_t active = igraph_i_spqueue_has_active(&Q, tto);
+                igraph_bool_t has = igraph_i_spqueue_has_elem(&Q, tto);
+                igraph_real_t curdist = active ? igraph_i_spqueue_get(&Q, tto) : 0.0;
 
                 if (!has) {
                     /* First finite distance */
-                    IGRAPH_CHECK(igraph_2wheap_push_with_index(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_spqueue_push(&Q, tto, altdist));
                 } else if (altdist < curdist) {
                     /* A shorter path */
-                    IGRAPH_CHECK(igraph_2wheap_modify(&Q, tto, -altdist));
+                    IGRAPH_CHECK(igraph_i_spqueue_modify(&Q, tto, altdist));
                 }
             }
 
-        } /* !igraph_2wheap_empty(&Q) */
+        } /* !igraph_i_spqueue_empty(&Q) */
 
         /* not connected, return infinity */
         if (nodes_reached != no_of_nodes && !unconn) {
@@ -6371,7 +6762,7 @@ int igraph_diameter_dijkstra(const igraph_t *graph,
     res -= 1;
 
     igraph_inclist_destroy(&inclist);
-    igraph_2wheap_destroy(&Q);
+    igraph_i_spqueue_destroy(&Q);
     IGRAPH_FINALLY_CLEAN(2);
 
     IGRAPH_PROGRESS("Weighted diameter: ", 100.0, NULL);
@@ -27,6 +27,7 @@
 #include "igraph_constants.h"
 #include "igraph_types.h"
 #include "igraph_iterators.h"
+#include "igraph_vector_ptr.h"
 
 int igraph_i_induced_subgraph_suggest_implementation(
     const igraph_t *graph, const igraph_vs_t vids,
@@ -44,4 +45,29 @@ int igraph_i_subgraph_create_from_scratch(const igraph_t *graph,
         igraph_vector_t *map,
         igraph_vector_t *invmap);
 
+int igraph_i_diameter_radius(const igraph_t *graph,
+                             const igraph_vector_t *weights,
+                             igraph_real_t *diameter,
+                             igraph_real_t *radius,
+                             igraph_neimode_t mode,
+                             igraph_bool_t unconn,
+                             igraph_integer_t *searches);
+
+int igraph_i_get_shortest_path_bidijkstra(const igraph_t *graph,
+        igraph_vector_t *vertices,
+        igraph_vector_t *edges,
+        igraph_integer_t from,
+        igraph_integer_t to,
+        const igraph_vector_t *weights,
+        igraph_neimode_t mode);
+
+int igraph_i_shortest_path_tree_result(const igraph_t *graph,
+                                       igraph_vector_ptr_t *vertices,
+                                       igraph_vector_ptr_t *edges,
+                                       igraph_integer_t from,
+                                       igraph_vit_t *vit,
+                                       const long int *parents,
+                                       igraph_vector_long_t *predecessors,
+                                       igraph_vector_long_t *inbound_edges);
+
 #endif
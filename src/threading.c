@@ -0,0 +1,839 @@
+/* -*- mode: C -*-  */
+/*
+   IGraph library.
+   Copyright (C) 2020  The igraph development team
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA
+   02110-1301 USA
+
+*/
+
+#include "igraph_threading.h"
+#include "igraph_error.h"
+#include "igraph_types.h"
+#include "igraph_memory.h"
+#include "igraph_interrupt_internal.h"
+#include "igraph_threading_internal.h"
+#include "config.h"
+
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+    #include <pthread.h>
+    #include <stdlib.h>
+    #include <unistd.h>
+#endif
+
+static IGRAPH_THREAD_LOCAL int igraph_i_num_threads = 1;
+
+/**
+ * \function igraph_set_num_threads
+ * \brief Sets the number of threads used by parallel algorithms.
+ *
+ * </para><para>
+ * Some igraph functions can divide their work among several threads,
+ * see the list in the introduction of this chapter. This function
+ * sets how many threads they use. The default is one, i.e. they run
+ * on the calling thread only, exactly as their serial versions.
+ *
+ * </para><para>
+ * If igraph was built without thread support (see \ref
+ * IGRAPH_PARALLEL), the number of threads is always one and this
+ * function has no effect.
+ *
+ * \param num_threads The number of threads. Zero or a negative value
+ *        means one thread for each online processor.
+ * \return Error code, currently always \c IGRAPH_SUCCESS.
+ *
+ * \sa \ref igraph_get_num_threads().
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_set_num_threads(int num_threads) {
+#ifdef HAVE_PTHREAD
+    if (num_threads <= 0) {
+        long int n = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = n > 0 ? (int) n : 1;
+    }
+    igraph_i_num_threads = num_threads;
+#else
+    IGRAPH_UNUSED(num_threads);
+#endif
+    return 0;
+}
+
+/**
+ * \function igraph_get_num_threads
+ * \brief The number of threads used by parallel algorithms.
+ *
+ * \return The number of threads set by \ref igraph_set_num_threads(),
+ *         or one if igraph was built without thread support.
+ *
+ * Time complexity: O(1).
+ */
+
+int igraph_get_num_threads(void) {
+    return igraph_i_num_threads;
+}
+
+/* A parallel region processes the chunks 0, ..., nchunks-1 of a
+ * loop. Participant zero is the calling thread, the others are the
+ * workers of a thread pool that is started when it is first needed
+ * and kept until igraph_parallel_shutdown() or the exit of the
+ * process. The child of fork() inherits the state of the pool but
+ * not its threads, so the pool is emptied there, and the next region
+ * starts new workers. At the start every
+ * participant owns a contiguous range of chunks. It takes chunks from
+ * the front of its own range, and once that is empty, it steals the
+ * back half of the range of another participant.
+ *
+ * Each participant has its own finally stack for the duration of the
+ * region. Errors and warnings raised on the participants are recorded
+ * in the region, instead of calling the handlers of the calling
+ * thread from the workers. The first error cancels the region and it
+ * is raised again on the calling thread when all participants have
+ * stopped. Only the calling thread calls the interruption and
+ * progress handlers, the workers see the interruption as a
+ * cancelled region.
+ *
+ * Only one region runs on the pool at a time. Regions started from
+ * within a region, or while another thread uses the pool, run
+ * serially on the calling thread. */
+
+typedef struct igraph_i_parallel_region_t igraph_i_parallel_region_t;
+
+typedef int igraph_i_parallel_chunk_t(igraph_i_parallel_region_t *region,
+                                      igraph_integer_t chunk, int thread);
+
+#ifdef HAVE_PTHREAD
+
+typedef struct igraph_i_parallel_range_t {
+    pthread_mutex_t lock;
+    igraph_integer_t begin, end;
+} igraph_i_parallel_range_t;
+
+#endif
+
+struct igraph_i_parallel_region_t {
+    igraph_i_parallel_chunk_t *chunk;
+    igraph_i_parallel_func_t *run_func;
+    igraph_parallel_for_func_t *for_func;
+    igraph_parallel_reduce_func_t *reduce_func;
+    void *arg;
+    igraph_integer_t n, grain, nchunks;
+    igraph_real_t *partial;
+    int nthreads;
+#ifdef HAVE_PTHREAD
+    igraph_i_parallel_range_t *ranges;
+    pthread_mutex_t lock;
+#endif
+    volatile int cancel;
+    igraph_bool_t interrupted;
+    int error;
+    char reason[500];
+    const char *file;
+    int line;
+    int warning;
+    igraph_bool_t has_warning;
+    char warning_reason[500];
+    const char *warning_file;
+    int warning_line;
+};
+
+struct igraph_i_parallel_context_t {
+    igraph_i_parallel_region_t *region;
+    int thread;
+    struct igraph_i_protectedPtr finally_stack[100];
+};
+
+#ifdef HAVE_PTHREAD
+
+typedef struct igraph_i_parallel_pool_t {
+    pthread_mutex_t lock;
+    pthread_cond_t work, done;
+    pthread_mutex_t busy;       /* held while a region runs */
+    int size;                   /* the number of workers */
+    unsigned long generation;   /* incremented for every region */
+    int pending;                /* workers that did not finish it yet */
+    int stop;                   /* the workers should exit */
+    igraph_i_parallel_region_t *region;
+    pthread_t *threads;         /* the workers, to join them */
+    int capacity;               /* the allocated length of 'threads' */
+} igraph_i_parallel_pool_t;
+
+typedef struct igraph_i_parallel_worker_t {
+    int thread;
+    unsigned long generation;
+} igraph_i_parallel_worker_t;
+
+static igraph_i_parallel_pool_t igraph_i_parallel_pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER, PTHREAD_MUTEX_INITIALIZER, 0, 0, 0, 0, 0, 0, 0
+};
+
+static pthread_key_t igraph_i_parallel_key;
+static pthread_once_t igraph_i_parallel_once = PTHREAD_ONCE_INIT;
+static volatile int igraph_i_parallel_active = 0;
+
+static void igraph_i_parallel_atfork_child(void);
+static void igraph_i_parallel_atexit(void);
+
+static void igraph_i_parallel_init(void) {
+    pthread_key_create(&igraph_i_parallel_key, 0);
+    pthread_atfork(0, 0, igraph_i_parallel_atfork_child);
+    atexit(igraph_i_parallel_atexit);
+}
+
+#endif
+
+igraph_i_parallel_context_t *igraph_i_parallel_context(void) {
+#ifdef HAVE_PTHREAD
+    if (igraph_i_parallel_active) {
+        return (igraph_i_parallel_context_t *)
+               pthread_getspecific(igraph_i_parallel_key);
+    }
+#endif
+    return 0;
+}
+
+struct igraph_i_protectedPtr *igraph_i_parallel_finally_stack(
+    igraph_i_parallel_context_t *ctx) {
+    return ctx->finally_stack;
+}
+
+igraph_bool_t igraph_i_parallel_is_caller(igraph_i_parallel_context_t *ctx) {
+    return ctx->thread == 0;
+}
+
+igraph_bool_t igraph_i_parallel_cancelled(igraph_i_parallel_context_t *ctx) {
+    return ctx->region->cancel != 0;
+}
+
+int igraph_i_parallel_error(igraph_i_parallel_context_t *ctx,
+                            const char *reason, const char *file,
+                            int line, int igraph_errno) {
+    igraph_i_parallel_region_t *region = ctx->region;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&region->lock);
+#endif
+    if (!region->error) {
+        region->error = igraph_errno;
+        strncpy(region->reason, reason, sizeof(region->reason) - 1);
+        region->reason[sizeof(region->reason) - 1] = '\0';
+        region->file = file;
+        region->line = line;
+    }
+    region->cancel = 1;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&region->lock);
+#endif
+    return igraph_errno;
+}
+
+void igraph_i_parallel_warning(igraph_i_parallel_context_t *ctx,
+                               const char *reason, const char *file,
+                               int line, int igraph_errno) {
+    igraph_i_parallel_region_t *region = ctx->region;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&region->lock);
+#endif
+    if (!region->has_warning) {
+        region->has_warning = 1;
+        region->warning = igraph_errno;
+        strncpy(region->warning_reason, reason,
+                sizeof(region->warning_reason) - 1);
+        region->warning_reason[sizeof(region->warning_reason) - 1] = '\0';
+        region->warning_file = file;
+        region->warning_line = line;
+    }
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&region->lock);
+#endif
+}
+
+void igraph_i_parallel_interrupt(igraph_i_parallel_context_t *ctx) {
+    igraph_i_parallel_region_t *region = ctx->region;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_lock(&region->lock);
+#endif
+    region->interrupted = 1;
+    region->cancel = 1;
+#ifdef HAVE_PTHREAD
+    pthread_mutex_unlock(&region->lock);
+#endif
+}
+
+int igraph_i_parallel_allow_interruption(igraph_i_parallel_context_t *ctx,
+        void *data) {
+    if (ctx->thread == 0 && !ctx->region->cancel &&
+        igraph_i_interruption_handler &&
+        igraph_i_interruption_handler(data) != IGRAPH_SUCCESS) {
+        igraph_i_parallel_interrupt(ctx);
+    }
+    return ctx->region->cancel ? IGRAPH_INTERRUPTED : IGRAPH_SUCCESS;
+}
+
+#ifdef HAVE_PTHREAD
+
+#ifdef HAVE_TLS
+/* Installed on the workers during a region, so that
+   IGRAPH_ALLOW_INTERRUPTION() calls igraph_allow_interruption(),
+   which checks whether the region was cancelled. */
+static int igraph_i_parallel_interruption_stub(void *data) {
+    IGRAPH_UNUSED(data);
+    return IGRAPH_SUCCESS;
+}
+#endif
+
+/* Takes the next chunk of 'thread', stealing from the others if its
+   own range is empty. Returns zero if there is no chunk left. */
+
+static igraph_bool_t igraph_i_parallel_next(igraph_i_parallel_region_t *region,
+        int thread, igraph_integer_t *chunk) {
+    igraph_i_parallel_range_t *own = &region->ranges[thread];
+    int i;
+
+    pthread_mutex_lock(&own->lock);
+    if (own->begin < own->end) {
+        *chunk = own->begin++;
+        pthread_mutex_unlock(&own->lock);
+        return 1;
+    }
+    pthread_mutex_unlock(&own->lock);
+
+    for (i = 1; i < region->nthreads; i++) {
+        igraph_i_parallel_range_t *victim =
+            &region->ranges[(thread + i) % region->nthreads];
+        igraph_integer_t left, end;
+        pthread_mutex_lock(&victim->lock);
+        left = victim->end - victim->begin;
+        if (left > 0) {
+            end = victim->end;
+            victim->end -= (left + 1) / 2;
+            *chunk = victim->end;
+            pthread_mutex_unlock(&victim->lock);
+            pthread_mutex_lock(&own->lock);
+            own->begin = *chunk + 1;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+        pthread_mutex_unlock(&victim->lock);
+    }
+
+    return 0;
+}
+
+static void igraph_i_parallel_work(igraph_i_parallel_region_t *region,
+                                   int thread) {
+    igraph_i_parallel_context_t ctx;
+    igraph_integer_t chunk;
+#ifdef HAVE_TLS
+    igraph_interruption_handler_t *handler = igraph_i_interruption_handler;
+    if (thread != 0) {
+        igraph_i_interruption_handler = igraph_i_parallel_interruption_stub;
+    }
+#endif
+
+    ctx.region = region;
+    ctx.thread = thread;
+    ctx.finally_stack[0].all = 0;
+    pthread_setspecific(igraph_i_parallel_key, &ctx);
+
+    while (!region->cancel) {
+        int ret;
+        if (thread == 0 &&
+            igraph_i_parallel_allow_interruption(&ctx, 0) != IGRAPH_SUCCESS) {
+            break;
+        }
+        if (!igraph_i_parallel_next(region, thread, &chunk)) {
+            break;
+        }
+        ret = region->chunk(region, chunk, thread);
+        if (ret == IGRAPH_INTERRUPTED) {
+            igraph_i_parallel_interrupt(&ctx);
+        } else if (ret != IGRAPH_SUCCESS) {
+            /* In case the chunk did not raise the error itself */
+            igraph_i_parallel_error(&ctx, "", __FILE__, __LINE__, ret);
+        }
+    }
+
+    pthread_setspecific(igraph_i_parallel_key, 0);
+#ifdef HAVE_TLS
+    igraph_i_interruption_handler = handler;
+#endif
+}
+
+static void *igraph_i_parallel_worker(void *arg) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+    igraph_i_parallel_worker_t *worker = (igraph_i_parallel_worker_t *) arg;
+    int thread = worker->thread;
+    unsigned long seen = worker->generation;
+
+    igraph_Free(worker);
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        igraph_i_parallel_region_t *region;
+        while (pool->generation == seen) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+        }
+        if (pool->stop) {
+            break;
+        }
+        seen = pool->generation;
+        region = pool->region;
+        pthread_mutex_unlock(&pool->lock);
+
+        if (thread < region->nthreads) {
+            igraph_i_parallel_work(region, thread);
+        }
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    return 0;
+}
+
+/* Starts workers until there are 'size' of them, or starting one
+   fails. Must be called with the busy lock held. Returns the number
+   of workers. */
+
+static int igraph_i_parallel_grow(int size) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+
+    if (pool->capacity < size) {
+        pthread_t *threads = igraph_Realloc(pool->threads, size, pthread_t);
+        if (!threads) {
+            return pool->size;
+        }
+        pool->threads = threads;
+        pool->capacity = size;
+    }
+
+    while (pool->size < size) {
+        igraph_i_parallel_worker_t *worker;
+        worker = igraph_Calloc(1, igraph_i_parallel_worker_t);
+        if (!worker) {
+            break;
+        }
+        worker->thread = pool->size + 1;
+        worker->generation = pool->generation;
+        if (pthread_create(&pool->threads[pool->size], 0,
+                           igraph_i_parallel_worker, worker) != 0) {
+            igraph_Free(worker);
+            break;
+        }
+        pool->size++;
+    }
+
+    return pool->size;
+}
+
+/* Tells the workers to exit and joins them. Must be called with the
+   busy lock held, i.e. while no region runs. */
+
+static void igraph_i_parallel_stop(void) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+    int t;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (t = 0; t < pool->size; t++) {
+        pthread_join(pool->threads[t], 0);
+    }
+
+    pool->size = 0;
+    pool->stop = 0;
+    pool->capacity = 0;
+    igraph_Free(pool->threads);
+}
+
+/* Only the thread that called fork() exists in the child. The locks
+   may have been held by other threads, and the workers are gone, so
+   the pool starts again from scratch. The array of the workers is
+   kept, it is reused by the next region or freed at exit. */
+
+static void igraph_i_parallel_atfork_child(void) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+
+    pthread_mutex_init(&pool->lock, 0);
+    pthread_cond_init(&pool->work, 0);
+    pthread_cond_init(&pool->done, 0);
+    pthread_mutex_init(&pool->busy, 0);
+    pool->size = 0;
+    pool->pending = 0;
+    pool->stop = 0;
+    pool->region = 0;
+    igraph_i_parallel_active = 0;
+}
+
+/* Joins the workers at exit, unless exit() is called while a region
+   runs, e.g. from a loop body. */
+
+static void igraph_i_parallel_atexit(void) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+
+    if (pthread_mutex_trylock(&pool->busy) == 0) {
+        igraph_i_parallel_stop();
+        pthread_mutex_unlock(&pool->busy);
+    }
+}
+
+/* Runs the region on the pool. Returns zero if this is not possible,
+   then the caller runs it serially. */
+
+static igraph_bool_t igraph_i_parallel_execute(igraph_i_parallel_region_t *region) {
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+    igraph_integer_t per, extra;
+    int t, workers;
+
+    if (pthread_mutex_trylock(&pool->busy) != 0) {
+        return 0;
+    }
+    pthread_once(&igraph_i_parallel_once, igraph_i_parallel_init);
+
+    workers = igraph_i_parallel_grow(region->nthreads - 1);
+    if (region->nthreads > workers + 1) {
+        region->nthreads = workers + 1;
+    }
+    region->ranges = region->nthreads > 1 ?
+                     igraph_Calloc(region->nthreads, igraph_i_parallel_range_t) : 0;
+    if (!region->ranges) {
+        pthread_mutex_unlock(&pool->busy);
+        return 0;
+    }
+
+    per = region->nchunks / region->nthreads;
+    extra = region->nchunks % region->nthreads;
+    for (t = 0; t < region->nthreads; t++) {
+        pthread_mutex_init(&region->ranges[t].lock, 0);
+        region->ranges[t].begin = t * per + (t < extra ? t : extra);
+        region->ranges[t].end = region->ranges[t].begin + per + (t < extra ? 1 : 0);
+    }
+    pthread_mutex_init(&region->lock, 0);
+
+    igraph_i_parallel_active = 1;
+    pthread_mutex_lock(&pool->lock);
+    pool->region = region;
+    pool->pending = pool->size;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    igraph_i_parallel_work(region, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pool->region = 0;
+    pthread_mutex_unlock(&pool->lock);
+    igraph_i_parallel_active = 0;
+
+    pthread_mutex_destroy(&region->lock);
+    for (t = 0; t < region->nthreads; t++) {
+        pthread_mutex_destroy(&region->ranges[t].lock);
+    }
+    igraph_Free(region->ranges);
+    pthread_mutex_unlock(&pool->busy);
+
+    return 1;
+}
+
+#endif
+
+static int igraph_i_parallel_serial(igraph_i_parallel_region_t *region) {
+    igraph_integer_t chunk;
+    for (chunk = 0; chunk < region->nchunks; chunk++) {
+        int ret;
+        IGRAPH_ALLOW_INTERRUPTION();
+        ret = region->chunk(region, chunk, 0);
+        if (ret == IGRAPH_INTERRUPTED) {
+            return ret;
+        }
+        IGRAPH_CHECK(ret);
+    }
+    return 0;
+}
+
+static int igraph_i_parallel(igraph_i_parallel_region_t *region) {
+    region->cancel = 0;
+    region->interrupted = 0;
+    region->error = 0;
+    region->has_warning = 0;
+    if (region->nthreads > region->nchunks) {
+        region->nthreads = (int) region->nchunks;
+    }
+
+#ifdef HAVE_PTHREAD
+    if (region->nthreads < 2 || igraph_i_parallel_context() ||
+        !igraph_i_parallel_execute(region)) {
+        return igraph_i_parallel_serial(region);
+    }
+#else
+    return igraph_i_parallel_serial(region);
+#endif
+
+    if (region->has_warning) {
+        igraph_warning(region->warning_reason, region->warning_file,
+                       region->warning_line, region->warning);
+    }
+    if (region->error) {
+        return igraph_error(region->reason, region->file, region->line,
+                            region->error);
+    }
+    if (region->interrupted) {
+        return IGRAPH_INTERRUPTED;
+    }
+    return 0;
+}
+
+static int igraph_i_parallel_run_chunk(igraph_i_parallel_region_t *region,
+                                       igraph_integer_t chunk, int thread) {
+    IGRAPH_UNUSED(thread);
+    return region->run_func(region->arg, (int) chunk);
+}
+
+/* Calls func(arg, i) for i = 0, ..., nthreads-1, on at most nthreads
+   threads of the pool, and waits for all of them. Each index is
+   processed exactly once, but not necessarily on a separate thread.
+   'func' can raise errors with IGRAPH_ERROR, the first one is raised
+   again on the calling thread. */
+
+int igraph_i_parallel_run(igraph_i_parallel_func_t *func, void *arg,
+                          int nthreads) {
+    igraph_i_parallel_region_t region;
+
+    region.chunk = igraph_i_parallel_run_chunk;
+    region.run_func = func;
+    region.arg = arg;
+    region.nchunks = nthreads > 1 ? nthreads : 1;
+    region.nthreads = nthreads;
+
+    return igraph_i_parallel(&region);
+}
+
+/**
+ * \function igraph_parallel_shutdown
+ * \brief Stops the threads of the parallel algorithms.
+ *
+ * </para><para>
+ * The worker threads of \ref igraph_parallel_for() and of the
+ * parallel algorithms are kept in a pool and reused. This function
+ * stops them and releases their memory. The next parallel loop
+ * starts new threads, so it is safe to call it at any time, except
+ * from within a parallel loop. If another thread is running a
+ * parallel loop, it waits until that loop has finished.
+ *
+ * </para><para>
+ * The threads are also stopped when the process exits, so calling
+ * this function is not necessary, but it is useful before checking
+ * for leaks with memory debuggers, or to free the resources of a
+ * long-running program. A child process created with \c fork()
+ * does not inherit the threads, it starts its own pool when needed.
+ *
+ * \return Error code, \c IGRAPH_EINVAL if called from within a
+ *         parallel loop.
+ *
+ * Time complexity: O(t), the number of threads in the pool.
+ */
+
+int igraph_parallel_shutdown(void) {
+#ifdef HAVE_PTHREAD
+    igraph_i_parallel_pool_t *pool = &igraph_i_parallel_pool;
+
+    if (igraph_i_parallel_context()) {
+        IGRAPH_ERROR("Cannot stop the threads from within a parallel loop",
+                     IGRAPH_EINVAL);
+    }
+
+    pthread_mutex_lock(&pool->busy);
+    igraph_i_parallel_stop();
+    pthread_mutex_unlock(&pool->busy);
+#endif
+    return 0;
+}
+
+static igraph_integer_t igraph_i_parallel_grain(igraph_integer_t n,
+        igraph_integer_t grain,
+        int nthreads) {
+    if (grain <= 0) {
+        grain = n / (8 * (igraph_integer_t) nthreads);
+    }
+    return grain > 0 ? grain : 1;
+}
+
+static int igraph_i_parallel_for_chunk(igraph_i_parallel_region_t *region,
+                                       igraph_integer_t chunk, int thread) {
+    igraph_integer_t from = chunk * region->grain;
+    igraph_integer_t to = region->n - from > region->grain ?
+                          from + region->grain : region->n;
+    return region->for_func(from, to, thread, region->arg);
+}
+
+/**
+ * \function igraph_parallel_for
+ * \brief Runs a loop on several threads.
+ *
+ * </para><para>
+ * Divides the indices 0, ..., \p n - 1 into chunks of \p grain
+ * consecutive indices, and calls \p func for each chunk, on \ref
+ * igraph_get_num_threads() threads. Each thread starts with a
+ * contiguous part of the chunks; threads that run out of work take
+ * over half of the remaining chunks of another thread, so uneven
+ * chunks are balanced automatically. The threads are kept in a pool
+ * and reused by later calls.
+ *
+ * </para><para>
+ * \p func may use the usual igraph error handling, \ref IGRAPH_CHECK,
+ * \ref IGRAPH_ERROR and \ref IGRAPH_FINALLY, even on the worker
+ * threads: each thread has its own finally stack while the loop
+ * runs, and errors are not passed to the error handler on the worker
+ * threads. Instead, the first error stops the loop, and once every
+ * thread has stopped, this function calls the error handler with it
+ * on the calling thread. Similarly, the first warning of the worker
+ * threads is reported after the loop, and only the calling thread
+ * reports progress and calls the interruption handler; on the other
+ * threads \ref igraph_allow_interruption() returns \c
+ * IGRAPH_INTERRUPTED once the loop was interrupted or failed.
+ *
+ * </para><para>
+ * The loop runs serially on the calling thread, in the order of the
+ * chunks, if only one thread is used, if igraph was built without
+ * thread support, if it is called from within another parallel loop,
+ * or if another thread is running a parallel loop at the same time.
+ *
+ * \param n The number of indices.
+ * \param grain The number of indices in a chunk. Zero or a negative
+ *        value chooses it automatically, so that there are about
+ *        eight chunks for each thread.
+ * \param func The function to call for each chunk. It must only
+ *        modify data that belongs to its range of indices or to its
+ *        thread index.
+ * \param arg Extra argument, passed to \p func.
+ * \return Error code, the first error returned by \p func, or
+ *         \c IGRAPH_INTERRUPTED if the loop was interrupted.
+ *
+ * \sa \ref igraph_parallel_reduce().
+ *
+ * Time complexity: O(n/grain) plus the time of the calls to \p func.
+ */
+
+int igraph_parallel_for(igraph_integer_t n, igraph_integer_t grain,
+                        igraph_parallel_for_func_t *func, void *arg) {
+    igraph_i_parallel_region_t region;
+
+    if (n < 0) {
+        IGRAPH_ERROR("Negative number of indices in parallel loop", IGRAPH_EINVAL);
+    }
+
+    region.nthreads = igraph_get_num_threads();
+    region.chunk = igraph_i_parallel_for_chunk;
+    region.for_func = func;
+    region.arg = arg;
+    region.n = n;
+    region.grain = igraph_i_parallel_grain(n, grain, region.nthreads);
+    region.nchunks = (n + region.grain - 1) / region.grain;
+
+    return igraph_i_parallel(&region);
+}
+
+static int igraph_i_parallel_reduce_chunk(igraph_i_parallel_region_t *region,
+        igraph_integer_t chunk, int thread) {
+    igraph_integer_t from = chunk * region->grain;
+    igraph_integer_t to = region->n - from > region->grain ?
+                          from + region->grain : region->n;
+    return region->reduce_func(from, to, thread, &region->partial[chunk],
+                               region->arg);
+}
+
+/**
+ * \function igraph_parallel_reduce
+ * \brief Sums up values computed on several threads.
+ *
+ * </para><para>
+ * Runs a loop like \ref igraph_parallel_for(), but \p func also
+ * returns a number for each chunk, and the result is the sum of
+ * these. The numbers of the chunks are added in the order of the
+ * chunks, not in the order they were computed, so the result does
+ * not depend on the timing of the threads: it is the same for every
+ * run with the same \p grain, and if \p grain is given explicitly, it
+ * is also the same for any number of threads.
+ *
+ * </para><para>
+ * Errors, warnings and interruption are handled as in \ref
+ * igraph_parallel_for().
+ *
+ * \param n The number of indices.
+ * \param grain The number of indices in a chunk, zero or a negative
+ *        value chooses it automatically.
+ * \param func The function to call for each chunk.
+ * \param arg Extra argument, passed to \p func.
+ * \param result Pointer to a real number, the sum is stored here.
+ * \return Error code, the first error returned by \p func,
+ *         \c IGRAPH_INTERRUPTED if the loop was interrupted, or
+ *         \c IGRAPH_ENOMEM if there is not enough memory for the
+ *         partial sums.
+ *
+ * Time complexity: O(n/grain) plus the time of the calls to \p func.
+ */
+
+int igraph_parallel_reduce(igraph_integer_t n, igraph_integer_t grain,
+                           igraph_parallel_reduce_func_t *func,
+                           void *arg, igraph_real_t *result) {
+    igraph_i_parallel_region_t region;
+    igraph_integer_t i;
+    igraph_real_t sum = 0.0;
+
+    if (n < 0) {
+        IGRAPH_ERROR("Negative number of indices in parallel loop", IGRAPH_EINVAL);
+    }
+
+    region.nthreads = igraph_get_num_threads();
+    region.chunk = igraph_i_parallel_reduce_chunk;
+    region.reduce_func = func;
+    region.arg = arg;
+    region.n = n;
+    region.grain = igraph_i_parallel_grain(n, grain, region.nthreads);
+    region.nchunks = (n + region.grain - 1) / region.grain;
+    region.partial = igraph_Calloc(region.nchunks > 0 ? region.nchunks : 1,
+                                   igraph_real_t);
+    if (!region.partial) {
+        IGRAPH_ERROR("Cannot run parallel reduction", IGRAPH_ENOMEM);
+    }
+    IGRAPH_FINALLY(igraph_free, region.partial);
+
+    IGRAPH_CHECK(igraph_i_parallel(&region));
+
+    for (i = 0; i < region.nchunks; i++) {
+        sum += region.partial[i];
+    }
+    *result = sum;
+
+    igraph_Free(region.partial);
+    IGRAPH_FINALLY_CLEAN(1);
+
+    return 0;
+}
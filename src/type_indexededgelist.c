@@ -25,13 +25,15 @@
 #include "igraph_interface.h"
 #include "igraph_attributes.h"
 #include "igraph_memory.h"
+#include "igraph_qsort.h"
+#include "igraph_types_internal.h"
 #include <string.h>     /* memset & co. */
 #include "config.h"
 
 /* Internal functions */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *index,
-                          igraph_integer_t nodes);
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+                          igraph_vector_int_t *index, igraph_integer_t nodes);
 
 /**
  * \section about_basic_interface
@@ -123,18 +125,19 @@ int igraph_empty_attrs(igraph_t *graph, igraph_integer_t n, igraph_bool_t direct
 
     graph->n = 0;
     graph->directed = directed;
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->from, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->to, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->oi, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->ii, 0);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->os, 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&graph->is, 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->from, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->to, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->oi, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->ii, 0);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->os, 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&graph->is, 1);
 
     VECTOR(graph->os)[0] = 0;
     VECTOR(graph->is)[0] = 0;
 
     /* init attributes */
     graph->attr = 0;
+    graph->mapping = 0;
     IGRAPH_CHECK(igraph_i_attribute_init(graph, attr));
 
     /* add the vertices */
@@ -164,12 +167,19 @@ void igraph_destroy(igraph_t *graph) {
 
     IGRAPH_I_ATTRIBUTE_DESTROY(graph);
 
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
-    igraph_vector_destroy(&graph->os);
-    igraph_vector_destroy(&graph->is);
+    if (graph->mapping) {
+        /* the vectors are views into the mapped file */
+        igraph_i_binary_release(graph->mapping);
+        graph->mapping = 0;
+        return;
+    }
+
+    igraph_vector_int_destroy(&graph->from);
+    igraph_vector_int_destroy(&graph->to);
+    igraph_vector_int_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->ii);
+    igraph_vector_int_destroy(&graph->os);
+    igraph_vector_int_destroy(&graph->is);
 }
 
 /**
@@ -201,18 +211,19 @@ void igraph_destroy(igraph_t *graph) {
 int igraph_copy(igraph_t *to, const igraph_t *from) {
     to->n = from->n;
     to->directed = from->directed;
-    IGRAPH_CHECK(igraph_vector_copy(&to->from, &from->from));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->from);
-    IGRAPH_CHECK(igraph_vector_copy(&to->to, &from->to));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->to);
-    IGRAPH_CHECK(igraph_vector_copy(&to->oi, &from->oi));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->oi);
-    IGRAPH_CHECK(igraph_vector_copy(&to->ii, &from->ii));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->ii);
-    IGRAPH_CHECK(igraph_vector_copy(&to->os, &from->os));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->os);
-    IGRAPH_CHECK(igraph_vector_copy(&to->is, &from->is));
-    IGRAPH_FINALLY(igraph_vector_destroy, &to->is);
+    to->mapping = 0;
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->from, &from->from));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->from);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->to, &from->to));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->to);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->oi, &from->oi));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->oi);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->ii, &from->ii));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->ii);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->os, &from->os));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->os);
+    IGRAPH_CHECK(igraph_vector_int_copy(&to->is, &from->is));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &to->is);
 
     IGRAPH_I_ATTRIBUTE_COPY(to, from, 1, 1, 1); /* does IGRAPH_CHECK */
 
@@ -220,6 +231,112 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
     return 0;
 }
 
+typedef struct igraph_i_edge_order_t {
+    const igraph_vector_int_t *key1;
+    const igraph_vector_int_t *key2;
+} igraph_i_edge_order_t;
+
+/* Orders edge ids the same way as igraph_vector_int_order() does:
+   by the first key, then by the second key, and edges with identical
+   keys by decreasing edge id. */
+
+static int igraph_i_edge_order_cmp(void *extra, const void *a, const void *b) {
+    igraph_i_edge_order_t *data = (igraph_i_edge_order_t *) extra;
+    igraph_integer_t ea = *(const igraph_integer_t *) a;
+    igraph_integer_t eb = *(const igraph_integer_t *) b;
+    igraph_integer_t a1 = VECTOR(*data->key1)[ea], b1 = VECTOR(*data->key1)[eb];
+    igraph_integer_t a2, b2;
+    if (a1 != b1) {
+        return a1 < b1 ? -1 : 1;
+    }
+    a2 = VECTOR(*data->key2)[ea]; b2 = VECTOR(*data->key2)[eb];
+    if (a2 != b2) {
+        return a2 < b2 ? -1 : 1;
+    }
+    return ea > eb ? -1 : (ea < eb ? 1 : 0);
+}
+
+/* Sorts the ids of the last 'batch' edges of the edge list into
+   'res', using the order of igraph_i_edge_order_cmp(). 'res' must
+   have 'batch' elements. */
+
+static void igraph_i_order_batch(igraph_vector_int_t *res,
+                                 const igraph_vector_int_t *key1,
+                                 const igraph_vector_int_t *key2) {
+    long int batch = igraph_vector_int_size(res);
+    long int first = igraph_vector_int_size(key1) - batch;
+    long int i;
+    igraph_i_edge_order_t data;
+
+    data.key1 = key1;
+    data.key2 = key2;
+    for (i = 0; i < batch; i++) {
+        VECTOR(*res)[i] = (igraph_integer_t) (first + i);
+    }
+    igraph_qsort_r(VECTOR(*res), (size_t) batch, sizeof(VECTOR(*res)[0]),
+                   &data, igraph_i_edge_order_cmp);
+}
+
+/* Merges the sorted ids of the new edges in 'batch' into the index
+   'iindex' of the old edges. This is done in place, from the back,
+   so 'iindex' must have enough reserved space for the new edges.
+   'start' is the start vector belonging to the old index, it is
+   used to find the insertion points with a binary search, so only
+   the moved blocks of the index are touched, not the edge list. New
+   edges have larger ids than all old ones, so they precede old edges
+   with the same keys. */
+
+static void igraph_i_merge_index(igraph_vector_int_t *iindex,
+                                 const igraph_vector_int_t *batch,
+                                 const igraph_vector_int_t *start,
+                                 const igraph_vector_int_t *key1,
+                                 const igraph_vector_int_t *key2) {
+    long int end = igraph_vector_int_size(iindex);
+    long int j = igraph_vector_int_size(batch) - 1;
+    igraph_integer_t *idx;
+
+    igraph_vector_int_resize(iindex, end + j + 1); /* reserved */
+    idx = VECTOR(*iindex);
+
+    for (; j >= 0; j--) {
+        igraph_integer_t enew = VECTOR(*batch)[j];
+        igraph_integer_t v = VECTOR(*key1)[enew], w = VECTOR(*key2)[enew];
+        long int lo = VECTOR(*start)[v], hi = VECTOR(*start)[v + 1];
+        if (hi > end) {
+            hi = end;
+        }
+        while (lo < hi) {
+            long int mid = lo + (hi - lo) / 2;
+            if (VECTOR(*key2)[ idx[mid] ] < w) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        memmove(idx + lo + j + 1, idx + lo, sizeof(idx[0]) * (size_t) (end - lo));
+        idx[lo + j] = enew;
+        end = lo;
+    }
+}
+
+/* Updates a start vector after the sorted new edges in 'batch' were
+   merged into the corresponding index. */
+
+static void igraph_i_update_start(igraph_vector_int_t *res,
+                                  const igraph_vector_int_t *batch,
+                                  const igraph_vector_int_t *el) {
+    long int no_of_nodes = igraph_vector_int_size(res) - 1;
+    long int batch_size = igraph_vector_int_size(batch);
+    long int v, j = 0;
+
+    for (v = 0; v <= no_of_nodes; v++) {
+        while (j < batch_size && VECTOR(*el)[ VECTOR(*batch)[j] ] < v) {
+            j++;
+        }
+        VECTOR(*res)[v] += j;
+    }
+}
+
 /**
  * \ingroup interface
  * \function igraph_add_edges
@@ -233,6 +350,12 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
  * should contain even number of integer numbers between zero and the
  * number of vertices in the graph minus one (inclusive). If you also
  * want to add new vertices, call igraph_add_vertices() first.
+ *
+ * </para><para>
+ * If only a few edges are added to a large graph, then only the new
+ * edges are sorted, and they are merged into the existing index of
+ * the graph. This makes adding edges in small batches considerably
+ * cheaper than rebuilding the graph each time.
  * \param graph The graph to which the edges will be added.
  * \param edges The edges themselves.
  * \param attr The attributes of the new edges, only used by high level
@@ -248,20 +371,28 @@ int igraph_copy(igraph_t *to, const igraph_t *from) {
  * Time complexity: O(|V|+|E|) where
  * |V| is the number of vertices and
  * |E| is the number of
- * edges in the \em new, extended graph.
+ * edges in the \em new, extended graph. If the number of new edges,
+ * k, is not larger than the number of existing edges, then
+ * O(|V|+|E|+k log |E|), but the |E| part is only a block copy within
+ * the index, and the edge list itself is not traversed.
  *
  * \example examples/simple/igraph_add_edges.c
  */
 int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
                      void *attr) {
-    long int no_of_edges = igraph_vector_size(&graph->from);
+    long int no_of_edges = igraph_vector_int_size(&graph->from);
     long int edges_to_add = igraph_vector_size(edges) / 2;
     long int i = 0;
     igraph_error_handler_t *oldhandler;
     int ret1, ret2;
-    igraph_vector_t newoi, newii;
+    igraph_vector_int_t newoi, newii;
     igraph_bool_t directed = igraph_is_directed(graph);
+    /* merge the new edges into the existing index, or rebuild it? */
+    igraph_bool_t merge = no_of_edges > 0 && edges_to_add <= no_of_edges;
 
+    if (graph->mapping) {
+        IGRAPH_ERROR("cannot add edges to a read-only graph", IGRAPH_EINVAL);
+    }
     if (igraph_vector_size(edges) % 2 != 0) {
         IGRAPH_ERROR("invalid (odd) length of edges vector", IGRAPH_EINVEVECTOR);
     }
@@ -270,40 +401,51 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
     }
 
     /* from & to */
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->from, no_of_edges + edges_to_add));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->to, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->from, no_of_edges + edges_to_add));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->to, no_of_edges + edges_to_add));
+    if (merge) {
+        IGRAPH_CHECK(igraph_vector_int_reserve(&graph->oi, no_of_edges + edges_to_add));
+        IGRAPH_CHECK(igraph_vector_int_reserve(&graph->ii, no_of_edges + edges_to_add));
+    }
 
     while (i < edges_to_add * 2) {
-        if (directed || VECTOR(*edges)[i] > VECTOR(*edges)[i + 1]) {
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
+        igraph_integer_t v1 = (igraph_integer_t) VECTOR(*edges)[i++];
+        igraph_integer_t v2 = (igraph_integer_t) VECTOR(*edges)[i++];
+        if (directed || v1 > v2) {
+            igraph_vector_int_push_back(&graph->from, v1); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   v2); /* reserved */
         } else {
-            igraph_vector_push_back(&graph->to,   VECTOR(*edges)[i++]); /* reserved */
-            igraph_vector_push_back(&graph->from, VECTOR(*edges)[i++]); /* reserved */
+            igraph_vector_int_push_back(&graph->to,   v1); /* reserved */
+            igraph_vector_int_push_back(&graph->from, v2); /* reserved */
         }
     }
 
     /* disable the error handler temporarily */
     oldhandler = igraph_set_error_handler(igraph_error_handler_ignore);
 
-    /* oi & ii */
-    ret1 = igraph_vector_init(&newoi, no_of_edges);
-    ret2 = igraph_vector_init(&newii, no_of_edges);
+    /* oi & ii, either for the new edges only, or for all edges */
+    ret1 = igraph_vector_int_init(&newoi, merge ? edges_to_add : no_of_edges);
+    ret2 = igraph_vector_int_init(&newii, merge ? edges_to_add : no_of_edges);
     if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges); /* gets smaller */
-        igraph_vector_resize(&graph->to, no_of_edges);   /* gets smaller */
+        igraph_vector_int_resize(&graph->from, no_of_edges); /* gets smaller */
+        igraph_vector_int_resize(&graph->to, no_of_edges);   /* gets smaller */
         igraph_set_error_handler(oldhandler);
         IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
     }
-    ret1 = igraph_vector_order(&graph->from, &graph->to, &newoi, graph->n);
-    ret2 = igraph_vector_order(&graph->to, &graph->from, &newii, graph->n);
-    if (ret1 != 0 || ret2 != 0) {
-        igraph_vector_resize(&graph->from, no_of_edges);
-        igraph_vector_resize(&graph->to, no_of_edges);
-        igraph_vector_destroy(&newoi);
-        igraph_vector_destroy(&newii);
-        igraph_set_error_handler(oldhandler);
-        IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
+    if (merge) {
+        igraph_i_order_batch(&newoi, &graph->from, &graph->to);
+        igraph_i_order_batch(&newii, &graph->to, &graph->from);
+    } else {
+        ret1 = igraph_vector_int_order(&graph->from, &graph->to, &newoi, graph->n);
+        ret2 = igraph_vector_int_order(&graph->to, &graph->from, &newii, graph->n);
+        if (ret1 != 0 || ret2 != 0) {
+            igraph_vector_int_resize(&graph->from, no_of_edges);
+            igraph_vector_int_resize(&graph->to, no_of_edges);
+            igraph_vector_int_destroy(&newoi);
+            igraph_vector_int_destroy(&newii);
+            igraph_set_error_handler(oldhandler);
+            IGRAPH_ERROR("cannot add edges", IGRAPH_ERROR_SELECT_2(ret1, ret2));
+        }
     }
 
     /* Attributes */
@@ -312,24 +454,33 @@ int igraph_add_edges(igraph_t *graph, const igraph_vector_t *edges,
         ret1 = igraph_i_attribute_add_edges(graph, edges, attr);
         igraph_set_error_handler(igraph_error_handler_ignore);
         if (ret1 != 0) {
-            igraph_vector_resize(&graph->from, no_of_edges);
-            igraph_vector_resize(&graph->to, no_of_edges);
-            igraph_vector_destroy(&newoi);
-            igraph_vector_destroy(&newii);
+            igraph_vector_int_resize(&graph->from, no_of_edges);
+            igraph_vector_int_resize(&graph->to, no_of_edges);
+            igraph_vector_int_destroy(&newoi);
+            igraph_vector_int_destroy(&newii);
             igraph_set_error_handler(oldhandler);
             IGRAPH_ERROR("cannot add edges", ret1);
         }
     }
 
-    /* os & is, its length does not change, error safe */
-    igraph_i_create_start(&graph->os, &graph->from, &newoi, graph->n);
-    igraph_i_create_start(&graph->is, &graph->to, &newii, graph->n);
+    /* everything went fine, install the new index */
+    if (merge) {
+        igraph_i_merge_index(&graph->oi, &newoi, &graph->os, &graph->from, &graph->to);
+        igraph_i_merge_index(&graph->ii, &newii, &graph->is, &graph->to, &graph->from);
+        igraph_i_update_start(&graph->os, &newoi, &graph->from);
+        igraph_i_update_start(&graph->is, &newii, &graph->to);
+        igraph_vector_int_destroy(&newoi);
+        igraph_vector_int_destroy(&newii);
+    } else {
+        igraph_vector_int_destroy(&graph->oi);
+        igraph_vector_int_destroy(&graph->ii);
+        graph->oi = newoi;
+        graph->ii = newii;
+        /* os & is, its length does not change, error safe */
+        igraph_i_create_start(&graph->os, &graph->from, &graph->oi, graph->n);
+        igraph_i_create_start(&graph->is, &graph->to, &graph->ii, graph->n);
+    }
 
-    /* everything went fine  */
-    igraph_vector_destroy(&graph->oi);
-    igraph_vector_destroy(&graph->ii);
-    graph->oi = newoi;
-    graph->ii = newii;
     igraph_set_error_handler(oldhandler);
 
     return 0;
@@ -365,12 +516,15 @@ int igraph_add_vertices(igraph_t *graph, igraph_integer_t nv, void *attr) {
     if (nv < 0) {
         IGRAPH_ERROR("cannot add negative number of vertices", IGRAPH_EINVAL);
     }
+    if (graph->mapping) {
+        IGRAPH_ERROR("cannot add vertices to a read-only graph", IGRAPH_EINVAL);
+    }
 
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->os, graph->n + nv + 1));
-    IGRAPH_CHECK(igraph_vector_reserve(&graph->is, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->os, graph->n + nv + 1));
+    IGRAPH_CHECK(igraph_vector_int_reserve(&graph->is, graph->n + nv + 1));
 
-    igraph_vector_resize(&graph->os, graph->n + nv + 1); /* reserved */
-    igraph_vector_resize(&graph->is, graph->n + nv + 1); /* reserved */
+    igraph_vector_int_resize(&graph->os, graph->n + nv + 1); /* reserved */
+    igraph_vector_int_resize(&graph->is, graph->n + nv + 1); /* reserved */
     for (i = graph->n + 1; i < graph->n + nv + 1; i++) {
         VECTOR(graph->os)[i] = ec;
         VECTOR(graph->is)[i] = ec;
@@ -417,11 +571,15 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     long int remaining_edges;
     igraph_eit_t eit;
 
-    igraph_vector_t newfrom, newto, newoi;
+    igraph_vector_int_t newfrom, newto, newoi;
 
     int *mark;
     long int i, j;
 
+    if (graph->mapping) {
+        IGRAPH_ERROR("cannot delete edges from a read-only graph", IGRAPH_EINVAL);
+    }
+
     mark = igraph_Calloc(no_of_edges, int);
     if (mark == 0) {
         IGRAPH_ERROR("Cannot delete edges", IGRAPH_ENOMEM);
@@ -444,8 +602,8 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     igraph_eit_destroy(&eit);
     IGRAPH_FINALLY_CLEAN(1);
 
-    IGRAPH_VECTOR_INIT_FINALLY(&newfrom, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newto, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newfrom, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newto, remaining_edges);
 
     /* Actually remove the edges, move from pos i to pos j in newfrom/newto */
     for (i = 0, j = 0; j < remaining_edges; i++) {
@@ -457,9 +615,11 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     }
 
     /* Create index, this might require additional memory */
-    IGRAPH_VECTOR_INIT_FINALLY(&newoi, remaining_edges);
-    IGRAPH_CHECK(igraph_vector_order(&newfrom, &newto, &newoi, no_of_nodes));
-    IGRAPH_CHECK(igraph_vector_order(&newto, &newfrom, &graph->ii, no_of_nodes));
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newoi, remaining_edges);
+    IGRAPH_CHECK(igraph_vector_int_order(&newfrom, &newto, &newoi,
+                                         (igraph_integer_t) no_of_nodes));
+    IGRAPH_CHECK(igraph_vector_int_order(&newto, &newfrom, &graph->ii,
+                                         (igraph_integer_t) no_of_nodes));
 
     /* Edge attributes, we need an index that gives the ids of the
        original edges for every new edge.
@@ -478,9 +638,9 @@ int igraph_delete_edges(igraph_t *graph, igraph_es_t edges) {
     }
 
     /* Ok, we've all memory needed, free the old structure  */
-    igraph_vector_destroy(&graph->from);
-    igraph_vector_destroy(&graph->to);
-    igraph_vector_destroy(&graph->oi);
+    igraph_vector_int_destroy(&graph->from);
+    igraph_vector_int_destroy(&graph->to);
+    igraph_vector_int_destroy(&graph->oi);
     graph->from = newfrom;
     graph->to = newto;
     graph->oi = newoi;
@@ -575,8 +735,8 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     }
     /* create edge recoding vector */
     for (remaining_edges = 0, i = 0; i < no_of_edges; i++) {
-        long int from = (long int) VECTOR(graph->from)[i];
-        long int to = (long int) VECTOR(graph->to)[i];
+        long int from = VECTOR(graph->from)[i];
+        long int to = VECTOR(graph->to)[i];
         if (VECTOR(*my_vertex_recoding)[from] != 0 &&
             VECTOR(*my_vertex_recoding)[to  ] != 0) {
             VECTOR(edge_recoding)[i] = remaining_edges + 1;
@@ -587,30 +747,33 @@ int igraph_delete_vertices_idx(igraph_t *graph, const igraph_vs_t vertices,
     /* start creating the graph */
     newgraph.n = (igraph_integer_t) remaining_vertices;
     newgraph.directed = graph->directed;
+    newgraph.mapping = 0;
 
     /* allocate vectors */
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.from, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.to, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.oi, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.ii, remaining_edges);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
-    IGRAPH_VECTOR_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.from, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.to, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.oi, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.ii, remaining_edges);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.os, remaining_vertices + 1);
+    IGRAPH_VECTOR_INT_INIT_FINALLY(&newgraph.is, remaining_vertices + 1);
 
     /* Add the edges */
     for (i = 0, j = 0; j < remaining_edges; i++) {
         if (VECTOR(edge_recoding)[i] > 0) {
-            long int from = (long int) VECTOR(graph->from)[i];
-            long int to = (long int) VECTOR(graph->to  )[i];
-            VECTOR(newgraph.from)[j] = VECTOR(*my_vertex_recoding)[from] - 1;
-            VECTOR(newgraph.to  )[j] = VECTOR(*my_vertex_recoding)[to] - 1;
+            long int from = VECTOR(graph->from)[i];
+            long int to = VECTOR(graph->to  )[i];
+            VECTOR(newgraph.from)[j] = (igraph_integer_t)
+                                       VECTOR(*my_vertex_recoding)[from] - 1;
+            VECTOR(newgraph.to  )[j] = (igraph_integer_t)
+                                       VECTOR(*my_vertex_recoding)[to] - 1;
             j++;
         }
     }
     /* update oi & ii */
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.from, &newgraph.to, &newgraph.oi,
-                                     remaining_vertices));
-    IGRAPH_CHECK(igraph_vector_order(&newgraph.to, &newgraph.from, &newgraph.ii,
-                                     remaining_vertices));
+    IGRAPH_CHECK(igraph_vector_int_order(&newgraph.from, &newgraph.to, &newgraph.oi,
+                                         (igraph_integer_t) remaining_vertices));
+    IGRAPH_CHECK(igraph_vector_int_order(&newgraph.to, &newgraph.from, &newgraph.ii,
+                                         (igraph_integer_t) remaining_vertices));
 
     IGRAPH_CHECK(igraph_i_create_start(&newgraph.os, &newgraph.from,
                                        &newgraph.oi, (igraph_integer_t)
@@ -700,7 +863,7 @@ igraph_integer_t igraph_vcount(const igraph_t *graph) {
  * Time complexity: O(1)
  */
 igraph_integer_t igraph_ecount(const igraph_t *graph) {
-    return (igraph_integer_t) igraph_vector_size(&graph->from);
+    return (igraph_integer_t) igraph_vector_int_size(&graph->from);
 }
 
 /**
@@ -769,31 +932,27 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
     if (!igraph_is_directed(graph) || mode != IGRAPH_ALL) {
 
         if (mode & IGRAPH_OUT) {
-            j = (long int) VECTOR(graph->os)[node + 1];
-            for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
-                VECTOR(*neis)[idx++] =
-                    VECTOR(graph->to)[ (long int)VECTOR(graph->oi)[i] ];
+            j = VECTOR(graph->os)[node + 1];
+            for (i = VECTOR(graph->os)[node]; i < j; i++) {
+                VECTOR(*neis)[idx++] = VECTOR(graph->to)[ VECTOR(graph->oi)[i] ];
             }
         }
         if (mode & IGRAPH_IN) {
-            j = (long int) VECTOR(graph->is)[node + 1];
-            for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
-                VECTOR(*neis)[idx++] =
-                    VECTOR(graph->from)[ (long int)VECTOR(graph->ii)[i] ];
+            j = VECTOR(graph->is)[node + 1];
+            for (i = VECTOR(graph->is)[node]; i < j; i++) {
+                VECTOR(*neis)[idx++] = VECTOR(graph->from)[ VECTOR(graph->ii)[i] ];
             }
         }
     } else {
         /* both in- and out- neighbors in a directed graph,
            we need to merge the two 'vectors' */
-        long int jj1 = (long int) VECTOR(graph->os)[node + 1];
-        long int j2 = (long int) VECTOR(graph->is)[node + 1];
-        long int i1 = (long int) VECTOR(graph->os)[node];
-        long int i2 = (long int) VECTOR(graph->is)[node];
+        long int jj1 = VECTOR(graph->os)[node + 1];
+        long int j2 = VECTOR(graph->is)[node + 1];
+        long int i1 = VECTOR(graph->os)[node];
+        long int i2 = VECTOR(graph->is)[node];
         while (i1 < jj1 && i2 < j2) {
-            long int n1 = (long int) VECTOR(graph->to)[
-                   (long int)VECTOR(graph->oi)[i1] ];
-            long int n2 = (long int) VECTOR(graph->from)[
-                   (long int)VECTOR(graph->ii)[i2] ];
+            long int n1 = VECTOR(graph->to)[ VECTOR(graph->oi)[i1] ];
+            long int n2 = VECTOR(graph->from)[ VECTOR(graph->ii)[i2] ];
             if (n1 < n2) {
                 VECTOR(*neis)[idx++] = n1;
                 i1++;
@@ -808,14 +967,12 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
             }
         }
         while (i1 < jj1) {
-            long int n1 = (long int) VECTOR(graph->to)[
-                   (long int)VECTOR(graph->oi)[i1] ];
+            long int n1 = VECTOR(graph->to)[ VECTOR(graph->oi)[i1] ];
             VECTOR(*neis)[idx++] = n1;
             i1++;
         }
         while (i2 < j2) {
-            long int n2 = (long int) VECTOR(graph->from)[
-                   (long int)VECTOR(graph->ii)[i2] ];
+            long int n2 = VECTOR(graph->from)[ VECTOR(graph->ii)[i2] ];
             VECTOR(*neis)[idx++] = n2;
             i2++;
         }
@@ -829,39 +986,39 @@ int igraph_neighbors(const igraph_t *graph, igraph_vector_t *neis, igraph_intege
  *
  */
 
-int igraph_i_create_start(igraph_vector_t *res, igraph_vector_t *el, igraph_vector_t *iindex,
-                          igraph_integer_t nodes) {
+int igraph_i_create_start(igraph_vector_int_t *res, igraph_vector_int_t *el,
+                          igraph_vector_int_t *iindex, igraph_integer_t nodes) {
 
-# define EDGE(i) (VECTOR(*el)[ (long int) VECTOR(*iindex)[(i)] ])
+# define EDGE(i) (VECTOR(*el)[ VECTOR(*iindex)[(i)] ])
 
     long int no_of_nodes;
     long int no_of_edges;
     long int i, j, idx;
 
     no_of_nodes = nodes;
-    no_of_edges = igraph_vector_size(el);
+    no_of_edges = igraph_vector_int_size(el);
 
     /* result */
 
-    IGRAPH_CHECK(igraph_vector_resize(res, nodes + 1));
+    IGRAPH_CHECK(igraph_vector_int_resize(res, nodes + 1));
 
     /* create the index */
 
-    if (igraph_vector_size(el) == 0) {
+    if (no_of_edges == 0) {
         /* empty graph */
-        igraph_vector_null(res);
+        igraph_vector_int_null(res);
     } else {
         idx = -1;
         for (i = 0; i <= EDGE(0); i++) {
             idx++; VECTOR(*res)[idx] = 0;
         }
         for (i = 1; i < no_of_edges; i++) {
-            long int n = (long int) (EDGE(i) - EDGE((long int)VECTOR(*res)[idx]));
+            long int n = EDGE(i) - EDGE(VECTOR(*res)[idx]);
             for (j = 0; j < n; j++) {
                 idx++; VECTOR(*res)[idx] = i;
             }
         }
-        j = (long int) EDGE((long int)VECTOR(*res)[idx]);
+        j = EDGE(VECTOR(*res)[idx]);
         for (i = 0; i < no_of_nodes - j; i++) {
             idx++; VECTOR(*res)[idx] = no_of_edges;
         }
@@ -976,9 +1133,9 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
                  IGRAPH_VIT_NEXT(vit), i++) {
                 long int vid = IGRAPH_VIT_GET(vit);
                 VECTOR(*res)[i] += (VECTOR(graph->os)[vid + 1] - VECTOR(graph->os)[vid]);
-                for (j = (long int) VECTOR(graph->os)[vid];
+                for (j = VECTOR(graph->os)[vid];
                      j < VECTOR(graph->os)[vid + 1]; j++) {
-                    if (VECTOR(graph->to)[ (long int)VECTOR(graph->oi)[j] ] == vid) {
+                    if (VECTOR(graph->to)[ VECTOR(graph->oi)[j] ] == vid) {
                         VECTOR(*res)[i] -= 1;
                     }
                 }
@@ -990,9 +1147,9 @@ int igraph_degree(const igraph_t *graph, igraph_vector_t *res,
                  IGRAPH_VIT_NEXT(vit), i++) {
                 long int vid = IGRAPH_VIT_GET(vit);
                 VECTOR(*res)[i] += (VECTOR(graph->is)[vid + 1] - VECTOR(graph->is)[vid]);
-                for (j = (long int) VECTOR(graph->is)[vid];
+                for (j = VECTOR(graph->is)[vid];
                      j < VECTOR(graph->is)[vid + 1]; j++) {
-                    if (VECTOR(graph->from)[ (long int)VECTOR(graph->ii)[j] ] == vid) {
+                    if (VECTOR(graph->from)[ VECTOR(graph->ii)[j] ] == vid) {
                         VECTOR(*res)[i] -= 1;
                     }
                 }
@@ -1029,11 +1186,11 @@ int igraph_edge(const igraph_t *graph, igraph_integer_t eid,
                 igraph_integer_t *from, igraph_integer_t *to) {
 
     if (igraph_is_directed(graph)) {
-        *from = (igraph_integer_t) VECTOR(graph->from)[(long int)eid];
-        *to   = (igraph_integer_t) VECTOR(graph->to  )[(long int)eid];
+        *from = VECTOR(graph->from)[(long int)eid];
+        *to   = VECTOR(graph->to  )[(long int)eid];
     } else {
-        *from = (igraph_integer_t) VECTOR(graph->to  )[(long int)eid];
-        *to   = (igraph_integer_t) VECTOR(graph->from)[(long int)eid];
+        *from = VECTOR(graph->to  )[(long int)eid];
+        *to   = VECTOR(graph->from)[(long int)eid];
     }
 
     return 0;
@@ -1690,14 +1847,14 @@ int igraph_incident(const igraph_t *graph, igraph_vector_t *eids,
     IGRAPH_CHECK(igraph_vector_resize(eids, length));
 
     if (mode & IGRAPH_OUT) {
-        j = (long int) VECTOR(graph->os)[node + 1];
-        for (i = (long int) VECTOR(graph->os)[node]; i < j; i++) {
+        j = VECTOR(graph->os)[node + 1];
+        for (i = VECTOR(graph->os)[node]; i < j; i++) {
             VECTOR(*eids)[idx++] = VECTOR(graph->oi)[i];
         }
     }
     if (mode & IGRAPH_IN) {
-        j = (long int) VECTOR(graph->is)[node + 1];
-        for (i = (long int) VECTOR(graph->is)[node]; i < j; i++) {
+        j = VECTOR(graph->is)[node + 1];
+        for (i = VECTOR(graph->is)[node]; i < j; i++) {
             VECTOR(*eids)[idx++] = VECTOR(graph->ii)[i];
         }
     }
@@ -285,6 +285,94 @@ int igraph_vector_order1_int(const igraph_vector_t* v,
     return 0;
 }
 
+/**
+ * \ingroup internal
+ * \function igraph_vector_int_order
+ * \brief Two-key radix sort of integer vectors.
+ *
+ * The same as \ref igraph_vector_order(), but for integer vectors.
+ * This is used to build the edge index of a graph, the sort keys are
+ * vertex ids, so the scratch space is kept in integer vectors, too.
+ *
+ * \param v The primary sort key.
+ * \param v2 The secondary sort key, it must have the same length as
+ *        \p v.
+ * \param res Initialized integer vector, the result is stored here,
+ *        it will be resized as needed.
+ * \param nodes The largest value in \p v and \p v2.
+ * \return Error code.
+ *
+ * Time complexity: O(n+nodes), n is the length of the vectors.
+ */
+
+int igraph_vector_int_order(const igraph_vector_int_t* v,
+                            const igraph_vector_int_t *v2,
+                            igraph_vector_int_t* res, igraph_integer_t nodes) {
+    long int edges = igraph_vector_int_size(v);
+    igraph_vector_int_t ptr;
+    igraph_vector_int_t rad;
+    long int i, j;
+
+    assert(v != NULL);
+    assert(v->stor_begin != NULL);
+
+    IGRAPH_CHECK(igraph_vector_int_init(&ptr, (long int) nodes + 1));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &ptr);
+    IGRAPH_CHECK(igraph_vector_int_init(&rad, edges));
+    IGRAPH_FINALLY(igraph_vector_int_destroy, &rad);
+    IGRAPH_CHECK(igraph_vector_int_resize(res, edges));
+
+    for (i = 0; i < edges; i++) {
+        long int radix = v2->stor_begin[i];
+        if (VECTOR(ptr)[radix] != 0) {
+            VECTOR(rad)[i] = VECTOR(ptr)[radix];
+        }
+        VECTOR(ptr)[radix] = i + 1;
+    }
+
+    j = 0;
+    for (i = 0; i < nodes + 1; i++) {
+        if (VECTOR(ptr)[i] != 0) {
+            long int next = VECTOR(ptr)[i] - 1;
+            res->stor_begin[j++] = next;
+            while (VECTOR(rad)[next] != 0) {
+                next = VECTOR(rad)[next] - 1;
+                res->stor_begin[j++] = next;
+            }
+        }
+    }
+
+    igraph_vector_int_null(&ptr);
+    igraph_vector_int_null(&rad);
+
+    for (i = 0; i < edges; i++) {
+        long int edge = VECTOR(*res)[edges - i - 1];
+        long int radix = VECTOR(*v)[edge];
+        if (VECTOR(ptr)[radix] != 0) {
+            VECTOR(rad)[edge] = VECTOR(ptr)[radix];
+        }
+        VECTOR(ptr)[radix] = edge + 1;
+    }
+
+    j = 0;
+    for (i = 0; i < nodes + 1; i++) {
+        if (VECTOR(ptr)[i] != 0) {
+            long int next = VECTOR(ptr)[i] - 1;
+            res->stor_begin[j++] = next;
+            while (VECTOR(rad)[next] != 0) {
+                next = VECTOR(rad)[next] - 1;
+                res->stor_begin[j++] = next;
+            }
+        }
+    }
+
+    igraph_vector_int_destroy(&ptr);
+    igraph_vector_int_destroy(&rad);
+    IGRAPH_FINALLY_CLEAN(2);
+
+    return 0;
+}
+
 int igraph_vector_rank(const igraph_vector_t *v, igraph_vector_t *res,
                        long int nodes) {
 